@@ -72,6 +72,8 @@ SOFTWARE.
 #define SNAP_ERROR_FRAME_FORMAT		(-5)	/**< @brief Frame format does not have the requested field. Check the frame format (header bytes). */
 #define SNAP_ERROR_SHORT_FRAME		(-6)	/**< @brief Frame format has the requested field, but it is incomplete or empty. */
 #define SNAP_ERROR_FIELD_TYPE		(-7)	/**< @brief Invalid field type value. It must be a value from #snap_fieldType_t. */
+#define SNAP_ERROR_UNCORRECTABLE	(-8)	/**< @brief FEC codeword has more errors than the code can correct. */
+#define SNAP_ERROR_MESSAGE_CHECK	(-9)	/**< @brief CRC of a reassembled message does not match, i.e. it was completed with fragments of another message. */
 
 /**
  * @}
@@ -126,6 +128,31 @@ SOFTWARE.
 #define SNAP_HDB1_EDM(pByteArray)	(SNAP_GET_BITS(SNAP_HDB1(pByteArray), SNAP_HDB1_EDM_MASK, SNAP_HDB1_EDM_POS))	/**< @brief Get the EDM bits of a frame. @param pByteArray Pointer to the array of bytes that contains the frame. */
 #define SNAP_HDB1_NDB(pByteArray)	(SNAP_GET_BITS(SNAP_HDB1(pByteArray), SNAP_HDB1_NDB_MASK, SNAP_HDB1_NDB_POS))	/**< @brief Get the NDB bits of a frame. @param pByteArray Pointer to the array of bytes that contains the frame. */
 
+/**
+ * @}
+ * @name Data length field (#SNAP_HDB1_NDB_USER_SPECIFIED)
+ * @{
+ */
+
+#define SNAP_LENGTH_EXTENDED	(0x80U)	/**< @brief Bit set in the first byte of a 2-byte data length field. Lengths up to 127 bytes use a single byte. */
+#define SNAP_LENGTH_MAX_SIZE	(2U)	/**< @brief Maximum size of the data length field. */
+
+#define SNAP_IS_EXACT_LENGTH(pByteArray)	(SNAP_HDB1_NDB(pByteArray) == SNAP_HDB1_NDB_USER_SPECIFIED)	/**< @brief Check if a frame has a data length field instead of a data size based on the NDB bits. @param pByteArray Pointer to the array of bytes that contains the frame. */
+#define SNAP_LENGTH(pLengthField)			(((pLengthField)[0] & SNAP_LENGTH_EXTENDED) ? \
+											 (uint16_t)((((pLengthField)[0] & ~SNAP_LENGTH_EXTENDED) << 8) | (pLengthField)[1]) : (uint16_t)(pLengthField)[0])	/**< @brief Get the value of a data length field. @param pLengthField Pointer to the first byte of the field. */
+
+/**
+ * @}
+ * @name Protocol flags used by the library (see snap_setInterleaving())
+ * @{
+ */
+
+#define SNAP_FLAGS_DEPTH_MASK	(0x03U)	/**< @brief Bit mask of the interleaving depth bits in the protocol flags. */
+#define SNAP_FLAGS_DEPTH_POS	(8U)	/**< @brief Position of the interleaving depth bits (LSb) in the protocol flags. */
+#define SNAP_MAX_DEPTH			(8U)	/**< @brief Maximum interleaving depth. */
+
+#define SNAP_FLAGS_DEPTH(flags)	(SNAP_GET_BITS(flags, SNAP_FLAGS_DEPTH_MASK, SNAP_FLAGS_DEPTH_POS))	/**< @brief Get the interleaving depth bits from the protocol flags. It can assume any value from #snap_depth_t. @param flags Protocol flags. */
+
 /**
  * @}
  * @name Frame and field sizes
@@ -136,10 +163,16 @@ SOFTWARE.
 #define SNAP_SIZE_HDB2				(1U)													/**< @brief Size of the HDB2 field. */
 #define SNAP_SIZE_HDB1				(1U)													/**< @brief Size of the HDB1 field. */
 #define SNAP_SIZE_HEADER			(SNAP_SIZE_HDB2 + SNAP_SIZE_HDB1)						/**< @brief Size of the header field. */
-#define SNAP_SIZE_DATA(pByteArray)	(snap_getDataSizeFromNdb(SNAP_HDB1_NDB(pByteArray)))	/**< @brief Size of the data field based on the NDB bits. @param pByteArray Pointer to the array of bytes that contains the frame. */
-#define SNAP_SIZE_HASH(pByteArray)	(snap_getHashSizeFromEdm(SNAP_HDB1_EDM(pByteArray)))	/**< @brief Size of the hash field based on the EDM bits. @param pByteArray Pointer to the array of bytes that contains the frame. */
+#define SNAP_SIZE_LENGTH(pByteArray)	(SNAP_IS_EXACT_LENGTH(pByteArray) ? (((pByteArray)[SNAP_INDEX_LENGTH(pByteArray)] & SNAP_LENGTH_EXTENDED) ? 2U : 1U) : 0U)	/**< @brief Size of the data length field (zero if the NDB bits are not #SNAP_HDB1_NDB_USER_SPECIFIED). @param pByteArray Pointer to the array of bytes that contains the frame. */
+#define SNAP_SIZE_DATA(pByteArray)	(SNAP_IS_EXACT_LENGTH(pByteArray) ? SNAP_LENGTH(&(pByteArray)[SNAP_INDEX_LENGTH(pByteArray)]) : \
+									 snap_getDataSizeFromNdb(SNAP_HDB1_NDB(pByteArray)))		/**< @brief Size of the data field based on the NDB bits (or on the data length field). @param pByteArray Pointer to the array of bytes that contains the frame. */
+#define SNAP_SIZE_HASH(pByteArray)	(snap_getHashSizeFromEdm(SNAP_HDB1_EDM(pByteArray)))	/**< @brief Size of the hash field based on the EDM bits (the FEC bytes depend on the frame size, see #snap_layout_t::hashSize). @param pByteArray Pointer to the array of bytes that contains the frame. */
 #define SNAP_MIN_SIZE_FRAME			(SNAP_SIZE_SYNC + SNAP_SIZE_HEADER)						/**< @brief Minimum frame size allowed = 1 (sync) + 2 (header). */
-#define SNAP_MAX_SIZE_FRAME			(528U)													/**< @brief Maximum frame size allowed = 1 (sync) + 2 (header) + 3 (destination address) + 3 (source address) + 3 (flags) + 512 (data) + 4 (hash). */
+#define SNAP_MAX_SIZE_DATA			(512U)													/**< @brief Maximum number of data bytes. */
+#define SNAP_MAX_SIZE_HASHED_FRAME	(530U)													/**< @brief Maximum size of a frame with a hash value (any EDM except #SNAP_HDB1_EDM_FEC) = 1 (sync) + 2 (header) + 3 (destination address) + 3 (source address) + 3 (flags) + 2 (data length) + 512 (data) + 4 (hash). */
+#define SNAP_MAX_SIZE_FEC_FRAME		(SNAP_MAX_SIZE_HASHED_FRAME - 4U + SNAP_SIZE_FEC_CHECK + SNAP_MAX_FEC_CODEWORDS * SNAP_SIZE_FEC_PARITY)	/**< @brief Maximum size of a FEC frame (#SNAP_HDB1_EDM_FEC) = 1 (sync) + 2 (header) + 3 (destination address) + 3 (source address) + 3 (flags) + 2 (data length) + 512 (data) + 2 (CRC-16) + parity bytes of each codeword. */
+#define SNAP_MAX_SIZE_FRAME			((SNAP_MAX_SIZE_FEC_FRAME > SNAP_MAX_SIZE_HASHED_FRAME) ? SNAP_MAX_SIZE_FEC_FRAME : SNAP_MAX_SIZE_HASHED_FRAME)	/**< @brief Maximum frame size allowed, whatever the error detection method. */
+#define SNAP_MAX_SIZE_BUFFER		(3U * SNAP_MAX_SIZE_HASHED_FRAME)						/**< @brief Maximum buffer size used by the library = 3 copies of the largest frame (#SNAP_HDB1_EDM_3_RETRANSMISSION). It is larger than any FEC frame. */
 
 #ifdef SNAP_SIZE_USER_HASH
 	#if (SNAP_SIZE_USER_HASH < 0) || (SNAP_SIZE_USER_HASH > 4)
@@ -149,6 +182,18 @@ SOFTWARE.
 	#define SNAP_SIZE_USER_HASH	(0U)	/**< @brief Size of the user hash field (0 to 4 bytes). It is supposed to be defined by the user in the compilation command. */
 #endif
 
+#ifdef SNAP_SIZE_FEC_PARITY
+	#if (SNAP_SIZE_FEC_PARITY < 2) || (SNAP_SIZE_FEC_PARITY > 64)
+		#error Invalid FEC parity size! It must be an integer from 2 to 64 (bytes).
+	#endif
+#else
+	#define SNAP_SIZE_FEC_PARITY	(8U)	/**< @brief Number of Reed-Solomon parity bytes in each FEC codeword (2 to 64 bytes). Each codeword can correct up to half this number of byte errors. It can be defined by the user in the compilation command. */
+#endif
+
+#define SNAP_SIZE_FEC_MESSAGE	(255U - SNAP_SIZE_FEC_PARITY)	/**< @brief Maximum number of frame bytes protected by each FEC codeword. Larger frames are split into several codewords. */
+#define SNAP_SIZE_FEC_CHECK		(2U)							/**< @brief Size of the CRC-16 stored after the data of a FEC frame. It rejects the frames that the decoder "corrects" into a wrong codeword when they have too many errors. */
+#define SNAP_MAX_FEC_CODEWORDS	(SNAP_MAX_DEPTH)				/**< @brief Maximum number of FEC codewords in a frame: 3 (up to 527 bytes from HDB2 to the CRC-16, and at least 191 bytes per codeword), or the interleaving depth. */
+
 /**
  * @}
  * @name Field indexes
@@ -161,7 +206,8 @@ SOFTWARE.
 #define SNAP_INDEX_DAB				(3U)														/**< @brief Index of the first (MSB) destination address byte (if there are any). */
 #define SNAP_INDEX_SAB(pByteArray)	(SNAP_INDEX_DAB + SNAP_HDB2_DAB(pByteArray))				/**< @brief Index of the first (MSB) source address byte (if there are any), based on the frame header. @param pByteArray Pointer to the array of bytes that contains the frame. */
 #define SNAP_INDEX_PFB(pByteArray)	(SNAP_INDEX_SAB(pByteArray) + SNAP_HDB2_SAB(pByteArray))	/**< @brief Index of the first (MSB) protocol flags byte (if there are any), based on the frame header. @param pByteArray Pointer to the array of bytes that contains the frame. */
-#define SNAP_INDEX_DATA(pByteArray)	(SNAP_INDEX_PFB(pByteArray) + SNAP_HDB2_PFB(pByteArray))	/**< @brief Index of the first data byte (if there are any), based on the frame header. @param pByteArray Pointer to the array of bytes that contains the frame. */
+#define SNAP_INDEX_LENGTH(pByteArray)	(SNAP_INDEX_PFB(pByteArray) + SNAP_HDB2_PFB(pByteArray))	/**< @brief Index of the first data length byte (if the NDB bits are #SNAP_HDB1_NDB_USER_SPECIFIED), based on the frame header. @param pByteArray Pointer to the array of bytes that contains the frame. */
+#define SNAP_INDEX_DATA(pByteArray)	(SNAP_INDEX_LENGTH(pByteArray) + SNAP_SIZE_LENGTH(pByteArray))	/**< @brief Index of the first data byte (if there are any), based on the frame header (and on the data length field). @param pByteArray Pointer to the array of bytes that contains the frame. */
 #define SNAP_INDEX_HASH(pByteArray)	(SNAP_INDEX_DATA(pByteArray) +  SNAP_SIZE_DATA(pByteArray))	/**< @brief Index of the first (MSB) hash byte (if there are any), based on the frame header. @param pByteArray Pointer to the array of bytes that contains the frame. */
 
 /**
@@ -181,6 +227,7 @@ SOFTWARE.
  * @note Only functions actually check the frame for errors (e.g. incomplete frame, wrong frame format, etc).
  *       Before using macros that are not wrappers of the function snap_getField(), be sure the operation is valid
  *       (i.e. the frame has a valid header, the frame format has the requested field, etc).
+ *       Macros that return field indexes and sizes read the layout cached in the frame structure (see snap_updateLayout()).
  * @{
  * @name Get frame content
  * @{
@@ -201,8 +248,10 @@ SOFTWARE.
 #define snap_getSourceAddress(pFrame, pSourceAddr)	(snap_getField(pFrame, pSourceAddr, SNAP_FIELD_SOURCE_ADDRESS))	/**< @brief Get the source address of a frame. @param pFrame Pointer to the frame structure (#snap_frame_t*). @param pSourceAddr Pointer to the variable that will store the address (uint32_t*). */
 #define snap_getProtocolFlags(pFrame, pFlags)		(snap_getField(pFrame, pFlags, SNAP_FIELD_PROTOCOL_FLAGS))		/**< @brief Get the protocol flags of a frame. @param pFrame Pointer to the frame structure (#snap_frame_t*). @param pFlags Pointer to the variable that will store the flags (uint32_t*). */
 #define snap_getData(pFrame, pData)					(snap_getField(pFrame, pData, SNAP_FIELD_DATA))					/**< @brief Get the data bytes of a frame. @param pFrame Pointer to the frame structure (#snap_frame_t*). @param pData Pointer to the byte array that will store the data (uint8_t*). */
-#define snap_getHash(pFrame, pHash)					(snap_getField(pFrame, pHash, SNAP_FIELD_HASH))					/**< @brief Get the hash value of a frame. @param pFrame Pointer to the frame structure (#snap_frame_t*). @param pHash Pointer to the variable that will store the hash value (uint32_t*). */
-#define snap_getDataPtr(pFrame)						((pFrame)->buffer + SNAP_INDEX_DATA((pFrame)->buffer))			/**< @brief Get the pointer to the first data byte of a frame. @param pFrame Pointer to the frame structure (#snap_frame_t*). */
+#define snap_getHash(pFrame, pHash)					(snap_getField(pFrame, pHash, SNAP_FIELD_HASH))					/**< @brief Get the hash value of a frame. @param pFrame Pointer to the frame structure (#snap_frame_t*). @param pHash Pointer to the variable that will store the hash value (uint32_t*, or an array of uint8_t with the CRC and parity bytes if the EDM is #SNAP_HDB1_EDM_FEC). */
+#define snap_getDataView(pFrame, ppData)			(snap_getFieldPtr(pFrame, ppData, SNAP_FIELD_DATA))				/**< @brief Get a pointer to the data bytes of a frame, without copying them. @param pFrame Pointer to the frame structure (#snap_frame_t*). @param ppData Pointer to the variable that will store the pointer to the first data byte (const uint8_t**). */
+#define snap_getHashView(pFrame, ppHash)			(snap_getFieldPtr(pFrame, ppHash, SNAP_FIELD_HASH))				/**< @brief Get a pointer to the hash bytes of a frame (MSB first), without copying them. @param pFrame Pointer to the frame structure (#snap_frame_t*). @param ppHash Pointer to the variable that will store the pointer to the first hash byte (const uint8_t**). */
+#define snap_getDataPtr(pFrame)						((pFrame)->buffer + (pFrame)->layout.dataIndex)			/**< @brief Get the pointer to the first data byte of a frame. @param pFrame Pointer to the frame structure (#snap_frame_t*). */
 #define snap_getBufferPtr(pFrame)					((pFrame)->buffer)												/**< @brief Get the pointer to the first byte of a frame. @param pFrame Pointer to the frame structure (#snap_frame_t*). */
 #define snap_getStatus(pFrame)						((pFrame)->status)												/**< @brief Get the frame status (it can be any value from #snap_status_t). @param pFrame Pointer to the frame structure (#snap_frame_t*). */
 
@@ -217,10 +266,10 @@ SOFTWARE.
 #define snap_getHdb1Index()				(SNAP_INDEX_HDB1)					/**< @brief Get the index of the HDB1 byte. */
 #define snap_getHeaderIndex()			(SNAP_INDEX_HDB2)					/**< @brief Get the index of the first header byte (HDB2). */
 #define snap_getDestAddrIndex()			(SNAP_INDEX_DAB)					/**< @brief Get the index of the first (MSB) destination address byte (if there are any). */
-#define snap_getSourceAddrIndex(pFrame)	(SNAP_INDEX_SAB((pFrame)->buffer))	/**< @brief Get the index of the first (MSB) source address byte (if there are any). @param pFrame Pointer to the frame structure (#snap_frame_t*). */
-#define snap_getProtFlagsIndex(pFrame)	(SNAP_INDEX_PFB((pFrame)->buffer))	/**< @brief Get the index of the first (MSB) protocol flags byte (if there are any). @param pFrame Pointer to the frame structure (#snap_frame_t*). */
-#define snap_getDataIndex(pFrame)		(SNAP_INDEX_DATA((pFrame)->buffer))	/**< @brief Get the index of the first data byte (if there are any). @param pFrame Pointer to the frame structure (#snap_frame_t*). */
-#define snap_getHashIndex(pFrame)		(SNAP_INDEX_HASH((pFrame)->buffer))	/**< @brief Get the index of the first (MSB) data byte (if there are any). @param pFrame Pointer to the frame structure (#snap_frame_t*). */
+#define snap_getSourceAddrIndex(pFrame)	((pFrame)->layout.sourceIndex)	/**< @brief Get the index of the first (MSB) source address byte (if there are any). @param pFrame Pointer to the frame structure (#snap_frame_t*). */
+#define snap_getProtFlagsIndex(pFrame)	((pFrame)->layout.flagsIndex)	/**< @brief Get the index of the first (MSB) protocol flags byte (if there are any). @param pFrame Pointer to the frame structure (#snap_frame_t*). */
+#define snap_getDataIndex(pFrame)		((pFrame)->layout.dataIndex)	/**< @brief Get the index of the first data byte (if there are any). @param pFrame Pointer to the frame structure (#snap_frame_t*). */
+#define snap_getHashIndex(pFrame)		((pFrame)->layout.hashIndex)	/**< @brief Get the index of the first (MSB) data byte (if there are any). @param pFrame Pointer to the frame structure (#snap_frame_t*). */
 
 /**
  * @}
@@ -235,11 +284,11 @@ SOFTWARE.
 #define snap_getDestAddrSize(pFrame)	(SNAP_HDB2_DAB((pFrame)->buffer))										/**< @brief Get the size of the destination address. @param pFrame Pointer to the frame structure (#snap_frame_t*). */
 #define snap_getSourceAddrSize(pFrame)	(SNAP_HDB2_SAB((pFrame)->buffer))										/**< @brief Get the size of the source address. @param pFrame Pointer to the frame structure (#snap_frame_t*). */
 #define snap_getProtFlagsSize(pFrame)	(SNAP_HDB2_PFB((pFrame)->buffer))										/**< @brief Get the size of the protocol flags. @param pFrame Pointer to the frame structure (#snap_frame_t*). */
-#define snap_getDataSize(pFrame)		(SNAP_SIZE_DATA((pFrame)->buffer))										/**< @brief Get the size of the data field. @param pFrame Pointer to the frame structure (#snap_frame_t*). */
-#define snap_getHashSize(pFrame)		(SNAP_SIZE_HASH((pFrame)->buffer))										/**< @brief Get the size of the hash field. @param pFrame Pointer to the frame structure (#snap_frame_t*). */
+#define snap_getDataSize(pFrame)		((pFrame)->layout.dataSize)												/**< @brief Get the size of the data field. @param pFrame Pointer to the frame structure (#snap_frame_t*). */
+#define snap_getHashSize(pFrame)		((pFrame)->layout.hashSize)												/**< @brief Get the size of the hash field. @param pFrame Pointer to the frame structure (#snap_frame_t*). */
 #define snap_getFrameSize(pFrame)		((pFrame)->size)														/**< @brief Get the current size of a frame (it may be incomplete). @param pFrame Pointer to the frame structure (#snap_frame_t*). */
 #define snap_getBufferSize(pFrame)		((pFrame)->maxSize)														/**< @brief Get the maximum number of bytes that can be stored in the buffer. @param pFrame Pointer to the frame structure (#snap_frame_t*). */
-#define snap_getFullFrameSize(pFrame)	(SNAP_INDEX_HASH((pFrame)->buffer) + SNAP_SIZE_HASH((pFrame)->buffer))	/**< @brief Get the size of a frame as if it were complete (based on the header). @param pFrame Pointer to the frame structure (#snap_frame_t*). */
+#define snap_getFullFrameSize(pFrame)	((pFrame)->layout.fullSize)												/**< @brief Get the size of a frame as if it were complete (based on the header). @param pFrame Pointer to the frame structure (#snap_frame_t*). */
 
 /**
  * @}
@@ -340,12 +389,16 @@ typedef enum snap_hdb1_cmd_t
 typedef enum snap_hdb1_edm_t
 {
 	SNAP_HDB1_EDM_NO_ERROR_DETECTION = 0,	/**< Frame does not contain any information about error detection/correction. */
-	SNAP_HDB1_EDM_3_RETRANSMISSION   = 1,	/**< The sending node must send the same frame 3 times, and the receiving node should compare the frames in order to detect errors. @note Not supported by this library. It produces the same result as EDM = 0. */
+	SNAP_HDB1_EDM_3_RETRANSMISSION   = 1,	/**< The sending node must send the same frame 3 times, and the receiving node should compare the frames in order to detect errors.
+												 @note This library writes the 3 copies back to back in the buffer, so the buffer must be 3 times the frame size. The decoder rebuilds the frame by a bitwise majority vote of the copies. */
 	SNAP_HDB1_EDM_8BIT_CHECKSUM      = 2,	/**< Frame has an 8-bit checksum at the end. */
 	SNAP_HDB1_EDM_8BIT_CRC           = 3,	/**< Frame has an 8-bit CRC at the end. */
 	SNAP_HDB1_EDM_16BIT_CRC          = 4,	/**< Frame has a 16-bit CRC at the end. */
 	SNAP_HDB1_EDM_32BIT_CRC          = 5,	/**< Frame has a 32-bit CRC at the end. */
-	SNAP_HDB1_EDM_FEC                = 6,	/**< Specific FEC (Forward Error Correction) standard to be determined. @note Not supported by this library. It produces the same result as EDM = 0. */
+	SNAP_HDB1_EDM_FEC                = 6,	/**< Specific FEC (Forward Error Correction) standard to be determined.
+												 @note This library uses a Reed-Solomon code over GF(256): a CRC-16 of the bytes from HDB2 to the last data byte (#SNAP_SIZE_FEC_CHECK bytes) follows the data,
+												 the bytes from HDB2 to the CRC are split into codewords of up to #SNAP_SIZE_FEC_MESSAGE bytes, and #SNAP_SIZE_FEC_PARITY parity bytes per codeword follow the CRC.
+												 The CRC and the parity bytes take the place of the hash value. The decoder corrects the frame in place, then checks the CRC. */
 	SNAP_HDB1_EDM_USER_SPECIFIED     = 7	/**< Error detection method defined by the user. @note This library only supports methods that append a hash value of up to 4 bytes into the end of the frame (like the CRC options).
 												 The user can only define the hash function (by overriding snap_calculateUserHash()) and the hash value size (by overriding #SNAP_SIZE_USER_HASH). */
 } snap_hdb1_edm_t;
@@ -370,9 +423,24 @@ typedef enum snap_hdb1_ndb_t
 	SNAP_HDB1_NDB_128BYTE_DATA   = 12,	/**< Frame has 128 data bytes (it might contain padding bytes). */
 	SNAP_HDB1_NDB_256BYTE_DATA   = 13,	/**< Frame has 256 data bytes (it might contain padding bytes). */
 	SNAP_HDB1_NDB_512BYTE_DATA   = 14,	/**< Frame has 512 data bytes (it might contain padding bytes). */
-	SNAP_HDB1_NDB_USER_SPECIFIED = 15	/**< Number of data bytes is defined by the user. @note Not supported by this library. It produces the same result as NDB = 0. */
+	SNAP_HDB1_NDB_USER_SPECIFIED = 15	/**< Number of data bytes is defined by the user.
+											 @note This library sends the exact number of data bytes (0 to #SNAP_MAX_SIZE_DATA, without padding) in a data length field placed right before the data:
+											 1 byte for up to 127 bytes, or 2 bytes (MSB first, with #SNAP_LENGTH_EXTENDED set in the first one) otherwise. */
 } snap_hdb1_ndb_t;
 
+/**
+ * @brief Values for the interleaving depth bits of the protocol flags (see #SNAP_FLAGS_DEPTH_POS and snap_setInterleaving()).
+ *        The bytes after the data length field are split into this number of rows, which are sent one column at a time,
+ *        so a burst of errors on the line hits each row (and each FEC codeword) only a few times.
+ */
+typedef enum snap_depth_t
+{
+	SNAP_DEPTH_1 = 0,	/**< Frame is not interleaved. */
+	SNAP_DEPTH_2 = 1,	/**< Frame is interleaved in 2 rows (and has at least 2 FEC codewords). */
+	SNAP_DEPTH_4 = 2,	/**< Frame is interleaved in 4 rows (and has at least 4 FEC codewords). */
+	SNAP_DEPTH_8 = 3	/**< Frame is interleaved in 8 rows (and has at least 8 FEC codewords). */
+} snap_depth_t;
+
 /**
  * @brief Values for the frame status. The frame structure will always be in one of these states.
  */
@@ -381,6 +449,7 @@ typedef enum snap_status_t
 	SNAP_STATUS_IDLE           =  0,	/**< Frame is considered empty (it has not received the sync byte yet). The frame structure must be in this state before decoding a new frame. */
 	SNAP_STATUS_INCOMPLETE     =  1,	/**< Frame has received the sync byte, but it is not complete yet. This state is used only during the decoding process. */
 	SNAP_STATUS_VALID          =  2,	/**< Frame buffer contains a complete and valid frame. */
+	SNAP_STATUS_SKIPPING       =  3,	/**< Frame is addressed to another node and its remaining bytes are being discarded (see snap_setAddressFilter()). This state is used only during the decoding process. */
 	SNAP_STATUS_ERROR_HASH     = -1,	/**< The hash value received does not match the value calculated. This state is used only during the decoding process. */
 	SNAP_STATUS_ERROR_OVERFLOW = -2		/**< Frame buffer does not have enough space to store the complete frame. */
 } snap_status_t;
@@ -415,15 +484,52 @@ typedef struct snap_fields_t
 	bool          paddingAfter;		/**< @brief Position of the padding bytes in the payload (if there are any). true = padding after data, false = padding before data. */
 } snap_fields_t;
 
+/**
+ * @brief Piece of a payload, used to encapsulate a frame from several non-contiguous chunks of data (see snap_encapsulateChunks()).
+ */
+typedef struct snap_chunk_t
+{
+	const uint8_t *data;	/**< @brief Pointer to the first byte of the chunk. */
+	uint16_t      size;		/**< @brief Number of bytes in the chunk. */
+	bool          inFlash;	/**< @brief Location of the chunk. true = program memory (e.g. a PROGMEM constant on AVR targets), false = data memory. It is ignored on targets with a single address space. */
+} snap_chunk_t;
+
+/**
+ * @brief Offsets and sizes of the frame fields, calculated once from the header bytes by snap_updateLayout().
+ */
+typedef struct snap_layout_t
+{
+	uint16_t dataIndex;		/**< @brief Index of the first data byte. */
+	uint16_t dataSize;		/**< @brief Size of the data field (including padding bytes). */
+	uint16_t hashIndex;		/**< @brief Index of the first (MSB) hash byte. */
+	uint16_t hashSize;		/**< @brief Size of the hash field. */
+	uint16_t fullSize;		/**< @brief Size of the frame as if it were complete (including the repeated copies of #SNAP_HDB1_EDM_3_RETRANSMISSION). */
+	uint8_t  sourceIndex;	/**< @brief Index of the first (MSB) source address byte. */
+	uint8_t  flagsIndex;	/**< @brief Index of the first (MSB) protocol flags byte. */
+} snap_layout_t;
+
 /**
  * @brief This is the main structure of the library, used in frame decoding, encapsulation, and decapsulation.
  */
 typedef struct snap_frame_t
 {
-	uint8_t  *buffer;	/**< @brief Pointer to the array that stores all the bytes of the frame. */
-	uint16_t maxSize;	/**< @brief Maximum number of bytes that can be stored in the buffer. */
-	uint16_t size;		/**< @brief Current size of the frame (it may be incomplete). */
-	int8_t   status;	/**< @brief Status of the frame, used primarily in the decoding process. It can assume any value from #snap_status_t. */
+	uint8_t       *buffer;	/**< @brief Pointer to the array that stores all the bytes of the frame. */
+	uint16_t      maxSize;	/**< @brief Maximum number of bytes that can be stored in the buffer. */
+	uint16_t      size;		/**< @brief Current size of the frame (it may be incomplete). */
+	snap_layout_t layout;	/**< @brief Field layout of the frame. It is only valid when the frame has a complete header. */
+	uint16_t      pendingIndex;	/**< @brief Index of the first byte received by snap_decodeStream() but not decoded yet. */
+	uint16_t      pendingSize;	/**< @brief Number of bytes received by snap_decodeStream() but not decoded yet. */
+	bool          pendingOverflow;	/**< @brief Bytes received by snap_decodeStream() while a valid frame was waiting for snap_reset() were lost, because the buffer was full. */
+	uint32_t      hash;		/**< @brief Running hash value of the frame being decoded, updated as each byte is received. Its content is only meaningful to the decoder. */
+	bool          incrementalHash;	/**< @brief The decoder validates the frame with its running hash (see #snap_frame_t::hash). It is set by the decoder when the header is complete. */
+	uint16_t      whitening;	/**< @brief State of the scrambler (see snap_setScrambling()). Its content is only meaningful to the library. */
+	uint32_t      localAddress;	/**< @brief Local address used by the decoder to reject frames addressed to other nodes. #SNAP_BROADCAST_ADDRESS disables the filter. */
+	uint32_t      groupMask;	/**< @brief Bit mask of the address bits that identify the group of this node. Zero means no group. */
+	uint16_t      skipCount;	/**< @brief Number of bytes of a rejected frame that still have to be skipped. */
+	bool          resynced;	/**< @brief The current frame started at a sync byte that snap_decodeStream() found inside a failed frame. */
+	bool          interleaving;	/**< @brief Frames are interleaved according to the depth bits of their protocol flags (see snap_setInterleaving()). */
+	bool          scrambling;	/**< @brief Frames are scrambled after the sync byte (see snap_setScrambling()). */
+	int8_t        status;	/**< @brief Status of the frame, used primarily in the decoding process. It can assume any value from #snap_status_t. */
 } snap_frame_t;
 
 /**
@@ -448,12 +554,34 @@ int16_t snap_init(snap_frame_t *frame, uint8_t *buffer, uint16_t maxSize);
 
 void snap_reset(snap_frame_t *frame);
 
+void snap_updateLayout(snap_frame_t *frame);
+
+void snap_setAddressFilter(snap_frame_t *frame, uint32_t localAddress, uint32_t groupMask);
+
+bool snap_isDestAccepted(const snap_frame_t *frame, uint32_t destAddress);
+
+void snap_setInterleaving(snap_frame_t *frame, bool enabled);
+
+void snap_setScrambling(snap_frame_t *frame, bool enabled);
+
 int8_t snap_decode(snap_frame_t *frame, uint8_t newByte);
 
+int8_t snap_decodeBuffer(snap_frame_t *frame, const uint8_t *bytes, uint16_t size, uint16_t *consumed);
+
+int8_t snap_decodeStream(snap_frame_t *frame, uint8_t newByte);
+
 int8_t snap_encapsulate(snap_frame_t *frame, snap_fields_t *fields);
 
+int8_t snap_encapsulateChunks(snap_frame_t *frame, snap_fields_t *fields, const snap_chunk_t *chunks, uint8_t chunkCount);
+
+uint8_t *snap_reservePayload(const snap_frame_t *frame, snap_fields_t *fields);
+
 int16_t snap_getField(const snap_frame_t *frame, void *fieldContent, uint8_t fieldType);
 
+int16_t snap_getFieldPtr(const snap_frame_t *frame, const uint8_t **fieldPtr, uint8_t fieldType);
+
+int16_t snap_decapsulate(snap_frame_t *frame, snap_fields_t *fields);
+
 int8_t snap_calculateHash(const snap_frame_t *frame, uint32_t *hash);
 
 /**
@@ -470,6 +598,8 @@ uint16_t snap_getDataSizeFromNdb(uint8_t ndb);
 
 uint8_t snap_getHashSizeFromEdm(uint8_t edm);
 
+uint32_t snap_readInteger(const uint8_t *bytes, uint8_t size);
+
 uint8_t snap_calculateChecksum8(const uint8_t *data, uint16_t size);
 
 uint8_t snap_calculateCrc8(const uint8_t *data, uint16_t size);
@@ -480,6 +610,10 @@ uint32_t snap_calculateCrc32(const uint8_t *data, uint16_t size);
 
 uint32_t snap_calculateUserHash(const uint8_t *data, uint16_t size);
 
+void snap_calculateFecParity(const uint8_t *data, uint16_t size, uint8_t *parity);
+
+int16_t snap_correctFecErrors(uint8_t *data, uint16_t size, uint8_t *parity);
+
 /**
  * @}
  * @}
@@ -0,0 +1,214 @@
+/*
+Copyright (c) 2026 libSNAP contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file   snap_arq.h
+ * @brief  Header file of the selective-repeat ARQ layer of the libSNAP library.
+ * @details Several frames can be sent before the first one is acknowledged (up to #SNAP_ARQ_WINDOW), and only the lost ones are sent again.
+ *          Every data frame carries a sequence number in the protocol flags and requests an ACK (#SNAP_HDB2_ACK_REQUESTED).
+ *          The ACK response (#SNAP_HDB2_ACK_RESPONSE_ACK) carries the cumulative ACK in the protocol flags (every frame before that sequence
+ *          number was received) and a selective ACK bitmap in the data (bit i % 8 of byte i / 8 is the frame cumulative ACK + 1 + i).
+ *          Frames are delivered to the application as soon as they arrive (duplicates are discarded), so the receiver does not store them.
+ *
+ * Example:
+ * @code
+ * // Transmitter
+ * snap_frame_t *frame = snap_arqSend(&sender, &fields, getTicks());
+ * if(frame != NULL) send(frame->buffer, frame->size);
+ * while((frame = snap_arqGetRetransmission(&sender, getTicks())) != NULL) send(frame->buffer, frame->size);
+ * if(ackReceived) snap_arqProcessAck(&sender, &rxFrame);
+ *
+ * // Receiver
+ * if(snap_decode(&rxFrame, newByte) == SNAP_STATUS_VALID)
+ * {
+ *     if(snap_arqReceive(&receiver, &rxFrame)) { ... new frame ... }
+ *     snap_arqEncapsulateAck(&receiver, &txFrame, &fields);
+ *     send(txFrame.buffer, txFrame.size);
+ * }
+ * @endcode
+ */
+
+#ifndef SNAP_ARQ_H_
+#define SNAP_ARQ_H_
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+/**
+ * @addtogroup libSNAP
+ * @{
+ */
+
+
+/******************************************************************************/
+/*  Public Includes                                                           */
+/******************************************************************************/
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "snap.h"
+
+
+/******************************************************************************/
+/*  Public Macros                                                             */
+/******************************************************************************/
+
+
+/**
+ * @addtogroup pm
+ * @{
+ * @name Protocol flags used by the ARQ layer
+ * @{
+ */
+
+#define SNAP_FLAGS_SEQ_MASK	(0xFFU)	/**< @brief Bit mask of the sequence number bits in the protocol flags. */
+#define SNAP_FLAGS_SEQ_POS	(0U)	/**< @brief Position of the sequence number bits (LSb) in the protocol flags. */
+
+#define SNAP_FLAGS_SEQ(flags)	(SNAP_GET_BITS(flags, SNAP_FLAGS_SEQ_MASK, SNAP_FLAGS_SEQ_POS))	/**< @brief Get the sequence number from the protocol flags (cumulative ACK in ACK responses). @param flags Protocol flags. */
+
+/**
+ * @}
+ * @name Window size
+ * @{
+ */
+
+#ifdef SNAP_ARQ_WINDOW
+	#if (SNAP_ARQ_WINDOW < 1) || (SNAP_ARQ_WINDOW > 32) || ((SNAP_ARQ_WINDOW & (SNAP_ARQ_WINDOW - 1)) != 0)
+		#error Invalid ARQ window size! It must be 1, 2, 4, 8, 16 or 32 (frames).
+	#endif
+#else
+	#define SNAP_ARQ_WINDOW	(4U)	/**< @brief Maximum number of frames sent and not acknowledged yet (1, 2, 4, 8, 16 or 32). Each one keeps a frame buffer in the sender. It can be defined by the user in the compilation command. */
+#endif
+
+#define SNAP_ARQ_SIZE_SACK	((SNAP_ARQ_WINDOW + 7U) / 8U)	/**< @brief Size of the selective ACK bitmap in the data of an ACK response. */
+
+/**
+ * @}
+ * @}
+ */
+
+
+/******************************************************************************/
+/*  Public Types                                                              */
+/******************************************************************************/
+
+
+/**
+ * @addtogroup pt
+ * @{
+ */
+
+/**
+ * @brief Frame sent and kept by the sender until it is acknowledged.
+ */
+typedef struct snap_arqSlot_t
+{
+	snap_frame_t frame;		/**< @brief Frame structure that holds the encapsulated frame. */
+	uint32_t     sendTime;	/**< @brief Time when the frame was sent for the last time. */
+	uint8_t      retries;	/**< @brief Number of times the frame was sent again. */
+	bool         busy;		/**< @brief The frame was sent and not acknowledged yet. */
+	bool         lost;		/**< @brief A later frame was acknowledged before this one, so it should be sent again right away. */
+} snap_arqSlot_t;
+
+/**
+ * @brief Sender of the selective-repeat ARQ layer (one per destination).
+ */
+typedef struct snap_arqSender_t
+{
+	snap_arqSlot_t slot[SNAP_ARQ_WINDOW];	/**< @brief Frames in the window, indexed by the sequence number modulo #SNAP_ARQ_WINDOW. */
+	uint32_t       timeout;					/**< @brief Time after which a frame not acknowledged is sent again. */
+	uint16_t       failedCount;				/**< @brief Number of frames given up after the maximum number of retries. */
+	uint8_t        base;					/**< @brief Sequence number of the oldest frame not acknowledged yet. */
+	uint8_t        nextSeq;					/**< @brief Sequence number of the next frame. */
+	uint8_t        maxRetries;				/**< @brief Maximum number of retries of each frame. */
+} snap_arqSender_t;
+
+/**
+ * @brief Receiver of the selective-repeat ARQ layer (one per source).
+ */
+typedef struct snap_arqReceiver_t
+{
+	uint32_t received;	/**< @brief Bitmap of the frames received in the window (bit i is the frame base + i). */
+	uint8_t  base;		/**< @brief Sequence number of the oldest frame not received yet (cumulative ACK). */
+} snap_arqReceiver_t;
+
+/**
+ * @}
+ */
+
+
+/******************************************************************************/
+/*  Public Function Declarations                                              */
+/******************************************************************************/
+
+
+/**
+ * @addtogroup pf
+ * @{
+ * @name Sequence number functions
+ * @{
+ */
+
+void snap_setSeq(snap_fields_t *fields, uint8_t seq);
+
+bool snap_getSeq(const snap_frame_t *frame, uint8_t *seq);
+
+/**
+ * @}
+ * @name ARQ functions
+ * @{
+ */
+
+int16_t snap_initArqSender(snap_arqSender_t *sender, uint8_t *buffer, uint16_t slotSize, uint32_t timeout, uint8_t maxRetries);
+
+snap_frame_t *snap_arqSend(snap_arqSender_t *sender, snap_fields_t *fields, uint32_t now);
+
+uint8_t snap_arqProcessAck(snap_arqSender_t *sender, const snap_frame_t *frame);
+
+snap_frame_t *snap_arqGetRetransmission(snap_arqSender_t *sender, uint32_t now);
+
+uint8_t snap_arqGetPendingCount(const snap_arqSender_t *sender);
+
+void snap_initArqReceiver(snap_arqReceiver_t *receiver);
+
+bool snap_arqReceive(snap_arqReceiver_t *receiver, const snap_frame_t *frame);
+
+int8_t snap_arqEncapsulateAck(const snap_arqReceiver_t *receiver, snap_frame_t *frame, snap_fields_t *fields);
+
+/**
+ * @}
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+	}
+#endif
+
+#endif	// SNAP_ARQ_H_
+
+/******************************** END OF FILE *********************************/
@@ -0,0 +1,252 @@
+/*
+Copyright (c) 2026 libSNAP contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file   snap_link.h
+ * @brief  Header file of the link manager of the libSNAP library.
+ * @details The link manager keeps the state of the link with each peer, updated with the result of every frame exchanged with it
+ *          (ACK, NACK, retry or hash error), and adapts the frame format of the link to the error rate observed.
+ *
+ *          The error detection method climbs the ladder 8-bit checksum, CRC-8, CRC-16, CRC-32 and FEC (within the range supported by
+ *          the peer) when the error rate exceeds #SNAP_LINK_UP_PERCENT, and goes back down when it drops below #SNAP_LINK_DOWN_PERCENT
+ *          with no failure in the last #SNAP_LINK_DOWN_HOLD frames. Both moves require a minimum number of frames since the previous
+ *          one (hysteresis). The peer learns the new method from the EDM bits of the frames it receives (see snap_reportLinkFrame()),
+ *          so it can answer with the same method: a stronger one right away, a lighter one with the same hysteresis.
+ *
+ *          The link manager also estimates the byte error rate of the link (failures per byte sent or received, over the last
+ *          #SNAP_LINK_BYTE_WINDOW bytes) and picks the NDB size class with the highest expected goodput: the fraction of the frame
+ *          taken by data, multiplied by the probability that the frame goes through. Short frames waste bytes in overhead, long
+ *          frames fail (and are sent again) more often. Messages larger than the size chosen are split by the fragmentation layer
+ *          (see snap_getLinkFragmentSize()). The estimate and the choice are available through snap_getLinkStats().
+ *          Only integer arithmetic is used, so the same code runs on the MCU and on the host.
+ *
+ * Example:
+ * @code
+ * snap_link_t *link = snap_findLink(links, LINK_COUNT, destAddress);
+ * snap_applyLink(link, &fields);
+ * snap_encapsulate(&txFrame, &fields);
+ * ...
+ * snap_reportLinkTransfer(link, ackReceived ? SNAP_LINK_EVENT_ACK : SNAP_LINK_EVENT_RETRY, txFrame.size);
+ *
+ * // Large message, split according to the link
+ * const uint16_t fragmentSize = snap_getLinkFragmentSize(link, &fields, sizeof(image));
+ * for(uint8_t i = 0; i < snap_getFragmentCount(sizeof(image), fragmentSize); i++) { ... snap_encapsulateFragment(...) ... }
+ * @endcode
+ */
+
+#ifndef SNAP_LINK_H_
+#define SNAP_LINK_H_
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+/**
+ * @addtogroup libSNAP
+ * @{
+ */
+
+
+/******************************************************************************/
+/*  Public Includes                                                           */
+/******************************************************************************/
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "snap.h"
+#include "snap_fragment.h"
+
+
+/******************************************************************************/
+/*  Public Macros                                                             */
+/******************************************************************************/
+
+
+/**
+ * @addtogroup pm
+ * @{
+ * @name Adaptation parameters
+ * @{
+ */
+
+#ifdef SNAP_LINK_UP_PERCENT
+	#if (SNAP_LINK_UP_PERCENT < 0) || (SNAP_LINK_UP_PERCENT > 100)
+		#error Invalid upgrade error rate! It must be a value from 0 to 100 (percent).
+	#endif
+#else
+	#define SNAP_LINK_UP_PERCENT	(20U)	/**< @brief Frame error rate (percent) above which the link moves to a stronger error detection method (0 to 100). It can be defined by the user in the compilation command. */
+#endif
+
+#ifdef SNAP_LINK_DOWN_PERCENT
+	#if (SNAP_LINK_DOWN_PERCENT < 0) || (SNAP_LINK_DOWN_PERCENT > 100)
+		#error Invalid downgrade error rate! It must be a value from 0 to 100 (percent).
+	#endif
+#else
+	#define SNAP_LINK_DOWN_PERCENT	(2U)	/**< @brief Frame error rate (percent) below which the link moves to a lighter error detection method (0 to 100). It can be defined by the user in the compilation command. */
+#endif
+
+#ifdef SNAP_LINK_UP_HOLD
+	#if (SNAP_LINK_UP_HOLD < 1) || (SNAP_LINK_UP_HOLD > 255)
+		#error Invalid upgrade hold! It must be a value from 1 to 255 (frames).
+	#endif
+#else
+	#define SNAP_LINK_UP_HOLD		(8U)	/**< @brief Minimum number of frames between a change of the error detection method and a move to a stronger one (1 to 255). It can be defined by the user in the compilation command. */
+#endif
+
+#ifdef SNAP_LINK_DOWN_HOLD
+	#if (SNAP_LINK_DOWN_HOLD < 1) || (SNAP_LINK_DOWN_HOLD > 255)
+		#error Invalid downgrade hold! It must be a value from 1 to 255 (frames).
+	#endif
+#else
+	#define SNAP_LINK_DOWN_HOLD		(64U)	/**< @brief Minimum number of frames since the last change of the error detection method, and since the last failure, for a move to a lighter one (1 to 255). It can be defined by the user in the compilation command. */
+#endif
+
+#ifdef SNAP_LINK_BYTE_WINDOW
+	#if (SNAP_LINK_BYTE_WINDOW < 256) || (SNAP_LINK_BYTE_WINDOW > 65535)
+		#error Invalid byte error rate window! It must be a value from 256 to 65535 (bytes).
+	#endif
+#else
+	#define SNAP_LINK_BYTE_WINDOW	(16384U)	/**< @brief Number of bytes after which the byte error rate counters are halved, so old results lose weight (256 to 65535). It can be defined by the user in the compilation command. */
+#endif
+
+#define SNAP_LINK_RATE_ONE		(0xFFFFU)	/**< @brief Error rate of a link where every frame (or byte) fails (see #snap_link_t::errorRate). */
+
+/**
+ * @}
+ * @}
+ */
+
+
+/******************************************************************************/
+/*  Public Types                                                              */
+/******************************************************************************/
+
+
+/**
+ * @addtogroup pt
+ * @{
+ */
+
+/**
+ * @brief Events reported to the link manager.
+ */
+typedef enum snap_linkEvent_t
+{
+	SNAP_LINK_EVENT_ACK        = 0,	/**< A frame sent to the peer was acknowledged, or a valid frame was received from it. */
+	SNAP_LINK_EVENT_NACK       = 1,	/**< A frame sent to the peer was rejected by it (NACK response). */
+	SNAP_LINK_EVENT_RETRY      = 2,	/**< A frame sent to the peer had to be sent again (no response before the timeout). */
+	SNAP_LINK_EVENT_HASH_ERROR = 3	/**< A frame received from the peer failed the hash check. */
+} snap_linkEvent_t;
+
+/**
+ * @brief State of the link with a peer.
+ */
+typedef struct snap_link_t
+{
+	uint32_t address;			/**< @brief Address of the peer. */
+	uint16_t errorRate;			/**< @brief Moving average of the frame error rate (#SNAP_LINK_RATE_ONE = 100 %). */
+	uint16_t ackCount;			/**< @brief Number of successful frames (saturated). */
+	uint16_t nackCount;			/**< @brief Number of NACK responses (saturated). */
+	uint16_t retryCount;		/**< @brief Number of retries (saturated). */
+	uint16_t hashErrorCount;	/**< @brief Number of frames received with hash errors (saturated). */
+	uint8_t  holdCount;			/**< @brief Number of frames since the last change of the error detection method (saturated). */
+	uint8_t  cleanCount;		/**< @brief Number of frames since the last failure (saturated). */
+	uint8_t  edm;				/**< @brief Error detection method used in the frames sent to the peer. It can assume any value from #snap_hdb1_edm_t. */
+	uint8_t  minEdm;			/**< @brief Lightest error detection method of the ladder that can be used with the peer. */
+	uint8_t  maxEdm;			/**< @brief Strongest error detection method of the ladder that can be used with the peer. */
+	uint8_t  ndb;				/**< @brief NDB size class chosen by the last call to snap_selectLinkDataSize() (zero before it). */
+	uint16_t goodput;			/**< @brief Expected goodput of the NDB size class chosen (#SNAP_LINK_RATE_ONE = 100 %). */
+	uint16_t byteCount;			/**< @brief Number of bytes sent or received in the current window (see #SNAP_LINK_BYTE_WINDOW). */
+	uint16_t failWeight;		/**< @brief Number of failures in the current window, in units of 1/16. */
+} snap_link_t;
+
+/**
+ * @brief Statistics of the link with a peer.
+ */
+typedef struct snap_linkStats_t
+{
+	uint16_t frameErrorRate;	/**< @brief Moving average of the frame error rate (#SNAP_LINK_RATE_ONE = 100 %). */
+	uint16_t byteErrorRate;		/**< @brief Estimated byte error rate (#SNAP_LINK_RATE_ONE = 100 %). */
+	uint16_t ackCount;			/**< @brief Number of successful frames. */
+	uint16_t nackCount;			/**< @brief Number of NACK responses. */
+	uint16_t retryCount;		/**< @brief Number of retries. */
+	uint16_t hashErrorCount;	/**< @brief Number of frames received with hash errors. */
+	uint16_t dataSize;			/**< @brief Number of data bytes of the NDB size class chosen. */
+	uint16_t goodput;			/**< @brief Expected goodput of the NDB size class chosen (#SNAP_LINK_RATE_ONE = 100 %). */
+	uint8_t  edm;				/**< @brief Error detection method used with the peer. */
+	uint8_t  ndb;				/**< @brief NDB size class chosen. */
+} snap_linkStats_t;
+
+/**
+ * @}
+ */
+
+
+/******************************************************************************/
+/*  Public Function Declarations                                              */
+/******************************************************************************/
+
+
+/**
+ * @addtogroup pf
+ * @{
+ * @name Link manager functions
+ * @{
+ */
+
+void snap_initLink(snap_link_t *link, uint32_t address, uint8_t minEdm, uint8_t maxEdm);
+
+snap_link_t *snap_findLink(snap_link_t *links, uint8_t count, uint32_t address);
+
+void snap_reportLinkEvent(snap_link_t *link, uint8_t event);
+
+void snap_reportLinkTransfer(snap_link_t *link, uint8_t event, uint16_t frameSize);
+
+void snap_reportLinkFrame(snap_link_t *link, const snap_frame_t *frame);
+
+void snap_applyLink(const snap_link_t *link, snap_fields_t *fields);
+
+uint16_t snap_getLinkByteErrorRate(const snap_link_t *link);
+
+uint16_t snap_selectLinkDataSize(snap_link_t *link, const snap_fields_t *fields, uint16_t maxDataSize);
+
+uint16_t snap_getLinkFragmentSize(snap_link_t *link, const snap_fields_t *fields, uint16_t messageSize);
+
+void snap_getLinkStats(const snap_link_t *link, snap_linkStats_t *stats);
+
+/**
+ * @}
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+	}
+#endif
+
+#endif	// SNAP_LINK_H_
+
+/******************************** END OF FILE *********************************/
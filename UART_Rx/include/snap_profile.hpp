@@ -0,0 +1,395 @@
+/*
+Copyright (c) 2026 libSNAP contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file   snap_profile.hpp
+ * @brief  Header-only C++ layer of the libSNAP library for links that use a single, fixed frame format.
+ * @details The frame format (DAB, SAB, PFB, EDM, NDB and CMD) is given as template parameters, so every field index,
+ *          the frame size and the hash function are resolved at compile time. The frames are identical to the ones
+ *          produced and accepted by snap.c, and the hash functions of snap.c are reused (including overrides).
+ *          It requires C++11 and works with avr-g++ (it does not use the C++ standard library).
+ *
+ * Example:
+ * @code
+ * typedef snap::Profile<SNAP_HDB2_DAB_1BYTE_DEST_ADDRESS, SNAP_HDB2_SAB_1BYTE_SOURCE_ADDRESS, SNAP_HDB2_PFB_1BYTE_PROTOCOL_FLAGS,
+ *                       SNAP_HDB1_EDM_16BIT_CRC, SNAP_HDB1_NDB_8BYTE_DATA> Link;
+ *
+ * uint8_t txBuffer[Link::frameSize];
+ * Link::encode(txBuffer, 0x12, 0x01, 0x00, payload, sizeof(payload));
+ *
+ * Link::Decoder rx;
+ * if(rx.decode(newByte) == SNAP_STATUS_VALID) { ... rx.getData() ... rx.reset(); }
+ * @endcode
+ */
+
+#ifndef SNAP_PROFILE_HPP_
+#define SNAP_PROFILE_HPP_
+
+/**
+ * @addtogroup libSNAP
+ * @{
+ */
+
+
+/******************************************************************************/
+/*  Public Includes                                                           */
+/******************************************************************************/
+
+
+#include <stdint.h>
+#include <string.h>
+#include "snap.h"
+
+
+/******************************************************************************/
+/*  Public Types                                                              */
+/******************************************************************************/
+
+
+namespace snap
+{
+
+/**
+ * @brief Compile-time helpers of the frame profiles. They are not supposed to be used directly.
+ */
+namespace detail
+{
+
+/**
+ * @brief Smallest unsigned integer type that stores a field of N bytes, so 8-bit cores do not handle 32-bit values needlessly.
+ */
+template<uint8_t N> struct UInt    { typedef uint32_t type; };
+template<>          struct UInt<0> { typedef uint8_t  type; };
+template<>          struct UInt<1> { typedef uint8_t  type; };
+template<>          struct UInt<2> { typedef uint16_t type; };
+
+/**
+ * @brief Store and load big-endian (MSB first) fields of N bytes, unrolled at compile time.
+ */
+template<uint8_t N> struct BigEndian
+{
+	template<typename T> static inline void store(uint8_t *bytes, const T value)
+	{
+		bytes[0] = (uint8_t)(value >> ((N - 1) * 8));
+		BigEndian<N - 1>::store(bytes + 1, value);
+	}
+
+	template<typename T> static inline T load(const uint8_t *bytes)
+	{
+		return (T)(((T)bytes[0] << ((N - 1) * 8)) | BigEndian<N - 1>::template load<T>(bytes + 1));
+	}
+};
+
+template<> struct BigEndian<0>
+{
+	template<typename T> static inline void store(uint8_t *, const T) {}
+	template<typename T> static inline T load(const uint8_t *) { return 0; }
+};
+
+/**
+ * @brief Hash function of each EDM value, with the same size and result as snap_calculateHash().
+ *        Methods without a hash value (no error detection, 3 times re-transmission and FEC) use the generic template.
+ *        The copies of the 3 times re-transmission and the FEC bytes are handled by the profile itself.
+ */
+template<uint8_t Edm> struct Hash
+{
+	static constexpr uint8_t size = 0;
+	static inline uint32_t calculate(const uint8_t *, uint16_t) { return 0; }
+};
+
+template<> struct Hash<SNAP_HDB1_EDM_8BIT_CHECKSUM>
+{
+	static constexpr uint8_t size = 1;
+	static inline uint32_t calculate(const uint8_t *data, const uint16_t length) { return snap_calculateChecksum8(data, length); }
+};
+
+template<> struct Hash<SNAP_HDB1_EDM_8BIT_CRC>
+{
+	static constexpr uint8_t size = 1;
+	static inline uint32_t calculate(const uint8_t *data, const uint16_t length) { return snap_calculateCrc8(data, length); }
+};
+
+template<> struct Hash<SNAP_HDB1_EDM_16BIT_CRC>
+{
+	static constexpr uint8_t size = 2;
+	static inline uint32_t calculate(const uint8_t *data, const uint16_t length) { return snap_calculateCrc16(data, length); }
+};
+
+template<> struct Hash<SNAP_HDB1_EDM_32BIT_CRC>
+{
+	static constexpr uint8_t size = 4;
+	static inline uint32_t calculate(const uint8_t *data, const uint16_t length) { return snap_calculateCrc32(data, length); }
+};
+
+template<> struct Hash<SNAP_HDB1_EDM_USER_SPECIFIED>
+{
+	static constexpr uint8_t size = SNAP_SIZE_USER_HASH;
+	static inline uint32_t calculate(const uint8_t *data, const uint16_t length) { return snap_calculateUserHash(data, length); }
+};
+
+/**
+ * @brief Reed-Solomon codewords of a frame body (HDB2 to the last data byte) of Size bytes, split like snap.c does:
+ *        the CRC-16 of the body follows it, then the body and the CRC are split into as few codewords as possible,
+ *        with balanced sizes and the parity bytes of each one stored in order after the CRC.
+ */
+template<uint16_t Size> struct Fec
+{
+	static constexpr uint16_t coded = (uint16_t)(Size + SNAP_SIZE_FEC_CHECK);										/**< @brief Number of bytes protected by the codewords. */
+	static constexpr uint8_t  count = (uint8_t)((coded + SNAP_SIZE_FEC_MESSAGE - 1) / SNAP_SIZE_FEC_MESSAGE);	/**< @brief Number of codewords. */
+	static constexpr uint16_t size  = (uint16_t)(SNAP_SIZE_FEC_CHECK + count * SNAP_SIZE_FEC_PARITY);			/**< @brief Number of CRC and parity bytes. */
+
+	static inline uint16_t messageSize(const uint8_t i) { return (uint16_t)(coded / count + ((i < coded % count) ? 1 : 0)); }
+
+	static void encode(uint8_t *body)
+	{
+		const uint16_t crc = snap_calculateCrc16(body, Size);
+		uint8_t *parity = &body[coded];
+
+		body[Size] = (uint8_t)(crc >> 8);
+		body[Size + 1] = (uint8_t)(crc & 0xFF);
+
+		for(uint8_t i = 0; i < count; i++)
+		{
+			snap_calculateFecParity(body, messageSize(i), &parity[i * SNAP_SIZE_FEC_PARITY]);
+			body += messageSize(i);
+		}
+	}
+
+	static bool correct(uint8_t *body)
+	{
+		uint8_t *message = body;
+		uint8_t *parity = &body[coded];
+
+		for(uint8_t i = 0; i < count; i++)
+		{
+			if(snap_correctFecErrors(message, messageSize(i), &parity[i * SNAP_SIZE_FEC_PARITY]) < 0)
+			{
+				return false;
+			}
+
+			message += messageSize(i);
+		}
+
+		return BigEndian<SNAP_SIZE_FEC_CHECK>::template load<uint16_t>(&body[Size]) == snap_calculateCrc16(body, Size);
+	}
+};
+
+/**
+ * @brief Compile-time version of snap_getDataSizeFromNdb().
+ */
+constexpr uint16_t dataSizeFromNdb(const uint8_t ndb)
+{
+	return (uint16_t)((ndb <= 8) ? ndb : (ndb <= 14) ? (0x01U << (ndb - 5)) : 0U);
+}
+
+}	// namespace detail
+
+/**
+ * @brief Fixed frame format of a link, with an encoder and a decoder specialized for it.
+ * @tparam Dab DAB value (#snap_hdb2_dab_t).
+ * @tparam Sab SAB value (#snap_hdb2_sab_t).
+ * @tparam Pfb PFB value (#snap_hdb2_pfb_t).
+ * @tparam Edm EDM value (#snap_hdb1_edm_t).
+ * @tparam Ndb NDB value (#snap_hdb1_ndb_t).
+ * @tparam Cmd CMD value (#snap_hdb1_cmd_t).
+ */
+template<uint8_t Dab, uint8_t Sab, uint8_t Pfb, uint8_t Edm, uint8_t Ndb, uint8_t Cmd = SNAP_HDB1_CMD_MODE_DISABLED>
+class Profile
+{
+	static_assert((Dab <= SNAP_HDB2_DAB_MASK) && (Sab <= SNAP_HDB2_SAB_MASK) && (Pfb <= SNAP_HDB2_PFB_MASK), "Invalid DAB, SAB or PFB value");
+	static_assert((Edm <= SNAP_HDB1_EDM_MASK) && (Cmd <= SNAP_HDB1_CMD_MASK), "Invalid EDM or CMD value");
+	static_assert(Ndb < SNAP_HDB1_NDB_USER_SPECIFIED, "Invalid NDB value");
+
+	typedef detail::Hash<Edm> Hash;
+	typedef detail::Fec<(uint16_t)(SNAP_INDEX_DAB + Dab + Sab + Pfb + detail::dataSizeFromNdb(Ndb) - SNAP_INDEX_HDB2)> Fec;
+
+public:
+	typedef typename detail::UInt<Dab>::type DestAddress;	/**< @brief Type of the destination address. */
+	typedef typename detail::UInt<Sab>::type SourceAddress;	/**< @brief Type of the source address. */
+	typedef typename detail::UInt<Pfb>::type ProtocolFlags;	/**< @brief Type of the protocol flags. */
+
+	static constexpr uint8_t  hdb2        = (uint8_t)((Dab << SNAP_HDB2_DAB_POS) | (Sab << SNAP_HDB2_SAB_POS) | (Pfb << SNAP_HDB2_PFB_POS));	/**< @brief HDB2 byte (without the ACK bits). */
+	static constexpr uint8_t  hdb1        = (uint8_t)((Cmd << SNAP_HDB1_CMD_POS) | (Edm << SNAP_HDB1_EDM_POS) | (Ndb << SNAP_HDB1_NDB_POS));	/**< @brief HDB1 byte. */
+	static constexpr uint8_t  sourceIndex = (uint8_t)(SNAP_INDEX_DAB + Dab);		/**< @brief Index of the first (MSB) source address byte. */
+	static constexpr uint8_t  flagsIndex  = (uint8_t)(sourceIndex + Sab);			/**< @brief Index of the first (MSB) protocol flags byte. */
+	static constexpr uint8_t  dataIndex   = (uint8_t)(flagsIndex + Pfb);			/**< @brief Index of the first data byte. */
+	static constexpr uint16_t dataSize    = detail::dataSizeFromNdb(Ndb);			/**< @brief Size of the data field (payload). */
+	static constexpr uint16_t hashIndex   = (uint16_t)(dataIndex + dataSize);		/**< @brief Index of the first (MSB) hash byte. */
+	static constexpr uint16_t hashSize    = (Edm == SNAP_HDB1_EDM_FEC) ? Fec::size : Hash::size;	/**< @brief Size of the hash field (or of the FEC bytes). */
+	static constexpr uint16_t copySize    = (uint16_t)(hashIndex + hashSize);		/**< @brief Size of a single copy of the frame. */
+	static constexpr uint8_t  copies      = (Edm == SNAP_HDB1_EDM_3_RETRANSMISSION) ? 3 : 1;	/**< @brief Number of times the frame is repeated. */
+	static constexpr uint16_t frameSize   = (uint16_t)(copySize * copies);		/**< @brief Size of every frame of this profile (including the repeated copies). */
+
+	/**
+	 * @brief Encapsulate a new frame into the buffer.
+	 * @details The frame is the same as the one built by snap_encapsulate() with the padding bytes after the data.
+	 * @param[out] buffer   Pointer to the array that will store the frame. It must have at least #frameSize bytes.
+	 * @param[in]  dest     Destination address.
+	 * @param[in]  source   Source address.
+	 * @param[in]  flags    Protocol flags.
+	 * @param[in]  data     Pointer to the data. It must not overlap the buffer.
+	 * @param[in]  size     Number of data bytes. It must not be greater than #dataSize.
+	 * @param[in]  ack      ACK bits (#snap_hdb2_ack_t).
+	 */
+	static void encode(uint8_t *buffer, const DestAddress dest, const SourceAddress source, const ProtocolFlags flags,
+	                   const uint8_t *data, const uint16_t size, const uint8_t ack = SNAP_HDB2_ACK_NOT_REQUESTED)
+	{
+		buffer[SNAP_INDEX_SYNC] = SNAP_SYNC;
+		buffer[SNAP_INDEX_HDB2] = (uint8_t)(hdb2 | (ack & SNAP_HDB2_ACK_MASK));
+		buffer[SNAP_INDEX_HDB1] = hdb1;
+
+		detail::BigEndian<Dab>::store(&buffer[SNAP_INDEX_DAB], dest);
+		detail::BigEndian<Sab>::store(&buffer[sourceIndex], source);
+		detail::BigEndian<Pfb>::store(&buffer[flagsIndex], flags);
+
+		memcpy(&buffer[dataIndex], data, size);
+		memset(&buffer[dataIndex + size], SNAP_PADDING, (uint16_t)(dataSize - size));
+
+		if(Edm == SNAP_HDB1_EDM_FEC)
+		{
+			Fec::encode(&buffer[SNAP_INDEX_HDB2]);
+		}
+		else
+		{
+			detail::BigEndian<Hash::size>::store(&buffer[hashIndex], Hash::calculate(&buffer[SNAP_INDEX_HDB2], hashIndex - SNAP_INDEX_HDB2));
+		}
+
+		for(uint8_t i = 1; i < copies; i++)
+		{
+			memcpy(&buffer[i * copySize], buffer, copySize);
+		}
+	}
+
+	/**
+	 * @brief Decoder of the frames of this profile, with a buffer of exactly #frameSize bytes.
+	 * @details It works like snap_decode(), with the same frame status values. A frame whose header does not match the profile
+	 *          (apart from the ACK bits) is discarded as soon as the header is received, and the decoder searches for the next
+	 *          sync byte. The hash value is checked (or the copies are voted, or the FEC codewords are corrected, like snap.c does)
+	 *          when the last byte is received.
+	 */
+	class Decoder
+	{
+	public:
+		Decoder() : size(0), status(SNAP_STATUS_IDLE) {}
+
+		/**
+		 * @brief Reset the frame size and status, prior to decoding a new frame.
+		 */
+		void reset()
+		{
+			size = 0;
+			status = SNAP_STATUS_IDLE;
+		}
+
+		/**
+		 * @brief Decode one more byte.
+		 * @param[in] newByte Byte to be decoded.
+		 * @return Frame status after the process. It can be any value from #snap_status_t.
+		 */
+		int8_t decode(const uint8_t newByte)
+		{
+			switch(status)
+			{
+				case SNAP_STATUS_IDLE:
+					if(newByte == SNAP_SYNC)
+					{
+						buffer[SNAP_INDEX_SYNC] = newByte;
+						size = 1;
+						status = SNAP_STATUS_INCOMPLETE;
+					}
+					return status;
+
+				case SNAP_STATUS_INCOMPLETE:
+					buffer[size++] = newByte;
+					if((size == SNAP_MIN_SIZE_FRAME) && !isProfileHeader())
+					{
+						reset();	// Frame format of another profile
+						return status;
+					}
+					if(size == frameSize)
+					{
+						status = isFrameValid() ? SNAP_STATUS_VALID : SNAP_STATUS_ERROR_HASH;
+					}
+					return status;
+
+				default:	// Valid frame or error
+					return status;
+			}
+		}
+
+		DestAddress   getDestAddress() const   { return detail::BigEndian<Dab>::template load<DestAddress>(&buffer[SNAP_INDEX_DAB]); }	/**< @brief Get the destination address. */
+		SourceAddress getSourceAddress() const { return detail::BigEndian<Sab>::template load<SourceAddress>(&buffer[sourceIndex]); }	/**< @brief Get the source address. */
+		ProtocolFlags getProtocolFlags() const { return detail::BigEndian<Pfb>::template load<ProtocolFlags>(&buffer[flagsIndex]); }	/**< @brief Get the protocol flags. */
+		uint8_t       getAck() const           { return (uint8_t)SNAP_HDB2_ACK(buffer); }			/**< @brief Get the ACK bits (#snap_hdb2_ack_t). */
+		const uint8_t *getData() const         { return &buffer[dataIndex]; }					/**< @brief Get the pointer to the first data byte (#dataSize bytes, including padding). */
+		const uint8_t *getBuffer() const       { return buffer; }								/**< @brief Get the pointer to the first byte of the frame. */
+		uint16_t      getSize() const          { return size; }									/**< @brief Get the current size of the frame (it may be incomplete). */
+		int8_t        getStatus() const        { return status; }								/**< @brief Get the frame status (it can be any value from #snap_status_t). */
+
+	private:
+		bool isProfileHeader() const
+		{
+			return ((buffer[SNAP_INDEX_HDB2] & (uint8_t)~(SNAP_HDB2_ACK_MASK << SNAP_HDB2_ACK_POS)) == hdb2) && (buffer[SNAP_INDEX_HDB1] == hdb1);
+		}
+
+		bool isFrameValid()
+		{
+			if(Edm == SNAP_HDB1_EDM_FEC)
+			{
+				return Fec::correct(&buffer[SNAP_INDEX_HDB2]) && isProfileHeader();
+			}
+
+			if(copies == 1)
+			{
+				return detail::BigEndian<Hash::size>::template load<uint32_t>(&buffer[hashIndex]) ==
+				       Hash::calculate(&buffer[SNAP_INDEX_HDB2], hashIndex - SNAP_INDEX_HDB2);
+			}
+
+			for(uint16_t i = 0; i < copySize; i++)	// Bitwise majority vote
+			{
+				const uint8_t a = buffer[i], b = buffer[i + copySize], c = buffer[i + 2 * copySize];
+				buffer[i] = (uint8_t)((a & b) | (a & c) | (b & c));
+			}
+
+			for(uint8_t i = 1; i < copies; i++)
+			{
+				memcpy(&buffer[i * copySize], buffer, copySize);
+			}
+
+			return (buffer[SNAP_INDEX_SYNC] == SNAP_SYNC) && isProfileHeader();
+		}
+
+		uint8_t  buffer[frameSize];	/**< @brief Bytes of the frame. */
+		uint16_t size;				/**< @brief Current size of the frame (it may be incomplete). */
+		int8_t   status;			/**< @brief Status of the frame. It can assume any value from #snap_status_t. */
+	};
+};
+
+}	// namespace snap
+
+/**
+ * @}
+ */
+
+#endif	// SNAP_PROFILE_HPP_
+
+/******************************** END OF FILE *********************************/
@@ -0,0 +1,310 @@
+/*
+Copyright (c) 2026 libSNAP contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file   snap_command.c
+ * @brief  Source file of the command dispatcher of the libSNAP library. Refer to the library documentation for details.
+ */
+
+/**
+ * @addtogroup libSNAP
+ * @{
+ */
+
+
+/******************************************************************************/
+/*  Private Includes                                                          */
+/******************************************************************************/
+
+
+#include <stddef.h>
+#include <string.h>
+#include "snap_command.h"
+#include "snap_arq.h"
+
+
+/******************************************************************************/
+/*  Private Macros                                                            */
+/******************************************************************************/
+
+
+#ifdef __AVR__
+	#define SNAP_CMD_READ_HANDLER(pHandler)	((snap_commandHandler_t)pgm_read_ptr(pHandler))	// Read a handler from program memory
+#else
+	#define SNAP_CMD_READ_HANDLER(pHandler)	(*(pHandler))
+#endif
+
+
+/******************************************************************************/
+/*  Private Function Definitions                                              */
+/******************************************************************************/
+
+
+/**
+ * @defgroup pfd Private Functions
+ * @brief Functions visible only to the library source file.
+ * @{
+ */
+
+/**
+ * @brief Get the largest number of bytes of the data length field and data that fit in a frame, for a given data length field size.
+ * @details Every byte of the copy of the frame that is not the sync byte, header, addresses, flags or hash value is available.
+ *          FEC frames (#SNAP_HDB1_EDM_FEC) are checked for every codeword count, since each codeword protects a limited number of bytes.
+ * @param[in] frame      Pointer to the frame structure.
+ * @param[in] fields     Pointer to the structure that contains the frame format.
+ * @param[in] lengthSize Size of the data length field (1 or 2 bytes).
+ * @return Number of data bytes (it may be negative if the frame does not fit).
+ */
+static int_fast32_t snap_getLargestDataSize(const snap_frame_t *frame, const snap_fields_t *fields, const uint_fast8_t lengthSize)
+{
+	const uint_fast8_t edm = fields->header.edm;
+	const int_fast32_t headSize = (int_fast32_t)(SNAP_INDEX_DAB + fields->header.dab + fields->header.sab + fields->header.pfb + lengthSize);
+	const int_fast32_t space = (int_fast32_t)(frame->maxSize / ((edm == SNAP_HDB1_EDM_3_RETRANSMISSION) ? 3U : 1U)) - headSize;
+
+	if(edm != SNAP_HDB1_EDM_FEC)
+	{
+		return space - snap_getHashSizeFromEdm(edm);
+	}
+
+	const uint_fast8_t depth = (frame->interleaving && (fields->header.pfb >= 2)) ? (uint_fast8_t)(1U << SNAP_FLAGS_DEPTH(fields->protocolFlags)) : 1;
+	const int_fast32_t share = (int_fast32_t)SNAP_SIZE_FEC_MESSAGE - ((depth > 1) ? (headSize - (int_fast32_t)SNAP_INDEX_HDB2) : 0);	// Interleaved: the first codeword also holds the bytes before the data
+	int_fast32_t largest = -1;
+
+	for(uint_fast8_t count = 1; count <= SNAP_MAX_FEC_CODEWORDS; count++)
+	{
+		const int_fast32_t fit = space - (int_fast32_t)(SNAP_SIZE_FEC_CHECK + count * SNAP_SIZE_FEC_PARITY);
+		int_fast32_t protect = (int_fast32_t)count * share - (int_fast32_t)SNAP_SIZE_FEC_CHECK;
+
+		if(depth == 1)
+		{
+			protect -= headSize - (int_fast32_t)SNAP_INDEX_HDB2;
+		}
+		else if(count < depth)
+		{
+			protect = (int_fast32_t)count - (int_fast32_t)SNAP_SIZE_FEC_CHECK;	// Fewer codewords than the depth only hold one data or CRC byte each
+		}
+
+		const int_fast32_t size = (fit < protect) ? fit : protect;
+
+		if(size > largest)
+		{
+			largest = size;
+		}
+	}
+
+	return largest;
+}
+
+/**
+ * @brief Reserve the largest payload that fits in the buffer of a frame, with an exact data size.
+ * @details The data size is calculated from the frame format: the buffer size minus the header, data length field and hash bytes.
+ * @param[in]     frame  Pointer to the frame structure.
+ * @param[in,out] fields Pointer to the structure that contains the frame format. The NDB, data size and data pointer are updated.
+ * @return Pointer to the first data byte in the frame buffer, or NULL if not even the opcode fits.
+ */
+static uint8_t *snap_reserveLargestPayload(const snap_frame_t *frame, snap_fields_t *fields)
+{
+	int_fast32_t size = snap_getLargestDataSize(frame, fields, 1);
+
+	if(size >= (int_fast32_t)SNAP_LENGTH_EXTENDED)	// Too large for a 1-byte data length field
+	{
+		const int_fast32_t extendedSize = snap_getLargestDataSize(frame, fields, 2);
+
+		size = (extendedSize >= (int_fast32_t)SNAP_LENGTH_EXTENDED) ? extendedSize : (int_fast32_t)(SNAP_LENGTH_EXTENDED - 1U);
+	}
+
+	if(size < (int_fast32_t)SNAP_CMD_SIZE_OPCODE)
+	{
+		return NULL;
+	}
+
+	fields->header.ndb = SNAP_HDB1_NDB_USER_SPECIFIED;
+	fields->dataSize = (uint16_t)((size > (int_fast32_t)SNAP_MAX_SIZE_DATA) ? SNAP_MAX_SIZE_DATA : size);
+
+	return snap_reservePayload(frame, fields);
+}
+
+/**
+ * @}
+ */
+
+
+/******************************************************************************/
+/*  Public Function Definitions                                               */
+/******************************************************************************/
+
+
+/**
+ * @addtogroup pf
+ * @{
+ */
+
+/**
+ * @brief Initialize the dispatcher structure with a table of handlers.
+ * @param[out] dispatcher Pointer to the dispatcher structure.
+ * @param[in]  handlers   Pointer to the table of handlers, indexed by opcode. On AVR targets, it must be declared with #SNAP_CMD_FLASH.
+ * @param[in]  count      Number of handlers in the table (up to #SNAP_CMD_MAX_OPCODE + 1). Larger values are limited to it.
+ * @param[in]  context    Pointer given to every handler (it can be NULL).
+ */
+void snap_initDispatcher(snap_dispatcher_t *dispatcher, const snap_commandHandler_t *handlers, const uint8_t count, void *context)
+{
+	dispatcher->handlers = handlers;
+	dispatcher->context = context;
+	dispatcher->count = (count > (SNAP_CMD_MAX_OPCODE + 1U)) ? (uint8_t)(SNAP_CMD_MAX_OPCODE + 1U) : count;
+}
+
+/**
+ * @brief Reserve the space of a command request in the frame buffer, so its arguments can be written in place before encapsulation.
+ * @details The CMD bit and the NDB (#SNAP_HDB1_NDB_USER_SPECIFIED) are set, and the opcode is written in the first data byte.
+ *          After writing the arguments, snap_encapsulate() builds the frame around them (see snap_reservePayload()).
+ * @param[in]     frame   Pointer to the frame structure.
+ * @param[in,out] fields  Pointer to the structure that contains the frame format (DAB, SAB, PFB, ACK and EDM, see snap_encapsulate()).
+ *                        The CMD, NDB, data size and data pointer are updated.
+ * @param[in]     opcode  Opcode of the command (up to #SNAP_CMD_MAX_OPCODE).
+ * @param[in]     argSize Number of arguments bytes (up to #SNAP_MAX_SIZE_DATA - 1).
+ * @return Pointer to the first argument byte in the frame buffer, or NULL if the opcode is invalid or the frame would not fit in the buffer.
+ */
+uint8_t *snap_reserveCommand(const snap_frame_t *frame, snap_fields_t *fields, const uint8_t opcode, const uint16_t argSize)
+{
+	if((opcode > SNAP_CMD_MAX_OPCODE) || (argSize > (SNAP_MAX_SIZE_DATA - SNAP_CMD_SIZE_OPCODE)))
+	{
+		return NULL;
+	}
+
+	fields->header.cmd = SNAP_HDB1_CMD_MODE_ENABLED;
+	fields->header.ndb = SNAP_HDB1_NDB_USER_SPECIFIED;
+	fields->dataSize = (uint16_t)(SNAP_CMD_SIZE_OPCODE + argSize);
+
+	uint8_t *data = snap_reservePayload(frame, fields);
+
+	if(data == NULL)
+	{
+		return NULL;
+	}
+
+	data[0] = opcode;
+
+	return &data[SNAP_CMD_SIZE_OPCODE];
+}
+
+/**
+ * @brief Check if a frame is a command request.
+ * @param[in] frame Pointer to the frame structure.
+ * @return true if the frame is valid, has the CMD bit set and starts with the opcode of a request, false otherwise.
+ */
+bool snap_isCommand(const snap_frame_t *frame)
+{
+	const uint8_t *data;
+
+	return (frame->status == SNAP_STATUS_VALID) && (SNAP_HDB1_CMD(frame->buffer) == SNAP_HDB1_CMD_MODE_ENABLED) &&
+		   (snap_getFieldPtr(frame, &data, SNAP_FIELD_DATA) > 0) && (data[0] <= SNAP_CMD_MAX_OPCODE);
+}
+
+/**
+ * @brief Execute a command request and encapsulate its response.
+ * @details The handler of the opcode is taken from the table in constant time. It reads the arguments from the frame received
+ *          and writes the result into the buffer of the response frame, so the two frames must not share the same buffer.
+ *          The command is executed even if the request does not ask for a response (#SNAP_HDB2_ACK_REQUESTED), but then no
+ *          response is built and the handler gets no result buffer (NULL, maximum size 0). Update the frame status and size of the response according to the result.
+ * @param[in]     dispatcher Pointer to the dispatcher structure.
+ * @param[in]     rxFrame    Pointer to the frame structure of the request. It must contain a valid frame.
+ * @param[in,out] txFrame    Pointer to the frame structure of the response.
+ * @param[in,out] fields     Pointer to the structure that contains the source address, DAB, SAB, PFB and EDM of the response.
+ *                           The destination address (if the request has a source address), CMD, ACK, NDB, protocol flags (sequence number),
+ *                           data size and data pointer are updated.
+ * @return Frame status of the response (value from #snap_status_t).
+ * @retval #SNAP_STATUS_VALID          Response created successfully (ACK or NACK). Frame size is updated to match the new frame.
+ * @retval #SNAP_STATUS_IDLE           The frame is not a command request, or it does not ask for a response. The response frame is not changed.
+ * @retval #SNAP_STATUS_ERROR_OVERFLOW Error: Response does not fit in the buffer. Frame size is changed to zero.
+ */
+int8_t snap_dispatchCommand(const snap_dispatcher_t *dispatcher, const snap_frame_t *rxFrame, snap_frame_t *txFrame, snap_fields_t *fields)
+{
+	if(!snap_isCommand(rxFrame))
+	{
+		return SNAP_STATUS_IDLE;
+	}
+
+	const uint8_t *request;
+	const uint16_t requestSize = (uint16_t)snap_getFieldPtr(rxFrame, &request, SNAP_FIELD_DATA);
+	const uint8_t opcode = request[0];
+	const snap_commandHandler_t handler = (opcode < dispatcher->count) ? SNAP_CMD_READ_HANDLER(&dispatcher->handlers[opcode]) : NULL;
+	const bool respond = (SNAP_HDB2_ACK(rxFrame->buffer) == SNAP_HDB2_ACK_REQUESTED);
+	uint8_t *response = NULL;
+	uint8_t seq;
+	uint32_t source;
+
+	if(respond)
+	{
+		if(snap_getField(rxFrame, &source, SNAP_FIELD_SOURCE_ADDRESS) > 0)
+		{
+			fields->destAddress = source;
+		}
+
+		if(snap_getSeq(rxFrame, &seq))
+		{
+			snap_setSeq(fields, seq);
+		}
+
+		fields->header.cmd = SNAP_HDB1_CMD_MODE_ENABLED;
+		response = snap_reserveLargestPayload(txFrame, fields);
+
+		if(response == NULL)
+		{
+			txFrame->size = 0;
+			txFrame->status = SNAP_STATUS_ERROR_OVERFLOW;
+			return txFrame->status;
+		}
+	}
+
+	uint8_t *result = respond ? &response[SNAP_CMD_SIZE_OPCODE] : NULL;	// No result for a command that does not ask for a response
+	const uint16_t maxResultSize = respond ? (uint16_t)(fields->dataSize - SNAP_CMD_SIZE_OPCODE) : 0U;
+	const int16_t resultSize = (handler != NULL) ? handler(&request[SNAP_CMD_SIZE_OPCODE], (uint16_t)(requestSize - SNAP_CMD_SIZE_OPCODE), result, maxResultSize, dispatcher->context) : -1;
+
+	if(!respond)
+	{
+		return SNAP_STATUS_IDLE;
+	}
+
+	const bool success = (resultSize >= 0) && ((uint16_t)resultSize <= maxResultSize);
+
+	response[0] = (uint8_t)(opcode | SNAP_CMD_RESPONSE);
+	fields->header.ack = success ? SNAP_HDB2_ACK_RESPONSE_ACK : SNAP_HDB2_ACK_RESPONSE_NACK;
+	fields->dataSize = (uint16_t)(SNAP_CMD_SIZE_OPCODE + (success ? (uint16_t)resultSize : 0U));
+	fields->data = snap_reservePayload(txFrame, fields);
+
+	if(fields->data != response)
+	{
+		memmove(fields->data, response, fields->dataSize);	// Shorter data length field (1 byte instead of 2)
+	}
+
+	return snap_encapsulate(txFrame, fields);
+}
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/******************************** END OF FILE *********************************/
@@ -0,0 +1,193 @@
+/*
+Copyright (c) 2026 libSNAP contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file   snap_command.h
+ * @brief  Header file of the command dispatcher of the libSNAP library.
+ * @details Frames with the CMD bit set (#SNAP_HDB1_CMD_MODE_ENABLED) are commands: the first data byte is the opcode
+ *          (0 to #SNAP_CMD_MAX_OPCODE) and the other ones are the arguments. Each opcode is the index of its handler in a dense
+ *          table, which can be kept in program memory (#SNAP_CMD_FLASH), so the dispatch takes constant time.
+ *
+ *          The handler reads the arguments straight from the frame received and writes its result straight into the buffer
+ *          of the response frame, so nothing is copied in between. The response also has the CMD bit set, its first data byte
+ *          is the opcode with #SNAP_CMD_RESPONSE set, and its ACK field tells if the command succeeded (#SNAP_HDB2_ACK_RESPONSE_ACK)
+ *          or not (#SNAP_HDB2_ACK_RESPONSE_NACK, unknown opcode or handler error). It echoes the sequence number of the request,
+ *          if there is one (see snap_setSeq()). Requests and responses have exact data sizes (#SNAP_HDB1_NDB_USER_SPECIFIED).
+ *
+ * Example:
+ * @code
+ * static int16_t readTemperature(const uint8_t *args, uint16_t argSize, uint8_t *result, uint16_t maxResultSize, void *context)
+ * {
+ *     if((argSize < 1) || (maxResultSize < 1)) return -1;
+ *     result[0] = adcRead(args[0]);
+ *     return 1;
+ * }
+ *
+ * static const snap_commandHandler_t handlers[] SNAP_CMD_FLASH = {ping, readTemperature, setLed};
+ * snap_initDispatcher(&dispatcher, handlers, 3, NULL);
+ *
+ * // Requester
+ * uint8_t *args = snap_reserveCommand(&txFrame, &fields, CMD_READ_TEMPERATURE, 1);
+ * args[0] = channel;
+ * snap_encapsulate(&txFrame, &fields);
+ *
+ * // Responder
+ * if(snap_decode(&rxFrame, newByte) == SNAP_STATUS_VALID)
+ * {
+ *     if(snap_dispatchCommand(&dispatcher, &rxFrame, &txFrame, &fields) == SNAP_STATUS_VALID) send(txFrame.buffer, txFrame.size);
+ *     snap_reset(&rxFrame);
+ * }
+ * @endcode
+ */
+
+#ifndef SNAP_COMMAND_H_
+#define SNAP_COMMAND_H_
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+/**
+ * @addtogroup libSNAP
+ * @{
+ */
+
+
+/******************************************************************************/
+/*  Public Includes                                                           */
+/******************************************************************************/
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#ifdef __AVR__
+	#include <avr/pgmspace.h>
+#endif
+#include "snap.h"
+
+
+/******************************************************************************/
+/*  Public Macros                                                             */
+/******************************************************************************/
+
+
+/**
+ * @addtogroup pm
+ * @{
+ * @name Command format
+ * @{
+ */
+
+#define SNAP_CMD_RESPONSE		(0x80U)	/**< @brief Bit set in the opcode of a response. */
+#define SNAP_CMD_MAX_OPCODE		(0x7FU)	/**< @brief Largest opcode of a request. */
+#define SNAP_CMD_SIZE_OPCODE	(1U)	/**< @brief Size of the opcode, at the beginning of the data. */
+
+/**
+ * @}
+ * @name Handler table location
+ * @{
+ */
+
+#ifdef __AVR__
+	#define SNAP_CMD_FLASH	PROGMEM	/**< @brief Attribute of a handler table kept in program memory. */
+#else
+	#define SNAP_CMD_FLASH			/**< @brief Attribute of a handler table kept in program memory (single address space). */
+#endif
+
+/**
+ * @}
+ * @}
+ */
+
+
+/******************************************************************************/
+/*  Public Types                                                              */
+/******************************************************************************/
+
+
+/**
+ * @addtogroup pt
+ * @{
+ */
+
+/**
+ * @brief Function that executes a command.
+ * @param[in]  args          Pointer to the arguments, inside the buffer of the frame received.
+ * @param[in]  argSize       Number of arguments bytes.
+ * @param[out] result        Pointer to the result, inside the buffer of the response frame (NULL if the request does not ask for a response).
+ * @param[in]  maxResultSize Maximum number of result bytes (limited by the buffer of the response frame, 0 if there is no response).
+ * @param[in]  context       Pointer given to snap_initDispatcher().
+ * @return Number of result bytes (up to maxResultSize), or a negative value if the command failed (NACK response without result).
+ */
+typedef int16_t (*snap_commandHandler_t)(const uint8_t *args, uint16_t argSize, uint8_t *result, uint16_t maxResultSize, void *context);
+
+/**
+ * @brief Structure that maps each opcode to its handler.
+ */
+typedef struct snap_dispatcher_t
+{
+	const snap_commandHandler_t *handlers;	/**< @brief Pointer to the table of handlers, indexed by opcode (it can be kept in program memory, see #SNAP_CMD_FLASH). NULL entries are unknown opcodes. */
+	void                        *context;	/**< @brief Pointer given to every handler. */
+	uint8_t                     count;		/**< @brief Number of handlers in the table. */
+} snap_dispatcher_t;
+
+/**
+ * @}
+ */
+
+
+/******************************************************************************/
+/*  Public Function Declarations                                              */
+/******************************************************************************/
+
+
+/**
+ * @addtogroup pf
+ * @{
+ * @name Command functions
+ * @{
+ */
+
+void snap_initDispatcher(snap_dispatcher_t *dispatcher, const snap_commandHandler_t *handlers, uint8_t count, void *context);
+
+uint8_t *snap_reserveCommand(const snap_frame_t *frame, snap_fields_t *fields, uint8_t opcode, uint16_t argSize);
+
+bool snap_isCommand(const snap_frame_t *frame);
+
+int8_t snap_dispatchCommand(const snap_dispatcher_t *dispatcher, const snap_frame_t *rxFrame, snap_frame_t *txFrame, snap_fields_t *fields);
+
+/**
+ * @}
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+	}
+#endif
+
+#endif	// SNAP_COMMAND_H_
+
+/******************************** END OF FILE *********************************/
@@ -0,0 +1,406 @@
+/*
+Copyright (c) 2026 libSNAP contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file   snap_compress.c
+ * @brief  Source file of the header compression layer of the libSNAP library. Refer to the library documentation for details.
+ */
+
+/**
+ * @addtogroup libSNAP
+ * @{
+ */
+
+
+/******************************************************************************/
+/*  Private Includes                                                          */
+/******************************************************************************/
+
+
+#include <stddef.h>
+#include <string.h>
+#include "snap_compress.h"
+
+
+/******************************************************************************/
+/*  Private Macros                                                            */
+/******************************************************************************/
+
+
+#define SNAP_COMP_HDB2_FORMAT	((SNAP_HDB2_DAB_MASK << SNAP_HDB2_DAB_POS) | (SNAP_HDB2_SAB_MASK << SNAP_HDB2_SAB_POS) | (SNAP_HDB2_PFB_MASK << SNAP_HDB2_PFB_POS))	// HDB2 bits stored in a context
+#define SNAP_COMP_SIZE_CHECK	(1U + 3U + 3U + 3U)	// Every context field covered by the check byte, with fixed sizes
+
+
+/******************************************************************************/
+/*  Private Function Definitions                                              */
+/******************************************************************************/
+
+
+/**
+ * @defgroup pfd Private Functions
+ * @brief Functions visible only to the library source file.
+ * @{
+ */
+
+/**
+ * @brief Write an integer in an array of bytes, MSB first.
+ * @param[out] bytes Pointer to the array.
+ * @param[in]  value Integer value.
+ * @param[in]  size  Number of bytes to write (up to 4).
+ */
+static void snap_writeInteger(uint8_t *bytes, const uint32_t value, const uint_fast8_t size)
+{
+	for(uint_fast8_t i = 0; i < size; i++)
+	{
+		bytes[i] = (uint8_t)(value >> (8U * (size - 1U - i)));
+	}
+}
+
+/**
+ * @brief Write the header of a flow in an array of bytes: HDB2, destination address, source address and protocol flags.
+ * @param[in]  context Pointer to the context of the flow.
+ * @param[out] bytes   Pointer to the array (up to #SNAP_COMP_MAX_HEADER bytes).
+ * @return Number of bytes written.
+ */
+static uint_fast8_t snap_writeFlowHeader(const snap_context_t *context, uint8_t *bytes)
+{
+	const uint_fast8_t destSize = (uint_fast8_t)SNAP_GET_BITS(context->hdb2, SNAP_HDB2_DAB_MASK, SNAP_HDB2_DAB_POS);
+	const uint_fast8_t sourceSize = (uint_fast8_t)SNAP_GET_BITS(context->hdb2, SNAP_HDB2_SAB_MASK, SNAP_HDB2_SAB_POS);
+	const uint_fast8_t flagsSize = (uint_fast8_t)SNAP_GET_BITS(context->hdb2, SNAP_HDB2_PFB_MASK, SNAP_HDB2_PFB_POS);
+
+	bytes[0] = context->hdb2;
+	snap_writeInteger(&bytes[1], context->destAddress, destSize);
+	snap_writeInteger(&bytes[1 + destSize], context->sourceAddress, sourceSize);
+	snap_writeInteger(&bytes[1 + destSize + sourceSize], context->protocolFlags, flagsSize);
+
+	return (uint_fast8_t)(1U + destSize + sourceSize + flagsSize);
+}
+
+/**
+ * @brief Read the header of a flow from an array of bytes (see snap_writeFlowHeader()).
+ * @param[out] context Pointer to the context of the flow.
+ * @param[in]  bytes   Pointer to the array.
+ * @param[in]  size    Number of bytes available in the array.
+ * @return Number of bytes read, or zero if the array is too short.
+ */
+static uint_fast8_t snap_readFlowHeader(snap_context_t *context, const uint8_t *bytes, const uint_fast16_t size)
+{
+	if(size == 0)
+	{
+		return 0;
+	}
+
+	const uint_fast8_t destSize = (uint_fast8_t)SNAP_GET_BITS(bytes[0], SNAP_HDB2_DAB_MASK, SNAP_HDB2_DAB_POS);
+	const uint_fast8_t sourceSize = (uint_fast8_t)SNAP_GET_BITS(bytes[0], SNAP_HDB2_SAB_MASK, SNAP_HDB2_SAB_POS);
+	const uint_fast8_t flagsSize = (uint_fast8_t)SNAP_GET_BITS(bytes[0], SNAP_HDB2_PFB_MASK, SNAP_HDB2_PFB_POS);
+	const uint_fast8_t headerSize = (uint_fast8_t)(1U + destSize + sourceSize + flagsSize);
+
+	if(size < headerSize)
+	{
+		return 0;
+	}
+
+	context->hdb2 = (uint8_t)(bytes[0] & SNAP_COMP_HDB2_FORMAT);
+	context->destAddress = snap_readInteger(&bytes[1], (uint8_t)destSize);
+	context->sourceAddress = snap_readInteger(&bytes[1 + destSize], (uint8_t)sourceSize);
+	context->protocolFlags = snap_readInteger(&bytes[1 + destSize + sourceSize], (uint8_t)flagsSize);
+
+	return headerSize;
+}
+
+/**
+ * @brief Calculate the check byte of a context, i.e. the CRC-8 of its format, addresses and protocol flags.
+ * @param[in] context Pointer to the context.
+ * @return Check byte.
+ */
+static uint8_t snap_getContextCheck(const snap_context_t *context)
+{
+	uint8_t bytes[SNAP_COMP_SIZE_CHECK];
+
+	bytes[0] = context->hdb2;
+	snap_writeInteger(&bytes[1], context->destAddress, 3);
+	snap_writeInteger(&bytes[4], context->sourceAddress, 3);
+	snap_writeInteger(&bytes[7], context->protocolFlags, 3);
+
+	return snap_calculateCrc8(bytes, sizeof(bytes));
+}
+
+/**
+ * @brief Keep only the bytes of an integer that fit in a field.
+ * @param[in] value Integer value.
+ * @param[in] size  Size of the field (up to 3 bytes).
+ * @return Truncated value.
+ */
+static inline uint32_t snap_truncateInteger(const uint32_t value, const uint_fast8_t size)
+{
+	return value & ((UINT32_C(1) << (8U * size)) - 1U);
+}
+
+/**
+ * @}
+ */
+
+
+/******************************************************************************/
+/*  Public Function Definitions                                               */
+/******************************************************************************/
+
+
+/**
+ * @addtogroup pf
+ * @{
+ */
+
+/**
+ * @brief Initialize a table of flow contexts. Every context is empty, so the first frame of each flow carries the full header.
+ * @param[out] contexts      Pointer to the table of contexts.
+ * @param[in]  refreshPeriod Number of compressed frames sent between full headers, which lets a receiver that lost a context
+ *                           recover without feedback (used only by the transmitter). Zero sends the full header only when the flow changes.
+ */
+void snap_initContexts(snap_contexts_t *contexts, const uint8_t refreshPeriod)
+{
+	memset(contexts->context, 0, sizeof(contexts->context));
+	contexts->refreshPeriod = refreshPeriod;
+}
+
+/**
+ * @brief Discard a flow context, e.g. when the receiver reports that it lost the context (NACK).
+ *        The next frame of the flow will carry the full header.
+ * @param[in,out] contexts  Pointer to the table of contexts.
+ * @param[in]     contextId Context id (less than #SNAP_MAX_CONTEXTS). Invalid ids are ignored.
+ */
+void snap_resetContext(snap_contexts_t *contexts, const uint8_t contextId)
+{
+	if(contextId < SNAP_MAX_CONTEXTS)
+	{
+		contexts->context[contextId].valid = false;
+	}
+}
+
+/**
+ * @brief Encapsulate a new frame with a compressed header (if there is enough space).
+ * @details The context is updated only if the frame is created. The full header is sent when the context is empty, when the frame
+ *          format or addresses differ from the context, or when the refresh period elapses. Otherwise, only the context id
+ *          and check byte are sent, plus the protocol flags if they changed. The frame always has a data length field.
+ *          Update the frame status and size according to the result.
+ * @param[in,out] frame     Pointer to the frame structure.
+ * @param[in]     fields    Pointer to the structure that contains every data needed to build the equivalent plain frame (see snap_encapsulate()).
+ *                          The NDB bits are ignored. The data must not overlap the frame buffer.
+ * @param[in,out] contexts  Pointer to the table of contexts of the transmitter.
+ * @param[in]     contextId Context id of the flow (less than #SNAP_MAX_CONTEXTS).
+ * @return Frame status after the process (value from #snap_status_t).
+ * @retval #SNAP_STATUS_VALID          Frame created successfully. Frame size is updated to match the new frame.
+ * @retval #SNAP_STATUS_ERROR_OVERFLOW Error: Invalid context id, or frame does not fit in the buffer. Buffer remains unchanged. Frame size is changed to zero.
+ */
+int8_t snap_encapsulateCompressed(snap_frame_t *frame, const snap_fields_t *fields, snap_contexts_t *contexts, const uint8_t contextId)
+{
+	if(contextId >= SNAP_MAX_CONTEXTS)
+	{
+		frame->size = 0;
+		frame->status = SNAP_STATUS_ERROR_OVERFLOW;
+		return frame->status;
+	}
+
+	snap_context_t *context = &contexts->context[contextId];
+	snap_context_t next;
+
+	next.hdb2 = (uint8_t)((fields->header.dab << SNAP_HDB2_DAB_POS) | (fields->header.sab << SNAP_HDB2_SAB_POS) | (fields->header.pfb << SNAP_HDB2_PFB_POS));
+	next.destAddress = snap_truncateInteger(fields->destAddress, fields->header.dab);
+	next.sourceAddress = snap_truncateInteger(fields->sourceAddress, fields->header.sab);
+	next.protocolFlags = snap_truncateInteger(fields->protocolFlags, fields->header.pfb);
+	next.check = snap_getContextCheck(&next);
+	next.valid = true;
+
+	const bool full = !context->valid || (context->hdb2 != next.hdb2) ||
+					  (context->destAddress != next.destAddress) || (context->sourceAddress != next.sourceAddress) ||
+					  ((contexts->refreshPeriod != 0) && (context->frameCount >= contexts->refreshPeriod));
+	const bool newFlags = !full && (context->protocolFlags != next.protocolFlags);
+
+	uint8_t header[SNAP_COMP_MAX_HEADER];
+	uint_fast8_t control = SNAP_COMP_MARKER | (uint_fast8_t)(contextId << SNAP_COMP_ID_POS);
+
+	if(fields->header.pfb >= SNAP_HDB2_PFB_2BYTE_PROTOCOL_FLAGS)
+	{
+		control |= SNAP_FLAGS_DEPTH(next.protocolFlags);	// Same bits of the plain flags
+	}
+
+	snap_chunk_t chunks[2] = {{header, 0, false}, {fields->data, (fields->data != NULL) ? fields->dataSize : 0, false}};
+
+	if(full)
+	{
+		control |= SNAP_COMP_FULL;
+		chunks[0].size = snap_writeFlowHeader(&next, header);
+		next.frameCount = 0;
+	}
+	else
+	{
+		if(newFlags)
+		{
+			control |= SNAP_COMP_FLAGS;
+			chunks[0].size = fields->header.pfb;
+			snap_writeInteger(header, next.protocolFlags, fields->header.pfb);
+		}
+
+		next.frameCount = (uint8_t)(context->frameCount + 1U);
+	}
+
+	snap_fields_t compressed = *fields;
+
+	compressed.header.dab = SNAP_HDB2_DAB_NO_DEST_ADDRESS;
+	compressed.header.sab = SNAP_HDB2_SAB_NO_SOURCE_ADDRESS;
+	compressed.header.pfb = SNAP_HDB2_PFB_2BYTE_PROTOCOL_FLAGS;
+	compressed.header.ndb = SNAP_HDB1_NDB_USER_SPECIFIED;
+	compressed.protocolFlags = ((uint32_t)control << 8) | next.check;
+
+	if(snap_encapsulateChunks(frame, &compressed, chunks, 2) == SNAP_STATUS_VALID)
+	{
+		*context = next;
+	}
+
+	return frame->status;
+}
+
+/**
+ * @brief Check if a frame has a compressed header (see snap_encapsulateCompressed()).
+ * @param[in] frame Pointer to the frame structure.
+ * @return true if the frame format is the one reserved for compressed frames and the marker bit is set, false otherwise.
+ */
+bool snap_isCompressed(const snap_frame_t *frame)
+{
+	return (frame->size >= SNAP_MIN_SIZE_FRAME) &&
+		   (SNAP_HDB2_DAB(frame->buffer) == SNAP_HDB2_DAB_NO_DEST_ADDRESS) &&
+		   (SNAP_HDB2_SAB(frame->buffer) == SNAP_HDB2_SAB_NO_SOURCE_ADDRESS) &&
+		   (SNAP_HDB2_PFB(frame->buffer) == SNAP_HDB2_PFB_2BYTE_PROTOCOL_FLAGS) &&
+		   (frame->size > frame->layout.flagsIndex) &&
+		   (frame->buffer[frame->layout.flagsIndex] & SNAP_COMP_MARKER);
+}
+
+/**
+ * @brief Restore the plain frame of a valid frame with a compressed header, in place.
+ * @details The frame is rebuilt with the format, addresses and protocol flags of its flow, a data length field, and a new hash value
+ *          (without interleaving nor scrambling), so it can be handled like any other frame. Frames that are not compressed are not changed.
+ *          Frames of unknown flows are discarded (e.g. they belong to other nodes), and so are full headers addressed to other nodes
+ *          according to the address filter (see snap_setAddressFilter()), since the decoder cannot filter compressed frames.
+ *          It must be called as soon as the frame is valid, before decoding other bytes with snap_decodeStream().
+ * @param[in,out] frame    Pointer to the frame structure.
+ * @param[in,out] contexts Pointer to the table of contexts of the receiver.
+ * @return Frame status after the process (value from #snap_status_t).
+ * @retval #SNAP_STATUS_VALID          Frame is a plain frame (restored or not compressed).
+ * @retval #SNAP_STATUS_IDLE           Frame belongs to an unknown flow or to another node. It is discarded (frame size is changed to zero).
+ * @retval #SNAP_STATUS_ERROR_HASH     Error: The check byte does not match the context, i.e. a context update was lost. The context remains unchanged.
+ * @retval #SNAP_STATUS_ERROR_OVERFLOW Error: The plain frame does not fit in the buffer. The context remains unchanged.
+ * @retval Other                       Frame status, if it is not valid. The frame is not changed.
+ */
+int8_t snap_decompress(snap_frame_t *frame, snap_contexts_t *contexts)
+{
+	if((frame->status != SNAP_STATUS_VALID) || !snap_isCompressed(frame))
+	{
+		return frame->status;
+	}
+
+	const uint8_t *data = NULL;
+	const int16_t dataSize = snap_getFieldPtr(frame, &data, SNAP_FIELD_DATA);
+	const uint_fast16_t size = (dataSize > 0) ? (uint_fast16_t)dataSize : 0;
+	const uint_fast8_t control = frame->buffer[frame->layout.flagsIndex];
+	const uint_fast8_t contextId = (control >> SNAP_COMP_ID_POS) & SNAP_COMP_ID_MASK;
+	uint_fast16_t headerSize = 0;
+	snap_context_t next = {0};
+
+	if(contextId < SNAP_MAX_CONTEXTS)
+	{
+		next = contexts->context[contextId];
+	}
+
+	if(control & SNAP_COMP_FULL)
+	{
+		headerSize = snap_readFlowHeader(&next, data, size);
+		next.valid = (headerSize != 0) && (contextId < SNAP_MAX_CONTEXTS) && snap_isDestAccepted(frame, next.destAddress);
+	}
+	else if(next.valid && (control & SNAP_COMP_FLAGS))
+	{
+		headerSize = SNAP_GET_BITS(next.hdb2, SNAP_HDB2_PFB_MASK, SNAP_HDB2_PFB_POS);
+		next.valid = (size >= headerSize);
+		next.protocolFlags = snap_readInteger(data, (uint8_t)headerSize);
+	}
+
+	if(!next.valid)
+	{
+		snap_reset(frame);
+		return frame->status;
+	}
+
+	next.check = frame->buffer[frame->layout.flagsIndex + 1U];
+
+	if(snap_getContextCheck(&next) != next.check)
+	{
+		frame->status = SNAP_STATUS_ERROR_HASH;
+		return frame->status;
+	}
+
+	snap_fields_t fields;
+	const bool interleaving = frame->interleaving;
+	const bool scrambling = frame->scrambling;
+
+	snap_getField(frame, &fields.header, SNAP_FIELD_HEADER);
+	fields.header.dab = SNAP_GET_BITS(next.hdb2, SNAP_HDB2_DAB_MASK, SNAP_HDB2_DAB_POS);
+	fields.header.sab = SNAP_GET_BITS(next.hdb2, SNAP_HDB2_SAB_MASK, SNAP_HDB2_SAB_POS);
+	fields.header.pfb = SNAP_GET_BITS(next.hdb2, SNAP_HDB2_PFB_MASK, SNAP_HDB2_PFB_POS);
+	fields.header.ndb = SNAP_HDB1_NDB_USER_SPECIFIED;
+	fields.destAddress = next.destAddress;
+	fields.sourceAddress = next.sourceAddress;
+	fields.protocolFlags = next.protocolFlags;
+	fields.dataSize = (uint16_t)(size - headerSize);
+	fields.paddingAfter = true;
+
+	uint8_t *payload = snap_reservePayload(frame, &fields);
+
+	if(payload == NULL)
+	{
+		frame->status = SNAP_STATUS_ERROR_OVERFLOW;
+		return frame->status;
+	}
+
+	if(fields.dataSize != 0)
+	{
+		memmove(payload, &data[headerSize], fields.dataSize);	// The data may move in both directions
+	}
+
+	frame->interleaving = false;	// Keep the restored frame readable
+	frame->scrambling = false;
+	snap_encapsulate(frame, &fields);
+	frame->interleaving = interleaving;
+	frame->scrambling = scrambling;
+
+	contexts->context[contextId] = next;
+
+	return frame->status;
+}
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/******************************** END OF FILE *********************************/
@@ -0,0 +1,516 @@
+/*
+Copyright (c) 2026 libSNAP contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file   snap_fragment.c
+ * @brief  Source file of the fragmentation layer of the libSNAP library. Refer to the library documentation for details.
+ */
+
+/**
+ * @addtogroup libSNAP
+ * @{
+ */
+
+
+/******************************************************************************/
+/*  Private Includes                                                          */
+/******************************************************************************/
+
+
+#include <stddef.h>
+#include <string.h>
+#include "snap_fragment.h"
+
+
+/******************************************************************************/
+/*  Private Macros                                                            */
+/******************************************************************************/
+
+
+#define SNAP_FLAGS_FRAG_BITS	(((uint32_t)SNAP_FLAGS_FRAG_INDEX_MASK << SNAP_FLAGS_FRAG_INDEX_POS) | \
+								 ((uint32_t)SNAP_FLAGS_FRAG_LAST_MASK << SNAP_FLAGS_FRAG_LAST_POS))	// Fragment position bits of the protocol flags (the message id is set by the user)
+
+
+/******************************************************************************/
+/*  Private Function Definitions                                              */
+/******************************************************************************/
+
+
+/**
+ * @defgroup pfd Private Functions
+ * @brief Functions visible only to the library source file.
+ * @{
+ */
+
+/**
+ * @brief Set the protocol flags and the frame format used by every fragmentation frame (3 flag bytes and exact data length).
+ *        The protocol flag bits not used by the fragmentation layer are kept.
+ * @param[in,out] fields Pointer to the structure that contains the frame fields.
+ * @param[in]     index  Fragment index.
+ * @param[in]     last   Index of the last fragment.
+ */
+static void snap_setFragmentFields(snap_fields_t *fields, const uint_fast8_t index, const uint_fast8_t last)
+{
+	fields->header.pfb = SNAP_HDB2_PFB_3BYTE_PROTOCOL_FLAGS;
+	fields->header.ndb = SNAP_HDB1_NDB_USER_SPECIFIED;
+
+	fields->protocolFlags = (fields->protocolFlags & ~SNAP_FLAGS_FRAG_BITS) |
+							((uint32_t)index << SNAP_FLAGS_FRAG_INDEX_POS) |
+							((uint32_t)last << SNAP_FLAGS_FRAG_LAST_POS);
+}
+
+/**
+ * @brief Start the reassembly of a new message, discarding the fragments of the previous one.
+ * @param[in,out] reassembly    Pointer to the reassembly structure.
+ * @param[in]     sourceAddress Source address of the new message.
+ * @param[in]     last          Index of the last fragment of the new message.
+ * @param[in]     id            Message id of the new message.
+ */
+static void snap_startMessage(snap_reassembly_t *reassembly, const uint32_t sourceAddress, const uint_fast8_t last, const uint_fast8_t id)
+{
+	memset(reassembly->received, 0, sizeof(reassembly->received));
+
+	reassembly->size = 0;
+	reassembly->fragmentSize = 0;
+	reassembly->lastSize = 0;
+	reassembly->sourceAddress = sourceAddress;
+	reassembly->missingCount = (uint8_t)(last + 1);
+	reassembly->lastIndex = (uint8_t)last;
+	reassembly->messageId = (uint8_t)id;
+	reassembly->started = true;
+}
+
+/**
+ * @brief Learn the fragment size of the message from a fragment that is not the last one.
+ *        If the last fragment was received before, it is moved from the end of the buffer to its actual position.
+ * @param[in,out] reassembly   Pointer to the reassembly structure.
+ * @param[in]     fragmentSize Size of the fragment.
+ * @retval 0                        Fragment size is valid.
+ * @retval #SNAP_ERROR_FRAME_FORMAT Error: The last fragment received is larger than the other fragments.
+ * @retval #SNAP_ERROR_SHORT_BUFFER Error: The message does not fit in the buffer.
+ */
+static int16_t snap_setFragmentSize(snap_reassembly_t *reassembly, const uint_fast16_t fragmentSize)
+{
+	const uint_fast32_t lastOffset = (uint_fast32_t)reassembly->lastIndex * fragmentSize;
+
+	if(reassembly->lastSize > fragmentSize)
+	{
+		return SNAP_ERROR_FRAME_FORMAT;
+	}
+
+	if((lastOffset + (reassembly->lastSize ? reassembly->lastSize : 1U)) > reassembly->maxSize)
+	{
+		return SNAP_ERROR_SHORT_BUFFER;
+	}
+
+	if(reassembly->lastSize != 0)
+	{
+		memmove(&reassembly->buffer[lastOffset], &reassembly->buffer[reassembly->maxSize - reassembly->lastSize], reassembly->lastSize);	// Destination is never after the source
+	}
+
+	reassembly->fragmentSize = (uint16_t)fragmentSize;
+
+	return 0;
+}
+
+/**
+ * @brief Store the last fragment of the message. If the fragment size is still unknown, it is kept at the end of the buffer.
+ * @param[in,out] reassembly Pointer to the reassembly structure.
+ * @param[in]     data       Pointer to the fragment data.
+ * @param[in]     size       Size of the fragment.
+ * @retval 0                        Fragment stored successfully.
+ * @retval #SNAP_ERROR_FRAME_FORMAT Error: The fragment is larger than the other fragments.
+ * @retval #SNAP_ERROR_SHORT_BUFFER Error: The message does not fit in the buffer.
+ */
+static int16_t snap_storeLastFragment(snap_reassembly_t *reassembly, const uint8_t *data, const uint_fast16_t size)
+{
+	uint_fast32_t offset;
+
+	if((reassembly->fragmentSize != 0) || (reassembly->lastIndex == 0))
+	{
+		if((size > reassembly->fragmentSize) && (reassembly->lastIndex != 0))
+		{
+			return SNAP_ERROR_FRAME_FORMAT;
+		}
+
+		offset = (uint_fast32_t)reassembly->lastIndex * reassembly->fragmentSize;
+	}
+	else
+	{
+		offset = (size <= reassembly->maxSize) ? (uint_fast32_t)(reassembly->maxSize - size) : 0;	// Parked until the fragment size is known
+	}
+
+	if((offset + size) > reassembly->maxSize)
+	{
+		return SNAP_ERROR_SHORT_BUFFER;
+	}
+
+	memcpy(&reassembly->buffer[offset], data, size);
+	reassembly->lastSize = (uint16_t)size;
+
+	return 0;
+}
+
+/**
+ * @}
+ */
+
+
+/******************************************************************************/
+/*  Public Function Definitions                                               */
+/******************************************************************************/
+
+
+/**
+ * @addtogroup pf
+ * @{
+ */
+
+/**
+ * @brief Get the number of fragments necessary to send a message, followed by its CRC (#SNAP_SIZE_FRAG_CHECK bytes).
+ * @param[in] messageSize  Size of the message (up to #SNAP_MAX_SIZE_MESSAGE).
+ * @param[in] fragmentSize Size of each fragment (1 to #SNAP_MAX_SIZE_DATA). The last fragment may be smaller.
+ * @return Number of fragments (1 to #SNAP_MAX_FRAGMENTS), or zero if the message is empty or cannot be fragmented with this fragment size.
+ */
+uint8_t snap_getFragmentCount(const uint16_t messageSize, const uint16_t fragmentSize)
+{
+	if((messageSize == 0) || (messageSize > SNAP_MAX_SIZE_MESSAGE) || (fragmentSize == 0) || (fragmentSize > SNAP_MAX_SIZE_DATA))
+	{
+		return 0;
+	}
+
+	const uint_fast16_t count = (uint_fast16_t)((messageSize + SNAP_SIZE_FRAG_CHECK + fragmentSize - 1U) / fragmentSize);
+
+	return (count <= SNAP_MAX_FRAGMENTS) ? (uint8_t)count : 0;
+}
+
+/**
+ * @brief Set the message id in the protocol flags, keeping the other flag bits.
+ * @details The id should change for each new message sent to the same destination (e.g. a message counter), so the receiver
+ *          starts a new message instead of completing the previous one with its fragments. Only the lowest bits are kept
+ *          (see #SNAP_FLAGS_FRAG_ID_MASK).
+ * @param[in,out] fields Pointer to the structure that contains the frame fields.
+ * @param[in]     id     Message id.
+ */
+void snap_setFragmentId(snap_fields_t *fields, const uint8_t id)
+{
+	fields->protocolFlags = (fields->protocolFlags & ~((uint32_t)SNAP_FLAGS_FRAG_ID_MASK << SNAP_FLAGS_FRAG_ID_POS)) |
+							((uint32_t)(id & SNAP_FLAGS_FRAG_ID_MASK) << SNAP_FLAGS_FRAG_ID_POS);
+}
+
+/**
+ * @brief Encapsulate one fragment of a message into a new frame (if there is enough space).
+ * @details The frame has 3 bytes of protocol flags that carry the fragment index and the index of the last fragment
+ *          (the other flag bits, including the message id, are taken from the fields structure), and a data length field with the exact fragment size.
+ *          The message is followed by its CRC-16 (MSB first), so every fragment has the same size, except the last one,
+ *          which holds the remaining bytes of the message and the CRC.
+ *          Update the frame status and size according to the result.
+ * @param[in,out] frame        Pointer to the frame structure.
+ * @param[in,out] fields       Pointer to the structure that contains the addresses, protocol flags, ACK, CMD and EDM of the frame.
+ *                             The PFB, NDB, protocol flags and data fields are updated with the fragment.
+ * @param[in]     message      Pointer to the first byte of the message. It must not overlap the frame buffer.
+ * @param[in]     messageSize  Size of the message (up to #SNAP_MAX_SIZE_MESSAGE).
+ * @param[in]     fragmentSize Size of each fragment (1 to #SNAP_MAX_SIZE_DATA). It must be the same for every fragment of the message.
+ * @param[in]     index        Index of the fragment (less than snap_getFragmentCount()).
+ * @return Frame status after the process (value from #snap_status_t).
+ * @retval #SNAP_STATUS_VALID          Frame created successfully. Frame size is updated to match the new frame.
+ * @retval #SNAP_STATUS_ERROR_OVERFLOW Error: Invalid fragment, or frame does not fit in the buffer. Buffer remains unchanged. Frame size is changed to zero.
+ */
+int8_t snap_encapsulateFragment(snap_frame_t *frame, snap_fields_t *fields, const uint8_t *message, const uint16_t messageSize, const uint16_t fragmentSize, const uint8_t index)
+{
+	const uint_fast8_t count = snap_getFragmentCount(messageSize, fragmentSize);
+
+	if(index >= count)
+	{
+		frame->size = 0;
+		frame->status = SNAP_STATUS_ERROR_OVERFLOW;
+		return frame->status;
+	}
+
+	const uint_fast16_t totalSize = (uint_fast16_t)(messageSize + SNAP_SIZE_FRAG_CHECK);
+	const uint_fast16_t offset = (uint_fast16_t)index * fragmentSize;
+	const uint_fast16_t end = ((totalSize - offset) < fragmentSize) ? totalSize : (offset + fragmentSize);
+	uint8_t check[SNAP_SIZE_FRAG_CHECK];
+	snap_chunk_t chunks[2];
+	uint_fast8_t chunkCount = 0;
+
+	if(offset < messageSize)
+	{
+		chunks[chunkCount++] = (snap_chunk_t){&message[offset], (uint16_t)(((end < messageSize) ? end : messageSize) - offset), false};
+	}
+
+	if(end > messageSize)	// The fragment holds some bytes of the CRC
+	{
+		const uint16_t crc = snap_calculateCrc16(message, messageSize);
+		const uint_fast16_t start = (offset > messageSize) ? (offset - messageSize) : 0;
+
+		check[0] = (uint8_t)(crc >> 8);
+		check[1] = (uint8_t)(crc & 0xFF);
+		chunks[chunkCount++] = (snap_chunk_t){&check[start], (uint16_t)(end - messageSize - start), false};
+	}
+
+	snap_setFragmentFields(fields, index, (uint_fast8_t)(count - 1));
+
+	return snap_encapsulateChunks(frame, fields, chunks, (uint8_t)chunkCount);
+}
+
+/**
+ * @brief Initialize the reassembly structure.
+ * @details A reassembly structure should be initialized before passing it to other functions.
+ *          On error, the structure remains unchanged.
+ * @param[out] reassembly Pointer to the reassembly structure.
+ * @param[in]  buffer     Pointer to the array that will store the message.
+ * @param[in]  maxSize    Maximum number of bytes that can be stored in the buffer. It must hold the message and its CRC (#SNAP_SIZE_FRAG_CHECK bytes).
+ *                        If necessary, it will be limited to #SNAP_MAX_SIZE_MESSAGE + #SNAP_SIZE_FRAG_CHECK without generating error.
+ * @retval >0                       Return the actual maxSize used.
+ * @retval #SNAP_ERROR_NULL_FRAME   Error: Reassembly pointer is NULL.
+ * @retval #SNAP_ERROR_NULL_BUFFER  Error: Buffer pointer is NULL.
+ * @retval #SNAP_ERROR_SHORT_BUFFER Error: maxSize is zero.
+ */
+int16_t snap_initReassembly(snap_reassembly_t *reassembly, uint8_t *buffer, const uint16_t maxSize)
+{
+	if(reassembly == NULL)
+	{
+		return SNAP_ERROR_NULL_FRAME;
+	}
+
+	if(buffer == NULL)
+	{
+		return SNAP_ERROR_NULL_BUFFER;
+	}
+
+	if(maxSize == 0)
+	{
+		return SNAP_ERROR_SHORT_BUFFER;
+	}
+
+	reassembly->buffer = buffer;
+	reassembly->maxSize = (maxSize > (SNAP_MAX_SIZE_MESSAGE + SNAP_SIZE_FRAG_CHECK)) ? (SNAP_MAX_SIZE_MESSAGE + SNAP_SIZE_FRAG_CHECK) : maxSize;
+	snap_resetReassembly(reassembly);
+
+	return (int16_t)reassembly->maxSize;
+}
+
+/**
+ * @brief Discard the message being reassembled. The next fragment received will start a new message.
+ * @param[in,out] reassembly Pointer to the reassembly structure.
+ */
+void snap_resetReassembly(snap_reassembly_t *reassembly)
+{
+	memset(reassembly->received, 0, sizeof(reassembly->received));
+
+	reassembly->size = 0;
+	reassembly->fragmentSize = 0;
+	reassembly->lastSize = 0;
+	reassembly->sourceAddress = 0;
+	reassembly->missingCount = 0;
+	reassembly->lastIndex = 0;
+	reassembly->messageId = 0;
+	reassembly->started = false;
+}
+
+/**
+ * @brief Add a fragment received in a valid frame to the message being reassembled.
+ * @details Fragments can be received in any order. Duplicated fragments are ignored.
+ *          A fragment whose source address, last fragment index or message id differs from the message being reassembled
+ *          starts a new message, and so does any fragment received after the message is complete. Hence the
+ *          message must be handled as soon as this function returns zero. A complete message whose CRC does not match
+ *          (i.e. it was completed with fragments of another message) is discarded.
+ * @param[in,out] reassembly Pointer to the reassembly structure.
+ * @param[in]     frame      Pointer to the frame structure. It must contain a valid frame (see snap_encapsulateFragment()).
+ * @retval >0                       Return the number of fragments still missing.
+ * @retval 0                        Message is complete. Its size (without the CRC) is stored in the reassembly structure.
+ * @retval #SNAP_ERROR_FRAME_FORMAT Error: Frame is not a fragment (or it is an ACK/NACK response), or its size does not match the other fragments. It is ignored.
+ * @retval #SNAP_ERROR_SHORT_BUFFER Error: Message does not fit in the buffer. The fragment is ignored.
+ * @retval #SNAP_ERROR_MESSAGE_CHECK Error: Message is complete, but its CRC does not match. The message is discarded.
+ */
+int16_t snap_addFragment(snap_reassembly_t *reassembly, const snap_frame_t *frame)
+{
+	uint32_t flags = 0, sourceAddress = 0;
+	const uint8_t *data;
+
+	if((snap_getField(frame, &flags, SNAP_FIELD_PROTOCOL_FLAGS) != SNAP_HDB2_PFB_3BYTE_PROTOCOL_FLAGS) || !SNAP_IS_EXACT_LENGTH(frame->buffer) ||
+	   (SNAP_HDB2_ACK(frame->buffer) >= SNAP_HDB2_ACK_RESPONSE_ACK))	// Resend requests are responses
+	{
+		return SNAP_ERROR_FRAME_FORMAT;
+	}
+
+	const int16_t dataSize = snap_getFieldPtr(frame, &data, SNAP_FIELD_DATA);
+	const uint_fast8_t index = (uint_fast8_t)SNAP_FLAGS_FRAG_INDEX(flags);
+	const uint_fast8_t last = (uint_fast8_t)SNAP_FLAGS_FRAG_LAST(flags);
+	const uint_fast8_t id = (uint_fast8_t)SNAP_FLAGS_FRAG_ID(flags);
+
+	if((dataSize <= 0) || (index > last))
+	{
+		return SNAP_ERROR_FRAME_FORMAT;
+	}
+
+	snap_getField(frame, &sourceAddress, SNAP_FIELD_SOURCE_ADDRESS);	// Remains zero if the frame has no source address
+
+	if(!reassembly->started || (reassembly->missingCount == 0) || (reassembly->sourceAddress != sourceAddress) ||
+	   (reassembly->lastIndex != last) || (reassembly->messageId != id))
+	{
+		snap_startMessage(reassembly, sourceAddress, last, id);
+	}
+
+	if(reassembly->received[index / 8U] & (1U << (index % 8U)))
+	{
+		return reassembly->missingCount;
+	}
+
+	int16_t error;
+
+	if(index == last)
+	{
+		error = snap_storeLastFragment(reassembly, data, (uint_fast16_t)dataSize);
+	}
+	else if(reassembly->fragmentSize == 0)
+	{
+		error = snap_setFragmentSize(reassembly, (uint_fast16_t)dataSize);
+	}
+	else
+	{
+		error = ((uint_fast16_t)dataSize == reassembly->fragmentSize) ? 0 : SNAP_ERROR_FRAME_FORMAT;
+	}
+
+	if(error != 0)
+	{
+		return error;
+	}
+
+	if(index != last)
+	{
+		memcpy(&reassembly->buffer[(uint_fast32_t)index * reassembly->fragmentSize], data, reassembly->fragmentSize);
+	}
+
+	reassembly->received[index / 8U] |= (uint8_t)(1U << (index % 8U));
+
+	if(--reassembly->missingCount == 0)
+	{
+		const uint_fast16_t size = (uint_fast16_t)(reassembly->lastIndex * reassembly->fragmentSize + reassembly->lastSize);
+
+		if((size < SNAP_SIZE_FRAG_CHECK) || (snap_calculateCrc16(reassembly->buffer, (uint16_t)(size - SNAP_SIZE_FRAG_CHECK)) !=
+		   (uint16_t)((reassembly->buffer[size - 2U] << 8) | reassembly->buffer[size - 1U])))
+		{
+			snap_resetReassembly(reassembly);
+			return SNAP_ERROR_MESSAGE_CHECK;
+		}
+
+		reassembly->size = (uint16_t)(size - SNAP_SIZE_FRAG_CHECK);
+	}
+
+	return reassembly->missingCount;
+}
+
+/**
+ * @brief Get the bitmap of the fragments of the message that have not been received yet.
+ * @param[in]  reassembly Pointer to the reassembly structure.
+ * @param[out] bitmap     Pointer to the array that will store the bitmap (up to #SNAP_SIZE_FRAG_BITMAP bytes).
+ *                        Bit i % 8 of byte i / 8 is set if fragment i is missing.
+ * @return Size of the bitmap (bytes), or zero if no fragment has been received yet.
+ */
+uint8_t snap_getMissingFragments(const snap_reassembly_t *reassembly, uint8_t *bitmap)
+{
+	if(!reassembly->started)
+	{
+		return 0;
+	}
+
+	const uint_fast8_t size = (uint_fast8_t)(reassembly->lastIndex / 8U + 1U);
+
+	for(uint_fast8_t i = 0; i < size; i++)
+	{
+		bitmap[i] = (uint8_t)~reassembly->received[i];
+	}
+
+	if((reassembly->lastIndex % 8U) != 7U)
+	{
+		bitmap[size - 1] &= (uint8_t)((1U << (reassembly->lastIndex % 8U + 1U)) - 1U);	// Clear the bits after the last fragment
+	}
+
+	return (uint8_t)size;
+}
+
+/**
+ * @brief Encapsulate a request to resend only the fragments of the message that have not been received yet.
+ * @details The request is a NACK response (#SNAP_HDB2_ACK_RESPONSE_NACK) addressed to the source of the message, whose protocol flags
+ *          carry the index of the last fragment and the message id, and whose data is the bitmap of the missing fragments (see snap_getMissingFragments()).
+ *          If no fragment has been received yet, the bitmap is empty, which requests every fragment (see snap_isFragmentRequested()).
+ *          Update the frame status and size according to the result.
+ * @param[in,out] frame      Pointer to the frame structure.
+ * @param[in,out] fields     Pointer to the structure that contains the source address, protocol flags, DAB, SAB and EDM of the frame.
+ *                           The destination address, PFB, ACK, NDB, protocol flags and data fields are updated with the request.
+ * @param[in]     reassembly Pointer to the reassembly structure.
+ * @return Frame status after the process (value from #snap_status_t).
+ * @retval #SNAP_STATUS_VALID          Frame created successfully. Frame size is updated to match the new frame.
+ * @retval #SNAP_STATUS_ERROR_OVERFLOW Error: Frame does not fit in the buffer. Buffer remains unchanged. Frame size is changed to zero.
+ */
+int8_t snap_encapsulateResendRequest(snap_frame_t *frame, snap_fields_t *fields, const snap_reassembly_t *reassembly)
+{
+	uint8_t bitmap[SNAP_SIZE_FRAG_BITMAP];
+	const snap_chunk_t chunk =
+	{
+		.data = bitmap,
+		.size = snap_getMissingFragments(reassembly, bitmap),
+		.inFlash = false
+	};
+
+	snap_setFragmentFields(fields, 0, reassembly->lastIndex);
+	snap_setFragmentId(fields, reassembly->messageId);
+
+	fields->destAddress = reassembly->sourceAddress;
+	fields->header.ack = SNAP_HDB2_ACK_RESPONSE_NACK;
+
+	return snap_encapsulateChunks(frame, fields, &chunk, 1);
+}
+
+/**
+ * @brief Check if a fragment is requested by a resend request (see snap_encapsulateResendRequest()).
+ * @param[in] bitmap     Pointer to the bitmap of missing fragments (data of the request). It can be NULL if bitmapSize is zero.
+ * @param[in] bitmapSize Size of the bitmap (bytes).
+ * @param[in] index      Fragment index.
+ * @return true if the fragment must be sent again, false otherwise. An empty bitmap requests every fragment.
+ */
+bool snap_isFragmentRequested(const uint8_t *bitmap, const uint16_t bitmapSize, const uint8_t index)
+{
+	if(bitmapSize == 0)
+	{
+		return true;
+	}
+
+	if((index / 8U) >= bitmapSize)
+	{
+		return false;
+	}
+
+	return (bitmap[index / 8U] >> (index % 8U)) & 1U;
+}
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/******************************** END OF FILE *********************************/
@@ -0,0 +1,193 @@
+/*
+Copyright (c) 2026 libSNAP contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file   snap_compress.h
+ * @brief  Header file of the header compression layer of the libSNAP library.
+ * @details Frames of a flow (same format, addresses and protocol flags) are sent with a 2-byte compressed header instead of
+ *          the addresses and flags: the transmitter and the receiver keep a table of flow contexts, and each compressed frame
+ *          carries only the context id, a check byte, and the protocol flags when they change.
+ *
+ *          A compressed frame is a regular frame without addresses and with 2 bytes of protocol flags:
+ *          - Flags bits 15-8: #SNAP_COMP_MARKER, #SNAP_COMP_FULL, #SNAP_COMP_FLAGS, the context id (bits 12-10) and the interleaving
+ *            depth of the flow (bits 9-8, see snap_setInterleaving()), so compressed frames are interleaved like the plain ones.
+ *          - Flags bits 7-0: CRC-8 of the context after the frame is applied (format, addresses and protocol flags).
+ *          - Data: the original HDB2 byte, addresses and flags (#SNAP_COMP_FULL), or only the flags (#SNAP_COMP_FLAGS), followed by the data.
+ *
+ *          The first frame of a flow, and every frame after the refresh period, carries the full header and (re)installs the context.
+ *          A receiver that lost a context update detects it with the check byte and reports a hash error, so the transmitter
+ *          can be told (e.g. NACK) to reset the context. Frames that are not compressed pass unchanged, so compressed and plain
+ *          flows can share the same link. The format used by compressed frames (no addresses, 2 flag bytes with the MSb set)
+ *          must not be used by plain frames, and context ids must be unique in the network (e.g. derived from the node address).
+ *
+ * Example:
+ * @code
+ * // Transmitter
+ * snap_encapsulateCompressed(&txFrame, &fields, &txContexts, NODE_CONTEXT);
+ *
+ * // Receiver
+ * if((snap_decode(&rxFrame, newByte) == SNAP_STATUS_VALID) && (snap_decompress(&rxFrame, &rxContexts) == SNAP_STATUS_VALID))
+ * {
+ *     // Plain frame with the original addresses and flags
+ * }
+ * @endcode
+ */
+
+#ifndef SNAP_COMPRESS_H_
+#define SNAP_COMPRESS_H_
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+/**
+ * @addtogroup libSNAP
+ * @{
+ */
+
+
+/******************************************************************************/
+/*  Public Includes                                                           */
+/******************************************************************************/
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "snap.h"
+
+
+/******************************************************************************/
+/*  Public Macros                                                             */
+/******************************************************************************/
+
+
+/**
+ * @addtogroup pm
+ * @{
+ * @name Compressed header
+ * @{
+ */
+
+#define SNAP_COMP_MARKER		(0x80U)	/**< @brief Bit set in the first flags byte of every compressed frame. */
+#define SNAP_COMP_FULL			(0x40U)	/**< @brief Bit set in the first flags byte of a compressed frame that carries the full header (context refresh). */
+#define SNAP_COMP_FLAGS			(0x20U)	/**< @brief Bit set in the first flags byte of a compressed frame that carries new protocol flags. */
+#define SNAP_COMP_ID_MASK		(0x07U)	/**< @brief Bit mask of the context id in the first flags byte of a compressed frame. */
+#define SNAP_COMP_ID_POS		(2U)	/**< @brief Position of the context id (LSb) in the first flags byte of a compressed frame. The 2 bits below it are the interleaving depth (#SNAP_FLAGS_DEPTH_POS). */
+
+#define SNAP_COMP_MAX_HEADER	(1U + 3U + 3U + 3U)	/**< @brief Maximum size of the header carried in the data of a compressed frame = 1 (HDB2) + 3 (destination address) + 3 (source address) + 3 (flags). */
+
+/**
+ * @}
+ * @name Context table size
+ * @{
+ */
+
+#ifdef SNAP_MAX_CONTEXTS
+	#if (SNAP_MAX_CONTEXTS < 1) || (SNAP_MAX_CONTEXTS > 8)
+		#error Invalid number of flow contexts! It must be a value from 1 to 8 (contexts).
+	#endif
+#else
+	#define SNAP_MAX_CONTEXTS	(4U)	/**< @brief Number of flow contexts in each table (1 to 8). It can be defined by the user in the compilation command. */
+#endif
+
+/**
+ * @}
+ * @}
+ */
+
+
+/******************************************************************************/
+/*  Public Types                                                              */
+/******************************************************************************/
+
+
+/**
+ * @addtogroup pt
+ * @{
+ */
+
+/**
+ * @brief Header fields shared by the frames of a flow.
+ */
+typedef struct snap_context_t
+{
+	uint32_t destAddress;	/**< @brief Destination address. */
+	uint32_t sourceAddress;	/**< @brief Source address. */
+	uint32_t protocolFlags;	/**< @brief Protocol flags of the last frame. */
+	uint8_t  hdb2;			/**< @brief DAB, SAB and PFB bits of the frames (ACK bits are zero). */
+	uint8_t  check;			/**< @brief CRC-8 of the fields above. */
+	uint8_t  frameCount;	/**< @brief Number of compressed frames sent since the last full header (transmitter only). */
+	bool     valid;			/**< @brief The context has been installed. */
+} snap_context_t;
+
+/**
+ * @brief Table of flow contexts of one end of the link. A node that compresses and decompresses frames needs two tables.
+ */
+typedef struct snap_contexts_t
+{
+	snap_context_t context[SNAP_MAX_CONTEXTS];	/**< @brief Flow contexts, indexed by the context id. */
+	uint8_t        refreshPeriod;				/**< @brief Number of compressed frames between full headers (zero = only when the flow changes). */
+} snap_contexts_t;
+
+/**
+ * @}
+ */
+
+
+/******************************************************************************/
+/*  Public Function Declarations                                              */
+/******************************************************************************/
+
+
+/**
+ * @addtogroup pf
+ * @{
+ * @name Header compression functions
+ * @{
+ */
+
+void snap_initContexts(snap_contexts_t *contexts, uint8_t refreshPeriod);
+
+void snap_resetContext(snap_contexts_t *contexts, uint8_t contextId);
+
+int8_t snap_encapsulateCompressed(snap_frame_t *frame, const snap_fields_t *fields, snap_contexts_t *contexts, uint8_t contextId);
+
+bool snap_isCompressed(const snap_frame_t *frame);
+
+int8_t snap_decompress(snap_frame_t *frame, snap_contexts_t *contexts);
+
+/**
+ * @}
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+	}
+#endif
+
+#endif	// SNAP_COMPRESS_H_
+
+/******************************** END OF FILE *********************************/
@@ -0,0 +1,173 @@
+/*
+Copyright (c) 2026 libSNAP contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file   crc_benchmark.c
+ * @brief  Host benchmark of the CRC calculations of the libSNAP library, in bytes per second, for frame sizes from
+ *         #SNAP_MIN_SIZE_FRAME to #SNAP_MAX_SIZE_FRAME. The table size is selected at compile time, so the program
+ *         must be built once per table size (the CRC-8 only has tables of 16 and 256 entries):
+ * @code
+ * for size in 0 16 256 1024 2048; do
+ *     crc8=$(( size > 256 ? 256 : size ))
+ *     gcc -O2 -I../.. -DSNAP_DISABLE_CLMUL -DSNAP_CRC8_TABLE_SIZE=$crc8 -DSNAP_CRC16_TABLE_SIZE=$size -DSNAP_CRC32_TABLE_SIZE=$size \
+ *         -DBENCHMARK_TABLE_SIZE=$size crc_benchmark.c ../../snap.c -o crc_benchmark && ./crc_benchmark
+ * done
+ * @endcode
+ *         On x86 hosts, building without `SNAP_DISABLE_CLMUL` measures the carry-less multiplications (PCLMULQDQ),
+ *         which are used for blocks of 64 bytes or more if the CPU supports them:
+ * @code
+ * gcc -O2 -I../.. crc_benchmark.c ../../snap.c -o crc_benchmark && ./crc_benchmark
+ * @endcode
+ */
+
+
+/******************************************************************************/
+/*  Private Includes                                                          */
+/******************************************************************************/
+
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <time.h>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	#include <cpuid.h>
+#endif
+#include "snap.h"
+
+
+/******************************************************************************/
+/*  Private Macros                                                            */
+/******************************************************************************/
+
+
+#ifndef BENCHMARK_TABLE_SIZE
+	#define BENCHMARK_TABLE_SIZE	(-1)	/* Default table sizes of the build */
+#endif
+
+#define BENCHMARK_BYTES	(32UL * 1024UL * 1024UL)	/* Bytes hashed per measurement */
+
+
+/******************************************************************************/
+/*  Private Variables                                                         */
+/******************************************************************************/
+
+
+static const uint16_t frameSizes[] = {SNAP_MIN_SIZE_FRAME, 8, 16, 32, 64, 65, 80, 128, 256, SNAP_MAX_SIZE_FRAME};	/* 65: smallest block folded with PCLMULQDQ */
+
+static uint8_t frame[SNAP_MAX_SIZE_FRAME];
+
+static volatile uint32_t sink;	/* Keeps the results alive */
+
+
+/******************************************************************************/
+/*  Private Function Definitions                                              */
+/******************************************************************************/
+
+
+/**
+ * @brief Get the time of a monotonic clock.
+ * @return Time in seconds.
+ */
+static double getSeconds(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Check if the library uses the carry-less multiplications (same conditions as snap.c).
+ * @return True if they are used.
+ */
+static bool isClmulUsed(void)
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && !defined(SNAP_DISABLE_CLMUL)
+	unsigned int eax, ebx, ecx, edx;
+
+	return __get_cpuid(1, &eax, &ebx, &ecx, &edx) && ((ecx & bit_PCLMUL) != 0) && ((ecx & bit_SSSE3) != 0);
+#else
+	return false;
+#endif
+}
+
+/**
+ * @brief Measure the throughput of a CRC over the bytes that follow the sync byte of a frame.
+ * @param[in] crcType   8, 16 or 32.
+ * @param[in] frameSize Frame size (bytes).
+ * @return Throughput (bytes per second).
+ */
+static double measure(const uint8_t crcType, const uint16_t frameSize)
+{
+	const uint16_t size = (uint16_t)(frameSize - 1U);
+	const unsigned long count = BENCHMARK_BYTES / size;
+	uint32_t result = 0;
+	const double start = getSeconds();
+
+	for(unsigned long i = 0; i < count; i++)
+	{
+		frame[1] = (uint8_t)i;	// Different data on each pass
+
+		switch(crcType)
+		{
+			case 8:  result += snap_calculateCrc8(&frame[1], size);  break;
+			case 16: result += snap_calculateCrc16(&frame[1], size); break;
+			default: result += snap_calculateCrc32(&frame[1], size); break;
+		}
+	}
+
+	const double elapsed = getSeconds() - start;
+	sink = result;
+
+	return (double)count * size / elapsed;
+}
+
+
+/******************************************************************************/
+/*  Public Function Definitions                                               */
+/******************************************************************************/
+
+
+int main(void)
+{
+	uint32_t state = 1;
+
+	for(uint16_t i = 0; i < sizeof(frame); i++)
+	{
+		state = state * 1103515245U + 12345U;
+		frame[i] = (uint8_t)(state >> 24);
+	}
+
+	printf("Table size: %d entries (-1 = default), carry-less multiplications: %s\n", BENCHMARK_TABLE_SIZE, isClmulUsed() ? "on" : "off");
+	printf("%10s %14s %14s %14s\n", "Frame (B)", "CRC-8 (MB/s)", "CRC-16 (MB/s)", "CRC-32 (MB/s)");
+
+	for(uint8_t i = 0; i < sizeof(frameSizes) / sizeof(frameSizes[0]); i++)
+	{
+		printf("%10u %14.1f %14.1f %14.1f\n", frameSizes[i], measure(8, frameSizes[i]) * 1e-6,
+		       measure(16, frameSizes[i]) * 1e-6, measure(32, frameSizes[i]) * 1e-6);
+	}
+
+	return 0;
+}
+
+/** @} */
@@ -38,19 +38,2178 @@ SOFTWARE.
 
 
 #include <stddef.h>
+#include <string.h>
+#ifdef __AVR__
+	#include <avr/pgmspace.h>
+#endif
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && !defined(SNAP_DISABLE_CLMUL)
+	#include <cpuid.h>
+	#include <immintrin.h>
+#endif
 #include "snap.h"
 
 
-/******************************************************************************/
-/*  Private Macros                                                            */
-/******************************************************************************/
+/******************************************************************************/
+/*  Private Macros                                                            */
+/******************************************************************************/
+
+
+#ifdef SNAP_DISABLE_WEAK
+	#define SNAP_WEAK
+#else
+	#define SNAP_WEAK	__attribute__((weak))
+#endif
+
+#ifdef __AVR__
+	#define SNAP_MEMCPY_FLASH(dest, src, size)	memcpy_P(dest, src, size)	// Copy from program memory
+	#define SNAP_FLASH							PROGMEM						// Keep constant tables out of SRAM
+	#define SNAP_READ_FLASH_BYTE(pByte)			pgm_read_byte(pByte)
+	#define SNAP_READ_FLASH_WORD(pWord)			pgm_read_word(pWord)
+	#define SNAP_READ_FLASH_DWORD(pDword)		pgm_read_dword(pDword)
+#else
+	#define SNAP_MEMCPY_FLASH(dest, src, size)	memcpy(dest, src, size)		// Single address space
+	#define SNAP_FLASH
+	#define SNAP_READ_FLASH_BYTE(pByte)			(*(pByte))
+	#define SNAP_READ_FLASH_WORD(pWord)			(*(pWord))
+	#define SNAP_READ_FLASH_DWORD(pDword)		(*(pDword))
+#endif
+
+/*
+ * Number of entries of the lookup table of each CRC: 0 (bitwise calculation), 16 (one lookup per nibble) or 256 (one
+ * lookup per byte). The tables are stored in program memory. Defining `SNAP_CRCx_TABLE` selects the 256-entry table.
+ * CRC-16 and CRC-32 can also use 1024 or 2048 entries (4 or 8 tables of 256 entries), which process blocks of 4 or 8
+ * bytes per iteration ("slicing-by-4/8"). They are meant for host builds (e.g. a gateway), where they are the default.
+ */
+
+#if defined(__linux__) || defined(_WIN32) || defined(__APPLE__)
+	#define SNAP_HOST_BUILD
+#endif
+
+#define SNAP_WHITENING_SEED	(0x1FFU)	/* Initial state of the PN9 scrambler (see snap_setScrambling()) */
+
+#define SNAP_SIZE_INTERLEAVE_BITMAP	((SNAP_MAX_SIZE_DATA + SNAP_SIZE_FEC_CHECK + SNAP_MAX_DEPTH * SNAP_SIZE_FEC_PARITY + 7U) / 8U)	/* One bit per interleaved byte (data and hash, see snap_interleaveCopy()) */
+
+#define SNAP_VOTE(a, b, c)	((uint8_t)(((a) & (b)) | ((a) & (c)) | ((b) & (c))))	/* Bitwise majority of 3 bytes (see snap_voteCopies()) */
+
+/*
+ * On x86 hosts, CRC-16 and CRC-32 of blocks of at least SNAP_CLMUL_MIN_SIZE bytes are calculated by folding 16 bytes at
+ * a time with carry-less multiplications (PCLMULQDQ), if the CPU supports them (checked once at startup with CPUID).
+ * Defining `SNAP_DISABLE_CLMUL` keeps the table-driven calculation.
+ */
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && !defined(SNAP_DISABLE_CLMUL)
+	#define SNAP_CRC_CLMUL
+	#define SNAP_CLMUL_MIN_SIZE	(64U)
+#endif
+
+#ifndef SNAP_CRC8_TABLE_SIZE
+	#ifdef SNAP_CRC8_TABLE
+		#define SNAP_CRC8_TABLE_SIZE	(256)
+	#else
+		#define SNAP_CRC8_TABLE_SIZE	(0)
+	#endif
+#endif
+
+#ifndef SNAP_CRC16_TABLE_SIZE
+	#if defined(SNAP_CRC16_TABLE)
+		#define SNAP_CRC16_TABLE_SIZE	(256)
+	#elif defined(SNAP_HOST_BUILD)
+		#define SNAP_CRC16_TABLE_SIZE	(2048)
+	#else
+		#define SNAP_CRC16_TABLE_SIZE	(0)
+	#endif
+#endif
+
+#ifndef SNAP_CRC32_TABLE_SIZE
+	#if defined(SNAP_CRC32_TABLE)
+		#define SNAP_CRC32_TABLE_SIZE	(256)
+	#elif defined(SNAP_HOST_BUILD)
+		#define SNAP_CRC32_TABLE_SIZE	(2048)
+	#else
+		#define SNAP_CRC32_TABLE_SIZE	(0)
+	#endif
+#endif
+
+#if ((SNAP_CRC8_TABLE_SIZE != 0) && (SNAP_CRC8_TABLE_SIZE != 16) && (SNAP_CRC8_TABLE_SIZE != 256))
+	#error Invalid CRC-8 table size! It must be 0, 16 or 256 (entries).
+#endif
+
+#if ((SNAP_CRC16_TABLE_SIZE != 0) && (SNAP_CRC16_TABLE_SIZE != 16) && (SNAP_CRC16_TABLE_SIZE != 256) && (SNAP_CRC16_TABLE_SIZE != 1024) && (SNAP_CRC16_TABLE_SIZE != 2048)) || \
+    ((SNAP_CRC32_TABLE_SIZE != 0) && (SNAP_CRC32_TABLE_SIZE != 16) && (SNAP_CRC32_TABLE_SIZE != 256) && (SNAP_CRC32_TABLE_SIZE != 1024) && (SNAP_CRC32_TABLE_SIZE != 2048))
+	#error Invalid CRC-16/CRC-32 table size! It must be 0, 16, 256, 1024 or 2048 (entries).
+#endif
+
+
+/******************************************************************************/
+/*  Private Types                                                             */
+/******************************************************************************/
+
+
+/**
+ * @brief Rows of the interleaver (see snap_getRows()). Each row is made of up to 2 segments of the interleaved bytes.
+ *        There are never more than #SNAP_MAX_DEPTH rows, because frames up to #SNAP_MAX_SIZE_FRAME have at most 3 FEC codewords.
+ */
+typedef struct snap_rows_t
+{
+	uint16_t index[SNAP_MAX_DEPTH][2];	/**< @brief Offset of each segment from the first interleaved byte. */
+	uint16_t size[SNAP_MAX_DEPTH][2];	/**< @brief Size of each segment. */
+	uint8_t  count;						/**< @brief Number of rows. */
+} snap_rows_t;
+
+
+/******************************************************************************/
+/*  Private Constants                                                         */
+/******************************************************************************/
+
+
+#if (SNAP_CRC8_TABLE_SIZE == 16)
+
+static const uint8_t tableCrc8[16] SNAP_FLASH =
+{
+	0x00, 0x9D, 0x23, 0xBE, 0x46, 0xDB, 0x65, 0xF8, 0x8C, 0x11, 0xAF, 0x32,
+	0xCA, 0x57, 0xE9, 0x74
+};
+
+#elif (SNAP_CRC8_TABLE_SIZE == 256)
+
+static const uint8_t tableCrc8[256] SNAP_FLASH =
+{
+	0x00, 0x5E, 0xBC, 0xE2, 0x61, 0x3F, 0xDD, 0x83, 0xC2, 0x9C, 0x7E, 0x20,
+	0xA3, 0xFD, 0x1F, 0x41, 0x9D, 0xC3, 0x21, 0x7F, 0xFC, 0xA2, 0x40, 0x1E,
+	0x5F, 0x01, 0xE3, 0xBD, 0x3E, 0x60, 0x82, 0xDC, 0x23, 0x7D, 0x9F, 0xC1,
+	0x42, 0x1C, 0xFE, 0xA0, 0xE1, 0xBF, 0x5D, 0x03, 0x80, 0xDE, 0x3C, 0x62,
+	0xBE, 0xE0, 0x02, 0x5C, 0xDF, 0x81, 0x63, 0x3D, 0x7C, 0x22, 0xC0, 0x9E,
+	0x1D, 0x43, 0xA1, 0xFF, 0x46, 0x18, 0xFA, 0xA4, 0x27, 0x79, 0x9B, 0xC5,
+	0x84, 0xDA, 0x38, 0x66, 0xE5, 0xBB, 0x59, 0x07, 0xDB, 0x85, 0x67, 0x39,
+	0xBA, 0xE4, 0x06, 0x58, 0x19, 0x47, 0xA5, 0xFB, 0x78, 0x26, 0xC4, 0x9A,
+	0x65, 0x3B, 0xD9, 0x87, 0x04, 0x5A, 0xB8, 0xE6, 0xA7, 0xF9, 0x1B, 0x45,
+	0xC6, 0x98, 0x7A, 0x24, 0xF8, 0xA6, 0x44, 0x1A, 0x99, 0xC7, 0x25, 0x7B,
+	0x3A, 0x64, 0x86, 0xD8, 0x5B, 0x05, 0xE7, 0xB9, 0x8C, 0xD2, 0x30, 0x6E,
+	0xED, 0xB3, 0x51, 0x0F, 0x4E, 0x10, 0xF2, 0xAC, 0x2F, 0x71, 0x93, 0xCD,
+	0x11, 0x4F, 0xAD, 0xF3, 0x70, 0x2E, 0xCC, 0x92, 0xD3, 0x8D, 0x6F, 0x31,
+	0xB2, 0xEC, 0x0E, 0x50, 0xAF, 0xF1, 0x13, 0x4D, 0xCE, 0x90, 0x72, 0x2C,
+	0x6D, 0x33, 0xD1, 0x8F, 0x0C, 0x52, 0xB0, 0xEE, 0x32, 0x6C, 0x8E, 0xD0,
+	0x53, 0x0D, 0xEF, 0xB1, 0xF0, 0xAE, 0x4C, 0x12, 0x91, 0xCF, 0x2D, 0x73,
+	0xCA, 0x94, 0x76, 0x28, 0xAB, 0xF5, 0x17, 0x49, 0x08, 0x56, 0xB4, 0xEA,
+	0x69, 0x37, 0xD5, 0x8B, 0x57, 0x09, 0xEB, 0xB5, 0x36, 0x68, 0x8A, 0xD4,
+	0x95, 0xCB, 0x29, 0x77, 0xF4, 0xAA, 0x48, 0x16, 0xE9, 0xB7, 0x55, 0x0B,
+	0x88, 0xD6, 0x34, 0x6A, 0x2B, 0x75, 0x97, 0xC9, 0x4A, 0x14, 0xF6, 0xA8,
+	0x74, 0x2A, 0xC8, 0x96, 0x15, 0x4B, 0xA9, 0xF7, 0xB6, 0xE8, 0x0A, 0x54,
+	0xD7, 0x89, 0x6B, 0x35
+};
+
+#endif	// SNAP_CRC8_TABLE_SIZE
+
+#if (SNAP_CRC16_TABLE_SIZE == 16)
+
+static const uint16_t tableCrc16[16] SNAP_FLASH =
+{
+	0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7, 0x8108,
+	0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+#elif (SNAP_CRC16_TABLE_SIZE == 256)
+
+static const uint16_t tableCrc16[256] SNAP_FLASH =
+{
+	0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7, 0x8108,
+	0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF, 0x1231, 0x0210,
+	0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6, 0x9339, 0x8318, 0xB37B,
+	0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE, 0x2462, 0x3443, 0x0420, 0x1401,
+	0x64E6, 0x74C7, 0x44A4, 0x5485, 0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE,
+	0xF5CF, 0xC5AC, 0xD58D, 0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6,
+	0x5695, 0x46B4, 0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D,
+	0xC7BC, 0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+	0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B, 0x5AF5,
+	0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12, 0xDBFD, 0xCBDC,
+	0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A, 0x6CA6, 0x7C87, 0x4CE4,
+	0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41, 0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD,
+	0xAD2A, 0xBD0B, 0x8D68, 0x9D49, 0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13,
+	0x2E32, 0x1E51, 0x0E70, 0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A,
+	0x9F59, 0x8F78, 0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E,
+	0xE16F, 0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+	0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E, 0x02B1,
+	0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256, 0xB5EA, 0xA5CB,
+	0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D, 0x34E2, 0x24C3, 0x14A0,
+	0x0481, 0x7466, 0x6447, 0x5424, 0x4405, 0xA7DB, 0xB7FA, 0x8799, 0x97B8,
+	0xE75F, 0xF77E, 0xC71D, 0xD73C, 0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657,
+	0x7676, 0x4615, 0x5634, 0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9,
+	0xB98A, 0xA9AB, 0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882,
+	0x28A3, 0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+	0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92, 0xFD2E,
+	0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9, 0x7C26, 0x6C07,
+	0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1, 0xEF1F, 0xFF3E, 0xCF5D,
+	0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8, 0x6E17, 0x7E36, 0x4E55, 0x5E74,
+	0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
+};
+
+#elif (SNAP_CRC16_TABLE_SIZE >= 1024)
+
+/*
+ * Entry 256 * k + i is the CRC of the byte i followed by k zero bytes, so the first 256 entries are the byte table.
+ */
+
+static const uint16_t tableCrc16[SNAP_CRC16_TABLE_SIZE] SNAP_FLASH =
+{
+	0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+	0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+	0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+	0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+	0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+	0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+	0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+	0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+	0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+	0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+	0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+	0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+	0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+	0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+	0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+	0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+	0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+	0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+	0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+	0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+	0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+	0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+	0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+	0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+	0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+	0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+	0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+	0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+	0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+	0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+	0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+	0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0,
+	0x0000, 0x3331, 0x6662, 0x5553, 0xCCC4, 0xFFF5, 0xAAA6, 0x9997,
+	0x89A9, 0xBA98, 0xEFCB, 0xDCFA, 0x456D, 0x765C, 0x230F, 0x103E,
+	0x0373, 0x3042, 0x6511, 0x5620, 0xCFB7, 0xFC86, 0xA9D5, 0x9AE4,
+	0x8ADA, 0xB9EB, 0xECB8, 0xDF89, 0x461E, 0x752F, 0x207C, 0x134D,
+	0x06E6, 0x35D7, 0x6084, 0x53B5, 0xCA22, 0xF913, 0xAC40, 0x9F71,
+	0x8F4F, 0xBC7E, 0xE92D, 0xDA1C, 0x438B, 0x70BA, 0x25E9, 0x16D8,
+	0x0595, 0x36A4, 0x63F7, 0x50C6, 0xC951, 0xFA60, 0xAF33, 0x9C02,
+	0x8C3C, 0xBF0D, 0xEA5E, 0xD96F, 0x40F8, 0x73C9, 0x269A, 0x15AB,
+	0x0DCC, 0x3EFD, 0x6BAE, 0x589F, 0xC108, 0xF239, 0xA76A, 0x945B,
+	0x8465, 0xB754, 0xE207, 0xD136, 0x48A1, 0x7B90, 0x2EC3, 0x1DF2,
+	0x0EBF, 0x3D8E, 0x68DD, 0x5BEC, 0xC27B, 0xF14A, 0xA419, 0x9728,
+	0x8716, 0xB427, 0xE174, 0xD245, 0x4BD2, 0x78E3, 0x2DB0, 0x1E81,
+	0x0B2A, 0x381B, 0x6D48, 0x5E79, 0xC7EE, 0xF4DF, 0xA18C, 0x92BD,
+	0x8283, 0xB1B2, 0xE4E1, 0xD7D0, 0x4E47, 0x7D76, 0x2825, 0x1B14,
+	0x0859, 0x3B68, 0x6E3B, 0x5D0A, 0xC49D, 0xF7AC, 0xA2FF, 0x91CE,
+	0x81F0, 0xB2C1, 0xE792, 0xD4A3, 0x4D34, 0x7E05, 0x2B56, 0x1867,
+	0x1B98, 0x28A9, 0x7DFA, 0x4ECB, 0xD75C, 0xE46D, 0xB13E, 0x820F,
+	0x9231, 0xA100, 0xF453, 0xC762, 0x5EF5, 0x6DC4, 0x3897, 0x0BA6,
+	0x18EB, 0x2BDA, 0x7E89, 0x4DB8, 0xD42F, 0xE71E, 0xB24D, 0x817C,
+	0x9142, 0xA273, 0xF720, 0xC411, 0x5D86, 0x6EB7, 0x3BE4, 0x08D5,
+	0x1D7E, 0x2E4F, 0x7B1C, 0x482D, 0xD1BA, 0xE28B, 0xB7D8, 0x84E9,
+	0x94D7, 0xA7E6, 0xF2B5, 0xC184, 0x5813, 0x6B22, 0x3E71, 0x0D40,
+	0x1E0D, 0x2D3C, 0x786F, 0x4B5E, 0xD2C9, 0xE1F8, 0xB4AB, 0x879A,
+	0x97A4, 0xA495, 0xF1C6, 0xC2F7, 0x5B60, 0x6851, 0x3D02, 0x0E33,
+	0x1654, 0x2565, 0x7036, 0x4307, 0xDA90, 0xE9A1, 0xBCF2, 0x8FC3,
+	0x9FFD, 0xACCC, 0xF99F, 0xCAAE, 0x5339, 0x6008, 0x355B, 0x066A,
+	0x1527, 0x2616, 0x7345, 0x4074, 0xD9E3, 0xEAD2, 0xBF81, 0x8CB0,
+	0x9C8E, 0xAFBF, 0xFAEC, 0xC9DD, 0x504A, 0x637B, 0x3628, 0x0519,
+	0x10B2, 0x2383, 0x76D0, 0x45E1, 0xDC76, 0xEF47, 0xBA14, 0x8925,
+	0x991B, 0xAA2A, 0xFF79, 0xCC48, 0x55DF, 0x66EE, 0x33BD, 0x008C,
+	0x13C1, 0x20F0, 0x75A3, 0x4692, 0xDF05, 0xEC34, 0xB967, 0x8A56,
+	0x9A68, 0xA959, 0xFC0A, 0xCF3B, 0x56AC, 0x659D, 0x30CE, 0x03FF,
+	0x0000, 0x3730, 0x6E60, 0x5950, 0xDCC0, 0xEBF0, 0xB2A0, 0x8590,
+	0xA9A1, 0x9E91, 0xC7C1, 0xF0F1, 0x7561, 0x4251, 0x1B01, 0x2C31,
+	0x4363, 0x7453, 0x2D03, 0x1A33, 0x9FA3, 0xA893, 0xF1C3, 0xC6F3,
+	0xEAC2, 0xDDF2, 0x84A2, 0xB392, 0x3602, 0x0132, 0x5862, 0x6F52,
+	0x86C6, 0xB1F6, 0xE8A6, 0xDF96, 0x5A06, 0x6D36, 0x3466, 0x0356,
+	0x2F67, 0x1857, 0x4107, 0x7637, 0xF3A7, 0xC497, 0x9DC7, 0xAAF7,
+	0xC5A5, 0xF295, 0xABC5, 0x9CF5, 0x1965, 0x2E55, 0x7705, 0x4035,
+	0x6C04, 0x5B34, 0x0264, 0x3554, 0xB0C4, 0x87F4, 0xDEA4, 0xE994,
+	0x1DAD, 0x2A9D, 0x73CD, 0x44FD, 0xC16D, 0xF65D, 0xAF0D, 0x983D,
+	0xB40C, 0x833C, 0xDA6C, 0xED5C, 0x68CC, 0x5FFC, 0x06AC, 0x319C,
+	0x5ECE, 0x69FE, 0x30AE, 0x079E, 0x820E, 0xB53E, 0xEC6E, 0xDB5E,
+	0xF76F, 0xC05F, 0x990F, 0xAE3F, 0x2BAF, 0x1C9F, 0x45CF, 0x72FF,
+	0x9B6B, 0xAC5B, 0xF50B, 0xC23B, 0x47AB, 0x709B, 0x29CB, 0x1EFB,
+	0x32CA, 0x05FA, 0x5CAA, 0x6B9A, 0xEE0A, 0xD93A, 0x806A, 0xB75A,
+	0xD808, 0xEF38, 0xB668, 0x8158, 0x04C8, 0x33F8, 0x6AA8, 0x5D98,
+	0x71A9, 0x4699, 0x1FC9, 0x28F9, 0xAD69, 0x9A59, 0xC309, 0xF439,
+	0x3B5A, 0x0C6A, 0x553A, 0x620A, 0xE79A, 0xD0AA, 0x89FA, 0xBECA,
+	0x92FB, 0xA5CB, 0xFC9B, 0xCBAB, 0x4E3B, 0x790B, 0x205B, 0x176B,
+	0x7839, 0x4F09, 0x1659, 0x2169, 0xA4F9, 0x93C9, 0xCA99, 0xFDA9,
+	0xD198, 0xE6A8, 0xBFF8, 0x88C8, 0x0D58, 0x3A68, 0x6338, 0x5408,
+	0xBD9C, 0x8AAC, 0xD3FC, 0xE4CC, 0x615C, 0x566C, 0x0F3C, 0x380C,
+	0x143D, 0x230D, 0x7A5D, 0x4D6D, 0xC8FD, 0xFFCD, 0xA69D, 0x91AD,
+	0xFEFF, 0xC9CF, 0x909F, 0xA7AF, 0x223F, 0x150F, 0x4C5F, 0x7B6F,
+	0x575E, 0x606E, 0x393E, 0x0E0E, 0x8B9E, 0xBCAE, 0xE5FE, 0xD2CE,
+	0x26F7, 0x11C7, 0x4897, 0x7FA7, 0xFA37, 0xCD07, 0x9457, 0xA367,
+	0x8F56, 0xB866, 0xE136, 0xD606, 0x5396, 0x64A6, 0x3DF6, 0x0AC6,
+	0x6594, 0x52A4, 0x0BF4, 0x3CC4, 0xB954, 0x8E64, 0xD734, 0xE004,
+	0xCC35, 0xFB05, 0xA255, 0x9565, 0x10F5, 0x27C5, 0x7E95, 0x49A5,
+	0xA031, 0x9701, 0xCE51, 0xF961, 0x7CF1, 0x4BC1, 0x1291, 0x25A1,
+	0x0990, 0x3EA0, 0x67F0, 0x50C0, 0xD550, 0xE260, 0xBB30, 0x8C00,
+	0xE352, 0xD462, 0x8D32, 0xBA02, 0x3F92, 0x08A2, 0x51F2, 0x66C2,
+	0x4AF3, 0x7DC3, 0x2493, 0x13A3, 0x9633, 0xA103, 0xF853, 0xCF63,
+	0x0000, 0x76B4, 0xED68, 0x9BDC, 0xCAF1, 0xBC45, 0x2799, 0x512D,
+	0x85C3, 0xF377, 0x68AB, 0x1E1F, 0x4F32, 0x3986, 0xA25A, 0xD4EE,
+	0x1BA7, 0x6D13, 0xF6CF, 0x807B, 0xD156, 0xA7E2, 0x3C3E, 0x4A8A,
+	0x9E64, 0xE8D0, 0x730C, 0x05B8, 0x5495, 0x2221, 0xB9FD, 0xCF49,
+	0x374E, 0x41FA, 0xDA26, 0xAC92, 0xFDBF, 0x8B0B, 0x10D7, 0x6663,
+	0xB28D, 0xC439, 0x5FE5, 0x2951, 0x787C, 0x0EC8, 0x9514, 0xE3A0,
+	0x2CE9, 0x5A5D, 0xC181, 0xB735, 0xE618, 0x90AC, 0x0B70, 0x7DC4,
+	0xA92A, 0xDF9E, 0x4442, 0x32F6, 0x63DB, 0x156F, 0x8EB3, 0xF807,
+	0x6E9C, 0x1828, 0x83F4, 0xF540, 0xA46D, 0xD2D9, 0x4905, 0x3FB1,
+	0xEB5F, 0x9DEB, 0x0637, 0x7083, 0x21AE, 0x571A, 0xCCC6, 0xBA72,
+	0x753B, 0x038F, 0x9853, 0xEEE7, 0xBFCA, 0xC97E, 0x52A2, 0x2416,
+	0xF0F8, 0x864C, 0x1D90, 0x6B24, 0x3A09, 0x4CBD, 0xD761, 0xA1D5,
+	0x59D2, 0x2F66, 0xB4BA, 0xC20E, 0x9323, 0xE597, 0x7E4B, 0x08FF,
+	0xDC11, 0xAAA5, 0x3179, 0x47CD, 0x16E0, 0x6054, 0xFB88, 0x8D3C,
+	0x4275, 0x34C1, 0xAF1D, 0xD9A9, 0x8884, 0xFE30, 0x65EC, 0x1358,
+	0xC7B6, 0xB102, 0x2ADE, 0x5C6A, 0x0D47, 0x7BF3, 0xE02F, 0x969B,
+	0xDD38, 0xAB8C, 0x3050, 0x46E4, 0x17C9, 0x617D, 0xFAA1, 0x8C15,
+	0x58FB, 0x2E4F, 0xB593, 0xC327, 0x920A, 0xE4BE, 0x7F62, 0x09D6,
+	0xC69F, 0xB02B, 0x2BF7, 0x5D43, 0x0C6E, 0x7ADA, 0xE106, 0x97B2,
+	0x435C, 0x35E8, 0xAE34, 0xD880, 0x89AD, 0xFF19, 0x64C5, 0x1271,
+	0xEA76, 0x9CC2, 0x071E, 0x71AA, 0x2087, 0x5633, 0xCDEF, 0xBB5B,
+	0x6FB5, 0x1901, 0x82DD, 0xF469, 0xA544, 0xD3F0, 0x482C, 0x3E98,
+	0xF1D1, 0x8765, 0x1CB9, 0x6A0D, 0x3B20, 0x4D94, 0xD648, 0xA0FC,
+	0x7412, 0x02A6, 0x997A, 0xEFCE, 0xBEE3, 0xC857, 0x538B, 0x253F,
+	0xB3A4, 0xC510, 0x5ECC, 0x2878, 0x7955, 0x0FE1, 0x943D, 0xE289,
+	0x3667, 0x40D3, 0xDB0F, 0xADBB, 0xFC96, 0x8A22, 0x11FE, 0x674A,
+	0xA803, 0xDEB7, 0x456B, 0x33DF, 0x62F2, 0x1446, 0x8F9A, 0xF92E,
+	0x2DC0, 0x5B74, 0xC0A8, 0xB61C, 0xE731, 0x9185, 0x0A59, 0x7CED,
+	0x84EA, 0xF25E, 0x6982, 0x1F36, 0x4E1B, 0x38AF, 0xA373, 0xD5C7,
+	0x0129, 0x779D, 0xEC41, 0x9AF5, 0xCBD8, 0xBD6C, 0x26B0, 0x5004,
+	0x9F4D, 0xE9F9, 0x7225, 0x0491, 0x55BC, 0x2308, 0xB8D4, 0xCE60,
+	0x1A8E, 0x6C3A, 0xF7E6, 0x8152, 0xD07F, 0xA6CB, 0x3D17, 0x4BA3,
+#if (SNAP_CRC16_TABLE_SIZE == 2048)
+	0x0000, 0xAA51, 0x4483, 0xEED2, 0x8906, 0x2357, 0xCD85, 0x67D4,
+	0x022D, 0xA87C, 0x46AE, 0xECFF, 0x8B2B, 0x217A, 0xCFA8, 0x65F9,
+	0x045A, 0xAE0B, 0x40D9, 0xEA88, 0x8D5C, 0x270D, 0xC9DF, 0x638E,
+	0x0677, 0xAC26, 0x42F4, 0xE8A5, 0x8F71, 0x2520, 0xCBF2, 0x61A3,
+	0x08B4, 0xA2E5, 0x4C37, 0xE666, 0x81B2, 0x2BE3, 0xC531, 0x6F60,
+	0x0A99, 0xA0C8, 0x4E1A, 0xE44B, 0x839F, 0x29CE, 0xC71C, 0x6D4D,
+	0x0CEE, 0xA6BF, 0x486D, 0xE23C, 0x85E8, 0x2FB9, 0xC16B, 0x6B3A,
+	0x0EC3, 0xA492, 0x4A40, 0xE011, 0x87C5, 0x2D94, 0xC346, 0x6917,
+	0x1168, 0xBB39, 0x55EB, 0xFFBA, 0x986E, 0x323F, 0xDCED, 0x76BC,
+	0x1345, 0xB914, 0x57C6, 0xFD97, 0x9A43, 0x3012, 0xDEC0, 0x7491,
+	0x1532, 0xBF63, 0x51B1, 0xFBE0, 0x9C34, 0x3665, 0xD8B7, 0x72E6,
+	0x171F, 0xBD4E, 0x539C, 0xF9CD, 0x9E19, 0x3448, 0xDA9A, 0x70CB,
+	0x19DC, 0xB38D, 0x5D5F, 0xF70E, 0x90DA, 0x3A8B, 0xD459, 0x7E08,
+	0x1BF1, 0xB1A0, 0x5F72, 0xF523, 0x92F7, 0x38A6, 0xD674, 0x7C25,
+	0x1D86, 0xB7D7, 0x5905, 0xF354, 0x9480, 0x3ED1, 0xD003, 0x7A52,
+	0x1FAB, 0xB5FA, 0x5B28, 0xF179, 0x96AD, 0x3CFC, 0xD22E, 0x787F,
+	0x22D0, 0x8881, 0x6653, 0xCC02, 0xABD6, 0x0187, 0xEF55, 0x4504,
+	0x20FD, 0x8AAC, 0x647E, 0xCE2F, 0xA9FB, 0x03AA, 0xED78, 0x4729,
+	0x268A, 0x8CDB, 0x6209, 0xC858, 0xAF8C, 0x05DD, 0xEB0F, 0x415E,
+	0x24A7, 0x8EF6, 0x6024, 0xCA75, 0xADA1, 0x07F0, 0xE922, 0x4373,
+	0x2A64, 0x8035, 0x6EE7, 0xC4B6, 0xA362, 0x0933, 0xE7E1, 0x4DB0,
+	0x2849, 0x8218, 0x6CCA, 0xC69B, 0xA14F, 0x0B1E, 0xE5CC, 0x4F9D,
+	0x2E3E, 0x846F, 0x6ABD, 0xC0EC, 0xA738, 0x0D69, 0xE3BB, 0x49EA,
+	0x2C13, 0x8642, 0x6890, 0xC2C1, 0xA515, 0x0F44, 0xE196, 0x4BC7,
+	0x33B8, 0x99E9, 0x773B, 0xDD6A, 0xBABE, 0x10EF, 0xFE3D, 0x546C,
+	0x3195, 0x9BC4, 0x7516, 0xDF47, 0xB893, 0x12C2, 0xFC10, 0x5641,
+	0x37E2, 0x9DB3, 0x7361, 0xD930, 0xBEE4, 0x14B5, 0xFA67, 0x5036,
+	0x35CF, 0x9F9E, 0x714C, 0xDB1D, 0xBCC9, 0x1698, 0xF84A, 0x521B,
+	0x3B0C, 0x915D, 0x7F8F, 0xD5DE, 0xB20A, 0x185B, 0xF689, 0x5CD8,
+	0x3921, 0x9370, 0x7DA2, 0xD7F3, 0xB027, 0x1A76, 0xF4A4, 0x5EF5,
+	0x3F56, 0x9507, 0x7BD5, 0xD184, 0xB650, 0x1C01, 0xF2D3, 0x5882,
+	0x3D7B, 0x972A, 0x79F8, 0xD3A9, 0xB47D, 0x1E2C, 0xF0FE, 0x5AAF,
+	0x0000, 0x45A0, 0x8B40, 0xCEE0, 0x06A1, 0x4301, 0x8DE1, 0xC841,
+	0x0D42, 0x48E2, 0x8602, 0xC3A2, 0x0BE3, 0x4E43, 0x80A3, 0xC503,
+	0x1A84, 0x5F24, 0x91C4, 0xD464, 0x1C25, 0x5985, 0x9765, 0xD2C5,
+	0x17C6, 0x5266, 0x9C86, 0xD926, 0x1167, 0x54C7, 0x9A27, 0xDF87,
+	0x3508, 0x70A8, 0xBE48, 0xFBE8, 0x33A9, 0x7609, 0xB8E9, 0xFD49,
+	0x384A, 0x7DEA, 0xB30A, 0xF6AA, 0x3EEB, 0x7B4B, 0xB5AB, 0xF00B,
+	0x2F8C, 0x6A2C, 0xA4CC, 0xE16C, 0x292D, 0x6C8D, 0xA26D, 0xE7CD,
+	0x22CE, 0x676E, 0xA98E, 0xEC2E, 0x246F, 0x61CF, 0xAF2F, 0xEA8F,
+	0x6A10, 0x2FB0, 0xE150, 0xA4F0, 0x6CB1, 0x2911, 0xE7F1, 0xA251,
+	0x6752, 0x22F2, 0xEC12, 0xA9B2, 0x61F3, 0x2453, 0xEAB3, 0xAF13,
+	0x7094, 0x3534, 0xFBD4, 0xBE74, 0x7635, 0x3395, 0xFD75, 0xB8D5,
+	0x7DD6, 0x3876, 0xF696, 0xB336, 0x7B77, 0x3ED7, 0xF037, 0xB597,
+	0x5F18, 0x1AB8, 0xD458, 0x91F8, 0x59B9, 0x1C19, 0xD2F9, 0x9759,
+	0x525A, 0x17FA, 0xD91A, 0x9CBA, 0x54FB, 0x115B, 0xDFBB, 0x9A1B,
+	0x459C, 0x003C, 0xCEDC, 0x8B7C, 0x433D, 0x069D, 0xC87D, 0x8DDD,
+	0x48DE, 0x0D7E, 0xC39E, 0x863E, 0x4E7F, 0x0BDF, 0xC53F, 0x809F,
+	0xD420, 0x9180, 0x5F60, 0x1AC0, 0xD281, 0x9721, 0x59C1, 0x1C61,
+	0xD962, 0x9CC2, 0x5222, 0x1782, 0xDFC3, 0x9A63, 0x5483, 0x1123,
+	0xCEA4, 0x8B04, 0x45E4, 0x0044, 0xC805, 0x8DA5, 0x4345, 0x06E5,
+	0xC3E6, 0x8646, 0x48A6, 0x0D06, 0xC547, 0x80E7, 0x4E07, 0x0BA7,
+	0xE128, 0xA488, 0x6A68, 0x2FC8, 0xE789, 0xA229, 0x6CC9, 0x2969,
+	0xEC6A, 0xA9CA, 0x672A, 0x228A, 0xEACB, 0xAF6B, 0x618B, 0x242B,
+	0xFBAC, 0xBE0C, 0x70EC, 0x354C, 0xFD0D, 0xB8AD, 0x764D, 0x33ED,
+	0xF6EE, 0xB34E, 0x7DAE, 0x380E, 0xF04F, 0xB5EF, 0x7B0F, 0x3EAF,
+	0xBE30, 0xFB90, 0x3570, 0x70D0, 0xB891, 0xFD31, 0x33D1, 0x7671,
+	0xB372, 0xF6D2, 0x3832, 0x7D92, 0xB5D3, 0xF073, 0x3E93, 0x7B33,
+	0xA4B4, 0xE114, 0x2FF4, 0x6A54, 0xA215, 0xE7B5, 0x2955, 0x6CF5,
+	0xA9F6, 0xEC56, 0x22B6, 0x6716, 0xAF57, 0xEAF7, 0x2417, 0x61B7,
+	0x8B38, 0xCE98, 0x0078, 0x45D8, 0x8D99, 0xC839, 0x06D9, 0x4379,
+	0x867A, 0xC3DA, 0x0D3A, 0x489A, 0x80DB, 0xC57B, 0x0B9B, 0x4E3B,
+	0x91BC, 0xD41C, 0x1AFC, 0x5F5C, 0x971D, 0xD2BD, 0x1C5D, 0x59FD,
+	0x9CFE, 0xD95E, 0x17BE, 0x521E, 0x9A5F, 0xDFFF, 0x111F, 0x54BF,
+	0x0000, 0xB861, 0x60E3, 0xD882, 0xC1C6, 0x79A7, 0xA125, 0x1944,
+	0x93AD, 0x2BCC, 0xF34E, 0x4B2F, 0x526B, 0xEA0A, 0x3288, 0x8AE9,
+	0x377B, 0x8F1A, 0x5798, 0xEFF9, 0xF6BD, 0x4EDC, 0x965E, 0x2E3F,
+	0xA4D6, 0x1CB7, 0xC435, 0x7C54, 0x6510, 0xDD71, 0x05F3, 0xBD92,
+	0x6EF6, 0xD697, 0x0E15, 0xB674, 0xAF30, 0x1751, 0xCFD3, 0x77B2,
+	0xFD5B, 0x453A, 0x9DB8, 0x25D9, 0x3C9D, 0x84FC, 0x5C7E, 0xE41F,
+	0x598D, 0xE1EC, 0x396E, 0x810F, 0x984B, 0x202A, 0xF8A8, 0x40C9,
+	0xCA20, 0x7241, 0xAAC3, 0x12A2, 0x0BE6, 0xB387, 0x6B05, 0xD364,
+	0xDDEC, 0x658D, 0xBD0F, 0x056E, 0x1C2A, 0xA44B, 0x7CC9, 0xC4A8,
+	0x4E41, 0xF620, 0x2EA2, 0x96C3, 0x8F87, 0x37E6, 0xEF64, 0x5705,
+	0xEA97, 0x52F6, 0x8A74, 0x3215, 0x2B51, 0x9330, 0x4BB2, 0xF3D3,
+	0x793A, 0xC15B, 0x19D9, 0xA1B8, 0xB8FC, 0x009D, 0xD81F, 0x607E,
+	0xB31A, 0x0B7B, 0xD3F9, 0x6B98, 0x72DC, 0xCABD, 0x123F, 0xAA5E,
+	0x20B7, 0x98D6, 0x4054, 0xF835, 0xE171, 0x5910, 0x8192, 0x39F3,
+	0x8461, 0x3C00, 0xE482, 0x5CE3, 0x45A7, 0xFDC6, 0x2544, 0x9D25,
+	0x17CC, 0xAFAD, 0x772F, 0xCF4E, 0xD60A, 0x6E6B, 0xB6E9, 0x0E88,
+	0xABF9, 0x1398, 0xCB1A, 0x737B, 0x6A3F, 0xD25E, 0x0ADC, 0xB2BD,
+	0x3854, 0x8035, 0x58B7, 0xE0D6, 0xF992, 0x41F3, 0x9971, 0x2110,
+	0x9C82, 0x24E3, 0xFC61, 0x4400, 0x5D44, 0xE525, 0x3DA7, 0x85C6,
+	0x0F2F, 0xB74E, 0x6FCC, 0xD7AD, 0xCEE9, 0x7688, 0xAE0A, 0x166B,
+	0xC50F, 0x7D6E, 0xA5EC, 0x1D8D, 0x04C9, 0xBCA8, 0x642A, 0xDC4B,
+	0x56A2, 0xEEC3, 0x3641, 0x8E20, 0x9764, 0x2F05, 0xF787, 0x4FE6,
+	0xF274, 0x4A15, 0x9297, 0x2AF6, 0x33B2, 0x8BD3, 0x5351, 0xEB30,
+	0x61D9, 0xD9B8, 0x013A, 0xB95B, 0xA01F, 0x187E, 0xC0FC, 0x789D,
+	0x7615, 0xCE74, 0x16F6, 0xAE97, 0xB7D3, 0x0FB2, 0xD730, 0x6F51,
+	0xE5B8, 0x5DD9, 0x855B, 0x3D3A, 0x247E, 0x9C1F, 0x449D, 0xFCFC,
+	0x416E, 0xF90F, 0x218D, 0x99EC, 0x80A8, 0x38C9, 0xE04B, 0x582A,
+	0xD2C3, 0x6AA2, 0xB220, 0x0A41, 0x1305, 0xAB64, 0x73E6, 0xCB87,
+	0x18E3, 0xA082, 0x7800, 0xC061, 0xD925, 0x6144, 0xB9C6, 0x01A7,
+	0x8B4E, 0x332F, 0xEBAD, 0x53CC, 0x4A88, 0xF2E9, 0x2A6B, 0x920A,
+	0x2F98, 0x97F9, 0x4F7B, 0xF71A, 0xEE5E, 0x563F, 0x8EBD, 0x36DC,
+	0xBC35, 0x0454, 0xDCD6, 0x64B7, 0x7DF3, 0xC592, 0x1D10, 0xA571,
+	0x0000, 0x47D3, 0x8FA6, 0xC875, 0x0F6D, 0x48BE, 0x80CB, 0xC718,
+	0x1EDA, 0x5909, 0x917C, 0xD6AF, 0x11B7, 0x5664, 0x9E11, 0xD9C2,
+	0x3DB4, 0x7A67, 0xB212, 0xF5C1, 0x32D9, 0x750A, 0xBD7F, 0xFAAC,
+	0x236E, 0x64BD, 0xACC8, 0xEB1B, 0x2C03, 0x6BD0, 0xA3A5, 0xE476,
+	0x7B68, 0x3CBB, 0xF4CE, 0xB31D, 0x7405, 0x33D6, 0xFBA3, 0xBC70,
+	0x65B2, 0x2261, 0xEA14, 0xADC7, 0x6ADF, 0x2D0C, 0xE579, 0xA2AA,
+	0x46DC, 0x010F, 0xC97A, 0x8EA9, 0x49B1, 0x0E62, 0xC617, 0x81C4,
+	0x5806, 0x1FD5, 0xD7A0, 0x9073, 0x576B, 0x10B8, 0xD8CD, 0x9F1E,
+	0xF6D0, 0xB103, 0x7976, 0x3EA5, 0xF9BD, 0xBE6E, 0x761B, 0x31C8,
+	0xE80A, 0xAFD9, 0x67AC, 0x207F, 0xE767, 0xA0B4, 0x68C1, 0x2F12,
+	0xCB64, 0x8CB7, 0x44C2, 0x0311, 0xC409, 0x83DA, 0x4BAF, 0x0C7C,
+	0xD5BE, 0x926D, 0x5A18, 0x1DCB, 0xDAD3, 0x9D00, 0x5575, 0x12A6,
+	0x8DB8, 0xCA6B, 0x021E, 0x45CD, 0x82D5, 0xC506, 0x0D73, 0x4AA0,
+	0x9362, 0xD4B1, 0x1CC4, 0x5B17, 0x9C0F, 0xDBDC, 0x13A9, 0x547A,
+	0xB00C, 0xF7DF, 0x3FAA, 0x7879, 0xBF61, 0xF8B2, 0x30C7, 0x7714,
+	0xAED6, 0xE905, 0x2170, 0x66A3, 0xA1BB, 0xE668, 0x2E1D, 0x69CE,
+	0xFD81, 0xBA52, 0x7227, 0x35F4, 0xF2EC, 0xB53F, 0x7D4A, 0x3A99,
+	0xE35B, 0xA488, 0x6CFD, 0x2B2E, 0xEC36, 0xABE5, 0x6390, 0x2443,
+	0xC035, 0x87E6, 0x4F93, 0x0840, 0xCF58, 0x888B, 0x40FE, 0x072D,
+	0xDEEF, 0x993C, 0x5149, 0x169A, 0xD182, 0x9651, 0x5E24, 0x19F7,
+	0x86E9, 0xC13A, 0x094F, 0x4E9C, 0x8984, 0xCE57, 0x0622, 0x41F1,
+	0x9833, 0xDFE0, 0x1795, 0x5046, 0x975E, 0xD08D, 0x18F8, 0x5F2B,
+	0xBB5D, 0xFC8E, 0x34FB, 0x7328, 0xB430, 0xF3E3, 0x3B96, 0x7C45,
+	0xA587, 0xE254, 0x2A21, 0x6DF2, 0xAAEA, 0xED39, 0x254C, 0x629F,
+	0x0B51, 0x4C82, 0x84F7, 0xC324, 0x043C, 0x43EF, 0x8B9A, 0xCC49,
+	0x158B, 0x5258, 0x9A2D, 0xDDFE, 0x1AE6, 0x5D35, 0x9540, 0xD293,
+	0x36E5, 0x7136, 0xB943, 0xFE90, 0x3988, 0x7E5B, 0xB62E, 0xF1FD,
+	0x283F, 0x6FEC, 0xA799, 0xE04A, 0x2752, 0x6081, 0xA8F4, 0xEF27,
+	0x7039, 0x37EA, 0xFF9F, 0xB84C, 0x7F54, 0x3887, 0xF0F2, 0xB721,
+	0x6EE3, 0x2930, 0xE145, 0xA696, 0x618E, 0x265D, 0xEE28, 0xA9FB,
+	0x4D8D, 0x0A5E, 0xC22B, 0x85F8, 0x42E0, 0x0533, 0xCD46, 0x8A95,
+	0x5357, 0x1484, 0xDCF1, 0x9B22, 0x5C3A, 0x1BE9, 0xD39C, 0x944F,
+#endif
+};
+
+#endif	// SNAP_CRC16_TABLE_SIZE
+
+#if (SNAP_CRC32_TABLE_SIZE == 16)
+
+static const uint32_t tableCrc32[16] SNAP_FLASH =
+{
+	0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4,
+	0x4DB26158, 0x5005713C, 0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+	0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+};
+
+#elif (SNAP_CRC32_TABLE_SIZE == 256)
+
+static const uint32_t tableCrc32[256] SNAP_FLASH =
+{
+	0x00000000, 0x77073096, 0xEE0E612C, 0x990951BA, 0x076DC419, 0x706AF48F,
+	0xE963A535, 0x9E6495A3, 0x0EDB8832, 0x79DCB8A4, 0xE0D5E91E, 0x97D2D988,
+	0x09B64C2B, 0x7EB17CBD, 0xE7B82D07, 0x90BF1D91, 0x1DB71064, 0x6AB020F2,
+	0xF3B97148, 0x84BE41DE, 0x1ADAD47D, 0x6DDDE4EB, 0xF4D4B551, 0x83D385C7,
+	0x136C9856, 0x646BA8C0, 0xFD62F97A, 0x8A65C9EC, 0x14015C4F, 0x63066CD9,
+	0xFA0F3D63, 0x8D080DF5, 0x3B6E20C8, 0x4C69105E, 0xD56041E4, 0xA2677172,
+	0x3C03E4D1, 0x4B04D447, 0xD20D85FD, 0xA50AB56B, 0x35B5A8FA, 0x42B2986C,
+	0xDBBBC9D6, 0xACBCF940, 0x32D86CE3, 0x45DF5C75, 0xDCD60DCF, 0xABD13D59,
+	0x26D930AC, 0x51DE003A, 0xC8D75180, 0xBFD06116, 0x21B4F4B5, 0x56B3C423,
+	0xCFBA9599, 0xB8BDA50F, 0x2802B89E, 0x5F058808, 0xC60CD9B2, 0xB10BE924,
+	0x2F6F7C87, 0x58684C11, 0xC1611DAB, 0xB6662D3D, 0x76DC4190, 0x01DB7106,
+	0x98D220BC, 0xEFD5102A, 0x71B18589, 0x06B6B51F, 0x9FBFE4A5, 0xE8B8D433,
+	0x7807C9A2, 0x0F00F934, 0x9609A88E, 0xE10E9818, 0x7F6A0DBB, 0x086D3D2D,
+	0x91646C97, 0xE6635C01, 0x6B6B51F4, 0x1C6C6162, 0x856530D8, 0xF262004E,
+	0x6C0695ED, 0x1B01A57B, 0x8208F4C1, 0xF50FC457, 0x65B0D9C6, 0x12B7E950,
+	0x8BBEB8EA, 0xFCB9887C, 0x62DD1DDF, 0x15DA2D49, 0x8CD37CF3, 0xFBD44C65,
+	0x4DB26158, 0x3AB551CE, 0xA3BC0074, 0xD4BB30E2, 0x4ADFA541, 0x3DD895D7,
+	0xA4D1C46D, 0xD3D6F4FB, 0x4369E96A, 0x346ED9FC, 0xAD678846, 0xDA60B8D0,
+	0x44042D73, 0x33031DE5, 0xAA0A4C5F, 0xDD0D7CC9, 0x5005713C, 0x270241AA,
+	0xBE0B1010, 0xC90C2086, 0x5768B525, 0x206F85B3, 0xB966D409, 0xCE61E49F,
+	0x5EDEF90E, 0x29D9C998, 0xB0D09822, 0xC7D7A8B4, 0x59B33D17, 0x2EB40D81,
+	0xB7BD5C3B, 0xC0BA6CAD, 0xEDB88320, 0x9ABFB3B6, 0x03B6E20C, 0x74B1D29A,
+	0xEAD54739, 0x9DD277AF, 0x04DB2615, 0x73DC1683, 0xE3630B12, 0x94643B84,
+	0x0D6D6A3E, 0x7A6A5AA8, 0xE40ECF0B, 0x9309FF9D, 0x0A00AE27, 0x7D079EB1,
+	0xF00F9344, 0x8708A3D2, 0x1E01F268, 0x6906C2FE, 0xF762575D, 0x806567CB,
+	0x196C3671, 0x6E6B06E7, 0xFED41B76, 0x89D32BE0, 0x10DA7A5A, 0x67DD4ACC,
+	0xF9B9DF6F, 0x8EBEEFF9, 0x17B7BE43, 0x60B08ED5, 0xD6D6A3E8, 0xA1D1937E,
+	0x38D8C2C4, 0x4FDFF252, 0xD1BB67F1, 0xA6BC5767, 0x3FB506DD, 0x48B2364B,
+	0xD80D2BDA, 0xAF0A1B4C, 0x36034AF6, 0x41047A60, 0xDF60EFC3, 0xA867DF55,
+	0x316E8EEF, 0x4669BE79, 0xCB61B38C, 0xBC66831A, 0x256FD2A0, 0x5268E236,
+	0xCC0C7795, 0xBB0B4703, 0x220216B9, 0x5505262F, 0xC5BA3BBE, 0xB2BD0B28,
+	0x2BB45A92, 0x5CB36A04, 0xC2D7FFA7, 0xB5D0CF31, 0x2CD99E8B, 0x5BDEAE1D,
+	0x9B64C2B0, 0xEC63F226, 0x756AA39C, 0x026D930A, 0x9C0906A9, 0xEB0E363F,
+	0x72076785, 0x05005713, 0x95BF4A82, 0xE2B87A14, 0x7BB12BAE, 0x0CB61B38,
+	0x92D28E9B, 0xE5D5BE0D, 0x7CDCEFB7, 0x0BDBDF21, 0x86D3D2D4, 0xF1D4E242,
+	0x68DDB3F8, 0x1FDA836E, 0x81BE16CD, 0xF6B9265B, 0x6FB077E1, 0x18B74777,
+	0x88085AE6, 0xFF0F6A70, 0x66063BCA, 0x11010B5C, 0x8F659EFF, 0xF862AE69,
+	0x616BFFD3, 0x166CCF45, 0xA00AE278, 0xD70DD2EE, 0x4E048354, 0x3903B3C2,
+	0xA7672661, 0xD06016F7, 0x4969474D, 0x3E6E77DB, 0xAED16A4A, 0xD9D65ADC,
+	0x40DF0B66, 0x37D83BF0, 0xA9BCAE53, 0xDEBB9EC5, 0x47B2CF7F, 0x30B5FFE9,
+	0xBDBDF21C, 0xCABAC28A, 0x53B39330, 0x24B4A3A6, 0xBAD03605, 0xCDD70693,
+	0x54DE5729, 0x23D967BF, 0xB3667A2E, 0xC4614AB8, 0x5D681B02, 0x2A6F2B94,
+	0xB40BBE37, 0xC30C8EA1, 0x5A05DF1B, 0x2D02EF8D
+};
+
+#elif (SNAP_CRC32_TABLE_SIZE >= 1024)
+
+/*
+ * Entry 256 * k + i is the CRC of the byte i followed by k zero bytes, so the first 256 entries are the byte table.
+ */
+
+static const uint32_t tableCrc32[SNAP_CRC32_TABLE_SIZE] SNAP_FLASH =
+{
+	0x00000000, 0x77073096, 0xEE0E612C, 0x990951BA, 0x076DC419, 0x706AF48F, 0xE963A535, 0x9E6495A3,
+	0x0EDB8832, 0x79DCB8A4, 0xE0D5E91E, 0x97D2D988, 0x09B64C2B, 0x7EB17CBD, 0xE7B82D07, 0x90BF1D91,
+	0x1DB71064, 0x6AB020F2, 0xF3B97148, 0x84BE41DE, 0x1ADAD47D, 0x6DDDE4EB, 0xF4D4B551, 0x83D385C7,
+	0x136C9856, 0x646BA8C0, 0xFD62F97A, 0x8A65C9EC, 0x14015C4F, 0x63066CD9, 0xFA0F3D63, 0x8D080DF5,
+	0x3B6E20C8, 0x4C69105E, 0xD56041E4, 0xA2677172, 0x3C03E4D1, 0x4B04D447, 0xD20D85FD, 0xA50AB56B,
+	0x35B5A8FA, 0x42B2986C, 0xDBBBC9D6, 0xACBCF940, 0x32D86CE3, 0x45DF5C75, 0xDCD60DCF, 0xABD13D59,
+	0x26D930AC, 0x51DE003A, 0xC8D75180, 0xBFD06116, 0x21B4F4B5, 0x56B3C423, 0xCFBA9599, 0xB8BDA50F,
+	0x2802B89E, 0x5F058808, 0xC60CD9B2, 0xB10BE924, 0x2F6F7C87, 0x58684C11, 0xC1611DAB, 0xB6662D3D,
+	0x76DC4190, 0x01DB7106, 0x98D220BC, 0xEFD5102A, 0x71B18589, 0x06B6B51F, 0x9FBFE4A5, 0xE8B8D433,
+	0x7807C9A2, 0x0F00F934, 0x9609A88E, 0xE10E9818, 0x7F6A0DBB, 0x086D3D2D, 0x91646C97, 0xE6635C01,
+	0x6B6B51F4, 0x1C6C6162, 0x856530D8, 0xF262004E, 0x6C0695ED, 0x1B01A57B, 0x8208F4C1, 0xF50FC457,
+	0x65B0D9C6, 0x12B7E950, 0x8BBEB8EA, 0xFCB9887C, 0x62DD1DDF, 0x15DA2D49, 0x8CD37CF3, 0xFBD44C65,
+	0x4DB26158, 0x3AB551CE, 0xA3BC0074, 0xD4BB30E2, 0x4ADFA541, 0x3DD895D7, 0xA4D1C46D, 0xD3D6F4FB,
+	0x4369E96A, 0x346ED9FC, 0xAD678846, 0xDA60B8D0, 0x44042D73, 0x33031DE5, 0xAA0A4C5F, 0xDD0D7CC9,
+	0x5005713C, 0x270241AA, 0xBE0B1010, 0xC90C2086, 0x5768B525, 0x206F85B3, 0xB966D409, 0xCE61E49F,
+	0x5EDEF90E, 0x29D9C998, 0xB0D09822, 0xC7D7A8B4, 0x59B33D17, 0x2EB40D81, 0xB7BD5C3B, 0xC0BA6CAD,
+	0xEDB88320, 0x9ABFB3B6, 0x03B6E20C, 0x74B1D29A, 0xEAD54739, 0x9DD277AF, 0x04DB2615, 0x73DC1683,
+	0xE3630B12, 0x94643B84, 0x0D6D6A3E, 0x7A6A5AA8, 0xE40ECF0B, 0x9309FF9D, 0x0A00AE27, 0x7D079EB1,
+	0xF00F9344, 0x8708A3D2, 0x1E01F268, 0x6906C2FE, 0xF762575D, 0x806567CB, 0x196C3671, 0x6E6B06E7,
+	0xFED41B76, 0x89D32BE0, 0x10DA7A5A, 0x67DD4ACC, 0xF9B9DF6F, 0x8EBEEFF9, 0x17B7BE43, 0x60B08ED5,
+	0xD6D6A3E8, 0xA1D1937E, 0x38D8C2C4, 0x4FDFF252, 0xD1BB67F1, 0xA6BC5767, 0x3FB506DD, 0x48B2364B,
+	0xD80D2BDA, 0xAF0A1B4C, 0x36034AF6, 0x41047A60, 0xDF60EFC3, 0xA867DF55, 0x316E8EEF, 0x4669BE79,
+	0xCB61B38C, 0xBC66831A, 0x256FD2A0, 0x5268E236, 0xCC0C7795, 0xBB0B4703, 0x220216B9, 0x5505262F,
+	0xC5BA3BBE, 0xB2BD0B28, 0x2BB45A92, 0x5CB36A04, 0xC2D7FFA7, 0xB5D0CF31, 0x2CD99E8B, 0x5BDEAE1D,
+	0x9B64C2B0, 0xEC63F226, 0x756AA39C, 0x026D930A, 0x9C0906A9, 0xEB0E363F, 0x72076785, 0x05005713,
+	0x95BF4A82, 0xE2B87A14, 0x7BB12BAE, 0x0CB61B38, 0x92D28E9B, 0xE5D5BE0D, 0x7CDCEFB7, 0x0BDBDF21,
+	0x86D3D2D4, 0xF1D4E242, 0x68DDB3F8, 0x1FDA836E, 0x81BE16CD, 0xF6B9265B, 0x6FB077E1, 0x18B74777,
+	0x88085AE6, 0xFF0F6A70, 0x66063BCA, 0x11010B5C, 0x8F659EFF, 0xF862AE69, 0x616BFFD3, 0x166CCF45,
+	0xA00AE278, 0xD70DD2EE, 0x4E048354, 0x3903B3C2, 0xA7672661, 0xD06016F7, 0x4969474D, 0x3E6E77DB,
+	0xAED16A4A, 0xD9D65ADC, 0x40DF0B66, 0x37D83BF0, 0xA9BCAE53, 0xDEBB9EC5, 0x47B2CF7F, 0x30B5FFE9,
+	0xBDBDF21C, 0xCABAC28A, 0x53B39330, 0x24B4A3A6, 0xBAD03605, 0xCDD70693, 0x54DE5729, 0x23D967BF,
+	0xB3667A2E, 0xC4614AB8, 0x5D681B02, 0x2A6F2B94, 0xB40BBE37, 0xC30C8EA1, 0x5A05DF1B, 0x2D02EF8D,
+	0x00000000, 0x191B3141, 0x32366282, 0x2B2D53C3, 0x646CC504, 0x7D77F445, 0x565AA786, 0x4F4196C7,
+	0xC8D98A08, 0xD1C2BB49, 0xFAEFE88A, 0xE3F4D9CB, 0xACB54F0C, 0xB5AE7E4D, 0x9E832D8E, 0x87981CCF,
+	0x4AC21251, 0x53D92310, 0x78F470D3, 0x61EF4192, 0x2EAED755, 0x37B5E614, 0x1C98B5D7, 0x05838496,
+	0x821B9859, 0x9B00A918, 0xB02DFADB, 0xA936CB9A, 0xE6775D5D, 0xFF6C6C1C, 0xD4413FDF, 0xCD5A0E9E,
+	0x958424A2, 0x8C9F15E3, 0xA7B24620, 0xBEA97761, 0xF1E8E1A6, 0xE8F3D0E7, 0xC3DE8324, 0xDAC5B265,
+	0x5D5DAEAA, 0x44469FEB, 0x6F6BCC28, 0x7670FD69, 0x39316BAE, 0x202A5AEF, 0x0B07092C, 0x121C386D,
+	0xDF4636F3, 0xC65D07B2, 0xED705471, 0xF46B6530, 0xBB2AF3F7, 0xA231C2B6, 0x891C9175, 0x9007A034,
+	0x179FBCFB, 0x0E848DBA, 0x25A9DE79, 0x3CB2EF38, 0x73F379FF, 0x6AE848BE, 0x41C51B7D, 0x58DE2A3C,
+	0xF0794F05, 0xE9627E44, 0xC24F2D87, 0xDB541CC6, 0x94158A01, 0x8D0EBB40, 0xA623E883, 0xBF38D9C2,
+	0x38A0C50D, 0x21BBF44C, 0x0A96A78F, 0x138D96CE, 0x5CCC0009, 0x45D73148, 0x6EFA628B, 0x77E153CA,
+	0xBABB5D54, 0xA3A06C15, 0x888D3FD6, 0x91960E97, 0xDED79850, 0xC7CCA911, 0xECE1FAD2, 0xF5FACB93,
+	0x7262D75C, 0x6B79E61D, 0x4054B5DE, 0x594F849F, 0x160E1258, 0x0F152319, 0x243870DA, 0x3D23419B,
+	0x65FD6BA7, 0x7CE65AE6, 0x57CB0925, 0x4ED03864, 0x0191AEA3, 0x188A9FE2, 0x33A7CC21, 0x2ABCFD60,
+	0xAD24E1AF, 0xB43FD0EE, 0x9F12832D, 0x8609B26C, 0xC94824AB, 0xD05315EA, 0xFB7E4629, 0xE2657768,
+	0x2F3F79F6, 0x362448B7, 0x1D091B74, 0x04122A35, 0x4B53BCF2, 0x52488DB3, 0x7965DE70, 0x607EEF31,
+	0xE7E6F3FE, 0xFEFDC2BF, 0xD5D0917C, 0xCCCBA03D, 0x838A36FA, 0x9A9107BB, 0xB1BC5478, 0xA8A76539,
+	0x3B83984B, 0x2298A90A, 0x09B5FAC9, 0x10AECB88, 0x5FEF5D4F, 0x46F46C0E, 0x6DD93FCD, 0x74C20E8C,
+	0xF35A1243, 0xEA412302, 0xC16C70C1, 0xD8774180, 0x9736D747, 0x8E2DE606, 0xA500B5C5, 0xBC1B8484,
+	0x71418A1A, 0x685ABB5B, 0x4377E898, 0x5A6CD9D9, 0x152D4F1E, 0x0C367E5F, 0x271B2D9C, 0x3E001CDD,
+	0xB9980012, 0xA0833153, 0x8BAE6290, 0x92B553D1, 0xDDF4C516, 0xC4EFF457, 0xEFC2A794, 0xF6D996D5,
+	0xAE07BCE9, 0xB71C8DA8, 0x9C31DE6B, 0x852AEF2A, 0xCA6B79ED, 0xD37048AC, 0xF85D1B6F, 0xE1462A2E,
+	0x66DE36E1, 0x7FC507A0, 0x54E85463, 0x4DF36522, 0x02B2F3E5, 0x1BA9C2A4, 0x30849167, 0x299FA026,
+	0xE4C5AEB8, 0xFDDE9FF9, 0xD6F3CC3A, 0xCFE8FD7B, 0x80A96BBC, 0x99B25AFD, 0xB29F093E, 0xAB84387F,
+	0x2C1C24B0, 0x350715F1, 0x1E2A4632, 0x07317773, 0x4870E1B4, 0x516BD0F5, 0x7A468336, 0x635DB277,
+	0xCBFAD74E, 0xD2E1E60F, 0xF9CCB5CC, 0xE0D7848D, 0xAF96124A, 0xB68D230B, 0x9DA070C8, 0x84BB4189,
+	0x03235D46, 0x1A386C07, 0x31153FC4, 0x280E0E85, 0x674F9842, 0x7E54A903, 0x5579FAC0, 0x4C62CB81,
+	0x8138C51F, 0x9823F45E, 0xB30EA79D, 0xAA1596DC, 0xE554001B, 0xFC4F315A, 0xD7626299, 0xCE7953D8,
+	0x49E14F17, 0x50FA7E56, 0x7BD72D95, 0x62CC1CD4, 0x2D8D8A13, 0x3496BB52, 0x1FBBE891, 0x06A0D9D0,
+	0x5E7EF3EC, 0x4765C2AD, 0x6C48916E, 0x7553A02F, 0x3A1236E8, 0x230907A9, 0x0824546A, 0x113F652B,
+	0x96A779E4, 0x8FBC48A5, 0xA4911B66, 0xBD8A2A27, 0xF2CBBCE0, 0xEBD08DA1, 0xC0FDDE62, 0xD9E6EF23,
+	0x14BCE1BD, 0x0DA7D0FC, 0x268A833F, 0x3F91B27E, 0x70D024B9, 0x69CB15F8, 0x42E6463B, 0x5BFD777A,
+	0xDC656BB5, 0xC57E5AF4, 0xEE530937, 0xF7483876, 0xB809AEB1, 0xA1129FF0, 0x8A3FCC33, 0x9324FD72,
+	0x00000000, 0x01C26A37, 0x0384D46E, 0x0246BE59, 0x0709A8DC, 0x06CBC2EB, 0x048D7CB2, 0x054F1685,
+	0x0E1351B8, 0x0FD13B8F, 0x0D9785D6, 0x0C55EFE1, 0x091AF964, 0x08D89353, 0x0A9E2D0A, 0x0B5C473D,
+	0x1C26A370, 0x1DE4C947, 0x1FA2771E, 0x1E601D29, 0x1B2F0BAC, 0x1AED619B, 0x18ABDFC2, 0x1969B5F5,
+	0x1235F2C8, 0x13F798FF, 0x11B126A6, 0x10734C91, 0x153C5A14, 0x14FE3023, 0x16B88E7A, 0x177AE44D,
+	0x384D46E0, 0x398F2CD7, 0x3BC9928E, 0x3A0BF8B9, 0x3F44EE3C, 0x3E86840B, 0x3CC03A52, 0x3D025065,
+	0x365E1758, 0x379C7D6F, 0x35DAC336, 0x3418A901, 0x3157BF84, 0x3095D5B3, 0x32D36BEA, 0x331101DD,
+	0x246BE590, 0x25A98FA7, 0x27EF31FE, 0x262D5BC9, 0x23624D4C, 0x22A0277B, 0x20E69922, 0x2124F315,
+	0x2A78B428, 0x2BBADE1F, 0x29FC6046, 0x283E0A71, 0x2D711CF4, 0x2CB376C3, 0x2EF5C89A, 0x2F37A2AD,
+	0x709A8DC0, 0x7158E7F7, 0x731E59AE, 0x72DC3399, 0x7793251C, 0x76514F2B, 0x7417F172, 0x75D59B45,
+	0x7E89DC78, 0x7F4BB64F, 0x7D0D0816, 0x7CCF6221, 0x798074A4, 0x78421E93, 0x7A04A0CA, 0x7BC6CAFD,
+	0x6CBC2EB0, 0x6D7E4487, 0x6F38FADE, 0x6EFA90E9, 0x6BB5866C, 0x6A77EC5B, 0x68315202, 0x69F33835,
+	0x62AF7F08, 0x636D153F, 0x612BAB66, 0x60E9C151, 0x65A6D7D4, 0x6464BDE3, 0x662203BA, 0x67E0698D,
+	0x48D7CB20, 0x4915A117, 0x4B531F4E, 0x4A917579, 0x4FDE63FC, 0x4E1C09CB, 0x4C5AB792, 0x4D98DDA5,
+	0x46C49A98, 0x4706F0AF, 0x45404EF6, 0x448224C1, 0x41CD3244, 0x400F5873, 0x4249E62A, 0x438B8C1D,
+	0x54F16850, 0x55330267, 0x5775BC3E, 0x56B7D609, 0x53F8C08C, 0x523AAABB, 0x507C14E2, 0x51BE7ED5,
+	0x5AE239E8, 0x5B2053DF, 0x5966ED86, 0x58A487B1, 0x5DEB9134, 0x5C29FB03, 0x5E6F455A, 0x5FAD2F6D,
+	0xE1351B80, 0xE0F771B7, 0xE2B1CFEE, 0xE373A5D9, 0xE63CB35C, 0xE7FED96B, 0xE5B86732, 0xE47A0D05,
+	0xEF264A38, 0xEEE4200F, 0xECA29E56, 0xED60F461, 0xE82FE2E4, 0xE9ED88D3, 0xEBAB368A, 0xEA695CBD,
+	0xFD13B8F0, 0xFCD1D2C7, 0xFE976C9E, 0xFF5506A9, 0xFA1A102C, 0xFBD87A1B, 0xF99EC442, 0xF85CAE75,
+	0xF300E948, 0xF2C2837F, 0xF0843D26, 0xF1465711, 0xF4094194, 0xF5CB2BA3, 0xF78D95FA, 0xF64FFFCD,
+	0xD9785D60, 0xD8BA3757, 0xDAFC890E, 0xDB3EE339, 0xDE71F5BC, 0xDFB39F8B, 0xDDF521D2, 0xDC374BE5,
+	0xD76B0CD8, 0xD6A966EF, 0xD4EFD8B6, 0xD52DB281, 0xD062A404, 0xD1A0CE33, 0xD3E6706A, 0xD2241A5D,
+	0xC55EFE10, 0xC49C9427, 0xC6DA2A7E, 0xC7184049, 0xC25756CC, 0xC3953CFB, 0xC1D382A2, 0xC011E895,
+	0xCB4DAFA8, 0xCA8FC59F, 0xC8C97BC6, 0xC90B11F1, 0xCC440774, 0xCD866D43, 0xCFC0D31A, 0xCE02B92D,
+	0x91AF9640, 0x906DFC77, 0x922B422E, 0x93E92819, 0x96A63E9C, 0x976454AB, 0x9522EAF2, 0x94E080C5,
+	0x9FBCC7F8, 0x9E7EADCF, 0x9C381396, 0x9DFA79A1, 0x98B56F24, 0x99770513, 0x9B31BB4A, 0x9AF3D17D,
+	0x8D893530, 0x8C4B5F07, 0x8E0DE15E, 0x8FCF8B69, 0x8A809DEC, 0x8B42F7DB, 0x89044982, 0x88C623B5,
+	0x839A6488, 0x82580EBF, 0x801EB0E6, 0x81DCDAD1, 0x8493CC54, 0x8551A663, 0x8717183A, 0x86D5720D,
+	0xA9E2D0A0, 0xA820BA97, 0xAA6604CE, 0xABA46EF9, 0xAEEB787C, 0xAF29124B, 0xAD6FAC12, 0xACADC625,
+	0xA7F18118, 0xA633EB2F, 0xA4755576, 0xA5B73F41, 0xA0F829C4, 0xA13A43F3, 0xA37CFDAA, 0xA2BE979D,
+	0xB5C473D0, 0xB40619E7, 0xB640A7BE, 0xB782CD89, 0xB2CDDB0C, 0xB30FB13B, 0xB1490F62, 0xB08B6555,
+	0xBBD72268, 0xBA15485F, 0xB853F606, 0xB9919C31, 0xBCDE8AB4, 0xBD1CE083, 0xBF5A5EDA, 0xBE9834ED,
+	0x00000000, 0xB8BC6765, 0xAA09C88B, 0x12B5AFEE, 0x8F629757, 0x37DEF032, 0x256B5FDC, 0x9DD738B9,
+	0xC5B428EF, 0x7D084F8A, 0x6FBDE064, 0xD7018701, 0x4AD6BFB8, 0xF26AD8DD, 0xE0DF7733, 0x58631056,
+	0x5019579F, 0xE8A530FA, 0xFA109F14, 0x42ACF871, 0xDF7BC0C8, 0x67C7A7AD, 0x75720843, 0xCDCE6F26,
+	0x95AD7F70, 0x2D111815, 0x3FA4B7FB, 0x8718D09E, 0x1ACFE827, 0xA2738F42, 0xB0C620AC, 0x087A47C9,
+	0xA032AF3E, 0x188EC85B, 0x0A3B67B5, 0xB28700D0, 0x2F503869, 0x97EC5F0C, 0x8559F0E2, 0x3DE59787,
+	0x658687D1, 0xDD3AE0B4, 0xCF8F4F5A, 0x7733283F, 0xEAE41086, 0x525877E3, 0x40EDD80D, 0xF851BF68,
+	0xF02BF8A1, 0x48979FC4, 0x5A22302A, 0xE29E574F, 0x7F496FF6, 0xC7F50893, 0xD540A77D, 0x6DFCC018,
+	0x359FD04E, 0x8D23B72B, 0x9F9618C5, 0x272A7FA0, 0xBAFD4719, 0x0241207C, 0x10F48F92, 0xA848E8F7,
+	0x9B14583D, 0x23A83F58, 0x311D90B6, 0x89A1F7D3, 0x1476CF6A, 0xACCAA80F, 0xBE7F07E1, 0x06C36084,
+	0x5EA070D2, 0xE61C17B7, 0xF4A9B859, 0x4C15DF3C, 0xD1C2E785, 0x697E80E0, 0x7BCB2F0E, 0xC377486B,
+	0xCB0D0FA2, 0x73B168C7, 0x6104C729, 0xD9B8A04C, 0x446F98F5, 0xFCD3FF90, 0xEE66507E, 0x56DA371B,
+	0x0EB9274D, 0xB6054028, 0xA4B0EFC6, 0x1C0C88A3, 0x81DBB01A, 0x3967D77F, 0x2BD27891, 0x936E1FF4,
+	0x3B26F703, 0x839A9066, 0x912F3F88, 0x299358ED, 0xB4446054, 0x0CF80731, 0x1E4DA8DF, 0xA6F1CFBA,
+	0xFE92DFEC, 0x462EB889, 0x549B1767, 0xEC277002, 0x71F048BB, 0xC94C2FDE, 0xDBF98030, 0x6345E755,
+	0x6B3FA09C, 0xD383C7F9, 0xC1366817, 0x798A0F72, 0xE45D37CB, 0x5CE150AE, 0x4E54FF40, 0xF6E89825,
+	0xAE8B8873, 0x1637EF16, 0x048240F8, 0xBC3E279D, 0x21E91F24, 0x99557841, 0x8BE0D7AF, 0x335CB0CA,
+	0xED59B63B, 0x55E5D15E, 0x47507EB0, 0xFFEC19D5, 0x623B216C, 0xDA874609, 0xC832E9E7, 0x708E8E82,
+	0x28ED9ED4, 0x9051F9B1, 0x82E4565F, 0x3A58313A, 0xA78F0983, 0x1F336EE6, 0x0D86C108, 0xB53AA66D,
+	0xBD40E1A4, 0x05FC86C1, 0x1749292F, 0xAFF54E4A, 0x322276F3, 0x8A9E1196, 0x982BBE78, 0x2097D91D,
+	0x78F4C94B, 0xC048AE2E, 0xD2FD01C0, 0x6A4166A5, 0xF7965E1C, 0x4F2A3979, 0x5D9F9697, 0xE523F1F2,
+	0x4D6B1905, 0xF5D77E60, 0xE762D18E, 0x5FDEB6EB, 0xC2098E52, 0x7AB5E937, 0x680046D9, 0xD0BC21BC,
+	0x88DF31EA, 0x3063568F, 0x22D6F961, 0x9A6A9E04, 0x07BDA6BD, 0xBF01C1D8, 0xADB46E36, 0x15080953,
+	0x1D724E9A, 0xA5CE29FF, 0xB77B8611, 0x0FC7E174, 0x9210D9CD, 0x2AACBEA8, 0x38191146, 0x80A57623,
+	0xD8C66675, 0x607A0110, 0x72CFAEFE, 0xCA73C99B, 0x57A4F122, 0xEF189647, 0xFDAD39A9, 0x45115ECC,
+	0x764DEE06, 0xCEF18963, 0xDC44268D, 0x64F841E8, 0xF92F7951, 0x41931E34, 0x5326B1DA, 0xEB9AD6BF,
+	0xB3F9C6E9, 0x0B45A18C, 0x19F00E62, 0xA14C6907, 0x3C9B51BE, 0x842736DB, 0x96929935, 0x2E2EFE50,
+	0x2654B999, 0x9EE8DEFC, 0x8C5D7112, 0x34E11677, 0xA9362ECE, 0x118A49AB, 0x033FE645, 0xBB838120,
+	0xE3E09176, 0x5B5CF613, 0x49E959FD, 0xF1553E98, 0x6C820621, 0xD43E6144, 0xC68BCEAA, 0x7E37A9CF,
+	0xD67F4138, 0x6EC3265D, 0x7C7689B3, 0xC4CAEED6, 0x591DD66F, 0xE1A1B10A, 0xF3141EE4, 0x4BA87981,
+	0x13CB69D7, 0xAB770EB2, 0xB9C2A15C, 0x017EC639, 0x9CA9FE80, 0x241599E5, 0x36A0360B, 0x8E1C516E,
+	0x866616A7, 0x3EDA71C2, 0x2C6FDE2C, 0x94D3B949, 0x090481F0, 0xB1B8E695, 0xA30D497B, 0x1BB12E1E,
+	0x43D23E48, 0xFB6E592D, 0xE9DBF6C3, 0x516791A6, 0xCCB0A91F, 0x740CCE7A, 0x66B96194, 0xDE0506F1,
+#if (SNAP_CRC32_TABLE_SIZE == 2048)
+	0x00000000, 0x3D6029B0, 0x7AC05360, 0x47A07AD0, 0xF580A6C0, 0xC8E08F70, 0x8F40F5A0, 0xB220DC10,
+	0x30704BC1, 0x0D106271, 0x4AB018A1, 0x77D03111, 0xC5F0ED01, 0xF890C4B1, 0xBF30BE61, 0x825097D1,
+	0x60E09782, 0x5D80BE32, 0x1A20C4E2, 0x2740ED52, 0x95603142, 0xA80018F2, 0xEFA06222, 0xD2C04B92,
+	0x5090DC43, 0x6DF0F5F3, 0x2A508F23, 0x1730A693, 0xA5107A83, 0x98705333, 0xDFD029E3, 0xE2B00053,
+	0xC1C12F04, 0xFCA106B4, 0xBB017C64, 0x866155D4, 0x344189C4, 0x0921A074, 0x4E81DAA4, 0x73E1F314,
+	0xF1B164C5, 0xCCD14D75, 0x8B7137A5, 0xB6111E15, 0x0431C205, 0x3951EBB5, 0x7EF19165, 0x4391B8D5,
+	0xA121B886, 0x9C419136, 0xDBE1EBE6, 0xE681C256, 0x54A11E46, 0x69C137F6, 0x2E614D26, 0x13016496,
+	0x9151F347, 0xAC31DAF7, 0xEB91A027, 0xD6F18997, 0x64D15587, 0x59B17C37, 0x1E1106E7, 0x23712F57,
+	0x58F35849, 0x659371F9, 0x22330B29, 0x1F532299, 0xAD73FE89, 0x9013D739, 0xD7B3ADE9, 0xEAD38459,
+	0x68831388, 0x55E33A38, 0x124340E8, 0x2F236958, 0x9D03B548, 0xA0639CF8, 0xE7C3E628, 0xDAA3CF98,
+	0x3813CFCB, 0x0573E67B, 0x42D39CAB, 0x7FB3B51B, 0xCD93690B, 0xF0F340BB, 0xB7533A6B, 0x8A3313DB,
+	0x0863840A, 0x3503ADBA, 0x72A3D76A, 0x4FC3FEDA, 0xFDE322CA, 0xC0830B7A, 0x872371AA, 0xBA43581A,
+	0x9932774D, 0xA4525EFD, 0xE3F2242D, 0xDE920D9D, 0x6CB2D18D, 0x51D2F83D, 0x167282ED, 0x2B12AB5D,
+	0xA9423C8C, 0x9422153C, 0xD3826FEC, 0xEEE2465C, 0x5CC29A4C, 0x61A2B3FC, 0x2602C92C, 0x1B62E09C,
+	0xF9D2E0CF, 0xC4B2C97F, 0x8312B3AF, 0xBE729A1F, 0x0C52460F, 0x31326FBF, 0x7692156F, 0x4BF23CDF,
+	0xC9A2AB0E, 0xF4C282BE, 0xB362F86E, 0x8E02D1DE, 0x3C220DCE, 0x0142247E, 0x46E25EAE, 0x7B82771E,
+	0xB1E6B092, 0x8C869922, 0xCB26E3F2, 0xF646CA42, 0x44661652, 0x79063FE2, 0x3EA64532, 0x03C66C82,
+	0x8196FB53, 0xBCF6D2E3, 0xFB56A833, 0xC6368183, 0x74165D93, 0x49767423, 0x0ED60EF3, 0x33B62743,
+	0xD1062710, 0xEC660EA0, 0xABC67470, 0x96A65DC0, 0x248681D0, 0x19E6A860, 0x5E46D2B0, 0x6326FB00,
+	0xE1766CD1, 0xDC164561, 0x9BB63FB1, 0xA6D61601, 0x14F6CA11, 0x2996E3A1, 0x6E369971, 0x5356B0C1,
+	0x70279F96, 0x4D47B626, 0x0AE7CCF6, 0x3787E546, 0x85A73956, 0xB8C710E6, 0xFF676A36, 0xC2074386,
+	0x4057D457, 0x7D37FDE7, 0x3A978737, 0x07F7AE87, 0xB5D77297, 0x88B75B27, 0xCF1721F7, 0xF2770847,
+	0x10C70814, 0x2DA721A4, 0x6A075B74, 0x576772C4, 0xE547AED4, 0xD8278764, 0x9F87FDB4, 0xA2E7D404,
+	0x20B743D5, 0x1DD76A65, 0x5A7710B5, 0x67173905, 0xD537E515, 0xE857CCA5, 0xAFF7B675, 0x92979FC5,
+	0xE915E8DB, 0xD475C16B, 0x93D5BBBB, 0xAEB5920B, 0x1C954E1B, 0x21F567AB, 0x66551D7B, 0x5B3534CB,
+	0xD965A31A, 0xE4058AAA, 0xA3A5F07A, 0x9EC5D9CA, 0x2CE505DA, 0x11852C6A, 0x562556BA, 0x6B457F0A,
+	0x89F57F59, 0xB49556E9, 0xF3352C39, 0xCE550589, 0x7C75D999, 0x4115F029, 0x06B58AF9, 0x3BD5A349,
+	0xB9853498, 0x84E51D28, 0xC34567F8, 0xFE254E48, 0x4C059258, 0x7165BBE8, 0x36C5C138, 0x0BA5E888,
+	0x28D4C7DF, 0x15B4EE6F, 0x521494BF, 0x6F74BD0F, 0xDD54611F, 0xE03448AF, 0xA794327F, 0x9AF41BCF,
+	0x18A48C1E, 0x25C4A5AE, 0x6264DF7E, 0x5F04F6CE, 0xED242ADE, 0xD044036E, 0x97E479BE, 0xAA84500E,
+	0x4834505D, 0x755479ED, 0x32F4033D, 0x0F942A8D, 0xBDB4F69D, 0x80D4DF2D, 0xC774A5FD, 0xFA148C4D,
+	0x78441B9C, 0x4524322C, 0x028448FC, 0x3FE4614C, 0x8DC4BD5C, 0xB0A494EC, 0xF704EE3C, 0xCA64C78C,
+	0x00000000, 0xCB5CD3A5, 0x4DC8A10B, 0x869472AE, 0x9B914216, 0x50CD91B3, 0xD659E31D, 0x1D0530B8,
+	0xEC53826D, 0x270F51C8, 0xA19B2366, 0x6AC7F0C3, 0x77C2C07B, 0xBC9E13DE, 0x3A0A6170, 0xF156B2D5,
+	0x03D6029B, 0xC88AD13E, 0x4E1EA390, 0x85427035, 0x9847408D, 0x531B9328, 0xD58FE186, 0x1ED33223,
+	0xEF8580F6, 0x24D95353, 0xA24D21FD, 0x6911F258, 0x7414C2E0, 0xBF481145, 0x39DC63EB, 0xF280B04E,
+	0x07AC0536, 0xCCF0D693, 0x4A64A43D, 0x81387798, 0x9C3D4720, 0x57619485, 0xD1F5E62B, 0x1AA9358E,
+	0xEBFF875B, 0x20A354FE, 0xA6372650, 0x6D6BF5F5, 0x706EC54D, 0xBB3216E8, 0x3DA66446, 0xF6FAB7E3,
+	0x047A07AD, 0xCF26D408, 0x49B2A6A6, 0x82EE7503, 0x9FEB45BB, 0x54B7961E, 0xD223E4B0, 0x197F3715,
+	0xE82985C0, 0x23755665, 0xA5E124CB, 0x6EBDF76E, 0x73B8C7D6, 0xB8E41473, 0x3E7066DD, 0xF52CB578,
+	0x0F580A6C, 0xC404D9C9, 0x4290AB67, 0x89CC78C2, 0x94C9487A, 0x5F959BDF, 0xD901E971, 0x125D3AD4,
+	0xE30B8801, 0x28575BA4, 0xAEC3290A, 0x659FFAAF, 0x789ACA17, 0xB3C619B2, 0x35526B1C, 0xFE0EB8B9,
+	0x0C8E08F7, 0xC7D2DB52, 0x4146A9FC, 0x8A1A7A59, 0x971F4AE1, 0x5C439944, 0xDAD7EBEA, 0x118B384F,
+	0xE0DD8A9A, 0x2B81593F, 0xAD152B91, 0x6649F834, 0x7B4CC88C, 0xB0101B29, 0x36846987, 0xFDD8BA22,
+	0x08F40F5A, 0xC3A8DCFF, 0x453CAE51, 0x8E607DF4, 0x93654D4C, 0x58399EE9, 0xDEADEC47, 0x15F13FE2,
+	0xE4A78D37, 0x2FFB5E92, 0xA96F2C3C, 0x6233FF99, 0x7F36CF21, 0xB46A1C84, 0x32FE6E2A, 0xF9A2BD8F,
+	0x0B220DC1, 0xC07EDE64, 0x46EAACCA, 0x8DB67F6F, 0x90B34FD7, 0x5BEF9C72, 0xDD7BEEDC, 0x16273D79,
+	0xE7718FAC, 0x2C2D5C09, 0xAAB92EA7, 0x61E5FD02, 0x7CE0CDBA, 0xB7BC1E1F, 0x31286CB1, 0xFA74BF14,
+	0x1EB014D8, 0xD5ECC77D, 0x5378B5D3, 0x98246676, 0x852156CE, 0x4E7D856B, 0xC8E9F7C5, 0x03B52460,
+	0xF2E396B5, 0x39BF4510, 0xBF2B37BE, 0x7477E41B, 0x6972D4A3, 0xA22E0706, 0x24BA75A8, 0xEFE6A60D,
+	0x1D661643, 0xD63AC5E6, 0x50AEB748, 0x9BF264ED, 0x86F75455, 0x4DAB87F0, 0xCB3FF55E, 0x006326FB,
+	0xF135942E, 0x3A69478B, 0xBCFD3525, 0x77A1E680, 0x6AA4D638, 0xA1F8059D, 0x276C7733, 0xEC30A496,
+	0x191C11EE, 0xD240C24B, 0x54D4B0E5, 0x9F886340, 0x828D53F8, 0x49D1805D, 0xCF45F2F3, 0x04192156,
+	0xF54F9383, 0x3E134026, 0xB8873288, 0x73DBE12D, 0x6EDED195, 0xA5820230, 0x2316709E, 0xE84AA33B,
+	0x1ACA1375, 0xD196C0D0, 0x5702B27E, 0x9C5E61DB, 0x815B5163, 0x4A0782C6, 0xCC93F068, 0x07CF23CD,
+	0xF6999118, 0x3DC542BD, 0xBB513013, 0x700DE3B6, 0x6D08D30E, 0xA65400AB, 0x20C07205, 0xEB9CA1A0,
+	0x11E81EB4, 0xDAB4CD11, 0x5C20BFBF, 0x977C6C1A, 0x8A795CA2, 0x41258F07, 0xC7B1FDA9, 0x0CED2E0C,
+	0xFDBB9CD9, 0x36E74F7C, 0xB0733DD2, 0x7B2FEE77, 0x662ADECF, 0xAD760D6A, 0x2BE27FC4, 0xE0BEAC61,
+	0x123E1C2F, 0xD962CF8A, 0x5FF6BD24, 0x94AA6E81, 0x89AF5E39, 0x42F38D9C, 0xC467FF32, 0x0F3B2C97,
+	0xFE6D9E42, 0x35314DE7, 0xB3A53F49, 0x78F9ECEC, 0x65FCDC54, 0xAEA00FF1, 0x28347D5F, 0xE368AEFA,
+	0x16441B82, 0xDD18C827, 0x5B8CBA89, 0x90D0692C, 0x8DD55994, 0x46898A31, 0xC01DF89F, 0x0B412B3A,
+	0xFA1799EF, 0x314B4A4A, 0xB7DF38E4, 0x7C83EB41, 0x6186DBF9, 0xAADA085C, 0x2C4E7AF2, 0xE712A957,
+	0x15921919, 0xDECECABC, 0x585AB812, 0x93066BB7, 0x8E035B0F, 0x455F88AA, 0xC3CBFA04, 0x089729A1,
+	0xF9C19B74, 0x329D48D1, 0xB4093A7F, 0x7F55E9DA, 0x6250D962, 0xA90C0AC7, 0x2F987869, 0xE4C4ABCC,
+	0x00000000, 0xA6770BB4, 0x979F1129, 0x31E81A9D, 0xF44F2413, 0x52382FA7, 0x63D0353A, 0xC5A73E8E,
+	0x33EF4E67, 0x959845D3, 0xA4705F4E, 0x020754FA, 0xC7A06A74, 0x61D761C0, 0x503F7B5D, 0xF64870E9,
+	0x67DE9CCE, 0xC1A9977A, 0xF0418DE7, 0x56368653, 0x9391B8DD, 0x35E6B369, 0x040EA9F4, 0xA279A240,
+	0x5431D2A9, 0xF246D91D, 0xC3AEC380, 0x65D9C834, 0xA07EF6BA, 0x0609FD0E, 0x37E1E793, 0x9196EC27,
+	0xCFBD399C, 0x69CA3228, 0x582228B5, 0xFE552301, 0x3BF21D8F, 0x9D85163B, 0xAC6D0CA6, 0x0A1A0712,
+	0xFC5277FB, 0x5A257C4F, 0x6BCD66D2, 0xCDBA6D66, 0x081D53E8, 0xAE6A585C, 0x9F8242C1, 0x39F54975,
+	0xA863A552, 0x0E14AEE6, 0x3FFCB47B, 0x998BBFCF, 0x5C2C8141, 0xFA5B8AF5, 0xCBB39068, 0x6DC49BDC,
+	0x9B8CEB35, 0x3DFBE081, 0x0C13FA1C, 0xAA64F1A8, 0x6FC3CF26, 0xC9B4C492, 0xF85CDE0F, 0x5E2BD5BB,
+	0x440B7579, 0xE27C7ECD, 0xD3946450, 0x75E36FE4, 0xB044516A, 0x16335ADE, 0x27DB4043, 0x81AC4BF7,
+	0x77E43B1E, 0xD19330AA, 0xE07B2A37, 0x460C2183, 0x83AB1F0D, 0x25DC14B9, 0x14340E24, 0xB2430590,
+	0x23D5E9B7, 0x85A2E203, 0xB44AF89E, 0x123DF32A, 0xD79ACDA4, 0x71EDC610, 0x4005DC8D, 0xE672D739,
+	0x103AA7D0, 0xB64DAC64, 0x87A5B6F9, 0x21D2BD4D, 0xE47583C3, 0x42028877, 0x73EA92EA, 0xD59D995E,
+	0x8BB64CE5, 0x2DC14751, 0x1C295DCC, 0xBA5E5678, 0x7FF968F6, 0xD98E6342, 0xE86679DF, 0x4E11726B,
+	0xB8590282, 0x1E2E0936, 0x2FC613AB, 0x89B1181F, 0x4C162691, 0xEA612D25, 0xDB8937B8, 0x7DFE3C0C,
+	0xEC68D02B, 0x4A1FDB9F, 0x7BF7C102, 0xDD80CAB6, 0x1827F438, 0xBE50FF8C, 0x8FB8E511, 0x29CFEEA5,
+	0xDF879E4C, 0x79F095F8, 0x48188F65, 0xEE6F84D1, 0x2BC8BA5F, 0x8DBFB1EB, 0xBC57AB76, 0x1A20A0C2,
+	0x8816EAF2, 0x2E61E146, 0x1F89FBDB, 0xB9FEF06F, 0x7C59CEE1, 0xDA2EC555, 0xEBC6DFC8, 0x4DB1D47C,
+	0xBBF9A495, 0x1D8EAF21, 0x2C66B5BC, 0x8A11BE08, 0x4FB68086, 0xE9C18B32, 0xD82991AF, 0x7E5E9A1B,
+	0xEFC8763C, 0x49BF7D88, 0x78576715, 0xDE206CA1, 0x1B87522F, 0xBDF0599B, 0x8C184306, 0x2A6F48B2,
+	0xDC27385B, 0x7A5033EF, 0x4BB82972, 0xEDCF22C6, 0x28681C48, 0x8E1F17FC, 0xBFF70D61, 0x198006D5,
+	0x47ABD36E, 0xE1DCD8DA, 0xD034C247, 0x7643C9F3, 0xB3E4F77D, 0x1593FCC9, 0x247BE654, 0x820CEDE0,
+	0x74449D09, 0xD23396BD, 0xE3DB8C20, 0x45AC8794, 0x800BB91A, 0x267CB2AE, 0x1794A833, 0xB1E3A387,
+	0x20754FA0, 0x86024414, 0xB7EA5E89, 0x119D553D, 0xD43A6BB3, 0x724D6007, 0x43A57A9A, 0xE5D2712E,
+	0x139A01C7, 0xB5ED0A73, 0x840510EE, 0x22721B5A, 0xE7D525D4, 0x41A22E60, 0x704A34FD, 0xD63D3F49,
+	0xCC1D9F8B, 0x6A6A943F, 0x5B828EA2, 0xFDF58516, 0x3852BB98, 0x9E25B02C, 0xAFCDAAB1, 0x09BAA105,
+	0xFFF2D1EC, 0x5985DA58, 0x686DC0C5, 0xCE1ACB71, 0x0BBDF5FF, 0xADCAFE4B, 0x9C22E4D6, 0x3A55EF62,
+	0xABC30345, 0x0DB408F1, 0x3C5C126C, 0x9A2B19D8, 0x5F8C2756, 0xF9FB2CE2, 0xC813367F, 0x6E643DCB,
+	0x982C4D22, 0x3E5B4696, 0x0FB35C0B, 0xA9C457BF, 0x6C636931, 0xCA146285, 0xFBFC7818, 0x5D8B73AC,
+	0x03A0A617, 0xA5D7ADA3, 0x943FB73E, 0x3248BC8A, 0xF7EF8204, 0x519889B0, 0x6070932D, 0xC6079899,
+	0x304FE870, 0x9638E3C4, 0xA7D0F959, 0x01A7F2ED, 0xC400CC63, 0x6277C7D7, 0x539FDD4A, 0xF5E8D6FE,
+	0x647E3AD9, 0xC209316D, 0xF3E12BF0, 0x55962044, 0x90311ECA, 0x3646157E, 0x07AE0FE3, 0xA1D90457,
+	0x579174BE, 0xF1E67F0A, 0xC00E6597, 0x66796E23, 0xA3DE50AD, 0x05A95B19, 0x34414184, 0x92364A30,
+	0x00000000, 0xCCAA009E, 0x4225077D, 0x8E8F07E3, 0x844A0EFA, 0x48E00E64, 0xC66F0987, 0x0AC50919,
+	0xD3E51BB5, 0x1F4F1B2B, 0x91C01CC8, 0x5D6A1C56, 0x57AF154F, 0x9B0515D1, 0x158A1232, 0xD92012AC,
+	0x7CBB312B, 0xB01131B5, 0x3E9E3656, 0xF23436C8, 0xF8F13FD1, 0x345B3F4F, 0xBAD438AC, 0x767E3832,
+	0xAF5E2A9E, 0x63F42A00, 0xED7B2DE3, 0x21D12D7D, 0x2B142464, 0xE7BE24FA, 0x69312319, 0xA59B2387,
+	0xF9766256, 0x35DC62C8, 0xBB53652B, 0x77F965B5, 0x7D3C6CAC, 0xB1966C32, 0x3F196BD1, 0xF3B36B4F,
+	0x2A9379E3, 0xE639797D, 0x68B67E9E, 0xA41C7E00, 0xAED97719, 0x62737787, 0xECFC7064, 0x205670FA,
+	0x85CD537D, 0x496753E3, 0xC7E85400, 0x0B42549E, 0x01875D87, 0xCD2D5D19, 0x43A25AFA, 0x8F085A64,
+	0x562848C8, 0x9A824856, 0x140D4FB5, 0xD8A74F2B, 0xD2624632, 0x1EC846AC, 0x9047414F, 0x5CED41D1,
+	0x299DC2ED, 0xE537C273, 0x6BB8C590, 0xA712C50E, 0xADD7CC17, 0x617DCC89, 0xEFF2CB6A, 0x2358CBF4,
+	0xFA78D958, 0x36D2D9C6, 0xB85DDE25, 0x74F7DEBB, 0x7E32D7A2, 0xB298D73C, 0x3C17D0DF, 0xF0BDD041,
+	0x5526F3C6, 0x998CF358, 0x1703F4BB, 0xDBA9F425, 0xD16CFD3C, 0x1DC6FDA2, 0x9349FA41, 0x5FE3FADF,
+	0x86C3E873, 0x4A69E8ED, 0xC4E6EF0E, 0x084CEF90, 0x0289E689, 0xCE23E617, 0x40ACE1F4, 0x8C06E16A,
+	0xD0EBA0BB, 0x1C41A025, 0x92CEA7C6, 0x5E64A758, 0x54A1AE41, 0x980BAEDF, 0x1684A93C, 0xDA2EA9A2,
+	0x030EBB0E, 0xCFA4BB90, 0x412BBC73, 0x8D81BCED, 0x8744B5F4, 0x4BEEB56A, 0xC561B289, 0x09CBB217,
+	0xAC509190, 0x60FA910E, 0xEE7596ED, 0x22DF9673, 0x281A9F6A, 0xE4B09FF4, 0x6A3F9817, 0xA6959889,
+	0x7FB58A25, 0xB31F8ABB, 0x3D908D58, 0xF13A8DC6, 0xFBFF84DF, 0x37558441, 0xB9DA83A2, 0x7570833C,
+	0x533B85DA, 0x9F918544, 0x111E82A7, 0xDDB48239, 0xD7718B20, 0x1BDB8BBE, 0x95548C5D, 0x59FE8CC3,
+	0x80DE9E6F, 0x4C749EF1, 0xC2FB9912, 0x0E51998C, 0x04949095, 0xC83E900B, 0x46B197E8, 0x8A1B9776,
+	0x2F80B4F1, 0xE32AB46F, 0x6DA5B38C, 0xA10FB312, 0xABCABA0B, 0x6760BA95, 0xE9EFBD76, 0x2545BDE8,
+	0xFC65AF44, 0x30CFAFDA, 0xBE40A839, 0x72EAA8A7, 0x782FA1BE, 0xB485A120, 0x3A0AA6C3, 0xF6A0A65D,
+	0xAA4DE78C, 0x66E7E712, 0xE868E0F1, 0x24C2E06F, 0x2E07E976, 0xE2ADE9E8, 0x6C22EE0B, 0xA088EE95,
+	0x79A8FC39, 0xB502FCA7, 0x3B8DFB44, 0xF727FBDA, 0xFDE2F2C3, 0x3148F25D, 0xBFC7F5BE, 0x736DF520,
+	0xD6F6D6A7, 0x1A5CD639, 0x94D3D1DA, 0x5879D144, 0x52BCD85D, 0x9E16D8C3, 0x1099DF20, 0xDC33DFBE,
+	0x0513CD12, 0xC9B9CD8C, 0x4736CA6F, 0x8B9CCAF1, 0x8159C3E8, 0x4DF3C376, 0xC37CC495, 0x0FD6C40B,
+	0x7AA64737, 0xB60C47A9, 0x3883404A, 0xF42940D4, 0xFEEC49CD, 0x32464953, 0xBCC94EB0, 0x70634E2E,
+	0xA9435C82, 0x65E95C1C, 0xEB665BFF, 0x27CC5B61, 0x2D095278, 0xE1A352E6, 0x6F2C5505, 0xA386559B,
+	0x061D761C, 0xCAB77682, 0x44387161, 0x889271FF, 0x825778E6, 0x4EFD7878, 0xC0727F9B, 0x0CD87F05,
+	0xD5F86DA9, 0x19526D37, 0x97DD6AD4, 0x5B776A4A, 0x51B26353, 0x9D1863CD, 0x1397642E, 0xDF3D64B0,
+	0x83D02561, 0x4F7A25FF, 0xC1F5221C, 0x0D5F2282, 0x079A2B9B, 0xCB302B05, 0x45BF2CE6, 0x89152C78,
+	0x50353ED4, 0x9C9F3E4A, 0x121039A9, 0xDEBA3937, 0xD47F302E, 0x18D530B0, 0x965A3753, 0x5AF037CD,
+	0xFF6B144A, 0x33C114D4, 0xBD4E1337, 0x71E413A9, 0x7B211AB0, 0xB78B1A2E, 0x39041DCD, 0xF5AE1D53,
+	0x2C8E0FFF, 0xE0240F61, 0x6EAB0882, 0xA201081C, 0xA8C40105, 0x646E019B, 0xEAE10678, 0x264B06E6,
+#endif
+};
+
+#endif	// SNAP_CRC32_TABLE_SIZE
+
+/*
+ * Powers (exp) and logarithms (log) of GF(256), generated by the primitive polynomial
+ * x^8 + x^4 + x^3 + x^2 + 1 (0x11D) with alpha = 0x02. They are used by the Reed-Solomon code (#SNAP_HDB1_EDM_FEC).
+ */
+
+static const uint8_t tableGfExp[255] SNAP_FLASH =
+{
+	0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1D, 0x3A, 0x74, 0xE8,
+	0xCD, 0x87, 0x13, 0x26, 0x4C, 0x98, 0x2D, 0x5A, 0xB4, 0x75, 0xEA, 0xC9,
+	0x8F, 0x03, 0x06, 0x0C, 0x18, 0x30, 0x60, 0xC0, 0x9D, 0x27, 0x4E, 0x9C,
+	0x25, 0x4A, 0x94, 0x35, 0x6A, 0xD4, 0xB5, 0x77, 0xEE, 0xC1, 0x9F, 0x23,
+	0x46, 0x8C, 0x05, 0x0A, 0x14, 0x28, 0x50, 0xA0, 0x5D, 0xBA, 0x69, 0xD2,
+	0xB9, 0x6F, 0xDE, 0xA1, 0x5F, 0xBE, 0x61, 0xC2, 0x99, 0x2F, 0x5E, 0xBC,
+	0x65, 0xCA, 0x89, 0x0F, 0x1E, 0x3C, 0x78, 0xF0, 0xFD, 0xE7, 0xD3, 0xBB,
+	0x6B, 0xD6, 0xB1, 0x7F, 0xFE, 0xE1, 0xDF, 0xA3, 0x5B, 0xB6, 0x71, 0xE2,
+	0xD9, 0xAF, 0x43, 0x86, 0x11, 0x22, 0x44, 0x88, 0x0D, 0x1A, 0x34, 0x68,
+	0xD0, 0xBD, 0x67, 0xCE, 0x81, 0x1F, 0x3E, 0x7C, 0xF8, 0xED, 0xC7, 0x93,
+	0x3B, 0x76, 0xEC, 0xC5, 0x97, 0x33, 0x66, 0xCC, 0x85, 0x17, 0x2E, 0x5C,
+	0xB8, 0x6D, 0xDA, 0xA9, 0x4F, 0x9E, 0x21, 0x42, 0x84, 0x15, 0x2A, 0x54,
+	0xA8, 0x4D, 0x9A, 0x29, 0x52, 0xA4, 0x55, 0xAA, 0x49, 0x92, 0x39, 0x72,
+	0xE4, 0xD5, 0xB7, 0x73, 0xE6, 0xD1, 0xBF, 0x63, 0xC6, 0x91, 0x3F, 0x7E,
+	0xFC, 0xE5, 0xD7, 0xB3, 0x7B, 0xF6, 0xF1, 0xFF, 0xE3, 0xDB, 0xAB, 0x4B,
+	0x96, 0x31, 0x62, 0xC4, 0x95, 0x37, 0x6E, 0xDC, 0xA5, 0x57, 0xAE, 0x41,
+	0x82, 0x19, 0x32, 0x64, 0xC8, 0x8D, 0x07, 0x0E, 0x1C, 0x38, 0x70, 0xE0,
+	0xDD, 0xA7, 0x53, 0xA6, 0x51, 0xA2, 0x59, 0xB2, 0x79, 0xF2, 0xF9, 0xEF,
+	0xC3, 0x9B, 0x2B, 0x56, 0xAC, 0x45, 0x8A, 0x09, 0x12, 0x24, 0x48, 0x90,
+	0x3D, 0x7A, 0xF4, 0xF5, 0xF7, 0xF3, 0xFB, 0xEB, 0xCB, 0x8B, 0x0B, 0x16,
+	0x2C, 0x58, 0xB0, 0x7D, 0xFA, 0xE9, 0xCF, 0x83, 0x1B, 0x36, 0x6C, 0xD8,
+	0xAD, 0x47, 0x8E
+};
+
+static const uint8_t tableGfLog[256] SNAP_FLASH =
+{
+	0x00, 0x00, 0x01, 0x19, 0x02, 0x32, 0x1A, 0xC6, 0x03, 0xDF, 0x33, 0xEE,
+	0x1B, 0x68, 0xC7, 0x4B, 0x04, 0x64, 0xE0, 0x0E, 0x34, 0x8D, 0xEF, 0x81,
+	0x1C, 0xC1, 0x69, 0xF8, 0xC8, 0x08, 0x4C, 0x71, 0x05, 0x8A, 0x65, 0x2F,
+	0xE1, 0x24, 0x0F, 0x21, 0x35, 0x93, 0x8E, 0xDA, 0xF0, 0x12, 0x82, 0x45,
+	0x1D, 0xB5, 0xC2, 0x7D, 0x6A, 0x27, 0xF9, 0xB9, 0xC9, 0x9A, 0x09, 0x78,
+	0x4D, 0xE4, 0x72, 0xA6, 0x06, 0xBF, 0x8B, 0x62, 0x66, 0xDD, 0x30, 0xFD,
+	0xE2, 0x98, 0x25, 0xB3, 0x10, 0x91, 0x22, 0x88, 0x36, 0xD0, 0x94, 0xCE,
+	0x8F, 0x96, 0xDB, 0xBD, 0xF1, 0xD2, 0x13, 0x5C, 0x83, 0x38, 0x46, 0x40,
+	0x1E, 0x42, 0xB6, 0xA3, 0xC3, 0x48, 0x7E, 0x6E, 0x6B, 0x3A, 0x28, 0x54,
+	0xFA, 0x85, 0xBA, 0x3D, 0xCA, 0x5E, 0x9B, 0x9F, 0x0A, 0x15, 0x79, 0x2B,
+	0x4E, 0xD4, 0xE5, 0xAC, 0x73, 0xF3, 0xA7, 0x57, 0x07, 0x70, 0xC0, 0xF7,
+	0x8C, 0x80, 0x63, 0x0D, 0x67, 0x4A, 0xDE, 0xED, 0x31, 0xC5, 0xFE, 0x18,
+	0xE3, 0xA5, 0x99, 0x77, 0x26, 0xB8, 0xB4, 0x7C, 0x11, 0x44, 0x92, 0xD9,
+	0x23, 0x20, 0x89, 0x2E, 0x37, 0x3F, 0xD1, 0x5B, 0x95, 0xBC, 0xCF, 0xCD,
+	0x90, 0x87, 0x97, 0xB2, 0xDC, 0xFC, 0xBE, 0x61, 0xF2, 0x56, 0xD3, 0xAB,
+	0x14, 0x2A, 0x5D, 0x9E, 0x84, 0x3C, 0x39, 0x53, 0x47, 0x6D, 0x41, 0xA2,
+	0x1F, 0x2D, 0x43, 0xD8, 0xB7, 0x7B, 0xA4, 0x76, 0xC4, 0x17, 0x49, 0xEC,
+	0x7F, 0x0C, 0x6F, 0xF6, 0x6C, 0xA1, 0x3B, 0x52, 0x29, 0x9D, 0x55, 0xAA,
+	0xFB, 0x60, 0x86, 0xB1, 0xBB, 0xCC, 0x3E, 0x5A, 0xCB, 0x59, 0x5F, 0xB0,
+	0x9C, 0xA9, 0xA0, 0x51, 0x0B, 0xF5, 0x16, 0xEB, 0x7A, 0x75, 0x2C, 0xD7,
+	0x4F, 0xAE, 0xD5, 0xE9, 0xE6, 0xE7, 0xAD, 0xE8, 0x74, 0xD6, 0xF4, 0xEA,
+	0xA8, 0x50, 0x58, 0xAF
+};
+
+#if (SNAP_SIZE_FEC_PARITY == 8)
+
+/*
+ * Logarithms of the coefficients of the Reed-Solomon generator polynomial (x - alpha^0)(x - alpha^1)...(x - alpha^7),
+ * highest degree first, without the leading coefficient (1). Other parity sizes calculate them on the first use.
+ */
+
+static const uint8_t tableFecGenerator[SNAP_SIZE_FEC_PARITY] SNAP_FLASH =
+{
+	0xAF, 0xEE, 0xD0, 0xF9, 0xD7, 0xFC, 0xC4, 0x1C
+};
+
+#endif	// SNAP_SIZE_FEC_PARITY
+
+
+/******************************************************************************/
+/*  Private Variables                                                         */
+/******************************************************************************/
+
+
+#ifdef SNAP_CRC_CLMUL
+static bool clmulAvailable = false;	/* Set at startup by snap_detectClmul() */
+#endif
+
+
+/******************************************************************************/
+/*  Private Function Definitions                                              */
+/******************************************************************************/
+
+
+/**
+ * @brief Update an 8-bit CRC (CRC-8/MAXIM-DOW) with one more byte.
+ * @param[in] crc  Current CRC value.
+ * @param[in] byte Next byte of the message.
+ * @return Updated CRC value.
+ */
+static inline uint8_t snap_updateCrc8(uint8_t crc, const uint8_t byte)
+{
+#if (SNAP_CRC8_TABLE_SIZE == 256)
+
+	return SNAP_READ_FLASH_BYTE(&tableCrc8[byte ^ crc]);
+
+#elif (SNAP_CRC8_TABLE_SIZE == 16)
+
+	crc ^= byte;
+	crc = (uint8_t)((crc >> 4) ^ SNAP_READ_FLASH_BYTE(&tableCrc8[crc & 0x0F]));
+	crc = (uint8_t)((crc >> 4) ^ SNAP_READ_FLASH_BYTE(&tableCrc8[crc & 0x0F]));
+	return crc;
+
+#else
+
+	crc ^= byte;
+	for(uint_fast8_t j = 0; j < 8; j++)
+	{
+		crc = (crc & 1) ? ((crc >> 1) ^ 0x8C) : (crc >> 1);
+	}
+	return crc;
+
+#endif
+}
+
+/**
+ * @brief Update a 16-bit CRC (CRC-16/XMODEM) with one more byte.
+ * @param[in] crc  Current CRC value.
+ * @param[in] byte Next byte of the message.
+ * @return Updated CRC value.
+ */
+static inline uint16_t snap_updateCrc16(uint16_t crc, const uint8_t byte)
+{
+#if (SNAP_CRC16_TABLE_SIZE >= 256)
+
+	return (uint16_t)(crc << 8) ^ SNAP_READ_FLASH_WORD(&tableCrc16[(crc >> 8) ^ byte]);
+
+#elif (SNAP_CRC16_TABLE_SIZE == 16)
+
+	crc ^= (uint16_t)(byte << 8);
+	crc = (uint16_t)((crc << 4) ^ SNAP_READ_FLASH_WORD(&tableCrc16[crc >> 12]));
+	crc = (uint16_t)((crc << 4) ^ SNAP_READ_FLASH_WORD(&tableCrc16[crc >> 12]));
+	return crc;
+
+#else
+
+	crc ^= (uint16_t)(byte << 8);
+	for(uint_fast8_t j = 0; j < 8; j++)
+	{
+		crc = (uint16_t)((crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1));
+	}
+	return crc;
+
+#endif
+}
+
+/**
+ * @brief Update a 32-bit CRC (CRC-32/ISO-HDLC) with one more byte. The final XOR is not applied.
+ * @param[in] crc  Current CRC value (not inverted).
+ * @param[in] byte Next byte of the message.
+ * @return Updated CRC value (not inverted).
+ */
+static inline uint32_t snap_updateCrc32(uint32_t crc, const uint8_t byte)
+{
+#if (SNAP_CRC32_TABLE_SIZE >= 256)
+
+	return (crc >> 8) ^ SNAP_READ_FLASH_DWORD(&tableCrc32[(crc ^ byte) & 0xFF]);
+
+#elif (SNAP_CRC32_TABLE_SIZE == 16)
+
+	crc ^= byte;
+	crc = (crc >> 4) ^ SNAP_READ_FLASH_DWORD(&tableCrc32[crc & 0x0F]);
+	crc = (crc >> 4) ^ SNAP_READ_FLASH_DWORD(&tableCrc32[crc & 0x0F]);
+	return crc;
+
+#else
+
+	crc = crc ^ byte;
+	for(uint_fast8_t j = 0; j < 8; j++)
+	{
+		crc = (crc & 1) ? ((crc >> 1) ^ 0xEDB88320) : (crc >> 1);
+	}
+	return crc;
+
+#endif
+}
+
+/**
+ * @brief Update a 16-bit CRC (CRC-16/XMODEM) with a block of bytes, using the lookup tables.
+ * @details With the slicing tables (`SNAP_CRC16_TABLE_SIZE` is 1024 or 2048), 4 or 8 bytes are processed per iteration.
+ * @param[in] crc  Current CRC value.
+ * @param[in] data Pointer to the next bytes of the message.
+ * @param[in] size Number of bytes.
+ * @return Updated CRC value.
+ */
+static uint16_t snap_updateCrc16Table(uint16_t crc, const uint8_t *data, uint_fast16_t size)
+{
+#if (SNAP_CRC16_TABLE_SIZE == 2048)
+
+	for(; size >= 8; size -= 8, data += 8)
+	{
+		crc = SNAP_READ_FLASH_WORD(&tableCrc16[0x700 + (data[0] ^ (crc >> 8))]) ^ SNAP_READ_FLASH_WORD(&tableCrc16[0x600 + (data[1] ^ (crc & 0xFF))]) ^
+		      SNAP_READ_FLASH_WORD(&tableCrc16[0x500 + data[2]]) ^ SNAP_READ_FLASH_WORD(&tableCrc16[0x400 + data[3]]) ^
+		      SNAP_READ_FLASH_WORD(&tableCrc16[0x300 + data[4]]) ^ SNAP_READ_FLASH_WORD(&tableCrc16[0x200 + data[5]]) ^
+		      SNAP_READ_FLASH_WORD(&tableCrc16[0x100 + data[6]]) ^ SNAP_READ_FLASH_WORD(&tableCrc16[data[7]]);
+	}
+
+#endif
+#if (SNAP_CRC16_TABLE_SIZE >= 1024)
+
+	for(; size >= 4; size -= 4, data += 4)
+	{
+		crc = SNAP_READ_FLASH_WORD(&tableCrc16[0x300 + (data[0] ^ (crc >> 8))]) ^ SNAP_READ_FLASH_WORD(&tableCrc16[0x200 + (data[1] ^ (crc & 0xFF))]) ^
+		      SNAP_READ_FLASH_WORD(&tableCrc16[0x100 + data[2]]) ^ SNAP_READ_FLASH_WORD(&tableCrc16[data[3]]);
+	}
+
+#endif
+
+	for(; size != 0; size--)
+	{
+		crc = snap_updateCrc16(crc, *data++);
+	}
+
+	return crc;
+}
+
+/**
+ * @brief Update a 32-bit CRC (CRC-32/ISO-HDLC) with a block of bytes, using the lookup tables. The final XOR is not applied.
+ * @details With the slicing tables (`SNAP_CRC32_TABLE_SIZE` is 1024 or 2048), 4 or 8 bytes are processed per iteration.
+ *          The bytes are combined in little-endian order, so the result does not depend on the endianness of the target.
+ * @param[in] crc  Current CRC value (not inverted).
+ * @param[in] data Pointer to the next bytes of the message.
+ * @param[in] size Number of bytes.
+ * @return Updated CRC value (not inverted).
+ */
+static uint32_t snap_updateCrc32Table(uint32_t crc, const uint8_t *data, uint_fast16_t size)
+{
+#if (SNAP_CRC32_TABLE_SIZE == 2048)
+
+	for(; size >= 8; size -= 8, data += 8)
+	{
+		crc ^= (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+		crc = SNAP_READ_FLASH_DWORD(&tableCrc32[0x700 + (crc & 0xFF)]) ^ SNAP_READ_FLASH_DWORD(&tableCrc32[0x600 + ((crc >> 8) & 0xFF)]) ^
+		      SNAP_READ_FLASH_DWORD(&tableCrc32[0x500 + ((crc >> 16) & 0xFF)]) ^ SNAP_READ_FLASH_DWORD(&tableCrc32[0x400 + (crc >> 24)]) ^
+		      SNAP_READ_FLASH_DWORD(&tableCrc32[0x300 + data[4]]) ^ SNAP_READ_FLASH_DWORD(&tableCrc32[0x200 + data[5]]) ^
+		      SNAP_READ_FLASH_DWORD(&tableCrc32[0x100 + data[6]]) ^ SNAP_READ_FLASH_DWORD(&tableCrc32[data[7]]);
+	}
+
+#endif
+#if (SNAP_CRC32_TABLE_SIZE >= 1024)
+
+	for(; size >= 4; size -= 4, data += 4)
+	{
+		crc ^= (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+		crc = SNAP_READ_FLASH_DWORD(&tableCrc32[0x300 + (crc & 0xFF)]) ^ SNAP_READ_FLASH_DWORD(&tableCrc32[0x200 + ((crc >> 8) & 0xFF)]) ^
+		      SNAP_READ_FLASH_DWORD(&tableCrc32[0x100 + ((crc >> 16) & 0xFF)]) ^ SNAP_READ_FLASH_DWORD(&tableCrc32[crc >> 24]);
+	}
+
+#endif
+
+	for(; size != 0; size--)
+	{
+		crc = snap_updateCrc32(crc, *data++);
+	}
+
+	return crc;
+}
+
+#ifdef SNAP_CRC_CLMUL
+
+/**
+ * @brief Check once, at startup, if the CPU supports the carry-less multiplication (PCLMULQDQ) and byte shuffle (SSSE3) instructions.
+ */
+__attribute__((constructor)) static void snap_detectClmul(void)
+{
+	unsigned int eax, ebx, ecx, edx;
+
+	if(__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+	{
+		clmulAvailable = ((ecx & bit_PCLMUL) != 0) && ((ecx & bit_SSSE3) != 0);
+	}
+}
+
+/**
+ * @brief Fold a 128-bit CRC state forward over 128 bits (or 512 bits) and add the next block.
+ * @param[in] state     Current state.
+ * @param[in] constants Folding constants of the high (upper 64 bits) and low (lower 64 bits) halves of the state.
+ * @param[in] block     Next block of the message.
+ * @return Updated state.
+ */
+__attribute__((target("pclmul,ssse3"))) static inline __m128i snap_foldClmul(const __m128i state, const __m128i constants, const __m128i block)
+{
+	return _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(state, constants, 0x11), _mm_clmulepi64_si128(state, constants, 0x00)), block);
+}
+
+/**
+ * @brief Update a 16-bit CRC (CRC-16/XMODEM) with a block of at least #SNAP_CLMUL_MIN_SIZE bytes, using carry-less multiplications.
+ * @details The message is folded into a 128-bit state (4 states at a time while there are enough bytes), whose value modulo the
+ *          CRC polynomial is the same as the one of the folded bytes. The CRC of the state and the remaining bytes is calculated
+ *          with the tables. The bytes are swapped so that the first bit of the message is the highest bit of the state.
+ *          The constants are x^576, x^512, x^192 and x^128 modulo the polynomial (0x11021).
+ * @param[in] crc  Current CRC value.
+ * @param[in] data Pointer to the next bytes of the message.
+ * @param[in] size Number of bytes.
+ * @return Updated CRC value.
+ */
+__attribute__((target("pclmul,ssse3"))) static uint16_t snap_updateCrc16Clmul(const uint16_t crc, const uint8_t *data, uint_fast16_t size)
+{
+	const __m128i swap = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+	const __m128i fold4 = _mm_set_epi64x(0x8832, 0x13FC);
+	const __m128i fold1 = _mm_set_epi64x(0x650B, 0xAEFC);
+	__m128i state[4];
+	uint8_t bytes[16];
+
+	for(uint_fast8_t i = 0; i < 4; i++)
+	{
+		state[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(const void *)&data[16 * i]), swap);
+	}
+
+	state[0] = _mm_xor_si128(state[0], _mm_set_epi64x((long long)((uint64_t)crc << 48), 0));	// Initial value added to the first 2 bytes
+	data += 64;
+	size -= 64;
+
+	for(; size >= 64; size -= 64, data += 64)
+	{
+		for(uint_fast8_t i = 0; i < 4; i++)
+		{
+			state[i] = snap_foldClmul(state[i], fold4, _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(const void *)&data[16 * i]), swap));
+		}
+	}
+
+	state[0] = snap_foldClmul(state[0], fold1, state[1]);
+	state[0] = snap_foldClmul(state[0], fold1, state[2]);
+	state[0] = snap_foldClmul(state[0], fold1, state[3]);
+
+	for(; size >= 16; size -= 16, data += 16)
+	{
+		state[0] = snap_foldClmul(state[0], fold1, _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(const void *)data), swap));
+	}
+
+	_mm_storeu_si128((__m128i *)(void *)bytes, _mm_shuffle_epi8(state[0], swap));
+
+	return snap_updateCrc16Table(snap_updateCrc16Table(0, bytes, sizeof(bytes)), data, size);
+}
+
+/**
+ * @brief Update a 32-bit CRC (CRC-32/ISO-HDLC) with a block of at least #SNAP_CLMUL_MIN_SIZE bytes, using carry-less multiplications.
+ *        The final XOR is not applied.
+ * @details Same method as snap_updateCrc16Clmul(), in the bit-reflected domain of this CRC (so the bytes are not swapped).
+ *          The constants are the reflected values of x^(512+32), x^(512-32), x^(128+32) and x^(128-32) modulo the polynomial
+ *          (0x104C11DB7), shifted left by 1 bit.
+ * @param[in] crc  Current CRC value (not inverted).
+ * @param[in] data Pointer to the next bytes of the message.
+ * @param[in] size Number of bytes.
+ * @return Updated CRC value (not inverted).
+ */
+__attribute__((target("pclmul,ssse3"))) static uint32_t snap_updateCrc32Clmul(const uint32_t crc, const uint8_t *data, uint_fast16_t size)
+{
+	const __m128i fold4 = _mm_set_epi64x(0x1C6E41596, 0x154442BD4);
+	const __m128i fold1 = _mm_set_epi64x(0x0CCAA009E, 0x1751997D0);
+	__m128i state[4];
+	uint8_t bytes[16];
+
+	for(uint_fast8_t i = 0; i < 4; i++)
+	{
+		state[i] = _mm_loadu_si128((const __m128i *)(const void *)&data[16 * i]);
+	}
+
+	state[0] = _mm_xor_si128(state[0], _mm_cvtsi32_si128((int)crc));	// Initial value added to the first 4 bytes
+	data += 64;
+	size -= 64;
+
+	for(; size >= 64; size -= 64, data += 64)
+	{
+		for(uint_fast8_t i = 0; i < 4; i++)
+		{
+			state[i] = snap_foldClmul(state[i], fold4, _mm_loadu_si128((const __m128i *)(const void *)&data[16 * i]));
+		}
+	}
+
+	state[0] = snap_foldClmul(state[0], fold1, state[1]);
+	state[0] = snap_foldClmul(state[0], fold1, state[2]);
+	state[0] = snap_foldClmul(state[0], fold1, state[3]);
+
+	for(; size >= 16; size -= 16, data += 16)
+	{
+		state[0] = snap_foldClmul(state[0], fold1, _mm_loadu_si128((const __m128i *)(const void *)data));
+	}
+
+	_mm_storeu_si128((__m128i *)(void *)bytes, state[0]);
+
+	return snap_updateCrc32Table(snap_updateCrc32Table(0, bytes, sizeof(bytes)), data, size);
+}
+
+#endif	// SNAP_CRC_CLMUL
+
+/**
+ * @brief Update a 16-bit CRC (CRC-16/XMODEM) with a block of bytes, using the fastest method available.
+ * @param[in] crc  Current CRC value.
+ * @param[in] data Pointer to the next bytes of the message.
+ * @param[in] size Number of bytes.
+ * @return Updated CRC value.
+ */
+static inline uint16_t snap_updateCrc16Block(const uint16_t crc, const uint8_t *data, const uint_fast16_t size)
+{
+#ifdef SNAP_CRC_CLMUL
+	if(clmulAvailable && (size >= SNAP_CLMUL_MIN_SIZE))
+	{
+		return snap_updateCrc16Clmul(crc, data, size);
+	}
+#endif
+
+	return snap_updateCrc16Table(crc, data, size);
+}
+
+/**
+ * @brief Update a 32-bit CRC (CRC-32/ISO-HDLC) with a block of bytes, using the fastest method available. The final XOR is not applied.
+ * @param[in] crc  Current CRC value (not inverted).
+ * @param[in] data Pointer to the next bytes of the message.
+ * @param[in] size Number of bytes.
+ * @return Updated CRC value (not inverted).
+ */
+static inline uint32_t snap_updateCrc32Block(const uint32_t crc, const uint8_t *data, const uint_fast16_t size)
+{
+#ifdef SNAP_CRC_CLMUL
+	if(clmulAvailable && (size >= SNAP_CLMUL_MIN_SIZE))
+	{
+		return snap_updateCrc32Clmul(crc, data, size);
+	}
+#endif
+
+	return snap_updateCrc32Table(crc, data, size);
+}
+
+/**
+ * @brief Get the initial value of the running hash used by the decoder.
+ * @param[in] edm EDM value (#snap_hdb1_edm_t).
+ * @return Initial hash value.
+ */
+static inline uint32_t snap_initHash(const uint8_t edm)
+{
+	return (edm == SNAP_HDB1_EDM_32BIT_CRC) ? 0xFFFFFFFF : 0;
+}
+
+/**
+ * @brief Check if the running hash of the decoder can be used for a given error detection method.
+ * @details The public CRC functions are weak, so a user implementation may be linked in their place. The running hash
+ *          is only used if the CRC function in use gives the check value of the built-in algorithm (see snap_calculateCrc8()),
+ *          otherwise the decoder calls that function at the end of the frame. The decoder checks it once per frame,
+ *          when the header is complete (see #snap_frame_t::incrementalHash).
+ * @param[in] edm EDM value (#snap_hdb1_edm_t).
+ * @retval true  The hash value is calculated incrementally, as each byte is decoded.
+ * @retval false The hash value must be calculated by snap_calculateHash() at the end of the frame.
+ */
+static bool snap_isIncrementalHash(const uint8_t edm)
+{
+	static const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+
+	switch(edm)
+	{
+		case SNAP_HDB1_EDM_8BIT_CHECKSUM: return true;
+		case SNAP_HDB1_EDM_8BIT_CRC:      return snap_calculateCrc8(check, sizeof(check)) == 0xA1;
+		case SNAP_HDB1_EDM_16BIT_CRC:     return snap_calculateCrc16(check, sizeof(check)) == 0x31C3;
+		case SNAP_HDB1_EDM_32BIT_CRC:     return snap_calculateCrc32(check, sizeof(check)) == 0xCBF43926;
+		default:                          return false;
+	}
+}
+
+/**
+ * @brief Update the running hash used by the decoder with one more byte.
+ * @details It should only be called if the hash is calculated incrementally (see snap_isIncrementalHash()). The other
+ *          methods are calculated by snap_calculateHash() when the frame is complete.
+ * @param[in] edm  EDM value (#snap_hdb1_edm_t).
+ * @param[in] hash Current hash value.
+ * @param[in] byte Next byte of the frame.
+ * @return Updated hash value.
+ */
+static inline uint32_t snap_updateHash(const uint8_t edm, const uint32_t hash, const uint8_t byte)
+{
+	switch(edm)
+	{
+		case SNAP_HDB1_EDM_8BIT_CHECKSUM: return (uint8_t)(hash + byte);
+		case SNAP_HDB1_EDM_8BIT_CRC:      return snap_updateCrc8((uint8_t)hash, byte);
+		case SNAP_HDB1_EDM_16BIT_CRC:     return snap_updateCrc16((uint16_t)hash, byte);
+		case SNAP_HDB1_EDM_32BIT_CRC:     return snap_updateCrc32(hash, byte);
+		default:                          return hash;
+	}
+}
+
+/**
+ * @brief Update the running hash used by the decoder with a block of bytes (see snap_updateHash()).
+ * @param[in] edm  EDM value (#snap_hdb1_edm_t).
+ * @param[in] hash Current hash value.
+ * @param[in] data Pointer to the next bytes of the frame.
+ * @param[in] size Number of bytes.
+ * @return Updated hash value.
+ */
+static uint32_t snap_updateHashBlock(const uint8_t edm, uint32_t hash, const uint8_t *data, const uint16_t size)
+{
+	switch(edm)
+	{
+		case SNAP_HDB1_EDM_8BIT_CHECKSUM:
+			return (uint8_t)(hash + snap_calculateChecksum8(data, size));
+		case SNAP_HDB1_EDM_8BIT_CRC:
+			for(uint_fast16_t i = 0; i < size; i++) hash = snap_updateCrc8((uint8_t)hash, data[i]);
+			return hash;
+		case SNAP_HDB1_EDM_16BIT_CRC:
+			return snap_updateCrc16Block((uint16_t)hash, data, size);
+		case SNAP_HDB1_EDM_32BIT_CRC:
+			return snap_updateCrc32Block(hash, data, size);
+		default:
+			return hash;
+	}
+}
+
+/**
+ * @brief Multiply an element of GF(256) by a power of alpha.
+ * @param[in] value Element of GF(256).
+ * @param[in] power Exponent of alpha (0 to 254).
+ * @return Product.
+ */
+static inline uint8_t snap_gfMulExp(const uint8_t value, const uint_fast8_t power)
+{
+	if(value == 0)
+	{
+		return 0;
+	}
+
+	uint_fast16_t sum = (uint_fast16_t)(SNAP_READ_FLASH_BYTE(&tableGfLog[value]) + power);
+	sum = (sum >= 255) ? (uint_fast16_t)(sum - 255) : sum;
+
+	return SNAP_READ_FLASH_BYTE(&tableGfExp[sum]);
+}
+
+/**
+ * @brief Multiply two elements of GF(256).
+ * @param[in] a First factor.
+ * @param[in] b Second factor.
+ * @return Product.
+ */
+static inline uint8_t snap_gfMul(const uint8_t a, const uint8_t b)
+{
+	return (b == 0) ? 0 : snap_gfMulExp(a, SNAP_READ_FLASH_BYTE(&tableGfLog[b]));
+}
+
+/**
+ * @brief Divide two elements of GF(256).
+ * @param[in] a Dividend.
+ * @param[in] b Divisor (not zero).
+ * @return Quotient.
+ */
+static inline uint8_t snap_gfDiv(const uint8_t a, const uint8_t b)
+{
+	return snap_gfMulExp(a, (uint_fast8_t)(255 - SNAP_READ_FLASH_BYTE(&tableGfLog[b])));
+}
+
+/**
+ * @brief Get the generator polynomial of the Reed-Solomon code: (x - alpha^0)(x - alpha^1)...(x - alpha^(P-1)),
+ *        where P is #SNAP_SIZE_FEC_PARITY.
+ * @details The default parity size reads it from a table. Other sizes calculate it once, on the first call, and keep it in RAM.
+ * @param[out] generator Pointer to the array that will store the logarithms of the P coefficients after the leading one
+ *                       (highest degree first). The coefficients of this generator are never zero.
+ */
+static void snap_getFecGenerator(uint8_t *generator)
+{
+#if (SNAP_SIZE_FEC_PARITY == 8)
+	SNAP_MEMCPY_FLASH(generator, tableFecGenerator, SNAP_SIZE_FEC_PARITY);
+#else
+	static uint8_t logs[SNAP_SIZE_FEC_PARITY];
+	static bool ready = false;
+
+	if(!ready)
+	{
+		uint8_t polynomial[SNAP_SIZE_FEC_PARITY + 1] = {1};	// Built aside, so a call from an interrupt never sees it half done
+
+		for(uint_fast8_t i = 0; i < SNAP_SIZE_FEC_PARITY; i++)
+		{
+			for(uint_fast8_t j = (uint_fast8_t)(i + 1); j != 0; j--)
+			{
+				polynomial[j] ^= snap_gfMulExp(polynomial[j - 1], i);
+			}
+		}
+
+		for(uint_fast8_t i = 0; i < SNAP_SIZE_FEC_PARITY; i++)
+		{
+			logs[i] = SNAP_READ_FLASH_BYTE(&tableGfLog[polynomial[i + 1]]);
+		}
+
+		ready = true;
+	}
+
+	memcpy(generator, logs, SNAP_SIZE_FEC_PARITY);
+#endif
+}
+
+/**
+ * @brief Get the size of the hash field of a frame, based on the error detection method.
+ * @details The FEC bytes of an interleaved frame are split into at least as many codewords as the depth
+ *          (as long as there are enough data bytes), see snap_getMessageSize(). The CRC of a FEC frame
+ *          is split like the data bytes.
+ * @param[in] edm       EDM value (#snap_hdb1_edm_t).
+ * @param[in] dataIndex Index of the first data byte.
+ * @param[in] hashIndex Index of the first hash byte.
+ * @param[in] depth     Interleaving depth (1 if the frame is not interleaved).
+ * @return Size of the hash value, or of the FEC bytes (#SNAP_SIZE_FEC_CHECK, plus #SNAP_SIZE_FEC_PARITY for each codeword).
+ */
+static inline uint_fast16_t snap_getHashFieldSize(const uint8_t edm, const uint_fast16_t dataIndex, const uint_fast16_t hashIndex, const uint_fast8_t depth)
+{
+	if(edm == SNAP_HDB1_EDM_FEC)
+	{
+		const uint_fast16_t bodySize = hashIndex + SNAP_SIZE_FEC_CHECK - SNAP_INDEX_HDB2;
+		uint_fast16_t codewordCount = (bodySize + SNAP_SIZE_FEC_MESSAGE - 1) / SNAP_SIZE_FEC_MESSAGE;
+
+		if(depth > 1)
+		{
+			const uint_fast16_t dataSize = hashIndex + SNAP_SIZE_FEC_CHECK - dataIndex;
+			const uint_fast16_t maxShare = SNAP_SIZE_FEC_MESSAGE - (dataIndex - SNAP_INDEX_HDB2);	// First codeword also holds the bytes before the data
+
+			codewordCount = (dataSize + maxShare - 1) / maxShare;
+
+			if(codewordCount < depth)
+			{
+				codewordCount = (depth < dataSize) ? depth : dataSize;
+			}
+
+			if(codewordCount == 0)
+			{
+				codewordCount = 1;
+			}
+		}
+
+		return (uint_fast16_t)(SNAP_SIZE_FEC_CHECK + codewordCount * SNAP_SIZE_FEC_PARITY);
+	}
+
+	return snap_getHashSizeFromEdm(edm);
+}
+
+/**
+ * @brief Get the number of codewords of a FEC frame (#SNAP_HDB1_EDM_FEC).
+ * @param[in] frame Pointer to the frame structure. The layout must be complete.
+ * @return Number of codewords.
+ */
+static inline uint_fast8_t snap_getCodewordCount(const snap_frame_t *frame)
+{
+	return (uint_fast8_t)((frame->layout.hashSize - SNAP_SIZE_FEC_CHECK) / SNAP_SIZE_FEC_PARITY);
+}
+
+/**
+ * @brief Get the message size of a FEC codeword (#SNAP_HDB1_EDM_FEC).
+ * @details The bytes from HDB2 to the last CRC byte are split into codewords with balanced sizes. If the frame is interleaved,
+ *          the data bytes are split instead, and the bytes before them are added to the first codeword, so every row of the
+ *          interleaver has the same size (see snap_getRows()).
+ * @param[in] frame    Pointer to the frame structure. The layout must be complete.
+ * @param[in] codeword Index of the codeword.
+ * @param[in] depth    Interleaving depth (1 if the frame is not interleaved).
+ * @return Number of frame bytes protected by the codeword.
+ */
+static uint_fast16_t snap_getMessageSize(const snap_frame_t *frame, const uint_fast8_t codeword, const uint_fast8_t depth)
+{
+	const uint_fast8_t codewordCount = snap_getCodewordCount(frame);
+	const uint_fast16_t headSize = (depth > 1) ? (uint_fast16_t)(frame->layout.dataIndex - SNAP_INDEX_HDB2) : 0;
+	const uint_fast16_t splitSize = (uint_fast16_t)(frame->layout.hashIndex + SNAP_SIZE_FEC_CHECK - SNAP_INDEX_HDB2 - headSize);
+
+	return splitSize / codewordCount + ((codeword < splitSize % codewordCount) ? 1 : 0) + ((codeword == 0) ? headSize : 0);
+}
+
+/**
+ * @brief Get the number of times a frame is repeated in the buffer, based on the error detection method.
+ * @param[in] edm EDM value (#snap_hdb1_edm_t).
+ * @return Number of copies (3 for #SNAP_HDB1_EDM_3_RETRANSMISSION, 1 otherwise).
+ */
+static inline uint_fast8_t snap_getCopyCount(const uint8_t edm)
+{
+	return (edm == SNAP_HDB1_EDM_3_RETRANSMISSION) ? 3 : 1;
+}
+
+/**
+ * @brief Read every header field from the HDB2 and HDB1 bytes of a frame.
+ * @param[in]  buffer Pointer to the array of bytes that contains the frame.
+ * @param[out] header Pointer to the structure that will store the header fields.
+ */
+static void snap_readHeader(const uint8_t *buffer, snap_header_t *header)
+{
+	header->dab = SNAP_HDB2_DAB(buffer);
+	header->sab = SNAP_HDB2_SAB(buffer);
+	header->pfb = SNAP_HDB2_PFB(buffer);
+	header->ack = SNAP_HDB2_ACK(buffer);
+	header->cmd = SNAP_HDB1_CMD(buffer);
+	header->edm = SNAP_HDB1_EDM(buffer);
+	header->ndb = SNAP_HDB1_NDB(buffer);
+}
+
+/**
+ * @brief Scramble (or descramble) bytes of a frame with the PN9 sequence (see snap_setScrambling()).
+ * @details The scrambler state is advanced 8 bits per byte. The sync byte of each copy of a frame (#SNAP_HDB1_EDM_3_RETRANSMISSION)
+ *          is left alone and restarts the sequence, like the first one.
+ * @param[in,out] frame Pointer to the frame structure. Its layout must be complete if the bytes go beyond the header.
+ * @param[in]     index Index of the first byte. The scrambler state must match this position.
+ * @param[in]     count Number of bytes.
+ */
+static void snap_whitenBytes(snap_frame_t *frame, uint_fast16_t index, uint_fast16_t count)
+{
+	const uint_fast16_t copySize = (uint_fast16_t)(frame->layout.hashIndex + frame->layout.hashSize);
+
+	for(; count != 0; count--, index++)
+	{
+		if((index >= SNAP_MIN_SIZE_FRAME) && ((index == copySize) || (index == 2 * copySize)))
+		{
+			frame->whitening = SNAP_WHITENING_SEED;
+			continue;	// Sync byte of a repeated copy
+		}
+
+		const uint_fast16_t state = frame->whitening;
+		const uint_fast16_t low = (state ^ (state >> 5)) & 0x0F;	// Next 4 bits of the x^9 + x^5 + 1 sequence
+		const uint_fast16_t high = ((state >> 4) ^ low) & 0x0F;		// And the 4 bits after them
+
+		frame->buffer[index] ^= (uint8_t)state;
+		frame->whitening = (uint16_t)((state >> 8) | (low << 1) | (high << 5));
+	}
+}
+
+/**
+ * @brief Get the interleaving depth of a frame from its protocol flags (see snap_setInterleaving()).
+ * @param[in] frame Pointer to the frame structure.
+ * @return Interleaving depth (1, 2, 4 or 8). It is 1 if interleaving is disabled, if the frame has less than 2 bytes
+ *         of protocol flags, or if the protocol flags are not complete yet.
+ */
+static uint_fast8_t snap_getDepth(const snap_frame_t *frame)
+{
+	const uint_fast8_t flagsSize = (uint_fast8_t)SNAP_HDB2_PFB(frame->buffer);
+	const uint_fast16_t flagsEnd = (uint_fast16_t)(SNAP_INDEX_PFB(frame->buffer) + flagsSize);
+
+	if(!frame->interleaving || (flagsSize < 2) || (frame->size < flagsEnd))
+	{
+		return 1;
+	}
+
+	return (uint_fast8_t)(1U << SNAP_FLAGS_DEPTH((uint32_t)frame->buffer[flagsEnd - 2] << 8));
+}
+
+/**
+ * @brief Split the data and hash bytes of a frame into the rows used by the interleaver.
+ * @details With #SNAP_HDB1_EDM_FEC, each row holds the bytes of a single codeword (the data and CRC bytes of its message and its parity bytes),
+ *          so a burst hits each codeword only once every depth bytes. Otherwise, the bytes are split into as many rows as the depth,
+ *          with balanced sizes.
+ * @param[in]  frame Pointer to the frame structure. The layout must be complete.
+ * @param[in]  depth Interleaving depth.
+ * @param[out] rows  Pointer to the structure that will store the rows.
+ */
+static void snap_getRows(const snap_frame_t *frame, const uint_fast8_t depth, snap_rows_t *rows)
+{
+	const uint_fast16_t dataIndex = frame->layout.dataIndex;
+
+	if(SNAP_HDB1_EDM(frame->buffer) == SNAP_HDB1_EDM_FEC)
+	{
+		uint_fast16_t messageIndex = SNAP_INDEX_HDB2;
+
+		rows->count = (uint8_t)snap_getCodewordCount(frame);
+
+		for(uint_fast8_t i = 0; i < rows->count; i++)
+		{
+			const uint_fast16_t messageEnd = messageIndex + snap_getMessageSize(frame, i, depth);
+			const uint_fast16_t start = (messageIndex > dataIndex) ? messageIndex : dataIndex;	// Bytes before the data are not interleaved
+
+			rows->index[i][0] = (uint16_t)(start - dataIndex);
+			rows->size[i][0] = (uint16_t)(messageEnd - start);
+			rows->index[i][1] = (uint16_t)(frame->layout.hashIndex + SNAP_SIZE_FEC_CHECK + i * SNAP_SIZE_FEC_PARITY - dataIndex);
+			rows->size[i][1] = SNAP_SIZE_FEC_PARITY;
+			messageIndex = messageEnd;
+		}
+	}
+	else
+	{
+		const uint_fast16_t size = (uint_fast16_t)(frame->layout.hashIndex + frame->layout.hashSize - dataIndex);
+		uint_fast16_t index = 0;
+
+		rows->count = (uint8_t)depth;
+
+		for(uint_fast8_t i = 0; i < rows->count; i++)
+		{
+			rows->index[i][0] = (uint16_t)index;
+			rows->size[i][0] = (uint16_t)(size / depth + ((i < size % depth) ? 1 : 0));
+			rows->index[i][1] = 0;
+			rows->size[i][1] = 0;
+			index += rows->size[i][0];
+		}
+	}
+}
+
+/**
+ * @brief Get the position of a byte after the interleaving.
+ * @details The rows are sent one column at a time, so the byte at row r and column c is sent after
+ *          all the bytes of the previous columns and the bytes of the same column in the previous rows.
+ * @param[in] rows  Pointer to the rows.
+ * @param[in] index Position of the byte before the interleaving. It must belong to one of the rows.
+ * @return Position of the byte.
+ */
+static uint_fast16_t snap_getInterleavedIndex(const snap_rows_t *rows, const uint_fast16_t index)
+{
+	uint_fast16_t column = 0;
+	uint_fast8_t row;
+
+	for(row = 0; row < rows->count; row++)
+	{
+		if((index - rows->index[row][0]) < rows->size[row][0])
+		{
+			column = index - rows->index[row][0];
+			break;
+		}
+
+		if((index - rows->index[row][1]) < rows->size[row][1])
+		{
+			column = rows->size[row][0] + index - rows->index[row][1];
+			break;
+		}
+	}
+
+	uint_fast16_t position = 0;
+
+	for(uint_fast8_t i = 0; i < rows->count; i++)
+	{
+		const uint_fast16_t rowSize = (uint_fast16_t)(rows->size[i][0] + rows->size[i][1]);
+
+		position += (rowSize < column) ? rowSize : column;		// Bytes of the previous columns
+		position += ((i < row) && (rowSize > column)) ? 1 : 0;	// Bytes of the same column in the previous rows
+	}
+
+	return position;
+}
+
+/**
+ * @brief Interleave (or de-interleave) a copy of a complete frame in place.
+ *        Only the data and hash bytes are interleaved, so the decoder can read the frame format and the depth.
+ * @details Each cycle of the permutation is walked once, and its positions are marked in a bitmap, so every byte is moved
+ *          exactly once and the position of each one is calculated only once. The bitmap takes one bit per interleaved byte
+ *          on the stack (#SNAP_SIZE_INTERLEAVE_BITMAP = 73 bytes with 8 parity bytes per codeword, 129 bytes with 64), instead of
+ *          walking each cycle again to find its first position, which is quadratic in the frame size.
+ * @param[in,out] frame     Pointer to the frame structure.
+ * @param[in]     rows      Pointer to the rows (see snap_getRows()).
+ * @param[in]     copyIndex Index of the first byte of the copy (sync byte).
+ * @param[in]     forward   True to interleave, false to de-interleave.
+ */
+static void snap_interleaveCopy(snap_frame_t *frame, const snap_rows_t *rows, const uint_fast16_t copyIndex, const bool forward)
+{
+	uint8_t *bytes = &frame->buffer[copyIndex + frame->layout.dataIndex];
+	const uint_fast16_t size = (uint_fast16_t)(frame->layout.hashIndex + frame->layout.hashSize - frame->layout.dataIndex);
+	uint8_t visited[SNAP_SIZE_INTERLEAVE_BITMAP] = {0};
+
+	for(uint_fast16_t start = 0; start < size; start++)
+	{
+		if(visited[start / 8U] & (1U << (start % 8U)))
+		{
+			continue;	// Cycle already walked
+		}
+
+		uint_fast16_t index = start;
+		uint8_t carry = bytes[start];
+
+		do
+		{
+			const uint_fast16_t next = snap_getInterleavedIndex(rows, index);
+
+			visited[index / 8U] |= (uint8_t)(1U << (index % 8U));
+
+			if(forward)	// The byte at index goes to next
+			{
+				const uint8_t byte = bytes[next];
+				bytes[next] = carry;
+				carry = byte;
+			}
+			else		// The byte at next comes back to index
+			{
+				bytes[index] = (next == start) ? carry : bytes[next];
+			}
+
+			index = next;
+		}
+		while(index != start);
+	}
+}
+
+/**
+ * @brief Get the size of the data length field needed by a number of data bytes (#SNAP_HDB1_NDB_USER_SPECIFIED).
+ * @param[in] dataSize Number of data bytes.
+ * @return Size of the data length field (1 or 2 bytes).
+ */
+static inline uint_fast8_t snap_getLengthFieldSize(const uint_fast16_t dataSize)
+{
+	return (dataSize < SNAP_LENGTH_EXTENDED) ? 1 : 2;
+}
+
+/**
+ * @brief Calculate the NDB value of a new frame and the position of its data bytes.
+ * @param[in]     frame     Pointer to the frame structure.
+ * @param[in,out] fields    Pointer to the structure that contains the frame fields. The NDB value is updated according to the data size,
+ *                          unless it is #SNAP_HDB1_NDB_USER_SPECIFIED (exact data size, sent in the data length field).
+ * @param[out]    dataIndex Pointer to the variable that will store the index of the first data byte.
+ * @retval true  The frame fits in the buffer.
+ * @retval false The frame does not fit in the buffer.
+ */
+static bool snap_placePayload(const snap_frame_t *frame, snap_fields_t *fields, uint_fast16_t *dataIndex)
+{
+	const bool exactLength = (fields->header.ndb == SNAP_HDB1_NDB_USER_SPECIFIED);
+
+	if(!exactLength)
+	{
+		fields->header.ndb = snap_getNdbFromDataSize(fields->dataSize) & SNAP_HDB1_NDB_MASK;
+	}
+
+	const uint_fast16_t payloadSize = exactLength ? fields->dataSize : snap_getDataSizeFromNdb(fields->header.ndb);
+	const uint_fast8_t lengthSize = exactLength ? snap_getLengthFieldSize(fields->dataSize) : 0;
+	const uint_fast8_t payloadIndex = (uint_fast8_t)(SNAP_INDEX_DAB + fields->header.dab + fields->header.sab + fields->header.pfb + lengthSize);
+	const uint_fast8_t depth = (frame->interleaving && (fields->header.pfb >= 2)) ? (uint_fast8_t)(1U << SNAP_FLAGS_DEPTH(fields->protocolFlags)) : 1;
+	const uint_fast16_t hashSize = snap_getHashFieldSize(fields->header.edm, payloadIndex, payloadIndex + payloadSize, depth);
+
+	const uint_fast16_t fullSize = (uint_fast16_t)((payloadIndex + payloadSize + hashSize) * snap_getCopyCount(fields->header.edm));
+
+	if((fields->dataSize > SNAP_MAX_SIZE_DATA) || (payloadSize < fields->dataSize) || (frame->maxSize < fullSize))
+	{
+		return false;
+	}
+
+	*dataIndex = fields->paddingAfter ? payloadIndex : (uint_fast16_t)(payloadIndex + payloadSize - fields->dataSize);
+
+	return true;
+}
+
+/**
+ * @brief Calculate the FEC bytes of a frame (#SNAP_HDB1_EDM_FEC), or use them to correct the frame.
+ * @details A CRC-16 of the bytes from HDB2 to the last data byte is stored after the data. The bytes from HDB2 to the last
+ *          CRC byte are split into as few Reed-Solomon codewords as possible (or as many as the interleaving depth), with
+ *          balanced sizes (see snap_getMessageSize()). The parity bytes of each codeword are stored in order after the CRC.
+ *          A codeword with more errors than the code can correct may be "corrected" into another valid codeword,
+ *          so the CRC is checked after the correction.
+ * @param[in,out] frame   Pointer to the frame structure. The frame must be complete, except for the FEC bytes when encoding.
+ * @param[in]     correct True to correct the frame, false to calculate the FEC bytes.
+ * @retval true  FEC bytes calculated, or every codeword is correct (or has been corrected) and so is the CRC.
+ * @retval false Some codeword has more errors than the code can correct, or the CRC does not match after the correction.
+ */
+static bool snap_processFec(snap_frame_t *frame, const bool correct)
+{
+	const uint_fast8_t codewordCount = snap_getCodewordCount(frame);
+	const uint_fast8_t depth = snap_getDepth(frame);
+	const uint16_t bodySize = (uint16_t)(frame->layout.hashIndex - SNAP_INDEX_HDB2);
+	uint8_t *message = &frame->buffer[SNAP_INDEX_HDB2];
+	uint8_t *check = &frame->buffer[frame->layout.hashIndex];
+	uint8_t *parity = &check[SNAP_SIZE_FEC_CHECK];
+
+	if(!correct)
+	{
+		const uint16_t crc = snap_calculateCrc16(message, bodySize);
+
+		check[0] = (uint8_t)(crc >> 8);
+		check[1] = (uint8_t)(crc & 0xFF);
+	}
+
+	for(uint_fast8_t i = 0; i < codewordCount; i++)
+	{
+		const uint16_t messageSize = (uint16_t)snap_getMessageSize(frame, i, depth);
+
+		if(!correct)
+		{
+			snap_calculateFecParity(message, messageSize, parity);
+		}
+		else if(snap_correctFecErrors(message, messageSize, parity) < 0)
+		{
+			return false;
+		}
+
+		message += messageSize;
+		parity += SNAP_SIZE_FEC_PARITY;
+	}
+
+	return !correct || (snap_readInteger(check, SNAP_SIZE_FEC_CHECK) == snap_calculateCrc16(&frame->buffer[SNAP_INDEX_HDB2], bodySize));
+}
+
+/**
+ * @brief Build a new frame around a payload that is already in place (see snap_placePayload()).
+ * @details Write the padding bytes, sync byte, header, addresses, flags and hash value, then update the frame layout, size and status.
+ *          The frame is interleaved if required by its protocol flags (see snap_setInterleaving()), then scrambled if
+ *          scrambling is enabled (see snap_setScrambling()).
+ * @param[in,out] frame     Pointer to the frame structure.
+ * @param[in]     fields    Pointer to the structure that contains the frame fields (with the NDB value already calculated).
+ * @param[in]     dataIndex Index of the first data byte.
+ * @return Frame status after the process (#SNAP_STATUS_VALID).
+ */
+static int8_t snap_buildFrame(snap_frame_t *frame, const snap_fields_t *fields, const uint_fast16_t dataIndex)
+{
+	const bool exactLength = (fields->header.ndb == SNAP_HDB1_NDB_USER_SPECIFIED);
+	const uint_fast16_t payloadSize = exactLength ? fields->dataSize : snap_getDataSizeFromNdb(fields->header.ndb);
+	const uint_fast16_t paddingSize = (uint_fast16_t)(payloadSize - fields->dataSize);
+	const uint_fast16_t paddingIndex = fields->paddingAfter ? (uint_fast16_t)(dataIndex + fields->dataSize) : (uint_fast16_t)(dataIndex - paddingSize);
+
+	for(uint_fast16_t i = paddingIndex; i < paddingIndex + paddingSize; i++)
+	{
+		frame->buffer[i] = SNAP_PADDING;
+	}
+
+	frame->buffer[SNAP_INDEX_SYNC] = SNAP_SYNC;
+
+	frame->buffer[SNAP_INDEX_HDB2] = (uint8_t)((fields->header.dab << SNAP_HDB2_DAB_POS) |
+	                                           (fields->header.sab << SNAP_HDB2_SAB_POS) |
+	                                           (fields->header.pfb << SNAP_HDB2_PFB_POS) |
+	                                           (fields->header.ack << SNAP_HDB2_ACK_POS));
+
+	frame->buffer[SNAP_INDEX_HDB1] = (uint8_t)((fields->header.cmd << SNAP_HDB1_CMD_POS) |
+	                                           (fields->header.edm << SNAP_HDB1_EDM_POS) |
+	                                           (fields->header.ndb << SNAP_HDB1_NDB_POS));
+
+	if(exactLength)
+	{
+		uint8_t *lengthField = &frame->buffer[SNAP_INDEX_LENGTH(frame->buffer)];
+
+		if(snap_getLengthFieldSize(fields->dataSize) == 1)
+		{
+			lengthField[0] = (uint8_t)fields->dataSize;
+		}
+		else
+		{
+			lengthField[0] = (uint8_t)((fields->dataSize >> 8) | SNAP_LENGTH_EXTENDED);
+			lengthField[1] = (uint8_t)(fields->dataSize & 0xFF);
+		}
+	}
+
+	frame->size = SNAP_INDEX_DAB;
+
+	for(uint_fast8_t i = fields->header.dab; i != 0; i--)
+	{
+		frame->buffer[frame->size++] = (fields->destAddress >> ((i - 1) * 8)) & 0xFF;
+	}
+
+	for(uint_fast8_t i = fields->header.sab; i != 0; i--)
+	{
+		frame->buffer[frame->size++] = (fields->sourceAddress >> ((i - 1) * 8)) & 0xFF;
+	}
+
+	for(uint_fast8_t i = fields->header.pfb; i != 0; i--)
+	{
+		frame->buffer[frame->size++] = (fields->protocolFlags >> ((i - 1) * 8)) & 0xFF;
+	}
+
+	snap_updateLayout(frame);	// After the protocol flags, which may change the number of FEC codewords
+
+	frame->size = (uint16_t)(frame->layout.dataIndex + payloadSize);
+
+	if(SNAP_HDB1_EDM(frame->buffer) == SNAP_HDB1_EDM_FEC)
+	{
+		snap_processFec(frame, false);
+		frame->size = (uint16_t)(frame->size + frame->layout.hashSize);
+	}
+	else if(frame->layout.hashSize)
+	{
+		uint32_t hashValue;
+		snap_calculateHash(frame, &hashValue);
+
+		for(uint_fast8_t i = (uint_fast8_t)frame->layout.hashSize; i != 0; i--)
+		{
+			frame->buffer[frame->size++] = (hashValue >> ((i - 1) * 8)) & 0xFF;
+		}
+	}
+
+	const uint_fast8_t depth = snap_getDepth(frame);
+
+	if(depth > 1)
+	{
+		snap_rows_t rows;
+		snap_getRows(frame, depth, &rows);
+		snap_interleaveCopy(frame, &rows, 0, true);
+	}
+
+	if(frame->scrambling)
+	{
+		frame->whitening = SNAP_WHITENING_SEED;
+		snap_whitenBytes(frame, SNAP_INDEX_HDB2, frame->size - SNAP_INDEX_HDB2);
+	}
+
+	const uint16_t copySize = frame->size;
+
+	while(frame->size < frame->layout.fullSize)	// Frame repeated (#SNAP_HDB1_EDM_3_RETRANSMISSION)
+	{
+		memcpy(&frame->buffer[frame->size], frame->buffer, copySize);
+		frame->size = (uint16_t)(frame->size + copySize);
+	}
+
+	frame->status = SNAP_STATUS_VALID;
+	return frame->status;
+}
+
+/**
+ * @brief Check if the header (and the data length field) of a frame still match the layout used to decode it,
+ *        after the frame bytes have been corrected.
+ * @param[in] frame Pointer to the frame structure.
+ * @param[in] bytes Pointer to the corrected bytes, from the sync byte to (at least) the data length field.
+ * @param[in] hdb2  HDB2 byte used to decode the frame.
+ * @param[in] hdb1  HDB1 byte used to decode the frame.
+ * @return True if the layout is unchanged.
+ */
+static bool snap_isSameLayout(const snap_frame_t *frame, const uint8_t *bytes, const uint8_t hdb2, const uint8_t hdb1)
+{
+	if((bytes[SNAP_INDEX_HDB2] != hdb2) || (bytes[SNAP_INDEX_HDB1] != hdb1))
+	{
+		return false;
+	}
+
+	return !SNAP_IS_EXACT_LENGTH(bytes) ||
+	       ((SNAP_INDEX_DATA(bytes) == frame->layout.dataIndex) && (SNAP_SIZE_DATA(bytes) == frame->layout.dataSize));
+}
+
+/**
+ * @brief Rebuild a frame sent 3 times (#SNAP_HDB1_EDM_3_RETRANSMISSION) by a bitwise majority vote of the copies.
+ * @details Every bit of the frame is set to the value found in at least 2 copies, so errors confined to a single copy
+ *          are corrected. The result is written over all copies, so the buffer looks like an encapsulated frame.
+ *          The bytes before the data are voted first, and the buffer is only changed if they match the layout.
+ * @param[in,out] frame Pointer to the frame structure. The 3 copies must be complete.
+ * @retval true  Frame rebuilt.
+ * @retval false The sync byte, header or data length obtained by the vote does not match the one used to decode the frame
+ *               (i.e. the copies were not aligned). The buffer remains unchanged, as it was received.
+ */
+static bool snap_voteCopies(snap_frame_t *frame)
+{
+	const uint_fast16_t copySize = frame->layout.fullSize / 3U;
+	uint8_t *copyA = frame->buffer;
+	uint8_t *copyB = &copyA[copySize];
+	uint8_t *copyC = &copyB[copySize];
+	uint8_t head[SNAP_INDEX_DAB + 3U * 3U + SNAP_LENGTH_MAX_SIZE] = {0};	// Sync byte to data length field (3 bytes per address and flags)
+
+	for(uint_fast16_t i = 0; i < frame->layout.dataIndex; i++)
+	{
+		head[i] = SNAP_VOTE(copyA[i], copyB[i], copyC[i]);
+	}
+
+	if((head[SNAP_INDEX_SYNC] != SNAP_SYNC) || !snap_isSameLayout(frame, head, copyA[SNAP_INDEX_HDB2], copyA[SNAP_INDEX_HDB1]))
+	{
+		return false;
+	}
+
+	for(uint_fast16_t i = 0; i < copySize; i++)
+	{
+		copyA[i] = SNAP_VOTE(copyA[i], copyB[i], copyC[i]);
+	}
+
+	memcpy(copyB, copyA, copySize);
+	memcpy(copyC, copyA, copySize);
+
+	return true;
+}
+
+/**
+ * @brief Validate a frame whose last byte has just been decoded and update its status.
+ * @details An interleaved frame (see snap_setInterleaving()) is de-interleaved first. If it is not valid,
+ *          its bytes are interleaved again, so snap_decodeStream() can search them in the received order.
+ * @param[in,out] frame Pointer to the frame structure. The frame must be complete.
+ * @return Frame status after the process (#SNAP_STATUS_VALID or #SNAP_STATUS_ERROR_HASH).
+ */
+static int8_t snap_validateFrame(snap_frame_t *frame)
+{
+	const uint8_t edm = SNAP_HDB1_EDM(frame->buffer);
+	const uint_fast8_t depth = snap_getDepth(frame);
+	const uint_fast16_t copySize = (uint_fast16_t)(frame->layout.hashIndex + frame->layout.hashSize);
+	snap_rows_t rows;
+
+	if(frame->resynced && (frame->layout.hashSize == 0))
+	{
+		frame->status = SNAP_STATUS_ERROR_HASH;	// Unverifiable (see snap_decodeStream()), and the bytes must stay as received to be searched again
+		return frame->status;
+	}
+
+	if(depth > 1)
+	{
+		snap_getRows(frame, depth, &rows);
+
+		for(uint_fast16_t i = 0; i < frame->layout.fullSize; i += copySize)
+		{
+			snap_interleaveCopy(frame, &rows, i, false);
+		}
+	}
+
+	if(edm == SNAP_HDB1_EDM_FEC)
+	{
+		const uint8_t hdb2 = frame->buffer[SNAP_INDEX_HDB2];
+		const uint8_t hdb1 = frame->buffer[SNAP_INDEX_HDB1];
+
+		frame->status = (snap_processFec(frame, true) && snap_isSameLayout(frame, frame->buffer, hdb2, hdb1)) ? SNAP_STATUS_VALID : SNAP_STATUS_ERROR_HASH;
+	}
+	else if(frame->layout.hashSize)
+	{
+		uint32_t expectedHash, actualHash;
+
+		if(frame->incrementalHash && (depth == 1))	// The running hash of an interleaved frame is meaningless
+		{
+			expectedHash = (edm == SNAP_HDB1_EDM_32BIT_CRC) ? ~frame->hash : frame->hash;
+		}
+		else
+		{
+			snap_calculateHash(frame, &expectedHash);
+		}
 
+		snap_getField(frame, &actualHash, SNAP_FIELD_HASH);
 
-#ifdef SNAP_DISABLE_WEAK
-	#define SNAP_WEAK
-#else
-	#define SNAP_WEAK	__attribute__((weak))
-#endif
+		frame->status = (actualHash == expectedHash) ? SNAP_STATUS_VALID : SNAP_STATUS_ERROR_HASH;
+	}
+	else if(edm == SNAP_HDB1_EDM_3_RETRANSMISSION)
+	{
+		frame->status = snap_voteCopies(frame) ? SNAP_STATUS_VALID : SNAP_STATUS_ERROR_HASH;
+	}
+	else
+	{
+		frame->status = SNAP_STATUS_VALID;
+	}
+
+	if((depth > 1) && (frame->status != SNAP_STATUS_VALID))
+	{
+		for(uint_fast16_t i = 0; i < frame->layout.fullSize; i += copySize)
+		{
+			snap_interleaveCopy(frame, &rows, i, true);
+		}
+	}
+
+	return frame->status;
+}
+
+/**
+ * @brief Calculate the offsets and sizes of the frame fields from the header bytes and the given data field.
+ * @param[in,out] frame      Pointer to the frame structure. The buffer must contain the HDB2 and HDB1 bytes.
+ * @param[in]     lengthSize Size of the data length field (zero if the NDB bits are not #SNAP_HDB1_NDB_USER_SPECIFIED).
+ * @param[in]     dataSize   Size of the data field.
+ */
+static void snap_setLayout(snap_frame_t *frame, const uint_fast8_t lengthSize, const uint_fast16_t dataSize)
+{
+	snap_layout_t *layout = &frame->layout;
+
+	layout->sourceIndex = (uint8_t)SNAP_INDEX_SAB(frame->buffer);
+	layout->flagsIndex = (uint8_t)(layout->sourceIndex + SNAP_HDB2_SAB(frame->buffer));
+	layout->dataIndex = (uint16_t)(layout->flagsIndex + SNAP_HDB2_PFB(frame->buffer) + lengthSize);
+	layout->dataSize = (uint16_t)dataSize;
+	layout->hashIndex = (uint16_t)(layout->dataIndex + layout->dataSize);
+	layout->hashSize = (uint16_t)snap_getHashFieldSize((uint8_t)SNAP_HDB1_EDM(frame->buffer), layout->dataIndex, layout->hashIndex, snap_getDepth(frame));
+	layout->fullSize = (uint16_t)((layout->hashIndex + layout->hashSize) * snap_getCopyCount((uint8_t)SNAP_HDB1_EDM(frame->buffer)));
+}
+
+/**
+ * @brief Check if the data length field of a frame being decoded has just been completed (#SNAP_HDB1_NDB_USER_SPECIFIED).
+ * @param[in] frame Pointer to the frame structure. The buffer must contain the complete header.
+ * @return True if the last decoded byte completed the data length field.
+ */
+static bool snap_isLengthComplete(const snap_frame_t *frame)
+{
+	const uint_fast16_t lengthIndex = (uint_fast16_t)(frame->layout.flagsIndex + SNAP_HDB2_PFB(frame->buffer));
+
+	if(!SNAP_IS_EXACT_LENGTH(frame->buffer) || (frame->size <= lengthIndex))
+	{
+		return false;
+	}
+
+	return frame->size == lengthIndex + ((frame->buffer[lengthIndex] & SNAP_LENGTH_EXTENDED) ? 2U : 1U);
+}
+
+/**
+ * @brief Check if the layout of a frame being decoded depends on its interleaving depth (i.e. the number of FEC codewords),
+ *        which is only known after the protocol flags.
+ * @param[in] frame Pointer to the frame structure. The buffer must contain the complete header.
+ * @return True if the layout must be updated after the protocol flags.
+ */
+static bool snap_hasDepth(const snap_frame_t *frame)
+{
+	return frame->interleaving && (SNAP_HDB1_EDM(frame->buffer) == SNAP_HDB1_EDM_FEC) && !SNAP_IS_EXACT_LENGTH(frame->buffer) &&
+	       (SNAP_HDB2_PFB(frame->buffer) >= 2);
+}
+
+/**
+ * @brief Check if the protocol flags of a frame being decoded have just been completed, and if they may change its layout
+ *        (see snap_hasDepth()).
+ * @param[in] frame Pointer to the frame structure. The buffer must contain the complete header.
+ * @return True if the last decoded byte completed the protocol flags and the layout must be updated.
+ */
+static bool snap_isDepthComplete(const snap_frame_t *frame)
+{
+	return snap_hasDepth(frame) && (frame->size == frame->layout.flagsIndex + SNAP_HDB2_PFB(frame->buffer));
+}
+
+/**
+ * @brief Check the destination address of a frame against the address filter.
+ * @param[in] frame Pointer to the frame structure. The buffer must contain the complete destination address.
+ * @return True if the frame must be decoded, or false if it is addressed to another node.
+ */
+static bool snap_isAddressAccepted(const snap_frame_t *frame)
+{
+	const uint_fast8_t destSize = (uint_fast8_t)(frame->layout.sourceIndex - SNAP_INDEX_DAB);
+
+	if(destSize == 0)
+	{
+		return true;	// Frame without destination address
+	}
+
+	return snap_isDestAccepted(frame, snap_readInteger(&frame->buffer[SNAP_INDEX_DAB], destSize));
+}
+
+/**
+ * @brief Discard the frame being decoded and skip its remaining bytes.
+ * @param[in,out] frame Pointer to the frame structure. The buffer must contain the complete header.
+ */
+static void snap_skipFrame(snap_frame_t *frame)
+{
+	frame->skipCount = (uint16_t)(frame->layout.fullSize - frame->size);
+	frame->size = 0;
+	frame->status = (frame->skipCount != 0) ? SNAP_STATUS_SKIPPING : SNAP_STATUS_IDLE;
+}
+
+/**
+ * @brief Decode bytes that are already stored in the frame buffer, as if they had just been received.
+ * @details Decoding stops when the frame is complete (valid or not) or an error occurs. The remaining bytes
+ *          are moved right after the frame bytes and kept pending. Every byte must be stored after the position
+ *          where the decoder writes it, which is always the case when the frame is reset before the replay.
+ * @param[in,out] frame Pointer to the frame structure.
+ * @param[in]     index Index of the first byte to be decoded.
+ * @param[in]     count Number of bytes to be decoded.
+ */
+static void snap_replay(snap_frame_t *frame, uint_fast16_t index, uint_fast16_t count)
+{
+	while(count != 0)
+	{
+		const int8_t status = snap_decode(frame, frame->buffer[index++]);
+		count--;
+
+		if((status != SNAP_STATUS_IDLE) && (status != SNAP_STATUS_INCOMPLETE) && (status != SNAP_STATUS_SKIPPING))
+		{
+			break;
+		}
+	}
+
+	memmove(&frame->buffer[frame->size], &frame->buffer[index], count);
+	frame->pendingIndex = frame->size;
+	frame->pendingSize = (uint16_t)count;
+}
+
+/**
+ * @brief Recover from a decoding error by decoding again every byte stored after the sync byte of the failed frame.
+ * @details Bytes before the next sync byte are discarded. If there is no other sync byte, the frame becomes empty.
+ *          The bytes of a scrambled frame are scrambled again first, so every stored byte is as it was received.
+ * @param[in,out] frame Pointer to the frame structure. Its status must be an error.
+ */
+static void snap_resync(snap_frame_t *frame)
+{
+	if(frame->scrambling)
+	{
+		frame->whitening = SNAP_WHITENING_SEED;
+		snap_whitenBytes(frame, SNAP_INDEX_HDB2, frame->size - SNAP_INDEX_HDB2);	// Back to the received bytes
+	}
+
+	memmove(&frame->buffer[frame->size], &frame->buffer[frame->pendingIndex], frame->pendingSize);	// Make the stored bytes contiguous
+
+	const uint_fast16_t end = (uint_fast16_t)(frame->size + frame->pendingSize);
+	const uint8_t *sync = (end > 1) ? memchr(&frame->buffer[1], SNAP_SYNC, end - 1) : NULL;
+	const uint_fast16_t index = (sync == NULL) ? end : (uint_fast16_t)(sync - frame->buffer);
+
+	snap_reset(frame);
+	frame->resynced = (sync != NULL);
+	snap_replay(frame, index, end - index);
+}
+
+/**
+ * @brief Clear the resync flag of a frame once it is valid.
+ * @details A frame found by snap_resync() without a hash value is rejected by snap_validateFrame() before any other
+ *          check, since it is probably a payload byte equal to the sync byte.
+ * @param[in,out] frame Pointer to the frame structure.
+ * @return Frame status after the process. It can be any value from #snap_status_t.
+ */
+static int8_t snap_checkResynced(snap_frame_t *frame)
+{
+	if(frame->status == SNAP_STATUS_VALID)
+	{
+		frame->resynced = false;
+	}
+
+	return frame->status;
+}
 
 
 /******************************************************************************/
@@ -71,8 +2230,8 @@ SOFTWARE.
  * @param[out] frame   Pointer to the frame structure.
  * @param[in]  buffer  Pointer to the array that will store the frame bytes.
  * @param[in]  maxSize Maximum number of bytes that can be stored in the buffer.
- *                     It must be a value from #SNAP_MIN_SIZE_FRAME to #SNAP_MAX_SIZE_FRAME.
- *                     If necessary, it will be limited to #SNAP_MAX_SIZE_FRAME without generating error.
+ *                     It must be a value from #SNAP_MIN_SIZE_FRAME to #SNAP_MAX_SIZE_BUFFER.
+ *                     If necessary, it will be limited to #SNAP_MAX_SIZE_BUFFER without generating error.
  * @retval >0                       Return the actual maxSize used.
  * @retval #SNAP_ERROR_NULL_FRAME   Error: Frame pointer is NULL.
  * @retval #SNAP_ERROR_NULL_BUFFER  Error: Buffer pointer is NULL.
@@ -84,10 +2243,23 @@ int16_t snap_init(snap_frame_t *frame, uint8_t *buffer, const uint16_t maxSize)
 	if(buffer == NULL)                return SNAP_ERROR_NULL_BUFFER;
 	if(maxSize < SNAP_MIN_SIZE_FRAME) return SNAP_ERROR_SHORT_BUFFER;
 
-	frame->maxSize = (maxSize > SNAP_MAX_SIZE_FRAME) ? SNAP_MAX_SIZE_FRAME : maxSize;
+	frame->maxSize = (maxSize > SNAP_MAX_SIZE_BUFFER) ? SNAP_MAX_SIZE_BUFFER : maxSize;
 	frame->buffer = buffer;
 	frame->status = SNAP_STATUS_IDLE;
 	frame->size = 0;
+	frame->hash = 0;
+	frame->incrementalHash = false;
+	frame->layout = (snap_layout_t){0};
+	frame->pendingIndex = 0;
+	frame->pendingSize = 0;
+	frame->pendingOverflow = false;
+	frame->resynced = false;
+	frame->interleaving = false;
+	frame->scrambling = false;
+	frame->whitening = SNAP_WHITENING_SEED;
+	frame->localAddress = SNAP_BROADCAST_ADDRESS;
+	frame->groupMask = 0;
+	frame->skipCount = 0;
 
 	return (int16_t)frame->maxSize;
 }
@@ -97,6 +2269,7 @@ int16_t snap_init(snap_frame_t *frame, uint8_t *buffer, const uint16_t maxSize)
  * @details This function should be called after decoding a frame, prior to decoding
  *          a new frame. After executing this function, the frame will be considered
  *          empty, even though the buffer still holds the previous frame bytes.
+ *          Bytes kept by snap_decodeStream() for the next frame are not discarded.
  * @param[out] frame Pointer to the frame structure.
  */
 void snap_reset(snap_frame_t *frame)
@@ -105,10 +2278,96 @@ void snap_reset(snap_frame_t *frame)
 	frame->status = SNAP_STATUS_IDLE;
 }
 
+/**
+ * @brief Set the address filter used by the decoder to reject frames addressed to other nodes.
+ * @details Once the destination address of a frame is received, the decoder checks it against the filter. A frame is
+ *          accepted if it has no destination address, if its destination address is #SNAP_BROADCAST_ADDRESS or the
+ *          local address, or if its destination address matches the local address in all the bits set in the group mask.
+ *          The remaining bytes of a rejected frame are skipped (#SNAP_STATUS_SKIPPING): they are not stored nor hashed,
+ *          and the frame becomes empty again (#SNAP_STATUS_IDLE) after the last one, without reporting anything.
+ *          The filter is disabled by snap_init().
+ * @param[out] frame        Pointer to the frame structure.
+ * @param[in]  localAddress Address of this node. If it is #SNAP_BROADCAST_ADDRESS, the filter is disabled and all frames are accepted.
+ * @param[in]  groupMask    Bit mask of the address bits that identify the group of this node, or zero if the node does not belong to any group.
+ */
+void snap_setAddressFilter(snap_frame_t *frame, const uint32_t localAddress, const uint32_t groupMask)
+{
+	frame->localAddress = localAddress;
+	frame->groupMask = groupMask;
+}
+
+/**
+ * @brief Check a destination address against the address filter of the frame structure (see snap_setAddressFilter()).
+ * @details It is useful for layers that carry the destination address outside the frame header, so the decoder cannot filter their frames.
+ * @param[in] frame       Pointer to the frame structure.
+ * @param[in] destAddress Destination address.
+ * @return true if the filter is disabled or the address is accepted by it, false otherwise.
+ */
+bool snap_isDestAccepted(const snap_frame_t *frame, const uint32_t destAddress)
+{
+	return (frame->localAddress == SNAP_BROADCAST_ADDRESS) ||
+	       (destAddress == SNAP_BROADCAST_ADDRESS) ||
+	       (destAddress == frame->localAddress) ||
+	       ((frame->groupMask != 0) && (((destAddress ^ frame->localAddress) & frame->groupMask) == 0));
+}
+
+/**
+ * @brief Enable or disable the interleaving of the frames encapsulated and decoded with a frame structure.
+ * @details Power line bursts usually corrupt several consecutive bytes. When interleaving is enabled, frames with at least
+ *          2 bytes of protocol flags are interleaved according to their depth bits (#SNAP_FLAGS_DEPTH_POS, #snap_depth_t),
+ *          so the depth can be chosen per link by the transmitter: snap_encapsulate() interleaves the data and hash bytes
+ *          right before the frame is sent, and snap_decode() de-interleaves them before validating the frame.
+ *          The frame format, addresses, flags and data length field are not interleaved.
+ *          With #SNAP_HDB1_EDM_FEC, the frame has as many codewords as the depth (as long as it has enough data bytes), and each one
+ *          is interleaved with the others, so a burst of up to depth * #SNAP_SIZE_FEC_PARITY / 2 interleaved bytes is always corrected.
+ *          Both nodes must enable interleaving. It is disabled by snap_init(). The bytes are permuted in the frame buffer,
+ *          with a bitmap of up to #SNAP_MAX_SIZE_DATA / 8 + #SNAP_MAX_DEPTH * #SNAP_SIZE_FEC_PARITY / 8 + 1 bytes on the stack.
+ * @note While interleaving is enabled, the field accessors return the interleaved bytes of an encapsulated frame.
+ * @param[out] frame   Pointer to the frame structure.
+ * @param[in]  enabled True to enable interleaving, false to disable it.
+ */
+void snap_setInterleaving(snap_frame_t *frame, const bool enabled)
+{
+	frame->interleaving = enabled;
+}
+
+/**
+ * @brief Enable or disable the scrambling of the frames encapsulated and decoded with a frame structure.
+ * @details Long runs of equal bytes (e.g. zeros in the payload and padding bytes) have no transitions for the receiver to keep the
+ *          bit timing. When scrambling is enabled, every byte after the sync byte is XORed with the PN9 sequence (x^9 + x^5 + 1,
+ *          starting at 0x1FF, the same data whitening used by many radio transceivers), restarted at each sync byte:
+ *          snap_encapsulate() scrambles the frame right before it is sent, and snap_decode() descrambles each byte as it is received.
+ *          The sync byte itself is left alone, so the decoder can still find it. Both nodes must enable scrambling.
+ *          It is disabled by snap_init().
+ * @note While scrambling is enabled, the field accessors return the scrambled bytes of an encapsulated frame.
+ * @param[out] frame   Pointer to the frame structure.
+ * @param[in]  enabled True to enable scrambling, false to disable it.
+ */
+void snap_setScrambling(snap_frame_t *frame, const bool enabled)
+{
+	frame->scrambling = enabled;
+}
+
+/**
+ * @brief Calculate the offsets and sizes of the frame fields from the header bytes and store them in the frame structure.
+ * @details The layout is cached so the decoder and the field accessors do not need to derive it from
+ *          the header on every access. It is updated automatically by snap_decode() (when the header is
+ *          complete) and by snap_encapsulate(). This function only needs to be called by the user after
+ *          writing the header bytes directly into the buffer.
+ * @param[in,out] frame Pointer to the frame structure. The buffer must contain the HDB2 and HDB1 bytes
+ *                      (and the data length field, if the NDB bits are #SNAP_HDB1_NDB_USER_SPECIFIED).
+ */
+void snap_updateLayout(snap_frame_t *frame)
+{
+	snap_setLayout(frame, SNAP_SIZE_LENGTH(frame->buffer), SNAP_SIZE_DATA(frame->buffer));
+}
+
 /**
  * @brief Detect, decode, validate and store a frame, one byte at a time.
  * @details All input bytes before a sync byte will be ignored.
  *          When a new byte is inserted into the buffer, the frame size and status are updated accordingly.
+ *          The hash value is updated as each byte is inserted (see #snap_frame_t::hash), so the
+ *          validation of a complete frame only compares the received hash with the running one.
  *          All input bytes after a valid frame or any error will be ignored.
  *          Prior to decoding a new frame, the frame status must be #SNAP_STATUS_IDLE. This can be achieved with snap_reset().
  *          See #snap_status_t for more details.
@@ -126,36 +2385,80 @@ int8_t snap_decode(snap_frame_t *frame, const uint8_t newByte)
 				frame->buffer[SNAP_INDEX_SYNC] = newByte;
 				frame->size = 1;
 				frame->status = SNAP_STATUS_INCOMPLETE;
+				frame->whitening = SNAP_WHITENING_SEED;
 			}
 			return frame->status;
 
 		case SNAP_STATUS_INCOMPLETE:
 			frame->buffer[frame->size++] = newByte;
+			if(frame->scrambling)
+			{
+				snap_whitenBytes(frame, frame->size - 1U, 1);
+			}
 			if(frame->size >= SNAP_MIN_SIZE_FRAME)
 			{
-				const uint8_t hashSize = SNAP_SIZE_HASH(frame->buffer);
-				const uint16_t fullFrameSize = (uint16_t)(SNAP_INDEX_HASH(frame->buffer) + hashSize);
+				const uint8_t edm = SNAP_HDB1_EDM(frame->buffer);
 
-				if(frame->maxSize < fullFrameSize)
-				{
-					frame->status = SNAP_STATUS_ERROR_OVERFLOW;
-				}
-				else if(frame->size >= fullFrameSize)
+				if(frame->size == SNAP_MIN_SIZE_FRAME)
 				{
-					if(hashSize)
+					if(SNAP_IS_EXACT_LENGTH(frame->buffer))
+					{
+						snap_setLayout(frame, SNAP_LENGTH_MAX_SIZE, 0);	// Provisional, until the data length field is received
+					}
+					else
+					{
+						snap_updateLayout(frame);
+					}
+
+					if(frame->maxSize < frame->layout.fullSize)
 					{
-						uint32_t expectedHash, actualHash;
+						frame->status = SNAP_STATUS_ERROR_OVERFLOW;
+						return frame->status;
+					}
+
+					frame->incrementalHash = snap_isIncrementalHash(edm);
+					frame->hash = frame->incrementalHash ? snap_updateHash(edm, snap_initHash(edm), frame->buffer[SNAP_INDEX_HDB2]) : 0;
+				}
 
-						snap_calculateHash(frame, &expectedHash);
-						snap_getField(frame, &actualHash, SNAP_FIELD_HASH);
+				if(snap_isLengthComplete(frame) || snap_isDepthComplete(frame))
+				{
+					snap_updateLayout(frame);
 
-						frame->status = (actualHash == expectedHash) ? SNAP_STATUS_VALID : SNAP_STATUS_ERROR_HASH;
+					if((frame->layout.dataSize > SNAP_MAX_SIZE_DATA) || (frame->maxSize < frame->layout.fullSize))
+					{
+						frame->status = SNAP_STATUS_ERROR_OVERFLOW;
+						return frame->status;
 					}
-					else
+
+					if(!snap_isAddressAccepted(frame))	// Delayed until the frame size is known
 					{
-						frame->status = SNAP_STATUS_VALID;
+						snap_skipFrame(frame);
+						return frame->status;
 					}
 				}
+				else if((frame->size == frame->layout.sourceIndex) && !SNAP_IS_EXACT_LENGTH(frame->buffer) && !snap_hasDepth(frame) &&
+						!snap_isAddressAccepted(frame))
+				{
+					snap_skipFrame(frame);
+					return frame->status;
+				}
+
+				if(frame->incrementalHash && (frame->size <= frame->layout.hashIndex))
+				{
+					frame->hash = snap_updateHash(edm, frame->hash, frame->buffer[frame->size - 1]);
+				}
+
+				if(frame->size >= frame->layout.fullSize)
+				{
+					snap_validateFrame(frame);
+				}
+			}
+			return frame->status;
+
+		case SNAP_STATUS_SKIPPING:
+			if(--frame->skipCount == 0)
+			{
+				frame->status = SNAP_STATUS_IDLE;
 			}
 			return frame->status;
 
@@ -164,15 +2467,176 @@ int8_t snap_decode(snap_frame_t *frame, const uint8_t newByte)
 	}
 }
 
+/**
+ * @brief Detect, decode, validate and store a frame from a slice of bytes.
+ * @details This function produces the same result as calling snap_decode() for every byte of the slice,
+ *          but it searches for the sync byte with memchr() and copies the frame bytes in blocks.
+ *          It stops consuming bytes as soon as the frame is complete (valid or not) or an error occurs,
+ *          so the remaining bytes of the slice can be decoded after handling the frame and calling snap_reset().
+ *          Frames rejected by the address filter (see snap_setAddressFilter()) are skipped in blocks without stopping.
+ * @param[in,out] frame    Pointer to the frame structure.
+ * @param[in]     bytes    Pointer to the bytes to be decoded.
+ * @param[in]     size     Number of bytes in the slice.
+ * @param[out]    consumed Pointer to the variable that will store the number of bytes consumed from the slice. It can be NULL.
+ * @return Frame status after the process. It can be any value from #snap_status_t.
+ */
+int8_t snap_decodeBuffer(snap_frame_t *frame, const uint8_t *bytes, const uint16_t size, uint16_t *consumed)
+{
+	uint_fast16_t index = 0;
+
+	while(index < size)
+	{
+		if(frame->status == SNAP_STATUS_IDLE)
+		{
+			const uint8_t *sync = memchr(&bytes[index], SNAP_SYNC, size - index);
+			if(sync == NULL)
+			{
+				index = size;
+				break;
+			}
+
+			index = (uint_fast16_t)(sync - bytes);
+			snap_decode(frame, bytes[index++]);
+			continue;
+		}
+
+		if(frame->status == SNAP_STATUS_SKIPPING)
+		{
+			const uint16_t available = (uint16_t)(size - index);
+			const uint16_t blockSize = (available < frame->skipCount) ? available : frame->skipCount;
+
+			frame->skipCount = (uint16_t)(frame->skipCount - blockSize);
+			frame->status = (frame->skipCount != 0) ? SNAP_STATUS_SKIPPING : SNAP_STATUS_IDLE;
+			index += blockSize;
+			continue;
+		}
+
+		if(frame->status != SNAP_STATUS_INCOMPLETE)
+		{
+			break;	// Valid frame or error
+		}
+
+		if((frame->size < SNAP_MIN_SIZE_FRAME) || (frame->size < frame->layout.sourceIndex) ||
+		   ((SNAP_IS_EXACT_LENGTH(frame->buffer) || frame->interleaving) && (frame->size < frame->layout.dataIndex)))
+		{
+			snap_decode(frame, bytes[index++]);	// Sync, header and destination address bytes (up to the protocol flags or data length field)
+			continue;
+		}
+
+		const uint8_t edm = SNAP_HDB1_EDM(frame->buffer);
+		const uint16_t hashIndex = frame->layout.hashIndex;
+		const uint16_t fullFrameSize = frame->layout.fullSize;
+		const uint16_t available = (uint16_t)(size - index);
+		const uint16_t missing = (uint16_t)(fullFrameSize - frame->size);
+		const uint16_t blockSize = (available < missing) ? available : missing;
+
+		memcpy(&frame->buffer[frame->size], &bytes[index], blockSize);
+
+		if(frame->scrambling)
+		{
+			snap_whitenBytes(frame, frame->size, blockSize);
+		}
+
+		if(frame->incrementalHash && (frame->size < hashIndex))
+		{
+			const uint16_t hashedSize = (uint16_t)(hashIndex - frame->size);
+			frame->hash = snap_updateHashBlock(edm, frame->hash, &frame->buffer[frame->size], (blockSize < hashedSize) ? blockSize : hashedSize);
+		}
+
+		frame->size = (uint16_t)(frame->size + blockSize);
+		index += blockSize;
+
+		if(frame->size >= fullFrameSize)
+		{
+			snap_validateFrame(frame);
+		}
+	}
+
+	if(consumed != NULL)
+	{
+		*consumed = (uint16_t)index;
+	}
+
+	return frame->status;
+}
+
+/**
+ * @brief Detect, decode, validate and store frames from a continuous stream, one byte at a time, recovering from errors without losing the stored bytes.
+ * @details This function works like snap_decode(), but a frame that ends with an error (#SNAP_STATUS_ERROR_HASH or
+ *          #SNAP_STATUS_ERROR_OVERFLOW) does not need to be reset. On the next call, the bytes already stored after the failed
+ *          sync byte are rescanned for the next sync byte and decoded again, so a frame that started inside the failed one
+ *          (e.g. after a false sync byte) is recovered without waiting for a fresh sync byte. Errors found while decoding the
+ *          stored bytes again are not reported. A frame recovered this way is only accepted if it has a hash value, because
+ *          payload bytes equal to the sync byte would otherwise produce unverifiable frames. A valid frame must still be
+ *          handled and reset with snap_reset(); bytes received meanwhile are stored after the frame and decoded after the reset.
+ *          Bytes that do not fit in the buffer are lost, and #snap_frame_t::pendingOverflow is set until the next valid frame.
+ *          Do not mix calls to this function and snap_decode() or snap_decodeBuffer() on the same frame.
+ * @param[in,out] frame   Pointer to the frame structure.
+ * @param[in]     newByte Byte to be decoded.
+ * @return Frame status after the process. It can be any value from #snap_status_t.
+ */
+int8_t snap_decodeStream(snap_frame_t *frame, const uint8_t newByte)
+{
+	for(;;)
+	{
+		if((frame->status == SNAP_STATUS_ERROR_HASH) || (frame->status == SNAP_STATUS_ERROR_OVERFLOW))
+		{
+			snap_resync(frame);
+		}
+		else if((frame->status != SNAP_STATUS_VALID) && (frame->pendingSize != 0))
+		{
+			snap_replay(frame, frame->pendingIndex, frame->pendingSize);
+		}
+		else
+		{
+			break;
+		}
+
+		snap_checkResynced(frame);
+	}
+
+	if(frame->status != SNAP_STATUS_VALID)
+	{
+		if(frame->status == SNAP_STATUS_IDLE)
+		{
+			frame->resynced = false;	// Next sync byte is a fresh one
+		}
+
+		snap_decode(frame, newByte);
+		return snap_checkResynced(frame);
+	}
+
+	if(frame->pendingSize == 0)
+	{
+		frame->pendingIndex = frame->size;
+		frame->pendingOverflow = false;
+	}
+
+	if((frame->pendingIndex + frame->pendingSize) < frame->maxSize)	// Keep the byte until the frame is reset
+	{
+		frame->buffer[frame->pendingIndex + frame->pendingSize++] = newByte;
+	}
+	else
+	{
+		frame->pendingOverflow = true;
+	}
+
+	return frame->status;
+}
+
 /**
  * @brief Encapsulate a new frame into the buffer (if there is enough space).
  *        Update the frame status and size according to the result.
  * @param[in,out] frame  Pointer to the frame structure.
  * @param[in,out] fields Pointer to the structure that contains every data needed to build the frame.
  *                       Fields that do not match the frame format will be ignored.
- *                       The NDB value is always ignored because it will be calculated from the data size.
+ *                       The NDB value is calculated from the data size, unless it is #SNAP_HDB1_NDB_USER_SPECIFIED: then the exact
+ *                       data size (up to #SNAP_MAX_SIZE_DATA) is sent in a data length field and the frame has no padding bytes.
  *                       If data pointer is NULL or data size is zero, the frame will have no payload.
  *                       It is safe to use the same array as data and frame buffer (safe copy).
+ *                       If the data was written in place (see snap_reservePayload()), it is not copied.
+ *                       If interleaving is enabled, the frame is interleaved according to the protocol flags (see snap_setInterleaving()).
+ *                       If scrambling is enabled, the frame is scrambled (see snap_setScrambling()).
  * @return Frame status after the process (value from #snap_status_t).
  * @retval #SNAP_STATUS_VALID          Frame created successfully. Frame size is updated to match the new frame.
  * @retval #SNAP_STATUS_ERROR_OVERFLOW Error: Frame does not fit in the buffer. Buffer remains unchanged. Frame size is changed to zero.
@@ -181,89 +2645,109 @@ int8_t snap_encapsulate(snap_frame_t *frame, snap_fields_t *fields)
 {
 	if(fields->data == NULL)
 	{
-		fields->dataSize = 0;
+		fields->dataSize = 0;
+	}
+
+	uint_fast16_t dataIndex;
+
+	if(!snap_placePayload(frame, fields, &dataIndex))
+	{
+		frame->size = 0;
+		frame->status = SNAP_STATUS_ERROR_OVERFLOW;
+		return frame->status;
+	}
+
+	if(fields->data != &frame->buffer[dataIndex])	// Data is not in place yet
+	{
+		for(uint_fast16_t i = (uint_fast16_t)(dataIndex + fields->dataSize - 1); i >= dataIndex; i--)
+		{
+			frame->buffer[i] = fields->data[i - dataIndex];	// Frame buffer and data pointers may point to the same array (safe copy)
+		}
+	}
+
+	return snap_buildFrame(frame, fields, dataIndex);
+}
+
+/**
+ * @brief Encapsulate a new frame into the buffer (if there is enough space), gathering the payload from several chunks.
+ * @details The chunks are copied one after the other straight into the frame buffer, in the array order, so the
+ *          payload does not need to be assembled in a staging buffer first. Chunks flagged as stored in program memory
+ *          are read with flash loads on AVR targets. The chunks must not overlap the frame buffer.
+ *          Update the frame status and size according to the result.
+ * @param[in,out] frame      Pointer to the frame structure.
+ * @param[in,out] fields     Pointer to the structure that contains every data needed to build the frame, except the payload.
+ *                           The data size is set to the total size of the chunks, and the data pointer is set to the payload inside the frame buffer.
+ *                           The NDB value is calculated from the data size, unless it is #SNAP_HDB1_NDB_USER_SPECIFIED (see snap_encapsulate()).
+ * @param[in]     chunks     Pointer to the array of chunks that make up the payload. It can be NULL if chunkCount is zero.
+ * @param[in]     chunkCount Number of chunks in the array.
+ * @return Frame status after the process (value from #snap_status_t).
+ * @retval #SNAP_STATUS_VALID          Frame created successfully. Frame size is updated to match the new frame.
+ * @retval #SNAP_STATUS_ERROR_OVERFLOW Error: Frame does not fit in the buffer. Buffer remains unchanged. Frame size is changed to zero.
+ */
+int8_t snap_encapsulateChunks(snap_frame_t *frame, snap_fields_t *fields, const snap_chunk_t *chunks, const uint8_t chunkCount)
+{
+	uint_fast32_t dataSize = 0;
+
+	for(uint_fast8_t i = 0; i < chunkCount; i++)
+	{
+		dataSize += chunks[i].size;
 	}
 
-	fields->header.ndb = snap_getNdbFromDataSize(fields->dataSize) & SNAP_HDB1_NDB_MASK;
+	uint_fast16_t dataIndex;
 
-	const uint_fast16_t payloadSize = snap_getDataSizeFromNdb(fields->header.ndb);
-	const uint_fast8_t hashSize = snap_getHashSizeFromEdm(fields->header.edm);
-	const uint_fast8_t payloadIndex = (uint_fast8_t)(SNAP_INDEX_DAB + fields->header.dab + fields->header.sab + fields->header.pfb);
+	fields->dataSize = (dataSize > UINT16_MAX) ? UINT16_MAX : (uint16_t)dataSize;	// Too large anyway
 
-	if(frame->maxSize < (payloadIndex + payloadSize + hashSize))
+	if(!snap_placePayload(frame, fields, &dataIndex))
 	{
 		frame->size = 0;
 		frame->status = SNAP_STATUS_ERROR_OVERFLOW;
 		return frame->status;
 	}
 
-	const uint_fast16_t paddingSize = (uint_fast16_t)(payloadSize - fields->dataSize);
-	uint_fast16_t dataIndex, paddingIndex;
-
-	if(fields->paddingAfter)
-	{
-		dataIndex = payloadIndex;
-		paddingIndex = (uint_fast16_t)(payloadIndex + fields->dataSize);
-	}
-	else
-	{
-		dataIndex = (uint_fast16_t)(payloadIndex + paddingSize);
-		paddingIndex = payloadIndex;
-	}
+	uint8_t *chunkPtr = &frame->buffer[dataIndex];
 
-	for(uint_fast16_t i = (uint_fast16_t)(dataIndex + fields->dataSize - 1); i >= dataIndex; i--)
+	for(uint_fast8_t i = 0; i < chunkCount; i++)
 	{
-		frame->buffer[i] = fields->data[i - dataIndex];	// Frame buffer and data pointers may point to the same array (safe copy)
-	}
+		if(chunks[i].inFlash)
+		{
+			SNAP_MEMCPY_FLASH(chunkPtr, chunks[i].data, chunks[i].size);
+		}
+		else
+		{
+			memcpy(chunkPtr, chunks[i].data, chunks[i].size);
+		}
 
-	for(uint_fast16_t i = paddingIndex; i < paddingIndex + paddingSize; i++)
-	{
-		frame->buffer[i] = SNAP_PADDING;
+		chunkPtr += chunks[i].size;
 	}
 
-	frame->buffer[SNAP_INDEX_SYNC] = SNAP_SYNC;
-
-	frame->buffer[SNAP_INDEX_HDB2] = (uint8_t)((fields->header.dab << SNAP_HDB2_DAB_POS) |
-	                                           (fields->header.sab << SNAP_HDB2_SAB_POS) |
-	                                           (fields->header.pfb << SNAP_HDB2_PFB_POS) |
-	                                           (fields->header.ack << SNAP_HDB2_ACK_POS));
-
-	frame->buffer[SNAP_INDEX_HDB1] = (uint8_t)((fields->header.cmd << SNAP_HDB1_CMD_POS) |
-	                                           (fields->header.edm << SNAP_HDB1_EDM_POS) |
-	                                           (fields->header.ndb << SNAP_HDB1_NDB_POS));
-
-	frame->size = SNAP_INDEX_DAB;
+	fields->data = &frame->buffer[dataIndex];
 
-	for(uint_fast8_t i = fields->header.dab; i != 0; i--)
-	{
-		frame->buffer[frame->size++] = (fields->destAddress >> ((i - 1) * 8)) & 0xFF;
-	}
+	return snap_buildFrame(frame, fields, dataIndex);
+}
 
-	for(uint_fast8_t i = fields->header.sab; i != 0; i--)
-	{
-		frame->buffer[frame->size++] = (fields->sourceAddress >> ((i - 1) * 8)) & 0xFF;
-	}
+/**
+ * @brief Reserve the space of the data bytes in the frame buffer, so the payload can be written in place before encapsulation.
+ * @details The position of the data bytes depends on the frame format (header fields), the data size and the padding position,
+ *          so these fields must be set before calling this function and must not be changed until the frame is encapsulated.
+ *          On success, the data pointer of the fields structure is set to the reserved space. After writing the payload there,
+ *          snap_encapsulate() only fills in the sync byte, header, addresses, flags, padding and hash value around it.
+ *          The frame size and status are not changed.
+ * @param[in]     frame  Pointer to the frame structure.
+ * @param[in,out] fields Pointer to the structure that contains the frame format (DAB, SAB, PFB, EDM and NDB, see snap_encapsulate()), the data size and the padding position.
+ * @return Pointer to the first data byte in the frame buffer, or NULL if the frame would not fit in the buffer.
+ */
+uint8_t *snap_reservePayload(const snap_frame_t *frame, snap_fields_t *fields)
+{
+	uint_fast16_t dataIndex;
 
-	for(uint_fast8_t i = fields->header.pfb; i != 0; i--)
+	if(!snap_placePayload(frame, fields, &dataIndex))
 	{
-		frame->buffer[frame->size++] = (fields->protocolFlags >> ((i - 1) * 8)) & 0xFF;
+		return NULL;
 	}
 
-	frame->size = (uint16_t)(frame->size + payloadSize);
-
-	if(hashSize)
-	{
-		uint32_t hashValue;
-		snap_calculateHash(frame, &hashValue);
-
-		for(uint_fast8_t i = hashSize; i != 0; i--)
-		{
-			frame->buffer[frame->size++] = (hashValue >> ((i - 1) * 8)) & 0xFF;
-		}
-	}
+	fields->data = &frame->buffer[dataIndex];
 
-	frame->status = SNAP_STATUS_VALID;
-	return frame->status;
+	return fields->data;
 }
 
 /**
@@ -273,7 +2757,8 @@ int8_t snap_encapsulate(snap_frame_t *frame, snap_fields_t *fields)
  *                          In case of error, the variable remains unchanged.
  *                          To get the header, the pointer must point to a #snap_header_t.
  *                          To get the destination address, source address, hash value or protocol flags, the pointer must point to a uint32_t.
- *                          To get the data/payload, the pointer must point to an array of uint8_t (it must be large enough to hold all the bytes).
+ *                          To get the data/payload or the FEC bytes (#SNAP_HDB1_EDM_FEC, CRC and parity), the pointer must point to an array of uint8_t
+ *                          (it must be large enough to hold all the bytes).
  * @param[in]  fieldType    Selects the field whose content should be returned. It must be a value from #snap_fieldType_t.
  * @retval >0                         Return the size (bytes) of the field.
  * @retval #SNAP_ERROR_UNKNOWN_FORMAT Error: Frame header is not complete.
@@ -282,6 +2767,57 @@ int8_t snap_encapsulate(snap_frame_t *frame, snap_fields_t *fields)
  * @retval #SNAP_ERROR_FIELD_TYPE     Error: Invalid field type value.
  */
 int16_t snap_getField(const snap_frame_t *frame, void *fieldContent, const uint8_t fieldType)
+{
+	const uint8_t *fieldPtr;
+	const int16_t fieldSize = snap_getFieldPtr(frame, &fieldPtr, fieldType);
+
+	if(fieldSize < 0)
+	{
+		return fieldSize;
+	}
+
+	switch(fieldType)
+	{
+		case SNAP_FIELD_HEADER:
+			snap_readHeader(frame->buffer, (snap_header_t *)fieldContent);
+			break;
+		case SNAP_FIELD_HASH:
+			if(SNAP_HDB1_EDM(frame->buffer) != SNAP_HDB1_EDM_FEC)
+			{
+				*(uint32_t *)fieldContent = snap_readInteger(fieldPtr, (uint8_t)fieldSize);
+				break;
+			}
+			// FEC bytes are copied like the data
+			// fall through
+		case SNAP_FIELD_DATA:
+			for(int_fast16_t i = 0; i < fieldSize; i++)
+			{
+				((uint8_t *)fieldContent)[i] = fieldPtr[i];
+			}
+			break;
+		default:
+			*(uint32_t *)fieldContent = snap_readInteger(fieldPtr, (uint8_t)fieldSize);
+			break;
+	}
+
+	return fieldSize;
+}
+
+/**
+ * @brief Get a pointer to a selected frame field, without copying its content.
+ * @details The pointer refers to the frame buffer, so it is only valid while the buffer holds the frame.
+ *          Multi-byte fields (addresses, flags and hash) are stored MSB first.
+ * @param[in]  frame     Pointer to the frame structure.
+ * @param[out] fieldPtr  Pointer to the variable that will store the pointer to the first byte of the field.
+ *                       In case of error, the variable remains unchanged.
+ * @param[in]  fieldType Selects the field. It must be a value from #snap_fieldType_t.
+ * @retval >0                         Return the size (bytes) of the field.
+ * @retval #SNAP_ERROR_UNKNOWN_FORMAT Error: Frame header is not complete.
+ * @retval #SNAP_ERROR_FRAME_FORMAT   Error: Frame format does not have the requested field.
+ * @retval #SNAP_ERROR_SHORT_FRAME    Error: Frame format has the requested field, but it is incomplete or empty.
+ * @retval #SNAP_ERROR_FIELD_TYPE     Error: Invalid field type value.
+ */
+int16_t snap_getFieldPtr(const snap_frame_t *frame, const uint8_t **fieldPtr, const uint8_t fieldType)
 {
 	if(frame->size < SNAP_MIN_SIZE_FRAME)
 	{
@@ -293,32 +2829,27 @@ int16_t snap_getField(const snap_frame_t *frame, void *fieldContent, const uint8
 	switch(fieldType)
 	{
 		case SNAP_FIELD_HEADER:
-			((snap_header_t *)fieldContent)->dab = SNAP_HDB2_DAB(frame->buffer);
-			((snap_header_t *)fieldContent)->sab = SNAP_HDB2_SAB(frame->buffer);
-			((snap_header_t *)fieldContent)->pfb = SNAP_HDB2_PFB(frame->buffer);
-			((snap_header_t *)fieldContent)->ack = SNAP_HDB2_ACK(frame->buffer);
-			((snap_header_t *)fieldContent)->cmd = SNAP_HDB1_CMD(frame->buffer);
-			((snap_header_t *)fieldContent)->edm = SNAP_HDB1_EDM(frame->buffer);
-			((snap_header_t *)fieldContent)->ndb = SNAP_HDB1_NDB(frame->buffer);
-			return SNAP_SIZE_HEADER;
+			fieldIndex = SNAP_INDEX_HDB2;
+			fieldSize = SNAP_SIZE_HEADER;
+			break;
 		case SNAP_FIELD_DEST_ADDRESS:
 			fieldIndex = SNAP_INDEX_DAB;
 			fieldSize = SNAP_HDB2_DAB(frame->buffer);
 			break;
 		case SNAP_FIELD_SOURCE_ADDRESS:
-			fieldIndex = (uint_fast16_t)SNAP_INDEX_SAB(frame->buffer);
+			fieldIndex = frame->layout.sourceIndex;
 			fieldSize = SNAP_HDB2_SAB(frame->buffer);
 			break;
 		case SNAP_FIELD_DATA:
-			fieldIndex = (uint_fast16_t)SNAP_INDEX_DATA(frame->buffer);
-			fieldSize = SNAP_SIZE_DATA(frame->buffer);
+			fieldIndex = frame->layout.dataIndex;
+			fieldSize = frame->layout.dataSize;
 			break;
 		case SNAP_FIELD_HASH:
-			fieldIndex = (uint_fast16_t)SNAP_INDEX_HASH(frame->buffer);
-			fieldSize = SNAP_SIZE_HASH(frame->buffer);
+			fieldIndex = frame->layout.hashIndex;
+			fieldSize = frame->layout.hashSize;
 			break;
 		case SNAP_FIELD_PROTOCOL_FLAGS:
-			fieldIndex = (uint_fast16_t)SNAP_INDEX_PFB(frame->buffer);
+			fieldIndex = frame->layout.flagsIndex;
 			fieldSize = SNAP_HDB2_PFB(frame->buffer);
 			break;
 		default:
@@ -330,30 +2861,49 @@ int16_t snap_getField(const snap_frame_t *frame, void *fieldContent, const uint8
 		return SNAP_ERROR_FRAME_FORMAT;
 	}
 
-	const uint_fast16_t frameSize = (uint_fast16_t)(fieldIndex + fieldSize);
-
-	if(frame->size < frameSize)
+	if(frame->size < fieldIndex + fieldSize)
 	{
 		return SNAP_ERROR_SHORT_FRAME;
 	}
 
-	if(fieldType == SNAP_FIELD_DATA)
+	*fieldPtr = &frame->buffer[fieldIndex];
+
+	return (int16_t)fieldSize;
+}
+
+/**
+ * @brief Get every field of a frame (except the hash value) in a single call, without copying the data/payload.
+ * @details The data pointer of the fields structure will point to the payload inside the frame buffer
+ *          (or NULL if the frame has no payload), so it is only valid while the buffer holds the frame.
+ *          Fields that are not present in the frame format are set to zero. The padding position is
+ *          not stored in the frame, so it remains unchanged.
+ * @param[in]  frame  Pointer to the frame structure.
+ * @param[out] fields Pointer to the structure that will store the frame fields. In case of error, it remains unchanged.
+ * @retval >=0                        Return the size (bytes) of the data field (including padding bytes).
+ * @retval #SNAP_ERROR_UNKNOWN_FORMAT Error: Frame header is not complete.
+ * @retval #SNAP_ERROR_SHORT_FRAME    Error: Frame is incomplete (every field before the hash value must be present).
+ */
+int16_t snap_decapsulate(snap_frame_t *frame, snap_fields_t *fields)
+{
+	if(frame->size < SNAP_MIN_SIZE_FRAME)
 	{
-		for(uint_fast16_t i = 0; i < fieldSize; i++)
-		{
-			((uint8_t *)fieldContent)[i] = frame->buffer[fieldIndex + i];
-		}
+		return SNAP_ERROR_UNKNOWN_FORMAT;
 	}
-	else
+
+	if(frame->size < frame->layout.hashIndex)
 	{
-		*(uint32_t *)fieldContent = 0;
-		for(uint_fast16_t i = fieldIndex; i < frameSize; i++)
-		{
-			*(uint32_t *)fieldContent = (*(uint32_t *)fieldContent << 8) | frame->buffer[i];
-		}
+		return SNAP_ERROR_SHORT_FRAME;
 	}
 
-	return (int16_t)fieldSize;
+	snap_readHeader(frame->buffer, &fields->header);
+
+	fields->destAddress = snap_readInteger(&frame->buffer[SNAP_INDEX_DAB], fields->header.dab);
+	fields->sourceAddress = snap_readInteger(&frame->buffer[frame->layout.sourceIndex], fields->header.sab);
+	fields->protocolFlags = snap_readInteger(&frame->buffer[frame->layout.flagsIndex], fields->header.pfb);
+	fields->data = frame->layout.dataSize ? &frame->buffer[frame->layout.dataIndex] : NULL;
+	fields->dataSize = frame->layout.dataSize;
+
+	return (int16_t)fields->dataSize;
 }
 
 /**
@@ -373,12 +2923,12 @@ int8_t snap_calculateHash(const snap_frame_t *frame, uint32_t *hash)
 		return SNAP_ERROR_UNKNOWN_FORMAT;
 	}
 
-	if(SNAP_SIZE_HASH(frame->buffer) == 0)
+	if(frame->layout.hashSize == 0)
 	{
 		return SNAP_ERROR_FRAME_FORMAT;
 	}
 
-	uint16_t frameSize = (uint16_t)SNAP_INDEX_HASH(frame->buffer);
+	uint16_t frameSize = frame->layout.hashIndex;
 
 	if(frame->size < frameSize)
 	{
@@ -487,6 +3037,24 @@ uint8_t snap_getHashSizeFromEdm(const uint8_t edm)
 	return hashSize[edm & SNAP_HDB1_EDM_MASK];
 }
 
+/**
+ * @brief Read a big-endian (MSB first) integer of up to 4 bytes.
+ * @param[in] bytes Pointer to the first (MSB) byte.
+ * @param[in] size  Number of bytes (0 to 4).
+ * @return Integer value (zero if size is zero).
+ */
+uint32_t snap_readInteger(const uint8_t *bytes, const uint8_t size)
+{
+	uint32_t value = 0;
+
+	for(uint_fast8_t i = 0; i < size; i++)
+	{
+		value = (value << 8) | bytes[i];
+	}
+
+	return value;
+}
+
 /**
  * @brief Calculate the 8-bit checksum of a byte array.
  * @param[in] data Pointer to the byte array used in the calculation.
@@ -511,10 +3079,12 @@ uint8_t snap_calculateChecksum8(const uint8_t *data, const uint16_t size)
  * @brief Calculate the 8-bit CRC of a byte array.
  * @details This "weak" function can be overridden by a user implementation,
  *          especially when a hardware implementation is available. If the macro
- *          `SNAP_CRC8_TABLE` is defined, this function will use a 256-byte lookup
- *          table to speed up the calculation. If the macro `SNAP_DISABLE_WEAK` is defined,
+ *          `SNAP_CRC8_TABLE_SIZE` is 16 or 256, this function will use a 16-byte or 256-byte
+ *          lookup table in program memory to speed up the calculation. If the macro `SNAP_DISABLE_WEAK` is defined,
  *          this function becomes a "strong" definition, so the only way to override it
- *          is to define the macro `SNAP_OVERRIDE_CRC8`. The algorithm can be described
+ *          is to define the macro `SNAP_OVERRIDE_CRC8`. The decoder accumulates this CRC as each byte arrives, unless
+ *          a user implementation that does not give the check value below is linked in its place: then it calls that one at
+ *          the end of the frame, so the encoder and the decoder use the same function. The algorithm can be described
  *          according to the Rocksoft^tm Model CRC Algorithm by Ross Williams:
  *          | Name            | Width | Poly | Init | RefIn | RefOut | XorOut | Check |
  *          |:---------------:|:-----:|:----:|:----:|:-----:|:------:|:------:|:-----:|
@@ -527,52 +3097,11 @@ SNAP_WEAK uint8_t snap_calculateCrc8(const uint8_t *data, const uint16_t size)
 {
 	uint8_t crc = 0;
 
-#ifdef SNAP_CRC8_TABLE
-
-	static const uint8_t tableCrc8[256] =
-	{
-		0x00, 0x5E, 0xBC, 0xE2, 0x61, 0x3F, 0xDD, 0x83, 0xC2, 0x9C, 0x7E, 0x20,
-		0xA3, 0xFD, 0x1F, 0x41, 0x9D, 0xC3, 0x21, 0x7F, 0xFC, 0xA2, 0x40, 0x1E,
-		0x5F, 0x01, 0xE3, 0xBD, 0x3E, 0x60, 0x82, 0xDC, 0x23, 0x7D, 0x9F, 0xC1,
-		0x42, 0x1C, 0xFE, 0xA0, 0xE1, 0xBF, 0x5D, 0x03, 0x80, 0xDE, 0x3C, 0x62,
-		0xBE, 0xE0, 0x02, 0x5C, 0xDF, 0x81, 0x63, 0x3D, 0x7C, 0x22, 0xC0, 0x9E,
-		0x1D, 0x43, 0xA1, 0xFF, 0x46, 0x18, 0xFA, 0xA4, 0x27, 0x79, 0x9B, 0xC5,
-		0x84, 0xDA, 0x38, 0x66, 0xE5, 0xBB, 0x59, 0x07, 0xDB, 0x85, 0x67, 0x39,
-		0xBA, 0xE4, 0x06, 0x58, 0x19, 0x47, 0xA5, 0xFB, 0x78, 0x26, 0xC4, 0x9A,
-		0x65, 0x3B, 0xD9, 0x87, 0x04, 0x5A, 0xB8, 0xE6, 0xA7, 0xF9, 0x1B, 0x45,
-		0xC6, 0x98, 0x7A, 0x24, 0xF8, 0xA6, 0x44, 0x1A, 0x99, 0xC7, 0x25, 0x7B,
-		0x3A, 0x64, 0x86, 0xD8, 0x5B, 0x05, 0xE7, 0xB9, 0x8C, 0xD2, 0x30, 0x6E,
-		0xED, 0xB3, 0x51, 0x0F, 0x4E, 0x10, 0xF2, 0xAC, 0x2F, 0x71, 0x93, 0xCD,
-		0x11, 0x4F, 0xAD, 0xF3, 0x70, 0x2E, 0xCC, 0x92, 0xD3, 0x8D, 0x6F, 0x31,
-		0xB2, 0xEC, 0x0E, 0x50, 0xAF, 0xF1, 0x13, 0x4D, 0xCE, 0x90, 0x72, 0x2C,
-		0x6D, 0x33, 0xD1, 0x8F, 0x0C, 0x52, 0xB0, 0xEE, 0x32, 0x6C, 0x8E, 0xD0,
-		0x53, 0x0D, 0xEF, 0xB1, 0xF0, 0xAE, 0x4C, 0x12, 0x91, 0xCF, 0x2D, 0x73,
-		0xCA, 0x94, 0x76, 0x28, 0xAB, 0xF5, 0x17, 0x49, 0x08, 0x56, 0xB4, 0xEA,
-		0x69, 0x37, 0xD5, 0x8B, 0x57, 0x09, 0xEB, 0xB5, 0x36, 0x68, 0x8A, 0xD4,
-		0x95, 0xCB, 0x29, 0x77, 0xF4, 0xAA, 0x48, 0x16, 0xE9, 0xB7, 0x55, 0x0B,
-		0x88, 0xD6, 0x34, 0x6A, 0x2B, 0x75, 0x97, 0xC9, 0x4A, 0x14, 0xF6, 0xA8,
-		0x74, 0x2A, 0xC8, 0x96, 0x15, 0x4B, 0xA9, 0xF7, 0xB6, 0xE8, 0x0A, 0x54,
-		0xD7, 0x89, 0x6B, 0x35
-	};
-
-	for(uint_fast16_t i = 0; i < size; i++)
-	{
-		crc = tableCrc8[data[i] ^ crc];
-	}
-
-#else
-
 	for(uint_fast16_t i = 0; i < size; i++)
 	{
-		crc ^= data[i];
-		for(uint_fast8_t j = 0; j < 8; j++)
-		{
-			crc = (crc & 1) ? ((crc >> 1) ^ 0x8C) : (crc >> 1);
-		}
+		crc = snap_updateCrc8(crc, data[i]);
 	}
 
-#endif
-
 	return crc;
 }
 
@@ -584,10 +3113,14 @@ SNAP_WEAK uint8_t snap_calculateCrc8(const uint8_t *data, const uint16_t size)
  * @brief Calculate the 16-bit CRC of a byte array.
  * @details This "weak" function can be overridden by a user implementation,
  *          especially when a hardware implementation is available. If the macro
- *          `SNAP_CRC16_TABLE` is defined, this function will use a 512-byte lookup
- *          table to speed up the calculation. If the macro `SNAP_DISABLE_WEAK` is defined,
+ *          `SNAP_CRC16_TABLE_SIZE` is 16 or 256, this function will use a 32-byte or 512-byte
+ *          lookup table in program memory to speed up the calculation (or 2 KB / 4 KB of slicing
+ *          tables if it is 1024 or 2048, the default on host builds). On x86 hosts whose CPU supports PCLMULQDQ, blocks of
+ *          64 bytes or more are folded with carry-less multiplications instead. If the macro `SNAP_DISABLE_WEAK` is defined,
  *          this function becomes a "strong" definition, so the only way to override it
- *          is to define the macro `SNAP_OVERRIDE_CRC16`. The algorithm can be described
+ *          is to define the macro `SNAP_OVERRIDE_CRC16`. The decoder accumulates this CRC as each byte arrives, unless
+ *          a user implementation that does not give the check value below is linked in its place: then it calls that one at
+ *          the end of the frame, so the encoder and the decoder use the same function. The algorithm can be described
  *          according to the Rocksoft^tm Model CRC Algorithm by Ross Williams:
  *          | Name          | Width | Poly   | Init   | RefIn | RefOut | XorOut | Check  |
  *          |:-------------:|:-----:|:------:|:------:|:-----:|:------:|:------:|:------:|
@@ -598,62 +3131,7 @@ SNAP_WEAK uint8_t snap_calculateCrc8(const uint8_t *data, const uint16_t size)
  */
 SNAP_WEAK uint16_t snap_calculateCrc16(const uint8_t *data, const uint16_t size)
 {
-	uint16_t crc = 0;
-
-#ifdef SNAP_CRC16_TABLE
-
-	static const uint16_t tableCrc16[256] =
-	{
-		0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7, 0x8108,
-		0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF, 0x1231, 0x0210,
-		0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6, 0x9339, 0x8318, 0xB37B,
-		0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE, 0x2462, 0x3443, 0x0420, 0x1401,
-		0x64E6, 0x74C7, 0x44A4, 0x5485, 0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE,
-		0xF5CF, 0xC5AC, 0xD58D, 0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6,
-		0x5695, 0x46B4, 0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D,
-		0xC7BC, 0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
-		0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B, 0x5AF5,
-		0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12, 0xDBFD, 0xCBDC,
-		0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A, 0x6CA6, 0x7C87, 0x4CE4,
-		0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41, 0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD,
-		0xAD2A, 0xBD0B, 0x8D68, 0x9D49, 0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13,
-		0x2E32, 0x1E51, 0x0E70, 0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A,
-		0x9F59, 0x8F78, 0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E,
-		0xE16F, 0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
-		0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E, 0x02B1,
-		0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256, 0xB5EA, 0xA5CB,
-		0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D, 0x34E2, 0x24C3, 0x14A0,
-		0x0481, 0x7466, 0x6447, 0x5424, 0x4405, 0xA7DB, 0xB7FA, 0x8799, 0x97B8,
-		0xE75F, 0xF77E, 0xC71D, 0xD73C, 0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657,
-		0x7676, 0x4615, 0x5634, 0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9,
-		0xB98A, 0xA9AB, 0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882,
-		0x28A3, 0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
-		0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92, 0xFD2E,
-		0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9, 0x7C26, 0x6C07,
-		0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1, 0xEF1F, 0xFF3E, 0xCF5D,
-		0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8, 0x6E17, 0x7E36, 0x4E55, 0x5E74,
-		0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
-	};
-
-	for(uint_fast16_t i = 0; i < size; i++)
-	{
-		crc = (uint16_t)(crc << 8) ^ tableCrc16[(crc >> 8) ^ data[i]];
-	}
-
-#else
-
-	for(uint_fast16_t i = 0; i < size; i++)
-	{
-		crc ^= (uint16_t)(data[i] << 8);
-		for(uint_fast8_t j = 0; j < 8; j++)
-		{
-			crc = (uint16_t)((crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1));
-		}
-	}
-
-#endif
-
-	return crc;
+	return snap_updateCrc16Block(0, data, size);
 }
 
 #endif	// SNAP_OVERRIDE_CRC16
@@ -664,10 +3142,14 @@ SNAP_WEAK uint16_t snap_calculateCrc16(const uint8_t *data, const uint16_t size)
  * @brief Calculate the 32-bit CRC of a byte array.
  * @details This "weak" function can be overridden by a user implementation,
  *          especially when a hardware implementation is available. If the macro
- *          `SNAP_CRC32_TABLE` is defined, this function will use a 1024-byte lookup
- *          table to speed up the calculation. If the macro `SNAP_DISABLE_WEAK` is defined,
+ *          `SNAP_CRC32_TABLE_SIZE` is 16 or 256, this function will use a 64-byte or 1024-byte
+ *          lookup table in program memory to speed up the calculation (or 4 KB / 8 KB of slicing
+ *          tables if it is 1024 or 2048, the default on host builds). On x86 hosts whose CPU supports PCLMULQDQ, blocks of
+ *          64 bytes or more are folded with carry-less multiplications instead. If the macro `SNAP_DISABLE_WEAK` is defined,
  *          this function becomes a "strong" definition, so the only way to override it
- *          is to define the macro `SNAP_OVERRIDE_CRC32`. The algorithm can be described
+ *          is to define the macro `SNAP_OVERRIDE_CRC32`. The decoder accumulates this CRC as each byte arrives, unless
+ *          a user implementation that does not give the check value below is linked in its place: then it calls that one at
+ *          the end of the frame, so the encoder and the decoder use the same function. The algorithm can be described
  *          according to the Rocksoft^tm Model CRC Algorithm by Ross Williams:
  *          | Name            | Width | Poly       | Init       | RefIn | RefOut | XorOut     | Check      |
  *          |:---------------:|:-----:|:----------:|:----------:|:-----:|:------:|:----------:|:----------:|
@@ -678,76 +3160,7 @@ SNAP_WEAK uint16_t snap_calculateCrc16(const uint8_t *data, const uint16_t size)
  */
 SNAP_WEAK uint32_t snap_calculateCrc32(const uint8_t *data, const uint16_t size)
 {
-	uint32_t crc = 0xFFFFFFFF;
-
-#ifdef SNAP_CRC32_TABLE
-
-	static const uint32_t tableCrc32[256] =
-	{
-		0x00000000, 0x77073096, 0xEE0E612C, 0x990951BA, 0x076DC419, 0x706AF48F,
-		0xE963A535, 0x9E6495A3, 0x0EDB8832, 0x79DCB8A4, 0xE0D5E91E, 0x97D2D988,
-		0x09B64C2B, 0x7EB17CBD, 0xE7B82D07, 0x90BF1D91, 0x1DB71064, 0x6AB020F2,
-		0xF3B97148, 0x84BE41DE, 0x1ADAD47D, 0x6DDDE4EB, 0xF4D4B551, 0x83D385C7,
-		0x136C9856, 0x646BA8C0, 0xFD62F97A, 0x8A65C9EC, 0x14015C4F, 0x63066CD9,
-		0xFA0F3D63, 0x8D080DF5, 0x3B6E20C8, 0x4C69105E, 0xD56041E4, 0xA2677172,
-		0x3C03E4D1, 0x4B04D447, 0xD20D85FD, 0xA50AB56B, 0x35B5A8FA, 0x42B2986C,
-		0xDBBBC9D6, 0xACBCF940, 0x32D86CE3, 0x45DF5C75, 0xDCD60DCF, 0xABD13D59,
-		0x26D930AC, 0x51DE003A, 0xC8D75180, 0xBFD06116, 0x21B4F4B5, 0x56B3C423,
-		0xCFBA9599, 0xB8BDA50F, 0x2802B89E, 0x5F058808, 0xC60CD9B2, 0xB10BE924,
-		0x2F6F7C87, 0x58684C11, 0xC1611DAB, 0xB6662D3D, 0x76DC4190, 0x01DB7106,
-		0x98D220BC, 0xEFD5102A, 0x71B18589, 0x06B6B51F, 0x9FBFE4A5, 0xE8B8D433,
-		0x7807C9A2, 0x0F00F934, 0x9609A88E, 0xE10E9818, 0x7F6A0DBB, 0x086D3D2D,
-		0x91646C97, 0xE6635C01, 0x6B6B51F4, 0x1C6C6162, 0x856530D8, 0xF262004E,
-		0x6C0695ED, 0x1B01A57B, 0x8208F4C1, 0xF50FC457, 0x65B0D9C6, 0x12B7E950,
-		0x8BBEB8EA, 0xFCB9887C, 0x62DD1DDF, 0x15DA2D49, 0x8CD37CF3, 0xFBD44C65,
-		0x4DB26158, 0x3AB551CE, 0xA3BC0074, 0xD4BB30E2, 0x4ADFA541, 0x3DD895D7,
-		0xA4D1C46D, 0xD3D6F4FB, 0x4369E96A, 0x346ED9FC, 0xAD678846, 0xDA60B8D0,
-		0x44042D73, 0x33031DE5, 0xAA0A4C5F, 0xDD0D7CC9, 0x5005713C, 0x270241AA,
-		0xBE0B1010, 0xC90C2086, 0x5768B525, 0x206F85B3, 0xB966D409, 0xCE61E49F,
-		0x5EDEF90E, 0x29D9C998, 0xB0D09822, 0xC7D7A8B4, 0x59B33D17, 0x2EB40D81,
-		0xB7BD5C3B, 0xC0BA6CAD, 0xEDB88320, 0x9ABFB3B6, 0x03B6E20C, 0x74B1D29A,
-		0xEAD54739, 0x9DD277AF, 0x04DB2615, 0x73DC1683, 0xE3630B12, 0x94643B84,
-		0x0D6D6A3E, 0x7A6A5AA8, 0xE40ECF0B, 0x9309FF9D, 0x0A00AE27, 0x7D079EB1,
-		0xF00F9344, 0x8708A3D2, 0x1E01F268, 0x6906C2FE, 0xF762575D, 0x806567CB,
-		0x196C3671, 0x6E6B06E7, 0xFED41B76, 0x89D32BE0, 0x10DA7A5A, 0x67DD4ACC,
-		0xF9B9DF6F, 0x8EBEEFF9, 0x17B7BE43, 0x60B08ED5, 0xD6D6A3E8, 0xA1D1937E,
-		0x38D8C2C4, 0x4FDFF252, 0xD1BB67F1, 0xA6BC5767, 0x3FB506DD, 0x48B2364B,
-		0xD80D2BDA, 0xAF0A1B4C, 0x36034AF6, 0x41047A60, 0xDF60EFC3, 0xA867DF55,
-		0x316E8EEF, 0x4669BE79, 0xCB61B38C, 0xBC66831A, 0x256FD2A0, 0x5268E236,
-		0xCC0C7795, 0xBB0B4703, 0x220216B9, 0x5505262F, 0xC5BA3BBE, 0xB2BD0B28,
-		0x2BB45A92, 0x5CB36A04, 0xC2D7FFA7, 0xB5D0CF31, 0x2CD99E8B, 0x5BDEAE1D,
-		0x9B64C2B0, 0xEC63F226, 0x756AA39C, 0x026D930A, 0x9C0906A9, 0xEB0E363F,
-		0x72076785, 0x05005713, 0x95BF4A82, 0xE2B87A14, 0x7BB12BAE, 0x0CB61B38,
-		0x92D28E9B, 0xE5D5BE0D, 0x7CDCEFB7, 0x0BDBDF21, 0x86D3D2D4, 0xF1D4E242,
-		0x68DDB3F8, 0x1FDA836E, 0x81BE16CD, 0xF6B9265B, 0x6FB077E1, 0x18B74777,
-		0x88085AE6, 0xFF0F6A70, 0x66063BCA, 0x11010B5C, 0x8F659EFF, 0xF862AE69,
-		0x616BFFD3, 0x166CCF45, 0xA00AE278, 0xD70DD2EE, 0x4E048354, 0x3903B3C2,
-		0xA7672661, 0xD06016F7, 0x4969474D, 0x3E6E77DB, 0xAED16A4A, 0xD9D65ADC,
-		0x40DF0B66, 0x37D83BF0, 0xA9BCAE53, 0xDEBB9EC5, 0x47B2CF7F, 0x30B5FFE9,
-		0xBDBDF21C, 0xCABAC28A, 0x53B39330, 0x24B4A3A6, 0xBAD03605, 0xCDD70693,
-		0x54DE5729, 0x23D967BF, 0xB3667A2E, 0xC4614AB8, 0x5D681B02, 0x2A6F2B94,
-		0xB40BBE37, 0xC30C8EA1, 0x5A05DF1B, 0x2D02EF8D
-	};
-
-	for(uint_fast16_t i = 0; i < size; i++)
-	{
-		crc = (crc >> 8) ^ tableCrc32[(crc ^ data[i]) & 0xFF];
-	}
-
-#else
-
-	for(uint_fast16_t i = 0; i < size; i++)
-	{
-		crc = crc ^ data[i];
-		for(uint_fast8_t j = 0; j < 8; j++)
-		{
-			crc = (crc & 1) ? ((crc >> 1) ^ 0xEDB88320) : (crc >> 1);
-		}
-	}
-
-#endif
-
-	return ~crc;
+	return ~snap_updateCrc32Block(0xFFFFFFFF, data, size);
 }
 
 #endif	// SNAP_OVERRIDE_CRC32
@@ -774,6 +3187,209 @@ SNAP_WEAK uint32_t snap_calculateUserHash(const uint8_t *data, const uint16_t si
 
 #endif	// SNAP_OVERRIDE_USER_HASH
 
+/**
+ * @brief Calculate the Reed-Solomon parity bytes of a message (#SNAP_HDB1_EDM_FEC).
+ * @details The code is a systematic Reed-Solomon code over GF(256) (primitive polynomial 0x11D), shortened from
+ *          255 bytes, with #SNAP_SIZE_FEC_PARITY parity bytes and generator roots alpha^0 to alpha^(P-1).
+ *          The codeword is the message followed by the parity bytes (highest degree first).
+ * @param[in]  data   Pointer to the message.
+ * @param[in]  size   Number of bytes in the message. It must not be greater than #SNAP_SIZE_FEC_MESSAGE.
+ * @param[out] parity Pointer to the array that will store the #SNAP_SIZE_FEC_PARITY parity bytes.
+ */
+void snap_calculateFecParity(const uint8_t *data, const uint16_t size, uint8_t *parity)
+{
+	uint8_t generator[SNAP_SIZE_FEC_PARITY];
+	snap_getFecGenerator(generator);
+
+	for(uint_fast8_t i = 0; i < SNAP_SIZE_FEC_PARITY; i++)
+	{
+		parity[i] = 0;
+	}
+
+	for(uint_fast16_t i = 0; i < size; i++)
+	{
+		const uint8_t feedback = data[i] ^ parity[0];
+
+		for(uint_fast8_t j = 0; j < SNAP_SIZE_FEC_PARITY - 1; j++)
+		{
+			parity[j] = parity[j + 1] ^ snap_gfMulExp(feedback, generator[j]);
+		}
+
+		parity[SNAP_SIZE_FEC_PARITY - 1] = snap_gfMulExp(feedback, generator[SNAP_SIZE_FEC_PARITY - 1]);
+	}
+}
+
+/**
+ * @brief Find and correct the errors of a Reed-Solomon codeword (#SNAP_HDB1_EDM_FEC).
+ * @details The syndromes are calculated first, so a correct codeword costs a single pass. Otherwise the error locator
+ *          is found with the Berlekamp-Massey algorithm, the error positions with a Chien search and the error values
+ *          with the Forney algorithm. Up to #SNAP_SIZE_FEC_PARITY / 2 byte errors can be corrected. The codeword is
+ *          only changed if all the errors are found.
+ * @param[in,out] data   Pointer to the message.
+ * @param[in]     size   Number of bytes in the message. It must not be greater than #SNAP_SIZE_FEC_MESSAGE.
+ * @param[in,out] parity Pointer to the #SNAP_SIZE_FEC_PARITY parity bytes.
+ * @retval >=0                        Return the number of bytes corrected.
+ * @retval #SNAP_ERROR_UNCORRECTABLE Error: Codeword has more errors than the code can correct.
+ */
+int16_t snap_correctFecErrors(uint8_t *data, const uint16_t size, uint8_t *parity)
+{
+	const uint_fast16_t codewordSize = (uint_fast16_t)(size + SNAP_SIZE_FEC_PARITY);
+	uint8_t syndromes[SNAP_SIZE_FEC_PARITY];
+	uint8_t hasErrors = 0;
+
+	for(uint_fast8_t j = 0; j < SNAP_SIZE_FEC_PARITY; j++)	// S(j) = codeword(alpha^j)
+	{
+		uint8_t syndrome = 0;
+
+		for(uint_fast16_t i = 0; i < size; i++)
+		{
+			syndrome = snap_gfMulExp(syndrome, j) ^ data[i];
+		}
+
+		for(uint_fast8_t i = 0; i < SNAP_SIZE_FEC_PARITY; i++)
+		{
+			syndrome = snap_gfMulExp(syndrome, j) ^ parity[i];
+		}
+
+		syndromes[j] = syndrome;
+		hasErrors |= syndrome;
+	}
+
+	if(!hasErrors)
+	{
+		return 0;
+	}
+
+	uint8_t locator[SNAP_SIZE_FEC_PARITY + 1] = {1};	// Lowest degree first
+	uint8_t previous[SNAP_SIZE_FEC_PARITY + 1] = {1};
+	uint8_t previousDiscrepancy = 1;
+	uint_fast8_t errorCount = 0;
+	uint_fast8_t shift = 1;
+
+	for(uint_fast8_t n = 0; n < SNAP_SIZE_FEC_PARITY; n++)	// Berlekamp-Massey
+	{
+		uint8_t discrepancy = syndromes[n];
+
+		for(uint_fast8_t i = 1; i <= errorCount; i++)
+		{
+			discrepancy ^= snap_gfMul(locator[i], syndromes[n - i]);
+		}
+
+		if(discrepancy == 0)
+		{
+			shift++;
+			continue;
+		}
+
+		const uint8_t factor = snap_gfDiv(discrepancy, previousDiscrepancy);
+		uint8_t temp[SNAP_SIZE_FEC_PARITY + 1];
+
+		memcpy(temp, locator, sizeof(temp));
+
+		for(uint_fast8_t i = 0; (uint_fast16_t)(i + shift) <= SNAP_SIZE_FEC_PARITY; i++)
+		{
+			locator[i + shift] ^= snap_gfMul(factor, previous[i]);
+		}
+
+		if((2U * errorCount) <= n)
+		{
+			errorCount = (uint_fast8_t)(n + 1 - errorCount);
+			memcpy(previous, temp, sizeof(previous));
+			previousDiscrepancy = discrepancy;
+			shift = 1;
+		}
+		else
+		{
+			shift++;
+		}
+	}
+
+	if((2U * errorCount) > SNAP_SIZE_FEC_PARITY)
+	{
+		return SNAP_ERROR_UNCORRECTABLE;
+	}
+
+	uint8_t evaluator[SNAP_SIZE_FEC_PARITY];	// Omega(x) = S(x) * Lambda(x) mod x^P
+
+	for(uint_fast8_t i = 0; i < SNAP_SIZE_FEC_PARITY; i++)
+	{
+		evaluator[i] = 0;
+
+		for(uint_fast8_t j = 0; (j <= i) && (j <= errorCount); j++)
+		{
+			evaluator[i] ^= snap_gfMul(locator[j], syndromes[i - j]);
+		}
+	}
+
+	uint16_t positions[SNAP_SIZE_FEC_PARITY / 2];
+	uint8_t values[SNAP_SIZE_FEC_PARITY / 2];
+	uint_fast8_t found = 0;
+
+	for(uint_fast16_t k = 0; k < codewordSize; k++)	// Chien search: byte k is wrong if Lambda(X^-1) = 0, with X = alpha^(degree of byte k)
+	{
+		const uint_fast8_t degree = (uint_fast8_t)(codewordSize - 1 - k);
+		const uint_fast8_t inverse = (uint_fast8_t)((degree == 0) ? 0 : (255 - degree));
+		uint8_t value = 0;
+
+		for(uint_fast8_t i = (uint_fast8_t)(errorCount + 1); i != 0; i--)
+		{
+			value = snap_gfMulExp(value, inverse) ^ locator[i - 1];
+		}
+
+		if(value != 0)
+		{
+			continue;
+		}
+
+		if(found == errorCount)
+		{
+			return SNAP_ERROR_UNCORRECTABLE;
+		}
+
+		uint8_t numerator = 0;		// Omega(X^-1)
+		uint8_t denominator = 0;	// Lambda'(X^-1), only odd powers remain in GF(2^m)
+		uint_fast16_t power = 0;
+
+		for(uint_fast8_t i = SNAP_SIZE_FEC_PARITY; i != 0; i--)
+		{
+			numerator = snap_gfMulExp(numerator, inverse) ^ evaluator[i - 1];
+		}
+
+		for(uint_fast8_t i = 1; i <= errorCount; i += 2)
+		{
+			denominator ^= snap_gfMulExp(locator[i], (uint_fast8_t)power);
+			power = (power + 2U * inverse) % 255U;
+		}
+
+		if(denominator == 0)
+		{
+			return SNAP_ERROR_UNCORRECTABLE;
+		}
+
+		positions[found] = (uint16_t)k;
+		values[found++] = snap_gfMulExp(snap_gfDiv(numerator, denominator), degree);	// Forney: X * Omega(X^-1) / Lambda'(X^-1)
+	}
+
+	if(found != errorCount)
+	{
+		return SNAP_ERROR_UNCORRECTABLE;	// Some roots are outside the (shortened) codeword
+	}
+
+	for(uint_fast8_t i = 0; i < found; i++)
+	{
+		if(positions[i] < size)
+		{
+			data[positions[i]] ^= values[i];
+		}
+		else
+		{
+			parity[positions[i] - size] ^= values[i];
+		}
+	}
+
+	return (int16_t)found;
+}
+
 /**
  * @}
  * @}
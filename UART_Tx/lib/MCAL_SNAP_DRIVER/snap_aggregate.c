@@ -0,0 +1,279 @@
+/*
+Copyright (c) 2026 libSNAP contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file   snap_aggregate.c
+ * @brief  Source file of the aggregation layer of the libSNAP library. Refer to the library documentation for details.
+ */
+
+/**
+ * @addtogroup libSNAP
+ * @{
+ */
+
+
+/******************************************************************************/
+/*  Private Includes                                                          */
+/******************************************************************************/
+
+
+#include <stddef.h>
+#include <string.h>
+#include "snap_aggregate.h"
+
+
+/******************************************************************************/
+/*  Public Function Definitions                                               */
+/******************************************************************************/
+
+
+/**
+ * @addtogroup pf
+ * @{
+ */
+
+/**
+ * @brief Initialize the aggregator structure with an empty queue.
+ * @details An aggregator structure should be initialized before passing it to other functions.
+ *          By default, the queue is due when it is full, and the records are sent as soon as possible
+ *          (see snap_setAggregationLimits()). On error, the structure remains unchanged.
+ * @param[out] aggregator  Pointer to the aggregator structure.
+ * @param[in]  buffer      Pointer to the array that will store the queued records.
+ * @param[in]  maxSize     Maximum number of bytes that can be stored in the buffer.
+ *                         If necessary, it will be limited to #SNAP_MAX_SIZE_DATA without generating error.
+ * @param[in]  destAddress Destination address of the records (up to 0xFFFFFF).
+ * @retval >0                       Return the actual maxSize used.
+ * @retval #SNAP_ERROR_NULL_FRAME   Error: Aggregator pointer is NULL.
+ * @retval #SNAP_ERROR_NULL_BUFFER  Error: Buffer pointer is NULL.
+ * @retval #SNAP_ERROR_SHORT_BUFFER Error: maxSize is too small to hold a record.
+ */
+int16_t snap_initAggregator(snap_aggregator_t *aggregator, uint8_t *buffer, const uint16_t maxSize, const uint32_t destAddress)
+{
+	if(aggregator == NULL)
+	{
+		return SNAP_ERROR_NULL_FRAME;
+	}
+
+	if(buffer == NULL)
+	{
+		return SNAP_ERROR_NULL_BUFFER;
+	}
+
+	if(maxSize < SNAP_SIZE_RECORD_HEADER(0))
+	{
+		return SNAP_ERROR_SHORT_BUFFER;
+	}
+
+	aggregator->buffer = buffer;
+	aggregator->maxSize = (maxSize > SNAP_MAX_SIZE_DATA) ? SNAP_MAX_SIZE_DATA : maxSize;
+	aggregator->size = 0;
+	aggregator->count = 0;
+	aggregator->destAddress = destAddress;
+	aggregator->firstTime = 0;
+	snap_setAggregationLimits(aggregator, aggregator->maxSize, 0);
+
+	return (int16_t)aggregator->maxSize;
+}
+
+/**
+ * @brief Set the limits that make the queue due, i.e. ready to be sent (see snap_isAggregateDue()).
+ * @param[in,out] aggregator Pointer to the aggregator structure.
+ * @param[in]     flushSize  Number of queued bytes that makes the queue due. If necessary, it will be limited to the buffer size.
+ * @param[in]     maxDelay   Maximum time that a record can wait in the queue, in the same unit as the time passed to
+ *                           snap_addRecord() and snap_isAggregateDue() (e.g. milliseconds or timer ticks).
+ *                           Zero makes the queue due as soon as it has a record.
+ */
+void snap_setAggregationLimits(snap_aggregator_t *aggregator, const uint16_t flushSize, const uint32_t maxDelay)
+{
+	aggregator->flushSize = (flushSize > aggregator->maxSize) ? aggregator->maxSize : flushSize;
+	aggregator->maxDelay = maxDelay;
+}
+
+/**
+ * @brief Add a record to the queue (if there is enough space).
+ * @details If the record does not fit, the queue should be sent (see snap_encapsulateAggregate()) before adding it again.
+ * @param[in,out] aggregator Pointer to the aggregator structure.
+ * @param[in]     type       Type of the record (defined by the application).
+ * @param[in]     value      Pointer to the record value. It can be NULL if size is zero.
+ * @param[in]     size       Size of the record value.
+ * @param[in]     now        Current time (see snap_setAggregationLimits()). It is stored if the queue was empty.
+ * @retval >0                       Return the number of bytes queued.
+ * @retval #SNAP_ERROR_SHORT_BUFFER Error: Record does not fit in the free space of the buffer. The queue remains unchanged.
+ */
+int16_t snap_addRecord(snap_aggregator_t *aggregator, const uint8_t type, const uint8_t *value, const uint16_t size, const uint32_t now)
+{
+	const uint_fast16_t headerSize = SNAP_SIZE_RECORD_HEADER(size);
+
+	if(((uint_fast32_t)aggregator->size + headerSize + size) > aggregator->maxSize)
+	{
+		return SNAP_ERROR_SHORT_BUFFER;
+	}
+
+	uint8_t *record = &aggregator->buffer[aggregator->size];
+
+	record[0] = type;
+
+	if(headerSize == SNAP_SIZE_RECORD_TYPE + 1U)
+	{
+		record[1] = (uint8_t)size;
+	}
+	else
+	{
+		record[1] = (uint8_t)((size >> 8) | SNAP_LENGTH_EXTENDED);
+		record[2] = (uint8_t)size;
+	}
+
+	if(size != 0)
+	{
+		memcpy(&record[headerSize], value, size);
+	}
+
+	if(aggregator->count++ == 0)
+	{
+		aggregator->firstTime = now;
+	}
+
+	aggregator->size = (uint16_t)(aggregator->size + headerSize + size);
+
+	return (int16_t)aggregator->size;
+}
+
+/**
+ * @brief Check if the queue should be sent, either because it reached the flush size or because its oldest record reached the maximum delay.
+ * @param[in] aggregator Pointer to the aggregator structure.
+ * @param[in] now        Current time (see snap_setAggregationLimits()). The time can wrap around.
+ * @return true if the queue has records and one of the limits was reached, false otherwise.
+ */
+bool snap_isAggregateDue(const snap_aggregator_t *aggregator, const uint32_t now)
+{
+	if(aggregator->count == 0)
+	{
+		return false;
+	}
+
+	return (aggregator->size >= aggregator->flushSize) || ((uint32_t)(now - aggregator->firstTime) >= aggregator->maxDelay);
+}
+
+/**
+ * @brief Encapsulate every queued record into a new frame (if there is enough space) and empty the queue.
+ * @details The frame has the aggregation bit set in the protocol flags (at least 2 flag bytes) and a data length field with the exact payload size.
+ *          Update the frame status and size according to the result.
+ * @param[in,out] frame      Pointer to the frame structure. Its buffer must not be the aggregator buffer.
+ * @param[in]     fields     Pointer to the structure that contains the source address, protocol flags, DAB, SAB, PFB, ACK, CMD and EDM of the frame.
+ *                           It remains unchanged: the destination address, PFB, NDB, aggregation bit and data are only set in a copy.
+ * @param[in,out] aggregator Pointer to the aggregator structure.
+ * @return Frame status after the process (value from #snap_status_t).
+ * @retval #SNAP_STATUS_VALID          Frame created successfully. Frame size is updated to match the new frame. The queue is emptied.
+ * @retval #SNAP_STATUS_ERROR_OVERFLOW Error: Frame does not fit in the buffer. Buffer remains unchanged. Frame size is changed to zero. The queue remains unchanged.
+ */
+int8_t snap_encapsulateAggregate(snap_frame_t *frame, const snap_fields_t *fields, snap_aggregator_t *aggregator)
+{
+	snap_fields_t aggregate = *fields;
+
+	if(aggregate.header.pfb < SNAP_HDB2_PFB_2BYTE_PROTOCOL_FLAGS)
+	{
+		aggregate.header.pfb = SNAP_HDB2_PFB_2BYTE_PROTOCOL_FLAGS;
+	}
+
+	aggregate.header.ndb = SNAP_HDB1_NDB_USER_SPECIFIED;
+	aggregate.protocolFlags |= (uint32_t)SNAP_FLAGS_AGG_MASK << SNAP_FLAGS_AGG_POS;
+	aggregate.destAddress = aggregator->destAddress;
+	aggregate.data = aggregator->buffer;
+	aggregate.dataSize = aggregator->size;
+
+	if(snap_encapsulate(frame, &aggregate) == SNAP_STATUS_VALID)
+	{
+		aggregator->size = 0;
+		aggregator->count = 0;
+	}
+
+	return frame->status;
+}
+
+/**
+ * @brief Prepare the reader structure to read the records of an aggregated frame.
+ * @param[out] reader Pointer to the reader structure. In case of error, it remains unchanged.
+ * @param[in]  frame  Pointer to the frame structure. It must contain a valid frame (see snap_encapsulateAggregate()).
+ * @retval >=0                      Return the size (bytes) of the records.
+ * @retval #SNAP_ERROR_FRAME_FORMAT Error: Frame does not have the aggregation bit set, or it does not have a data length field.
+ */
+int16_t snap_initRecordReader(snap_recordReader_t *reader, const snap_frame_t *frame)
+{
+	uint32_t flags = 0;
+
+	if((snap_getField(frame, &flags, SNAP_FIELD_PROTOCOL_FLAGS) < SNAP_HDB2_PFB_2BYTE_PROTOCOL_FLAGS) || !SNAP_FLAGS_AGG(flags) || !SNAP_IS_EXACT_LENGTH(frame->buffer))
+	{
+		return SNAP_ERROR_FRAME_FORMAT;
+	}
+
+	const uint8_t *data = NULL;
+	const int16_t dataSize = snap_getFieldPtr(frame, &data, SNAP_FIELD_DATA);
+
+	reader->data = data;
+	reader->size = (dataSize > 0) ? (uint16_t)dataSize : 0;
+	reader->index = 0;
+
+	return (int16_t)reader->size;
+}
+
+/**
+ * @brief Read the next record of an aggregated frame, without copying its value.
+ * @param[in,out] reader Pointer to the reader structure.
+ * @param[out]    record Pointer to the structure that will store the record. If there are no more records, it remains unchanged.
+ * @return true if a record was read, false if there are no more records (or the next record is truncated).
+ */
+bool snap_readRecord(snap_recordReader_t *reader, snap_record_t *record)
+{
+	const uint_fast16_t remaining = (uint_fast16_t)(reader->size - reader->index);
+
+	if(remaining < SNAP_SIZE_RECORD_HEADER(0))
+	{
+		reader->index = reader->size;
+		return false;
+	}
+
+	const uint8_t *header = &reader->data[reader->index];
+	const uint_fast16_t headerSize = SNAP_SIZE_RECORD_TYPE + ((header[1] & SNAP_LENGTH_EXTENDED) ? 2U : 1U);
+
+	if((headerSize > remaining) || ((headerSize + SNAP_LENGTH(&header[1])) > remaining))
+	{
+		reader->index = reader->size;
+		return false;
+	}
+
+	record->type = header[0];
+	record->value = &header[headerSize];
+	record->size = SNAP_LENGTH(&header[1]);
+	reader->index = (uint16_t)(reader->index + headerSize + record->size);
+
+	return true;
+}
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/******************************** END OF FILE *********************************/
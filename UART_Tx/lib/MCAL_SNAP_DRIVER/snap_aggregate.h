@@ -0,0 +1,196 @@
+/*
+Copyright (c) 2026 libSNAP contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file   snap_aggregate.h
+ * @brief  Header file of the aggregation layer of the libSNAP library.
+ * @details Small records addressed to the same node are queued and sent together in a single frame, so the sync byte,
+ *          header, addresses, flags and hash value are paid once per frame instead of once per record. The queue is
+ *          flushed when it reaches a size limit or when its oldest record reaches a latency limit.
+ *          Each record is stored as a type byte, a length field (same format as the data length field, see #SNAP_LENGTH())
+ *          and the record value. The aggregation bit of the protocol flags tells the receiver that the payload holds records.
+ *
+ * Example:
+ * @code
+ * // Transmitter (one aggregator per destination)
+ * snap_addRecord(&aggregator, RECORD_SWITCHES, &switches, 1, getTicks());
+ * if(snap_isAggregateDue(&aggregator, getTicks()))
+ * {
+ *     snap_encapsulateAggregate(&txFrame, &fields, &aggregator);
+ *     send(txFrame.buffer, txFrame.size);
+ * }
+ *
+ * // Receiver
+ * if((snap_decode(&rxFrame, newByte) == SNAP_STATUS_VALID) && (snap_initRecordReader(&reader, &rxFrame) >= 0))
+ * {
+ *     while(snap_readRecord(&reader, &record)) { ... record.type, record.value, record.size ... }
+ * }
+ * @endcode
+ */
+
+#ifndef SNAP_AGGREGATE_H_
+#define SNAP_AGGREGATE_H_
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+/**
+ * @addtogroup libSNAP
+ * @{
+ */
+
+
+/******************************************************************************/
+/*  Public Includes                                                           */
+/******************************************************************************/
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "snap.h"
+
+
+/******************************************************************************/
+/*  Public Macros                                                             */
+/******************************************************************************/
+
+
+/**
+ * @addtogroup pm
+ * @{
+ * @name Protocol flags used by the aggregation layer
+ * @{
+ */
+
+#define SNAP_FLAGS_AGG_MASK	(0x01U)	/**< @brief Bit mask of the aggregation bit in the protocol flags. */
+#define SNAP_FLAGS_AGG_POS	(10U)	/**< @brief Position of the aggregation bit in the protocol flags. */
+
+#define SNAP_FLAGS_AGG(flags)	(SNAP_GET_BITS(flags, SNAP_FLAGS_AGG_MASK, SNAP_FLAGS_AGG_POS))	/**< @brief Get the aggregation bit from the protocol flags. It is set if the payload is a sequence of records. @param flags Protocol flags. */
+
+/**
+ * @}
+ * @name Record format
+ * @{
+ */
+
+#define SNAP_SIZE_RECORD_TYPE			(1U)																/**< @brief Size of the type field of a record. */
+#define SNAP_SIZE_RECORD_HEADER(size)	(SNAP_SIZE_RECORD_TYPE + (((size) < SNAP_LENGTH_EXTENDED) ? 1U : 2U))	/**< @brief Size of the type and length fields of a record. @param size Size of the record value. */
+
+/**
+ * @}
+ * @}
+ */
+
+
+/******************************************************************************/
+/*  Public Types                                                              */
+/******************************************************************************/
+
+
+/**
+ * @addtogroup pt
+ * @{
+ */
+
+/**
+ * @brief Queue of records addressed to the same node, waiting to be sent in a single frame.
+ */
+typedef struct snap_aggregator_t
+{
+	uint8_t  *buffer;		/**< @brief Pointer to the array that stores the queued records (the payload of the next frame). */
+	uint16_t maxSize;		/**< @brief Maximum number of bytes that can be stored in the buffer. */
+	uint16_t size;			/**< @brief Number of bytes queued. */
+	uint16_t flushSize;		/**< @brief Number of bytes that makes the queue due (see snap_setAggregationLimits()). */
+	uint16_t count;			/**< @brief Number of records queued (each one takes at least 2 bytes, so it cannot overflow). */
+	uint32_t destAddress;	/**< @brief Destination address of the records. */
+	uint32_t firstTime;		/**< @brief Time when the oldest record was queued. */
+	uint32_t maxDelay;		/**< @brief Time that makes the oldest record due (see snap_setAggregationLimits()). */
+} snap_aggregator_t;
+
+/**
+ * @brief Record read from an aggregated payload. It points to the frame buffer, so it is only valid while the buffer holds the frame.
+ */
+typedef struct snap_record_t
+{
+	const uint8_t *value;	/**< @brief Pointer to the first byte of the record value. */
+	uint16_t      size;		/**< @brief Size of the record value. */
+	uint8_t       type;		/**< @brief Type of the record (defined by the application). */
+} snap_record_t;
+
+/**
+ * @brief Structure that reads the records of an aggregated payload one by one.
+ */
+typedef struct snap_recordReader_t
+{
+	const uint8_t *data;	/**< @brief Pointer to the payload. */
+	uint16_t      size;		/**< @brief Size of the payload. */
+	uint16_t      index;	/**< @brief Index of the next record. */
+} snap_recordReader_t;
+
+/**
+ * @}
+ */
+
+
+/******************************************************************************/
+/*  Public Function Declarations                                              */
+/******************************************************************************/
+
+
+/**
+ * @addtogroup pf
+ * @{
+ * @name Aggregation functions
+ * @{
+ */
+
+int16_t snap_initAggregator(snap_aggregator_t *aggregator, uint8_t *buffer, uint16_t maxSize, uint32_t destAddress);
+
+void snap_setAggregationLimits(snap_aggregator_t *aggregator, uint16_t flushSize, uint32_t maxDelay);
+
+int16_t snap_addRecord(snap_aggregator_t *aggregator, uint8_t type, const uint8_t *value, uint16_t size, uint32_t now);
+
+bool snap_isAggregateDue(const snap_aggregator_t *aggregator, uint32_t now);
+
+int8_t snap_encapsulateAggregate(snap_frame_t *frame, const snap_fields_t *fields, snap_aggregator_t *aggregator);
+
+int16_t snap_initRecordReader(snap_recordReader_t *reader, const snap_frame_t *frame);
+
+bool snap_readRecord(snap_recordReader_t *reader, snap_record_t *record);
+
+/**
+ * @}
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+	}
+#endif
+
+#endif	// SNAP_AGGREGATE_H_
+
+/******************************** END OF FILE *********************************/
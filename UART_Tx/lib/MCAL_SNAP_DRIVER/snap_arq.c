@@ -0,0 +1,428 @@
+/*
+Copyright (c) 2026 libSNAP contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file   snap_arq.c
+ * @brief  Source file of the selective-repeat ARQ layer of the libSNAP library. Refer to the library documentation for details.
+ */
+
+/**
+ * @addtogroup libSNAP
+ * @{
+ */
+
+
+/******************************************************************************/
+/*  Private Includes                                                          */
+/******************************************************************************/
+
+
+#include <stddef.h>
+#include <string.h>
+#include "snap_arq.h"
+
+
+/******************************************************************************/
+/*  Private Macros                                                            */
+/******************************************************************************/
+
+
+#define SNAP_ARQ_SLOT(seq)	((uint_fast8_t)((seq) & (SNAP_ARQ_WINDOW - 1U)))	// Index of the slot of a sequence number
+#define SNAP_ARQ_AHEAD		(128U)												// Distance (modulo 256) from which a sequence number is older than the window
+
+
+/******************************************************************************/
+/*  Private Function Definitions                                              */
+/******************************************************************************/
+
+
+/**
+ * @defgroup pfd Private Functions
+ * @brief Functions visible only to the library source file.
+ * @{
+ */
+
+/**
+ * @brief Move the window past the oldest frames already released.
+ * @param[in,out] sender Pointer to the sender structure.
+ */
+static void snap_moveWindow(snap_arqSender_t *sender)
+{
+	while((sender->base != sender->nextSeq) && !sender->slot[SNAP_ARQ_SLOT(sender->base)].busy)
+	{
+		sender->base++;
+	}
+}
+
+/**
+ * @}
+ */
+
+
+/******************************************************************************/
+/*  Public Function Definitions                                               */
+/******************************************************************************/
+
+
+/**
+ * @addtogroup pf
+ * @{
+ */
+
+/**
+ * @brief Set the sequence number (or cumulative ACK) in the protocol flags, keeping the other flag bits.
+ * @param[in,out] fields Pointer to the structure that contains the frame fields. It gets at least 1 byte of protocol flags.
+ * @param[in]     seq    Sequence number.
+ */
+void snap_setSeq(snap_fields_t *fields, const uint8_t seq)
+{
+	if(fields->header.pfb < SNAP_HDB2_PFB_1BYTE_PROTOCOL_FLAGS)
+	{
+		fields->header.pfb = SNAP_HDB2_PFB_1BYTE_PROTOCOL_FLAGS;
+	}
+
+	fields->protocolFlags = (fields->protocolFlags & ~((uint32_t)SNAP_FLAGS_SEQ_MASK << SNAP_FLAGS_SEQ_POS)) | ((uint32_t)seq << SNAP_FLAGS_SEQ_POS);
+}
+
+/**
+ * @brief Get the sequence number of a frame.
+ * @param[in]  frame Pointer to the frame structure.
+ * @param[out] seq   Pointer to the variable that will store the sequence number.
+ * @return true if the frame has protocol flags, false otherwise (the frame carries no sequence number).
+ */
+bool snap_getSeq(const snap_frame_t *frame, uint8_t *seq)
+{
+	uint32_t flags;
+
+	if(snap_getField(frame, &flags, SNAP_FIELD_PROTOCOL_FLAGS) <= 0)
+	{
+		return false;
+	}
+
+	*seq = (uint8_t)SNAP_FLAGS_SEQ(flags);
+
+	return true;
+}
+
+/**
+ * @brief Initialize the sender structure with an empty window.
+ * @details A sender structure should be initialized before passing it to other functions. The buffer is split into #SNAP_ARQ_WINDOW
+ *          frame buffers. Their frame structures can be configured like any other (e.g. snap_setScrambling()).
+ *          On error, the structure remains unchanged.
+ * @param[out] sender     Pointer to the sender structure.
+ * @param[in]  buffer     Pointer to the array that will store the frames (#SNAP_ARQ_WINDOW * slotSize bytes).
+ * @param[in]  slotSize   Size of each frame buffer. It must be a value from #SNAP_MIN_SIZE_FRAME to #SNAP_MAX_SIZE_BUFFER.
+ * @param[in]  timeout    Time after which a frame not acknowledged is sent again, in the same unit as the time passed to the other
+ *                        functions (e.g. milliseconds or timer ticks). It should be longer than the round trip of a frame and its ACK.
+ * @param[in]  maxRetries Maximum number of times each frame is sent again before it is given up.
+ * @retval >0                       Return the actual size of each frame buffer.
+ * @retval #SNAP_ERROR_NULL_FRAME   Error: Sender pointer is NULL.
+ * @retval #SNAP_ERROR_NULL_BUFFER  Error: Buffer pointer is NULL.
+ * @retval #SNAP_ERROR_SHORT_BUFFER Error: slotSize is less than the minimum allowed (#SNAP_MIN_SIZE_FRAME).
+ */
+int16_t snap_initArqSender(snap_arqSender_t *sender, uint8_t *buffer, const uint16_t slotSize, const uint32_t timeout, const uint8_t maxRetries)
+{
+	if(sender == NULL)
+	{
+		return SNAP_ERROR_NULL_FRAME;
+	}
+
+	if(buffer == NULL)
+	{
+		return SNAP_ERROR_NULL_BUFFER;
+	}
+
+	if(slotSize < SNAP_MIN_SIZE_FRAME)
+	{
+		return SNAP_ERROR_SHORT_BUFFER;
+	}
+
+	for(uint_fast8_t i = 0; i < SNAP_ARQ_WINDOW; i++)
+	{
+		snap_init(&sender->slot[i].frame, &buffer[(uint_fast32_t)i * slotSize], slotSize);
+		sender->slot[i].sendTime = 0;
+		sender->slot[i].retries = 0;
+		sender->slot[i].busy = false;
+		sender->slot[i].lost = false;
+	}
+
+	sender->timeout = timeout;
+	sender->failedCount = 0;
+	sender->base = 0;
+	sender->nextSeq = 0;
+	sender->maxRetries = maxRetries;
+
+	return (int16_t)sender->slot[0].frame.maxSize;
+}
+
+/**
+ * @brief Encapsulate a new frame in the window (if it is not full) and assign it the next sequence number.
+ * @details The frame requests an ACK, and its protocol flags carry the sequence number (at least 1 flag byte).
+ *          The frame is kept until it is acknowledged (see snap_arqProcessAck()) or given up (see snap_arqGetRetransmission()).
+ * @param[in,out] sender Pointer to the sender structure.
+ * @param[in,out] fields Pointer to the structure that contains every data needed to build the frame (see snap_encapsulate()).
+ *                       The PFB, ACK and protocol flags fields are updated with the sequence number.
+ * @param[in]     now    Current time (see snap_initArqSender()).
+ * @return Pointer to the frame structure that holds the frame to be sent, or NULL if the window is full or the frame does not fit in the frame buffer.
+ */
+snap_frame_t *snap_arqSend(snap_arqSender_t *sender, snap_fields_t *fields, const uint32_t now)
+{
+	if(snap_arqGetPendingCount(sender) >= SNAP_ARQ_WINDOW)
+	{
+		return NULL;
+	}
+
+	snap_arqSlot_t *slot = &sender->slot[SNAP_ARQ_SLOT(sender->nextSeq)];
+
+	snap_setSeq(fields, sender->nextSeq);
+	fields->header.ack = SNAP_HDB2_ACK_REQUESTED;
+
+	if(snap_encapsulate(&slot->frame, fields) != SNAP_STATUS_VALID)
+	{
+		return NULL;
+	}
+
+	slot->sendTime = now;
+	slot->retries = 0;
+	slot->busy = true;
+	slot->lost = false;
+	sender->nextSeq++;
+
+	return &slot->frame;
+}
+
+/**
+ * @brief Release the frames acknowledged by an ACK response, and mark the frames reported missing by the selective ACK to be sent again.
+ * @details A frame is reported missing if a later frame was acknowledged. It is sent again right away only once;
+ *          after that, it is sent again only when its timeout elapses.
+ * @param[in,out] sender Pointer to the sender structure.
+ * @param[in]     frame  Pointer to the frame structure. It must contain a valid ACK response (see snap_arqEncapsulateAck()).
+ * @return Number of frames acknowledged. Other frames and ACK responses outside the window are ignored.
+ */
+uint8_t snap_arqProcessAck(snap_arqSender_t *sender, const snap_frame_t *frame)
+{
+	uint8_t cumulative;
+
+	if((SNAP_HDB2_ACK(frame->buffer) != SNAP_HDB2_ACK_RESPONSE_ACK) || !snap_getSeq(frame, &cumulative))
+	{
+		return 0;
+	}
+
+	const uint_fast8_t pending = snap_arqGetPendingCount(sender);
+	const uint_fast8_t acked = (uint_fast8_t)((cumulative - sender->base) & SNAP_FLAGS_SEQ_MASK);
+
+	if(acked > pending)
+	{
+		return 0;	// Stale or invalid ACK
+	}
+
+	const uint8_t *sack = NULL;
+	const int16_t sackSize = snap_getFieldPtr(frame, &sack, SNAP_FIELD_DATA);
+	const uint_fast8_t base = sender->base;
+	uint_fast8_t count = 0, lastAcked = 0;
+
+	for(uint_fast8_t i = 0; i < pending; i++)
+	{
+		snap_arqSlot_t *slot = &sender->slot[SNAP_ARQ_SLOT(base + i)];
+		bool isAcked = (i < acked);
+
+		if(!isAcked && (sackSize > 0))
+		{
+			const uint_fast8_t bit = (uint_fast8_t)(i - acked - 1U);	// Bit of the selective ACK (not used by the cumulative ACK itself)
+
+			isAcked = (i > acked) && ((bit / 8U) < (uint_fast16_t)sackSize) && ((sack[bit / 8U] >> (bit % 8U)) & 1U);
+		}
+
+		if(isAcked)
+		{
+			lastAcked = (uint_fast8_t)(i + 1U);
+
+			if(slot->busy)
+			{
+				slot->busy = false;
+				count++;
+			}
+		}
+	}
+
+	for(uint_fast8_t i = acked; i < lastAcked; i++)
+	{
+		snap_arqSlot_t *slot = &sender->slot[SNAP_ARQ_SLOT(base + i)];
+
+		if(slot->busy && (slot->retries == 0))
+		{
+			slot->lost = true;	// Fast retransmission
+		}
+	}
+
+	snap_moveWindow(sender);
+
+	return (uint8_t)count;
+}
+
+/**
+ * @brief Get the next frame that should be sent again, either because it was reported missing or because its timeout elapsed.
+ * @details Frames that reached the maximum number of retries are given up (counted in #snap_arqSender_t::failedCount) and released.
+ *          This function should be called periodically, until it returns NULL.
+ * @param[in,out] sender Pointer to the sender structure.
+ * @param[in]     now    Current time (see snap_initArqSender()). The time can wrap around.
+ * @return Pointer to the frame structure that holds the frame to be sent again, or NULL if there are none.
+ */
+snap_frame_t *snap_arqGetRetransmission(snap_arqSender_t *sender, const uint32_t now)
+{
+	for(uint_fast8_t seq = sender->base; seq != sender->nextSeq; seq = (uint_fast8_t)((seq + 1U) & SNAP_FLAGS_SEQ_MASK))
+	{
+		snap_arqSlot_t *slot = &sender->slot[SNAP_ARQ_SLOT(seq)];
+
+		if(!slot->busy || (!slot->lost && ((uint32_t)(now - slot->sendTime) < sender->timeout)))
+		{
+			continue;
+		}
+
+		if(slot->retries >= sender->maxRetries)
+		{
+			sender->failedCount++;
+			slot->busy = false;
+			snap_moveWindow(sender);
+			continue;
+		}
+
+		slot->sendTime = now;
+		slot->retries++;
+		slot->lost = false;
+
+		return &slot->frame;
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Get the number of frames in the window, i.e. sent and not acknowledged nor given up yet.
+ * @param[in] sender Pointer to the sender structure.
+ * @return Number of frames (0 to #SNAP_ARQ_WINDOW).
+ */
+uint8_t snap_arqGetPendingCount(const snap_arqSender_t *sender)
+{
+	return (uint8_t)(sender->nextSeq - sender->base);
+}
+
+/**
+ * @brief Initialize the receiver structure. The next frame expected has sequence number zero.
+ * @param[out] receiver Pointer to the receiver structure.
+ */
+void snap_initArqReceiver(snap_arqReceiver_t *receiver)
+{
+	receiver->received = 0;
+	receiver->base = 0;
+}
+
+/**
+ * @brief Register a data frame received and check if it is new.
+ * @details Frames inside the window are new if they were not received before. Frames ahead of the window (the sender gave up
+ *          some frames) move the window forward. Frames behind the window are duplicates. An ACK response should be sent
+ *          for every data frame, new or not (see snap_arqEncapsulateAck()).
+ * @param[in,out] receiver Pointer to the receiver structure.
+ * @param[in]     frame    Pointer to the frame structure. It must contain a valid frame.
+ * @return true if the frame is new and should be delivered to the application, false if it is a duplicate or not an ARQ data frame.
+ */
+bool snap_arqReceive(snap_arqReceiver_t *receiver, const snap_frame_t *frame)
+{
+	uint8_t seq;
+
+	if((SNAP_HDB2_ACK(frame->buffer) != SNAP_HDB2_ACK_REQUESTED) || !snap_getSeq(frame, &seq))
+	{
+		return false;
+	}
+
+	uint_fast8_t offset = (uint_fast8_t)((seq - receiver->base) & SNAP_FLAGS_SEQ_MASK);
+
+	if(offset >= SNAP_ARQ_AHEAD)
+	{
+		return false;	// Behind the window
+	}
+
+	if(offset >= SNAP_ARQ_WINDOW)
+	{
+		const uint_fast8_t shift = (uint_fast8_t)(offset - SNAP_ARQ_WINDOW + 1U);
+
+		receiver->received = (shift < 32U) ? (receiver->received >> shift) : 0;
+		receiver->base = (uint8_t)(receiver->base + shift);
+		offset = SNAP_ARQ_WINDOW - 1U;
+	}
+
+	const uint32_t bit = UINT32_C(1) << offset;
+
+	if(receiver->received & bit)
+	{
+		return false;
+	}
+
+	receiver->received |= bit;
+
+	while(receiver->received & 1U)
+	{
+		receiver->received >>= 1;
+		receiver->base++;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Encapsulate an ACK response with the cumulative ACK and the selective ACK bitmap of the receiver.
+ * @details Update the frame status and size according to the result.
+ * @param[in]     receiver Pointer to the receiver structure.
+ * @param[in,out] frame    Pointer to the frame structure.
+ * @param[in,out] fields   Pointer to the structure that contains the addresses, protocol flags, DAB, SAB, PFB and EDM of the frame.
+ *                         The PFB, ACK, NDB, protocol flags and data fields are updated with the ACK response.
+ * @return Frame status after the process (value from #snap_status_t).
+ * @retval #SNAP_STATUS_VALID          Frame created successfully. Frame size is updated to match the new frame.
+ * @retval #SNAP_STATUS_ERROR_OVERFLOW Error: Frame does not fit in the buffer. Buffer remains unchanged. Frame size is changed to zero.
+ */
+int8_t snap_arqEncapsulateAck(const snap_arqReceiver_t *receiver, snap_frame_t *frame, snap_fields_t *fields)
+{
+	uint8_t sack[SNAP_ARQ_SIZE_SACK];
+	const uint32_t bitmap = receiver->received >> 1;	// Bit 0 is the cumulative ACK itself, which was not received
+	const snap_chunk_t chunk = {sack, (SNAP_ARQ_WINDOW > 1U) ? SNAP_ARQ_SIZE_SACK : 0U, false};
+
+	for(uint_fast8_t i = 0; i < SNAP_ARQ_SIZE_SACK; i++)
+	{
+		sack[i] = (uint8_t)(bitmap >> (8U * i));
+	}
+
+	snap_setSeq(fields, receiver->base);
+	fields->header.ack = SNAP_HDB2_ACK_RESPONSE_ACK;
+	fields->header.ndb = SNAP_HDB1_NDB_USER_SPECIFIED;
+
+	return snap_encapsulateChunks(frame, fields, &chunk, 1);
+}
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/******************************** END OF FILE *********************************/
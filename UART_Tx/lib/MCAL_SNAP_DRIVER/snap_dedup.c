@@ -0,0 +1,416 @@
+/*
+Copyright (c) 2026 libSNAP contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file   snap_dedup.c
+ * @brief  Source file of the duplicate suppression cache of the libSNAP library. Refer to the library documentation for details.
+ */
+
+/**
+ * @addtogroup libSNAP
+ * @{
+ */
+
+
+/******************************************************************************/
+/*  Private Includes                                                          */
+/******************************************************************************/
+
+
+#include <stddef.h>
+#include "snap_dedup.h"
+
+
+/******************************************************************************/
+/*  Private Macros                                                            */
+/******************************************************************************/
+
+
+#define SNAP_DEDUP_AHEAD	(128U)	// Distance (modulo 256) from which a sequence number is older than the highest one
+
+
+/******************************************************************************/
+/*  Private Function Definitions                                              */
+/******************************************************************************/
+
+
+/**
+ * @defgroup pfd Private Functions
+ * @brief Functions visible only to the library source file.
+ * @{
+ */
+
+/**
+ * @brief Get the source address and the sequence number of a frame.
+ * @param[in]  frame         Pointer to the frame structure. It must contain a valid frame.
+ * @param[out] sourceAddress Pointer to the variable that will store the source address.
+ * @param[out] seq           Pointer to the variable that will store the sequence number.
+ * @return true if the frame has both fields and is not an ACK/NACK response (which carries the sequence number of the frame it answers), false otherwise.
+ */
+static bool snap_getDedupKey(const snap_frame_t *frame, uint32_t *sourceAddress, uint8_t *seq)
+{
+	return (frame->status == SNAP_STATUS_VALID) && (SNAP_HDB2_ACK(frame->buffer) < SNAP_HDB2_ACK_RESPONSE_ACK) &&
+		   (snap_getField(frame, sourceAddress, SNAP_FIELD_SOURCE_ADDRESS) > 0) &&
+		   snap_getSeq(frame, seq);
+}
+
+/**
+ * @brief Find the entry of a source.
+ * @param[in] dedup         Pointer to the cache structure.
+ * @param[in] sourceAddress Source address.
+ * @return Index of the entry, or the number of entries in use if there is none.
+ */
+static uint_fast8_t snap_findDedupEntry(const snap_dedup_t *dedup, const uint32_t sourceAddress)
+{
+	uint_fast8_t i = 0;
+
+	while((i < dedup->count) && (dedup->entry[i].sourceAddress != sourceAddress))
+	{
+		i++;
+	}
+
+	return i;
+}
+
+/**
+ * @brief Get the bit of a sequence number in the bitmaps of an entry.
+ * @param[in]  entry Pointer to the entry.
+ * @param[in]  seq   Sequence number.
+ * @param[out] bit   Pointer to the variable that will store the bit mask.
+ * @return true if the sequence number is in the window of the entry (not newer than its highest one, and less than
+ *         #SNAP_ARQ_WINDOW behind it), false otherwise.
+ */
+static bool snap_getDedupBit(const snap_dedupEntry_t *entry, const uint8_t seq, uint32_t *bit)
+{
+	const uint_fast8_t behind = (uint_fast8_t)((entry->seq - seq) & SNAP_FLAGS_SEQ_MASK);
+
+	if(behind >= SNAP_ARQ_WINDOW)
+	{
+		return false;
+	}
+
+	*bit = (uint32_t)1 << behind;
+	return true;
+}
+
+/**
+ * @brief Move the oldest sequence number not answered yet of an entry past the frames answered, and into its window.
+ * @param[in,out] entry Pointer to the entry.
+ */
+static void snap_moveDedupBase(snap_dedupEntry_t *entry)
+{
+	const uint32_t answered = entry->ack | entry->nack;
+	uint_fast8_t span = (uint_fast8_t)((entry->seq - entry->base + 1U) & SNAP_FLAGS_SEQ_MASK);	// Frames from the base to the highest one
+
+	if(span > SNAP_ARQ_WINDOW)
+	{
+		entry->base = (uint8_t)(entry->seq - SNAP_ARQ_WINDOW + 1U);	// The sender gave up the frames behind the window
+		span = SNAP_ARQ_WINDOW;
+	}
+
+	while((span > 0) && (((answered >> (span - 1U)) & 1U) != 0))
+	{
+		entry->base++;
+		span--;
+	}
+}
+
+/**
+ * @brief Get the state of an entry as a receiver of the ARQ layer, to build its ACK responses.
+ * @param[in]  entry    Pointer to the entry.
+ * @param[out] receiver Pointer to the receiver structure.
+ */
+static void snap_getDedupReceiver(const snap_dedupEntry_t *entry, snap_arqReceiver_t *receiver)
+{
+	const uint32_t answered = entry->ack | entry->nack;
+	const uint_fast8_t span = (uint_fast8_t)((entry->seq - entry->base + 1U) & SNAP_FLAGS_SEQ_MASK);
+
+	receiver->base = entry->base;
+	receiver->received = 0;
+
+	for(uint_fast8_t i = 1; i < span; i++)
+	{
+		receiver->received |= ((answered >> (span - 1U - i)) & 1U) << i;
+	}
+}
+
+/**
+ * @brief Remember a new sequence number in an entry.
+ * @details A newer sequence number slides the window forward. An older one outside the window means that the source
+ *          started again (e.g. after a reset), so the window restarts from it.
+ * @param[in,out] entry Pointer to the entry.
+ * @param[in]     seq   Sequence number. It must not be a duplicate.
+ */
+static void snap_addDedupSeq(snap_dedupEntry_t *entry, const uint8_t seq)
+{
+	const uint_fast8_t ahead = (uint_fast8_t)((seq - entry->seq) & SNAP_FLAGS_SEQ_MASK);
+	uint32_t bit;
+
+	if(snap_getDedupBit(entry, seq, &bit))
+	{
+		entry->received |= bit;
+		return;
+	}
+
+	if((ahead < SNAP_DEDUP_AHEAD) && (ahead < SNAP_ARQ_WINDOW))
+	{
+		entry->received <<= ahead;
+		entry->ack <<= ahead;
+		entry->nack <<= ahead;
+	}
+	else
+	{
+		entry->received = 0;
+		entry->ack = 0;
+		entry->nack = 0;
+		entry->base = seq;
+	}
+
+	entry->seq = seq;
+	entry->received |= 1U;
+	snap_moveDedupBase(entry);
+}
+
+/**
+ * @brief Move an entry to the front of the cache (most recently used).
+ * @param[in,out] dedup Pointer to the cache structure.
+ * @param[in]     index Index of the entry.
+ * @param[in]     entry Content of the entry (it replaces the old one).
+ */
+static void snap_moveDedupEntry(snap_dedup_t *dedup, uint_fast8_t index, const snap_dedupEntry_t *entry)
+{
+	for(; index > 0; index--)
+	{
+		dedup->entry[index] = dedup->entry[index - 1U];
+	}
+
+	dedup->entry[0] = *entry;
+}
+
+/**
+ * @brief Encapsulate a response to a frame of a source.
+ * @details An ACK response carries the cumulative ACK and the selective ACK bitmap of the source, in the format of the ARQ layer.
+ *          A NACK response carries the sequence number of the frame and no data.
+ * @param[in,out] txFrame Pointer to the frame structure of the response.
+ * @param[in,out] fields  Pointer to the structure that contains the source address, DAB, SAB and EDM of the response.
+ *                        The destination address, PFB, ACK, NDB, protocol flags and data fields are updated.
+ * @param[in]     entry   Pointer to the entry of the source (destination of the response).
+ * @param[in]     seq     Sequence number of the frame.
+ * @param[in]     ack     Response (#SNAP_HDB2_ACK_RESPONSE_ACK or #SNAP_HDB2_ACK_RESPONSE_NACK).
+ * @return Frame status after the process (value from #snap_status_t).
+ */
+static int8_t snap_encapsulateResponse(snap_frame_t *txFrame, snap_fields_t *fields, const snap_dedupEntry_t *entry, const uint8_t seq, const uint8_t ack)
+{
+	fields->destAddress = entry->sourceAddress;
+	fields->data = NULL;
+	fields->dataSize = 0;
+
+	if(ack == SNAP_HDB2_ACK_RESPONSE_ACK)
+	{
+		snap_arqReceiver_t receiver;
+
+		snap_getDedupReceiver(entry, &receiver);
+		return snap_arqEncapsulateAck(&receiver, txFrame, fields);
+	}
+
+	fields->header.ack = ack & SNAP_HDB2_ACK_MASK;
+	fields->header.ndb = SNAP_HDB1_NDB_NO_DATA;
+	snap_setSeq(fields, seq);
+
+	return snap_encapsulate(txFrame, fields);
+}
+
+/**
+ * @}
+ */
+
+
+/******************************************************************************/
+/*  Public Function Definitions                                               */
+/******************************************************************************/
+
+
+/**
+ * @addtogroup pf
+ * @{
+ */
+
+/**
+ * @brief Initialize the cache structure with no entries.
+ * @param[out] dedup Pointer to the cache structure.
+ */
+void snap_initDedup(snap_dedup_t *dedup)
+{
+	dedup->count = 0;
+	dedup->duplicateCount = 0;
+}
+
+/**
+ * @brief Check if a frame was already received, and remember it otherwise.
+ * @details A frame is a duplicate if its sequence number was received from its source among the last #SNAP_ARQ_WINDOW ones.
+ *          The entry of the source becomes the most recently used one. A new source takes the place of the least recently
+ *          used one when the cache is full.
+ * @param[in,out] dedup Pointer to the cache structure.
+ * @param[in]     frame Pointer to the frame structure. It must contain a valid frame.
+ * @return true if the frame is a duplicate and should be dropped, false otherwise.
+ */
+bool snap_isDuplicate(snap_dedup_t *dedup, const snap_frame_t *frame)
+{
+	snap_dedupEntry_t entry = {0, 1U, 0, 0, 0, 0};
+	uint32_t bit;
+
+	if(!snap_getDedupKey(frame, &entry.sourceAddress, &entry.seq))
+	{
+		return false;
+	}
+
+	entry.base = entry.seq;
+
+	const uint8_t seq = entry.seq;
+	uint_fast8_t index = snap_findDedupEntry(dedup, entry.sourceAddress);
+	bool duplicate = false;
+
+	if(index < dedup->count)
+	{
+		entry = dedup->entry[index];
+		duplicate = snap_getDedupBit(&entry, seq, &bit) && ((entry.received & bit) != 0);
+
+		if(duplicate)
+		{
+			if(dedup->duplicateCount != UINT16_MAX)
+			{
+				dedup->duplicateCount++;
+			}
+		}
+		else
+		{
+			snap_addDedupSeq(&entry, seq);
+		}
+	}
+	else if(dedup->count < SNAP_DEDUP_SIZE)
+	{
+		dedup->count++;
+	}
+	else
+	{
+		index--;	// Replace the least recently used entry
+	}
+
+	snap_moveDedupEntry(dedup, index, &entry);
+
+	return duplicate;
+}
+
+/**
+ * @brief Encapsulate the response to a new frame (see snap_isDuplicate()), and keep it in the cache for its duplicates.
+ * @details The response has no data besides the selective ACK bitmap of an ACK response. Update the frame status and size according to the result.
+ * @param[in,out] dedup   Pointer to the cache structure.
+ * @param[in,out] txFrame Pointer to the frame structure of the response.
+ * @param[in,out] fields  Pointer to the structure that contains the source address, DAB, SAB and EDM of the response.
+ *                        The destination address, PFB, ACK, NDB, protocol flags and data fields are updated.
+ * @param[in]     rxFrame Pointer to the frame structure of the frame received. It must contain a valid frame.
+ * @param[in]     ack     Response (#SNAP_HDB2_ACK_RESPONSE_ACK or #SNAP_HDB2_ACK_RESPONSE_NACK).
+ * @return Frame status after the process (value from #snap_status_t).
+ * @retval #SNAP_STATUS_VALID          Frame created successfully. Frame size is updated to match the new frame.
+ * @retval #SNAP_STATUS_ERROR_OVERFLOW Error: Invalid response, frame received without source address or protocol flags,
+ *                                     frame not registered by snap_isDuplicate(), or frame does not fit in the buffer.
+ *                                     Frame size is changed to zero.
+ */
+int8_t snap_encapsulateDedupAck(snap_dedup_t *dedup, snap_frame_t *txFrame, snap_fields_t *fields, const snap_frame_t *rxFrame, const uint8_t ack)
+{
+	uint32_t source;
+	uint8_t seq;
+	uint32_t bit;
+	uint_fast8_t index = 0;
+
+	if(((ack != SNAP_HDB2_ACK_RESPONSE_ACK) && (ack != SNAP_HDB2_ACK_RESPONSE_NACK)) || !snap_getDedupKey(rxFrame, &source, &seq) ||
+	   ((index = snap_findDedupEntry(dedup, source)) == dedup->count) || !snap_getDedupBit(&dedup->entry[index], seq, &bit) ||
+	   ((dedup->entry[index].received & bit) == 0))
+	{
+		txFrame->size = 0;
+		txFrame->status = SNAP_STATUS_ERROR_OVERFLOW;
+		return txFrame->status;
+	}
+
+	snap_dedupEntry_t *entry = &dedup->entry[index];
+
+	entry->ack = (ack == SNAP_HDB2_ACK_RESPONSE_ACK) ? (entry->ack | bit) : (entry->ack & ~bit);
+	entry->nack = (ack == SNAP_HDB2_ACK_RESPONSE_NACK) ? (entry->nack | bit) : (entry->nack & ~bit);
+	snap_moveDedupBase(entry);
+
+	return snap_encapsulateResponse(txFrame, fields, entry, seq, ack);
+}
+
+/**
+ * @brief Encapsulate the response already sent to a frame, to answer one of its duplicates.
+ * @details An ACK response carries the current cumulative ACK of the source, which may be past the one sent before.
+ *          Update the frame status and size according to the result.
+ * @param[in]     dedup   Pointer to the cache structure.
+ * @param[in,out] txFrame Pointer to the frame structure of the response.
+ * @param[in,out] fields  Pointer to the structure that contains the source address, DAB, SAB and EDM of the response.
+ *                        The destination address, PFB, ACK, NDB, protocol flags and data fields are updated.
+ * @param[in]     rxFrame Pointer to the frame structure of the duplicate. It must contain a valid frame.
+ * @return Frame status after the process (value from #snap_status_t).
+ * @retval #SNAP_STATUS_VALID          Frame created successfully. Frame size is updated to match the new frame.
+ * @retval #SNAP_STATUS_IDLE           No response was sent to the frame (or it is not in the cache). Nothing is done.
+ * @retval #SNAP_STATUS_ERROR_OVERFLOW Error: Frame does not fit in the buffer. Frame size is changed to zero.
+ */
+int8_t snap_encapsulateCachedAck(const snap_dedup_t *dedup, snap_frame_t *txFrame, snap_fields_t *fields, const snap_frame_t *rxFrame)
+{
+	uint32_t source;
+	uint8_t seq;
+	uint32_t bit;
+
+	if(!snap_getDedupKey(rxFrame, &source, &seq))
+	{
+		return SNAP_STATUS_IDLE;
+	}
+
+	const uint_fast8_t index = snap_findDedupEntry(dedup, source);
+
+	if((index == dedup->count) || !snap_getDedupBit(&dedup->entry[index], seq, &bit))
+	{
+		return SNAP_STATUS_IDLE;
+	}
+
+	if((dedup->entry[index].ack & bit) != 0)
+	{
+		return snap_encapsulateResponse(txFrame, fields, &dedup->entry[index], seq, SNAP_HDB2_ACK_RESPONSE_ACK);
+	}
+
+	if((dedup->entry[index].nack & bit) != 0)
+	{
+		return snap_encapsulateResponse(txFrame, fields, &dedup->entry[index], seq, SNAP_HDB2_ACK_RESPONSE_NACK);
+	}
+
+	return SNAP_STATUS_IDLE;
+}
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/******************************** END OF FILE *********************************/
@@ -0,0 +1,182 @@
+/*
+Copyright (c) 2026 libSNAP contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file   snap_dedup.h
+ * @brief  Header file of the duplicate suppression cache of the libSNAP library.
+ * @details When an ACK response is lost, the sender sends the same frame again, and the receiver would process it twice.
+ *          To avoid that, each sender stamps its frames with its own sequence number (see snap_setSeq()), kept when a frame is
+ *          sent again and incremented for each new frame. The receiver remembers the sequence numbers of the last #SNAP_ARQ_WINDOW
+ *          frames of the most recent sources (up to #SNAP_DEDUP_SIZE, the least recently used one is replaced) and the responses it
+ *          sent, so a duplicate is dropped before the application and answered right away with the same response. Since a sender
+ *          never has more than #SNAP_ARQ_WINDOW frames in flight, this also catches the retransmissions of the selective-repeat
+ *          ARQ layer, which may arrive after later frames.
+ *
+ *          ACK responses use the format of the ARQ layer (see snap_arqEncapsulateAck()): the cumulative ACK is the oldest frame
+ *          of the source not answered yet, and the selective ACK bitmap holds the later frames answered, so snap_arqProcessAck()
+ *          never releases a frame that was lost. A sender without the ARQ layer knows its frame was answered if the cumulative
+ *          ACK is past it. NACK responses carry the sequence number of the frame they answer.
+ *
+ *          Frames without source address or protocol flags, and ACK/NACK responses, are never considered duplicates.
+ *
+ * Example:
+ * @code
+ * if(snap_decode(&rxFrame, newByte) == SNAP_STATUS_VALID)
+ * {
+ *     if(snap_isDuplicate(&dedup, &rxFrame))
+ *     {
+ *         if(snap_encapsulateCachedAck(&dedup, &txFrame, &fields, &rxFrame) == SNAP_STATUS_VALID) send(txFrame.buffer, txFrame.size);
+ *     }
+ *     else
+ *     {
+ *         const uint8_t ack = process(&rxFrame) ? SNAP_HDB2_ACK_RESPONSE_ACK : SNAP_HDB2_ACK_RESPONSE_NACK;
+ *         if(snap_encapsulateDedupAck(&dedup, &txFrame, &fields, &rxFrame, ack) == SNAP_STATUS_VALID) send(txFrame.buffer, txFrame.size);
+ *     }
+ *     snap_reset(&rxFrame);
+ * }
+ * @endcode
+ */
+
+#ifndef SNAP_DEDUP_H_
+#define SNAP_DEDUP_H_
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+/**
+ * @addtogroup libSNAP
+ * @{
+ */
+
+
+/******************************************************************************/
+/*  Public Includes                                                           */
+/******************************************************************************/
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "snap.h"
+#include "snap_arq.h"
+
+
+/******************************************************************************/
+/*  Public Macros                                                             */
+/******************************************************************************/
+
+
+/**
+ * @addtogroup pm
+ * @{
+ * @name Cache size
+ * @{
+ */
+
+#ifdef SNAP_DEDUP_SIZE
+	#if (SNAP_DEDUP_SIZE < 1) || (SNAP_DEDUP_SIZE > 255)
+		#error Invalid duplicate suppression cache size! It must be a value from 1 to 255 (sources).
+	#endif
+#else
+	#define SNAP_DEDUP_SIZE	(8U)	/**< @brief Number of sources remembered by the duplicate suppression cache (1 to 255). Each one takes 18 bytes of RAM (20 bytes on 32-bit targets). It can be defined by the user in the compilation command. */
+#endif
+
+/**
+ * @}
+ * @}
+ */
+
+
+/******************************************************************************/
+/*  Public Types                                                              */
+/******************************************************************************/
+
+
+/**
+ * @addtogroup pt
+ * @{
+ */
+
+/**
+ * @brief Last frames received from a source. Bit i of each bitmap is the frame with sequence number seq - i (up to #SNAP_ARQ_WINDOW frames).
+ */
+typedef struct snap_dedupEntry_t
+{
+	uint32_t sourceAddress;	/**< @brief Source address. */
+	uint32_t received;		/**< @brief Bitmap of the frames received. */
+	uint32_t ack;			/**< @brief Bitmap of the frames answered with #SNAP_HDB2_ACK_RESPONSE_ACK. */
+	uint32_t nack;			/**< @brief Bitmap of the frames answered with #SNAP_HDB2_ACK_RESPONSE_NACK. */
+	uint8_t  seq;			/**< @brief Highest sequence number received from the source (modulo 256). */
+	uint8_t  base;			/**< @brief Oldest sequence number not answered yet (cumulative ACK of the ACK responses). */
+} snap_dedupEntry_t;
+
+/**
+ * @brief Duplicate suppression cache. The entries are kept from the most recently used to the least recently used.
+ */
+typedef struct snap_dedup_t
+{
+	snap_dedupEntry_t entry[SNAP_DEDUP_SIZE];	/**< @brief Entries in use, most recently used first. */
+	uint8_t           count;					/**< @brief Number of entries in use. */
+	uint16_t          duplicateCount;			/**< @brief Number of duplicates dropped (saturated). */
+} snap_dedup_t;
+
+/**
+ * @}
+ */
+
+
+/******************************************************************************/
+/*  Public Function Declarations                                              */
+/******************************************************************************/
+
+
+/**
+ * @addtogroup pf
+ * @{
+ * @name Duplicate suppression functions
+ * @{
+ */
+
+void snap_initDedup(snap_dedup_t *dedup);
+
+bool snap_isDuplicate(snap_dedup_t *dedup, const snap_frame_t *frame);
+
+int8_t snap_encapsulateDedupAck(snap_dedup_t *dedup, snap_frame_t *txFrame, snap_fields_t *fields, const snap_frame_t *rxFrame, uint8_t ack);
+
+int8_t snap_encapsulateCachedAck(const snap_dedup_t *dedup, snap_frame_t *txFrame, snap_fields_t *fields, const snap_frame_t *rxFrame);
+
+/**
+ * @}
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+	}
+#endif
+
+#endif	// SNAP_DEDUP_H_
+
+/******************************** END OF FILE *********************************/
@@ -0,0 +1,194 @@
+/*
+Copyright (c) 2026 libSNAP contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file   snap_fragment.h
+ * @brief  Header file of the fragmentation layer of the libSNAP library.
+ * @details Messages larger than a single frame (up to #SNAP_MAX_SIZE_MESSAGE bytes) are split into fragments
+ *          of the same size (except the last one), each one sent in its own frame with 3 bytes of protocol flags.
+ *          The fragment index and the index of the last fragment are stored in the protocol flags, so the receiver can
+ *          reassemble the fragments in any order and ask for the missing ones only. A message id bit, toggled by the sender for
+ *          each new message (see snap_setFragmentId()), starts a new message as soon as its first fragment arrives. Since a single
+ *          bit repeats every other message, a CRC-16 of the message is sent after its last byte (in the last fragment) and checked
+ *          when the message is complete, which rejects a message completed with the fragments of another one.
+ *
+ * Example:
+ * @code
+ * // Transmitter
+ * snap_setFragmentId(&fields, messageCount++);
+ * for(uint8_t i = 0; i < snap_getFragmentCount(sizeof(image), 128); i++)
+ * {
+ *     snap_encapsulateFragment(&txFrame, &fields, image, sizeof(image), 128, i);
+ *     send(txFrame.buffer, txFrame.size);
+ * }
+ *
+ * // Receiver
+ * if(snap_decode(&rxFrame, newByte) == SNAP_STATUS_VALID)
+ * {
+ *     if(snap_addFragment(&reassembly, &rxFrame) == 0) { ... reassembly.buffer, reassembly.size ... }
+ *     snap_reset(&rxFrame);
+ * }
+ * @endcode
+ */
+
+#ifndef SNAP_FRAGMENT_H_
+#define SNAP_FRAGMENT_H_
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+/**
+ * @addtogroup libSNAP
+ * @{
+ */
+
+
+/******************************************************************************/
+/*  Public Includes                                                           */
+/******************************************************************************/
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "snap.h"
+
+
+/******************************************************************************/
+/*  Public Macros                                                             */
+/******************************************************************************/
+
+
+/**
+ * @addtogroup pm
+ * @{
+ * @name Protocol flags used by the fragmentation layer
+ * @{
+ */
+
+#define SNAP_FLAGS_FRAG_INDEX_MASK	(0x3FU)	/**< @brief Bit mask of the fragment index bits in the protocol flags. */
+#define SNAP_FLAGS_FRAG_INDEX_POS	(12U)	/**< @brief Position of the fragment index bits (LSb) in the protocol flags. */
+#define SNAP_FLAGS_FRAG_LAST_MASK	(0x3FU)	/**< @brief Bit mask of the last fragment index bits in the protocol flags. */
+#define SNAP_FLAGS_FRAG_LAST_POS	(18U)	/**< @brief Position of the last fragment index bits (LSb) in the protocol flags. */
+#define SNAP_FLAGS_FRAG_ID_MASK		(0x01U)	/**< @brief Bit mask of the message id bits in the protocol flags. */
+#define SNAP_FLAGS_FRAG_ID_POS		(11U)	/**< @brief Position of the message id bits (LSb) in the protocol flags. */
+
+#define SNAP_FLAGS_FRAG_INDEX(flags)	(SNAP_GET_BITS(flags, SNAP_FLAGS_FRAG_INDEX_MASK, SNAP_FLAGS_FRAG_INDEX_POS))	/**< @brief Get the fragment index from the protocol flags. @param flags Protocol flags. */
+#define SNAP_FLAGS_FRAG_LAST(flags)		(SNAP_GET_BITS(flags, SNAP_FLAGS_FRAG_LAST_MASK, SNAP_FLAGS_FRAG_LAST_POS))		/**< @brief Get the index of the last fragment from the protocol flags. @param flags Protocol flags. */
+#define SNAP_FLAGS_FRAG_ID(flags)		(SNAP_GET_BITS(flags, SNAP_FLAGS_FRAG_ID_MASK, SNAP_FLAGS_FRAG_ID_POS))			/**< @brief Get the message id from the protocol flags. @param flags Protocol flags. */
+
+/**
+ * @}
+ * @name Fragmentation limits
+ * @{
+ */
+
+#define SNAP_MAX_FRAGMENTS		(SNAP_FLAGS_FRAG_INDEX_MASK + 1U)	/**< @brief Maximum number of fragments of a message. */
+#define SNAP_SIZE_FRAG_CHECK	(2U)								/**< @brief Size of the CRC-16 sent after the last byte of a fragmented message. */
+#define SNAP_MAX_SIZE_MESSAGE	(32765U)							/**< @brief Maximum size of a fragmented message, so the message and its CRC (up to 64 fragments of 512 bytes) fit in the largest positive int16_t. */
+#define SNAP_SIZE_FRAG_BITMAP	(SNAP_MAX_FRAGMENTS / 8U)			/**< @brief Maximum size of a bitmap of fragments (one bit per fragment). */
+
+/**
+ * @}
+ * @}
+ */
+
+
+/******************************************************************************/
+/*  Public Types                                                              */
+/******************************************************************************/
+
+
+/**
+ * @addtogroup pt
+ * @{
+ */
+
+/**
+ * @brief Structure that reassembles a fragmented message from its fragments, received in any order.
+ */
+typedef struct snap_reassembly_t
+{
+	uint8_t  *buffer;							/**< @brief Pointer to the array that stores the message, followed by its CRC (#SNAP_SIZE_FRAG_CHECK bytes). */
+	uint16_t maxSize;							/**< @brief Maximum number of bytes that can be stored in the buffer. */
+	uint16_t size;								/**< @brief Size of the message. It is only valid when every fragment has been received. */
+	uint16_t fragmentSize;						/**< @brief Size of every fragment but the last one (zero until one of them is received). */
+	uint16_t lastSize;							/**< @brief Size of the last fragment (zero until it is received). It is kept at the end of the buffer until the fragment size is known. */
+	uint32_t sourceAddress;						/**< @brief Source address of the message. */
+	uint8_t  received[SNAP_SIZE_FRAG_BITMAP];	/**< @brief Bitmap of the received fragments (bit i of byte i / 8 is fragment i). */
+	uint8_t  missingCount;						/**< @brief Number of fragments not received yet. */
+	uint8_t  lastIndex;							/**< @brief Index of the last fragment. */
+	uint8_t  messageId;							/**< @brief Message id (see snap_setFragmentId()). */
+	bool     started;							/**< @brief At least one fragment of the message has been received. */
+} snap_reassembly_t;
+
+/**
+ * @}
+ */
+
+
+/******************************************************************************/
+/*  Public Function Declarations                                              */
+/******************************************************************************/
+
+
+/**
+ * @addtogroup pf
+ * @{
+ * @name Fragmentation functions
+ * @{
+ */
+
+uint8_t snap_getFragmentCount(uint16_t messageSize, uint16_t fragmentSize);
+
+void snap_setFragmentId(snap_fields_t *fields, uint8_t id);
+
+int8_t snap_encapsulateFragment(snap_frame_t *frame, snap_fields_t *fields, const uint8_t *message, uint16_t messageSize, uint16_t fragmentSize, uint8_t index);
+
+int16_t snap_initReassembly(snap_reassembly_t *reassembly, uint8_t *buffer, uint16_t maxSize);
+
+void snap_resetReassembly(snap_reassembly_t *reassembly);
+
+int16_t snap_addFragment(snap_reassembly_t *reassembly, const snap_frame_t *frame);
+
+uint8_t snap_getMissingFragments(const snap_reassembly_t *reassembly, uint8_t *bitmap);
+
+int8_t snap_encapsulateResendRequest(snap_frame_t *frame, snap_fields_t *fields, const snap_reassembly_t *reassembly);
+
+bool snap_isFragmentRequested(const uint8_t *bitmap, uint16_t bitmapSize, uint8_t index);
+
+/**
+ * @}
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+	}
+#endif
+
+#endif	// SNAP_FRAGMENT_H_
+
+/******************************** END OF FILE *********************************/
@@ -0,0 +1,475 @@
+/*
+Copyright (c) 2026 libSNAP contributors
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file   snap_link.c
+ * @brief  Source file of the link manager of the libSNAP library. Refer to the library documentation for details.
+ */
+
+/**
+ * @addtogroup libSNAP
+ * @{
+ */
+
+
+/******************************************************************************/
+/*  Private Includes                                                          */
+/******************************************************************************/
+
+
+#include <stddef.h>
+#include "snap_link.h"
+
+
+/******************************************************************************/
+/*  Private Macros                                                            */
+/******************************************************************************/
+
+
+#define SNAP_LINK_RATE(percent)	((uint16_t)(((uint32_t)(percent) * SNAP_LINK_RATE_ONE) / 100U))	// Convert a percentage into an error rate
+#define SNAP_LINK_RATE_SHIFT	(4U)															// Weight of each frame in the moving average = 1/16
+#define SNAP_LINK_MIN_EDM		(SNAP_HDB1_EDM_8BIT_CHECKSUM)									// Lightest method of the ladder
+#define SNAP_LINK_MAX_EDM		(SNAP_HDB1_EDM_FEC)												// Strongest method of the ladder
+#define SNAP_LINK_FAIL_WEIGHT	(16U)															// Weight of each failure in the byte error rate counter
+#define SNAP_LINK_MIN_NDB		(SNAP_HDB1_NDB_1BYTE_DATA)										// Smallest NDB size class considered
+#define SNAP_LINK_MAX_NDB		(SNAP_HDB1_NDB_512BYTE_DATA)									// Largest NDB size class considered
+
+
+/******************************************************************************/
+/*  Private Function Definitions                                              */
+/******************************************************************************/
+
+
+/**
+ * @defgroup pfd Private Functions
+ * @brief Functions visible only to the library source file.
+ * @{
+ */
+
+/**
+ * @brief Increment a counter without overflowing it.
+ * @param[in,out] counter Pointer to the counter.
+ */
+static inline void snap_incrementCounter(uint16_t *counter)
+{
+	if(*counter != UINT16_MAX)
+	{
+		(*counter)++;
+	}
+}
+
+/**
+ * @brief Limit an error detection method to the ladder (see snap_initLink()).
+ * @param[in] edm Error detection method.
+ * @return Closest method of the ladder.
+ */
+static inline uint8_t snap_clampEdm(const uint8_t edm)
+{
+	if(edm < SNAP_LINK_MIN_EDM) return SNAP_LINK_MIN_EDM;
+	if(edm > SNAP_LINK_MAX_EDM) return SNAP_LINK_MAX_EDM;
+	return edm;
+}
+
+/**
+ * @brief Check if a link may move to a lighter error detection method (hysteresis).
+ * @param[in] link Pointer to the link structure.
+ * @return true if the error rate is low enough and there was no change nor failure in the last #SNAP_LINK_DOWN_HOLD frames, false otherwise.
+ */
+static inline bool snap_canLowerLink(const snap_link_t *link)
+{
+	return (link->errorRate < SNAP_LINK_RATE(SNAP_LINK_DOWN_PERCENT)) && (link->holdCount >= SNAP_LINK_DOWN_HOLD) &&
+		   (link->cleanCount >= SNAP_LINK_DOWN_HOLD);
+}
+
+/**
+ * @brief Update the error rate of a link with the result of a frame, and move its error detection method along the ladder if necessary.
+ * @param[in,out] link   Pointer to the link structure.
+ * @param[in]     failed true if the frame failed, false otherwise.
+ */
+static void snap_updateLink(snap_link_t *link, const bool failed)
+{
+	if(failed)
+	{
+		link->errorRate = (uint16_t)(link->errorRate + ((SNAP_LINK_RATE_ONE - link->errorRate) >> SNAP_LINK_RATE_SHIFT));
+		link->cleanCount = 0;
+	}
+	else
+	{
+		link->errorRate = (uint16_t)(link->errorRate - (link->errorRate >> SNAP_LINK_RATE_SHIFT));
+
+		if(link->cleanCount != UINT8_MAX)
+		{
+			link->cleanCount++;
+		}
+	}
+
+	if(link->holdCount != UINT8_MAX)
+	{
+		link->holdCount++;
+	}
+
+	if((link->errorRate > SNAP_LINK_RATE(SNAP_LINK_UP_PERCENT)) && (link->holdCount >= SNAP_LINK_UP_HOLD) && (link->edm < link->maxEdm))
+	{
+		link->edm++;
+		link->holdCount = 0;
+	}
+	else if(snap_canLowerLink(link) && (link->edm > link->minEdm))
+	{
+		link->edm--;
+		link->holdCount = 0;
+	}
+}
+
+/**
+ * @brief Add the result of a frame to the byte error rate counters of a link. Both counters are halved at the end of each window.
+ * @param[in,out] link      Pointer to the link structure.
+ * @param[in]     failed    true if the frame failed, false otherwise.
+ * @param[in]     frameSize Number of bytes of the frame.
+ */
+static void snap_countLinkBytes(snap_link_t *link, const bool failed, const uint16_t frameSize)
+{
+	uint32_t byteCount = (uint32_t)link->byteCount + frameSize;
+	uint32_t failWeight = (uint32_t)link->failWeight + (failed ? SNAP_LINK_FAIL_WEIGHT : 0U);
+
+	while(byteCount >= SNAP_LINK_BYTE_WINDOW)
+	{
+		byteCount >>= 1;
+		failWeight >>= 1;
+	}
+
+	link->byteCount = (uint16_t)byteCount;
+	link->failWeight = (failWeight > UINT16_MAX) ? UINT16_MAX : (uint16_t)failWeight;
+}
+
+/**
+ * @brief Calculate the number of bytes of a frame sent to the peer (sync byte included), with the format of the link.
+ * @param[in] link     Pointer to the link structure.
+ * @param[in] header   Pointer to the header of the frame. Only the DAB, SAB, PFB and NDB fields are used.
+ * @param[in] dataSize Number of data bytes (it must be the size of an NDB class, unless the NDB is #SNAP_HDB1_NDB_USER_SPECIFIED).
+ * @return Frame size.
+ */
+static uint_fast16_t snap_getLinkFrameSize(const snap_link_t *link, const snap_header_t *header, const uint_fast16_t dataSize)
+{
+	const uint_fast8_t lengthSize = (header->ndb == SNAP_HDB1_NDB_USER_SPECIFIED) ? ((dataSize < SNAP_LENGTH_EXTENDED) ? 1U : 2U) : 0U;
+	const uint_fast16_t payloadIndex = (uint_fast16_t)(SNAP_INDEX_DAB + header->dab + header->sab + header->pfb + lengthSize);
+
+	if(link->edm == SNAP_HDB1_EDM_FEC)
+	{
+		const uint_fast16_t codedSize = payloadIndex - SNAP_INDEX_HDB2 + dataSize + SNAP_SIZE_FEC_CHECK;	// From HDB2 to the last CRC byte
+		const uint_fast16_t codewordCount = (codedSize + SNAP_SIZE_FEC_MESSAGE - 1U) / SNAP_SIZE_FEC_MESSAGE;
+
+		return (uint_fast16_t)(payloadIndex + dataSize + SNAP_SIZE_FEC_CHECK + codewordCount * SNAP_SIZE_FEC_PARITY);
+	}
+
+	return (uint_fast16_t)(payloadIndex + dataSize + snap_getHashSizeFromEdm(link->edm));
+}
+
+/**
+ * @brief Calculate the probability that a frame goes through the link, given its byte error rate.
+ * @param[in] byteErrorRate Byte error rate (#SNAP_LINK_RATE_ONE = 100 %).
+ * @param[in] frameSize     Number of bytes of the frame.
+ * @return Probability = (1 - byteErrorRate) ^ frameSize (#SNAP_LINK_RATE_ONE = 100 %).
+ */
+static uint16_t snap_getLinkSuccessRate(const uint16_t byteErrorRate, uint_fast16_t frameSize)
+{
+	uint32_t base = SNAP_LINK_RATE_ONE - byteErrorRate;
+	uint32_t result = SNAP_LINK_RATE_ONE;
+
+	if(byteErrorRate == 0)
+	{
+		return SNAP_LINK_RATE_ONE;
+	}
+
+	while((frameSize != 0) && (result != 0))	// Exponentiation by squaring
+	{
+		if(frameSize & 1U)
+		{
+			result = (result * base) / SNAP_LINK_RATE_ONE;
+		}
+
+		base = (base * base) / SNAP_LINK_RATE_ONE;
+		frameSize >>= 1;
+	}
+
+	return (uint16_t)result;
+}
+
+/**
+ * @}
+ */
+
+
+/******************************************************************************/
+/*  Public Function Definitions                                               */
+/******************************************************************************/
+
+
+/**
+ * @addtogroup pf
+ * @{
+ */
+
+/**
+ * @brief Initialize the link structure of a peer. The link starts with the lightest error detection method allowed.
+ * @param[out] link    Pointer to the link structure.
+ * @param[in]  address Address of the peer.
+ * @param[in]  minEdm  Lightest error detection method that can be used with the peer (#SNAP_HDB1_EDM_8BIT_CHECKSUM to #SNAP_HDB1_EDM_FEC).
+ * @param[in]  maxEdm  Strongest error detection method supported by the peer (#SNAP_HDB1_EDM_8BIT_CHECKSUM to #SNAP_HDB1_EDM_FEC).
+ *                     Values outside the ladder are limited to it, and maxEdm is raised to minEdm if necessary.
+ */
+void snap_initLink(snap_link_t *link, const uint32_t address, const uint8_t minEdm, const uint8_t maxEdm)
+{
+	link->address = address;
+	link->errorRate = 0;
+	link->ackCount = 0;
+	link->nackCount = 0;
+	link->retryCount = 0;
+	link->hashErrorCount = 0;
+	link->holdCount = 0;
+	link->cleanCount = 0;
+	link->ndb = 0;
+	link->goodput = 0;
+	link->byteCount = 0;
+	link->failWeight = 0;
+	link->minEdm = snap_clampEdm(minEdm);
+	link->maxEdm = (snap_clampEdm(maxEdm) < link->minEdm) ? link->minEdm : snap_clampEdm(maxEdm);
+	link->edm = link->minEdm;
+}
+
+/**
+ * @brief Find the link structure of a peer.
+ * @param[in] links   Pointer to the array of link structures.
+ * @param[in] count   Number of link structures in the array.
+ * @param[in] address Address of the peer.
+ * @return Pointer to the link structure, or NULL if there is no link with the peer.
+ */
+snap_link_t *snap_findLink(snap_link_t *links, const uint8_t count, const uint32_t address)
+{
+	for(uint_fast8_t i = 0; i < count; i++)
+	{
+		if(links[i].address == address)
+		{
+			return &links[i];
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Report the result of a frame exchanged with the peer.
+ * @param[in,out] link  Pointer to the link structure.
+ * @param[in]     event Result of the frame. It must be a value from #snap_linkEvent_t. Other values are ignored.
+ */
+void snap_reportLinkEvent(snap_link_t *link, const uint8_t event)
+{
+	switch(event)
+	{
+		case SNAP_LINK_EVENT_ACK:
+			snap_incrementCounter(&link->ackCount);
+			break;
+		case SNAP_LINK_EVENT_NACK:
+			snap_incrementCounter(&link->nackCount);
+			break;
+		case SNAP_LINK_EVENT_RETRY:
+			snap_incrementCounter(&link->retryCount);
+			break;
+		case SNAP_LINK_EVENT_HASH_ERROR:
+			snap_incrementCounter(&link->hashErrorCount);
+			break;
+		default:
+			return;
+	}
+
+	snap_updateLink(link, event != SNAP_LINK_EVENT_ACK);
+}
+
+/**
+ * @brief Report the result of a frame exchanged with the peer, and its size, used to estimate the byte error rate of the link.
+ * @param[in,out] link      Pointer to the link structure.
+ * @param[in]     event     Result of the frame. It must be a value from #snap_linkEvent_t. Other values are ignored.
+ * @param[in]     frameSize Number of bytes of the frame.
+ */
+void snap_reportLinkTransfer(snap_link_t *link, const uint8_t event, const uint16_t frameSize)
+{
+	if(event <= SNAP_LINK_EVENT_HASH_ERROR)
+	{
+		snap_countLinkBytes(link, event != SNAP_LINK_EVENT_ACK, frameSize);
+		snap_reportLinkEvent(link, event);
+	}
+}
+
+/**
+ * @brief Report a frame received from the peer, after it is decoded.
+ * @details A valid frame counts as a success, and its error detection method (if it is in the range allowed for the link) is
+ *          adopted by the link, so both ends follow the end that sees more errors. A stronger method is adopted right away. A lighter
+ *          one is adopted only when the link could move down by itself (see #SNAP_LINK_DOWN_HOLD), so a frame sent before the last
+ *          move up, or delayed, does not undo it. A frame with hash error counts as a failure. Incomplete frames are ignored.
+ * @param[in,out] link  Pointer to the link structure.
+ * @param[in]     frame Pointer to the frame structure.
+ */
+void snap_reportLinkFrame(snap_link_t *link, const snap_frame_t *frame)
+{
+	if(frame->status == SNAP_STATUS_VALID)
+	{
+		const uint8_t edm = (uint8_t)SNAP_HDB1_EDM(frame->buffer);
+
+		if((edm >= link->minEdm) && (edm <= link->maxEdm) && ((edm > link->edm) || ((edm < link->edm) && snap_canLowerLink(link))))
+		{
+			link->edm = edm;	// Change made by the peer
+			link->holdCount = 0;
+		}
+
+		snap_reportLinkTransfer(link, SNAP_LINK_EVENT_ACK, frame->size);
+	}
+	else if(frame->status == SNAP_STATUS_ERROR_HASH)
+	{
+		snap_reportLinkTransfer(link, SNAP_LINK_EVENT_HASH_ERROR, frame->size);
+	}
+}
+
+/**
+ * @brief Set the frame format of the link in the fields of a frame addressed to the peer.
+ * @param[in]     link   Pointer to the link structure.
+ * @param[in,out] fields Pointer to the structure that contains the frame fields. The EDM field is updated.
+ */
+void snap_applyLink(const snap_link_t *link, snap_fields_t *fields)
+{
+	fields->header.edm = link->edm & SNAP_HDB1_EDM_MASK;
+}
+
+/**
+ * @brief Get the estimated byte error rate of the link.
+ * @details The estimate is the number of failed frames per byte exchanged with the peer (a first-order approximation, accurate
+ *          while most frames go through). It includes the effect of the error detection method in use (e.g. the errors corrected
+ *          by FEC do not count).
+ * @param[in] link Pointer to the link structure.
+ * @return Byte error rate (#SNAP_LINK_RATE_ONE = 100 %). It is zero until the first failure.
+ */
+uint16_t snap_getLinkByteErrorRate(const snap_link_t *link)
+{
+	if(link->byteCount == 0)
+	{
+		return 0;
+	}
+
+	const uint32_t rate = ((uint32_t)link->failWeight * ((SNAP_LINK_RATE_ONE + 1U) / SNAP_LINK_FAIL_WEIGHT)) / link->byteCount;
+
+	return (rate > SNAP_LINK_RATE_ONE) ? SNAP_LINK_RATE_ONE : (uint16_t)rate;
+}
+
+/**
+ * @brief Choose the NDB size class with the highest expected goodput for the frames sent to the peer.
+ * @details The expected goodput of a class is (data size / frame size) * (1 - byte error rate) ^ frame size, where the frame size
+ *          includes the overhead of the frame format (addresses, flags, hash or FEC bytes). The choice and its goodput are stored
+ *          in the link structure (see snap_getLinkStats()). Ties are broken in favour of the larger class.
+ * @param[in,out] link        Pointer to the link structure.
+ * @param[in]     fields      Pointer to the structure that contains the fields of the frames. Only the DAB, SAB, PFB and NDB
+ *                            fields of the header are used (#SNAP_HDB1_NDB_USER_SPECIFIED adds the data length field to the overhead).
+ * @param[in]     maxDataSize Maximum number of data bytes per frame (e.g. limited by the buffer size). It is limited to #SNAP_MAX_SIZE_DATA.
+ * @return Number of data bytes of the class chosen, or zero if maxDataSize is zero.
+ */
+uint16_t snap_selectLinkDataSize(snap_link_t *link, const snap_fields_t *fields, const uint16_t maxDataSize)
+{
+	const uint16_t byteErrorRate = snap_getLinkByteErrorRate(link);
+	uint_fast8_t bestNdb = 0;
+	uint32_t bestGoodput = 0;
+
+	for(uint_fast8_t ndb = SNAP_LINK_MIN_NDB; ndb <= SNAP_LINK_MAX_NDB; ndb++)
+	{
+		const uint_fast16_t dataSize = snap_getDataSizeFromNdb((uint8_t)ndb);
+
+		if(dataSize > maxDataSize)
+		{
+			break;
+		}
+
+		const uint_fast16_t frameSize = snap_getLinkFrameSize(link, &fields->header, dataSize);
+		const uint32_t goodput = ((uint32_t)dataSize * snap_getLinkSuccessRate(byteErrorRate, frameSize)) / (uint32_t)frameSize;
+
+		if(goodput >= bestGoodput)
+		{
+			bestGoodput = goodput;
+			bestNdb = ndb;
+		}
+	}
+
+	link->ndb = (uint8_t)bestNdb;
+	link->goodput = (uint16_t)bestGoodput;
+
+	return snap_getDataSizeFromNdb((uint8_t)bestNdb);
+}
+
+/**
+ * @brief Get the fragment size of a message sent to the peer, according to the NDB size class with the highest expected goodput.
+ * @details The class is chosen with the frame format of the fragments (3 bytes of protocol flags and a data length field, see
+ *          snap_encapsulateFragment()). The fragment size is increased if necessary, so the message and its CRC fit in #SNAP_MAX_FRAGMENTS fragments.
+ * @param[in,out] link        Pointer to the link structure. The choice is stored in it (see snap_selectLinkDataSize()).
+ * @param[in]     fields      Pointer to the structure that contains the fields of the frames. Only the DAB and SAB fields of the header are used.
+ * @param[in]     messageSize Number of bytes of the message (up to #SNAP_MAX_SIZE_MESSAGE).
+ * @return Fragment size, or zero if the message size is invalid.
+ */
+uint16_t snap_getLinkFragmentSize(snap_link_t *link, const snap_fields_t *fields, const uint16_t messageSize)
+{
+	if((messageSize == 0) || (messageSize > SNAP_MAX_SIZE_MESSAGE))
+	{
+		return 0;
+	}
+
+	snap_fields_t fragmentFields = *fields;
+	fragmentFields.header.pfb = SNAP_HDB2_PFB_3BYTE_PROTOCOL_FLAGS;
+	fragmentFields.header.ndb = SNAP_HDB1_NDB_USER_SPECIFIED;
+
+	const uint16_t minSize = (uint16_t)((messageSize + SNAP_SIZE_FRAG_CHECK + SNAP_MAX_FRAGMENTS - 1U) / SNAP_MAX_FRAGMENTS);	// The CRC of the message is sent after it
+	const uint16_t size = snap_selectLinkDataSize(link, &fragmentFields, SNAP_MAX_SIZE_DATA);
+
+	return (size < minSize) ? minSize : size;
+}
+
+/**
+ * @brief Get the statistics of the link with a peer.
+ * @param[in]  link  Pointer to the link structure.
+ * @param[out] stats Pointer to the structure that will store the statistics.
+ */
+void snap_getLinkStats(const snap_link_t *link, snap_linkStats_t *stats)
+{
+	stats->frameErrorRate = link->errorRate;
+	stats->byteErrorRate = snap_getLinkByteErrorRate(link);
+	stats->ackCount = link->ackCount;
+	stats->nackCount = link->nackCount;
+	stats->retryCount = link->retryCount;
+	stats->hashErrorCount = link->hashErrorCount;
+	stats->dataSize = snap_getDataSizeFromNdb(link->ndb);
+	stats->goodput = link->goodput;
+	stats->edm = link->edm;
+	stats->ndb = link->ndb;
+}
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/******************************** END OF FILE *********************************/
@@ -0,0 +1,95 @@
+/**
+ * @file   snap_test.h
+ * @brief  Helpers shared by the host tests of the SNAP library: a pseudo-random number generator, so every run checks
+ *         the same frames, and the fixtures that decode the frames built by snap_encapsulate().
+ */
+
+#ifndef SNAP_TEST_H_
+#define SNAP_TEST_H_
+
+#include <stdint.h>
+#include <string.h>
+#include <unity.h>
+#include "snap.h"
+
+static uint32_t seed;	/**< @brief State of nextRandom(). Each test file sets its own value in setUp(). */
+
+/**
+ * @brief Pseudo-random number generator (xorshift32).
+ * @return Next number of the sequence.
+ */
+static inline uint32_t nextRandom(void)
+{
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	return seed;
+}
+
+/**
+ * @brief Fill an array with random bytes, drawn in order.
+ * @param[out] bytes Pointer to the array.
+ * @param[in]  size  Number of bytes.
+ */
+static inline void fillRandom(uint8_t *bytes, const uint16_t size)
+{
+	for(uint16_t i = 0; i < size; i++)
+	{
+		bytes[i] = (uint8_t)nextRandom();
+	}
+}
+
+/**
+ * @brief Set random fields, with data size from 0 to the given maximum. The data pointer is left NULL.
+ * @param[out] fields      Pointer to the fields structure.
+ * @param[in]  edm         Error detection method of the frame.
+ * @param[in]  maxDataSize Maximum number of data bytes.
+ */
+static inline void setRandomFields(snap_fields_t *fields, const uint8_t edm, const uint16_t maxDataSize)
+{
+	memset(fields, 0, sizeof(*fields));
+	fields->header.dab = nextRandom() % 4;
+	fields->header.sab = nextRandom() % 4;
+	fields->header.pfb = nextRandom() % 4;
+	fields->header.ack = nextRandom() % 4;
+	fields->header.cmd = nextRandom() % 2;
+	fields->header.edm = edm;
+	fields->header.ndb = (nextRandom() % 3 == 0) ? SNAP_HDB1_NDB_USER_SPECIFIED : 0;
+	fields->destAddress = nextRandom() & 0xFFFFFF;
+	fields->sourceAddress = nextRandom() & 0xFFFFFF;
+	fields->protocolFlags = nextRandom() & 0xFFFFFF;
+	fields->dataSize = (uint16_t)(nextRandom() % (maxDataSize + 1U));
+	fields->paddingAfter = nextRandom() % 2;
+}
+
+/**
+ * @brief Decode bytes one at a time with snap_decode().
+ * @param[in,out] frame Pointer to the frame structure.
+ * @param[in]     bytes Pointer to the bytes.
+ * @param[in]     size  Number of bytes.
+ * @return Status of the last decoded byte, or #SNAP_STATUS_IDLE if there is none.
+ */
+static inline int8_t decodeBytes(snap_frame_t *frame, const uint8_t *bytes, const uint16_t size)
+{
+	int8_t status = SNAP_STATUS_IDLE;
+
+	for(uint16_t i = 0; i < size; i++)
+	{
+		status = snap_decode(frame, bytes[i]);
+	}
+
+	return status;
+}
+
+/**
+ * @brief Reset a frame structure and decode an encapsulated frame with it. The frame must be valid.
+ * @param[in]     tx Pointer to the structure of the encapsulated frame.
+ * @param[in,out] rx Pointer to the structure used to decode it.
+ */
+static inline void deliverFrame(const snap_frame_t *tx, snap_frame_t *rx)
+{
+	snap_reset(rx);
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, decodeBytes(rx, tx->buffer, tx->size));
+}
+
+#endif	// SNAP_TEST_H_
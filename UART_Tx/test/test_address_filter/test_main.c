@@ -0,0 +1,170 @@
+/**
+ * @file   test_main.c
+ * @brief  Host tests of the address filter: the decoder must report exactly the frames addressed to this node
+ *         (or its group, or broadcast), and skip the others without storing their bytes.
+ */
+
+#include <string.h>
+#include <unity.h>
+#include "snap.h"
+#include "snap_test.h"
+
+#define LOCAL_ADDRESS	(0x1234U)
+#define GROUP_MASK		(0xFF00U)
+
+static uint8_t data[SNAP_MAX_SIZE_DATA];
+static uint8_t txBuffer[SNAP_MAX_SIZE_BUFFER];
+static uint8_t rxBuffer[SNAP_MAX_SIZE_BUFFER];
+
+/**
+ * @brief Encapsulate a frame with random fields and a destination address picked among interesting values.
+ * @return Destination address (zero if the frame has none, which is accepted as well).
+ */
+static uint32_t encapsulateRandomFrame(snap_frame_t *frame)
+{
+	static const uint32_t addresses[] = {LOCAL_ADDRESS, SNAP_BROADCAST_ADDRESS, 0x12AB, 0x1235, 0x3412, 0x0034};
+	snap_fields_t fields;
+
+	setRandomFields(&fields, (uint8_t)(nextRandom() % 7), 99U);
+	fields.header.dab = 1U + nextRandom() % 3U;
+	fields.destAddress = addresses[nextRandom() % (sizeof(addresses) / sizeof(addresses[0]))];
+	fields.data = data;
+
+	if(nextRandom() % 8 == 0)
+	{
+		fields.header.dab = SNAP_HDB2_DAB_NO_DEST_ADDRESS;
+		fields.destAddress = 0;
+	}
+	else if((fields.header.dab == SNAP_HDB2_DAB_1BYTE_DEST_ADDRESS) && (fields.destAddress > 0xFF))
+	{
+		fields.header.dab = SNAP_HDB2_DAB_2BYTE_DEST_ADDRESS;
+	}
+
+	fillRandom(data, fields.dataSize);
+
+	snap_init(frame, txBuffer, sizeof(txBuffer));
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(frame, &fields));
+
+	return fields.destAddress;
+}
+
+/**
+ * @brief Reference model of the address filter set by snap_setAddressFilter().
+ * @return true if a frame with this destination address must be reported, false otherwise.
+ */
+static bool isAccepted(const uint32_t groupMask, const uint32_t destAddress)
+{
+	return (destAddress == 0) ||	// Frame without destination address
+	       (destAddress == SNAP_BROADCAST_ADDRESS) ||
+	       (destAddress == LOCAL_ADDRESS) ||
+	       ((groupMask != 0) && (((destAddress ^ LOCAL_ADDRESS) & groupMask) == 0));
+}
+
+void setUp(void)
+{
+	seed = 8;
+}
+
+void tearDown(void)
+{
+}
+
+void test_accepted_addresses(void)
+{
+	snap_frame_t frame;
+
+	snap_init(&frame, rxBuffer, sizeof(rxBuffer));
+	TEST_ASSERT_TRUE(snap_isDestAccepted(&frame, 0x5678));	// Disabled by snap_init()
+
+	snap_setAddressFilter(&frame, LOCAL_ADDRESS, 0);
+	TEST_ASSERT_TRUE(snap_isDestAccepted(&frame, LOCAL_ADDRESS));
+	TEST_ASSERT_TRUE(snap_isDestAccepted(&frame, SNAP_BROADCAST_ADDRESS));
+	TEST_ASSERT_FALSE(snap_isDestAccepted(&frame, 0x1235));
+	TEST_ASSERT_FALSE(snap_isDestAccepted(&frame, 0x12AB));
+
+	snap_setAddressFilter(&frame, LOCAL_ADDRESS, GROUP_MASK);
+	TEST_ASSERT_TRUE(snap_isDestAccepted(&frame, 0x12AB));
+	TEST_ASSERT_FALSE(snap_isDestAccepted(&frame, 0x3412));
+
+	snap_setAddressFilter(&frame, SNAP_BROADCAST_ADDRESS, 0);
+	TEST_ASSERT_TRUE(snap_isDestAccepted(&frame, 0x3412));
+}
+
+void test_only_accepted_frames_are_reported(void)
+{
+	snap_frame_t tx, rx;
+	uint32_t groupMask = 0;
+
+	snap_init(&rx, rxBuffer, sizeof(rxBuffer));
+
+	for(uint16_t n = 0; n < 5000; n++)
+	{
+		if(n % 500 == 0)
+		{
+			groupMask = (nextRandom() % 2) ? GROUP_MASK : 0;
+			snap_setAddressFilter(&rx, LOCAL_ADDRESS, groupMask);
+		}
+
+		const uint32_t destAddress = encapsulateRandomFrame(&tx);
+		const bool accepted = isAccepted(groupMask, destAddress);
+		int8_t status = SNAP_STATUS_IDLE;
+
+		memset(rxBuffer, 0xEE, sizeof(rxBuffer));
+
+		for(uint16_t i = 0; i < tx.size; i++)
+		{
+			status = snap_decode(&rx, txBuffer[i]);
+
+			if(!accepted && (i >= tx.layout.dataIndex))	// Address (and data length field) received
+			{
+				TEST_ASSERT_EQUAL_INT8((i + 1U == tx.size) ? SNAP_STATUS_IDLE : SNAP_STATUS_SKIPPING, status);
+			}
+		}
+
+		if(accepted)
+		{
+			TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, status);
+			TEST_ASSERT_EQUAL_MEMORY(txBuffer, rxBuffer, tx.size);
+			snap_reset(&rx);
+		}
+		else
+		{
+			for(uint16_t i = tx.layout.dataIndex; i < tx.size; i++)	// Skipped bytes are not stored
+			{
+				TEST_ASSERT_EQUAL_HEX8(0xEE, rxBuffer[i]);
+			}
+		}
+	}
+}
+
+void test_frame_after_a_skipped_frame_is_decoded(void)
+{
+	static const uint8_t skipped[] = {SNAP_SYNC, 0x40, 0x04, 0x99, SNAP_SYNC, SNAP_SYNC, SNAP_SYNC, SNAP_SYNC};	// 1-byte address, 4 data bytes (sync values)
+	snap_frame_t tx, rx;
+	snap_fields_t fields;
+
+	memset(&fields, 0, sizeof(fields));
+	fields.header.dab = SNAP_HDB2_DAB_2BYTE_DEST_ADDRESS;
+	fields.header.edm = SNAP_HDB1_EDM_16BIT_CRC;
+	fields.destAddress = LOCAL_ADDRESS;
+
+	snap_init(&tx, txBuffer, sizeof(txBuffer));
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(&tx, &fields));
+
+	snap_init(&rx, rxBuffer, sizeof(rxBuffer));
+	snap_setAddressFilter(&rx, LOCAL_ADDRESS, 0);
+
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_IDLE, decodeBytes(&rx, skipped, sizeof(skipped)));	// The sync bytes in its data were skipped
+
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, decodeBytes(&rx, txBuffer, tx.size));
+	TEST_ASSERT_EQUAL_MEMORY(txBuffer, rxBuffer, tx.size);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_accepted_addresses);
+	RUN_TEST(test_only_accepted_frames_are_reported);
+	RUN_TEST(test_frame_after_a_skipped_frame_is_decoded);
+	return UNITY_END();
+}
@@ -0,0 +1,271 @@
+/**
+ * @file   test_main.c
+ * @brief  Host tests of the aggregation layer: the records queued for a node must be read back in order from the frame,
+ *         and the queue must become due at its size and time limits.
+ */
+
+#include <string.h>
+#include <unity.h>
+#include "snap.h"
+#include "snap_aggregate.h"
+#include "snap_test.h"
+
+#define MAX_RECORDS	(SNAP_MAX_SIZE_DATA / 2U)
+
+typedef struct
+{
+	uint16_t offset;
+	uint16_t size;
+	uint8_t  type;
+} queuedRecord_t;
+
+static uint8_t values[4000];
+static uint8_t queue[SNAP_MAX_SIZE_DATA];
+static uint8_t txBuffer[SNAP_MAX_SIZE_BUFFER];
+static uint8_t rxBuffer[SNAP_MAX_SIZE_BUFFER];
+static queuedRecord_t queued[MAX_RECORDS];
+
+/**
+ * @brief Send the queue in a frame, decode it and check its records against the queued array.
+ */
+static void checkAggregate(snap_frame_t *tx, snap_frame_t *rx, snap_aggregator_t *aggregator, const uint16_t count)
+{
+	snap_fields_t fields;
+	snap_recordReader_t reader;
+	snap_record_t record;
+	uint32_t value;
+
+	memset(&fields, 0, sizeof(fields));
+	fields.header.dab = SNAP_HDB2_DAB_2BYTE_DEST_ADDRESS;
+	fields.header.sab = SNAP_HDB2_SAB_2BYTE_SOURCE_ADDRESS;
+	fields.header.edm = SNAP_HDB1_EDM_16BIT_CRC;
+	fields.sourceAddress = 0x0001;
+	fields.protocolFlags = 0x0001;
+
+	TEST_ASSERT_EQUAL_UINT16(count, aggregator->count);
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulateAggregate(tx, &fields, aggregator));
+	TEST_ASSERT_EQUAL_UINT16(0, aggregator->size);
+	TEST_ASSERT_EQUAL_UINT16(0, aggregator->count);
+
+	deliverFrame(tx, rx);
+	snap_getProtocolFlags(rx, &value);
+	TEST_ASSERT_EQUAL_HEX32(0x0401, value);	// Aggregation bit added to the flags of the user
+	snap_getDestAddress(rx, &value);
+	TEST_ASSERT_EQUAL_HEX32(aggregator->destAddress, value);
+
+	TEST_ASSERT_TRUE(snap_initRecordReader(&reader, rx) > 0);
+
+	for(uint16_t k = 0; k < count; k++)
+	{
+		TEST_ASSERT_TRUE(snap_readRecord(&reader, &record));
+		TEST_ASSERT_EQUAL_UINT8(queued[k].type, record.type);
+		TEST_ASSERT_EQUAL_UINT16(queued[k].size, record.size);
+
+		if(record.size != 0)
+		{
+			TEST_ASSERT_EQUAL_MEMORY(&values[queued[k].offset], record.value, record.size);
+		}
+	}
+
+	TEST_ASSERT_FALSE(snap_readRecord(&reader, &record));
+}
+
+void setUp(void)
+{
+	seed = 19;
+}
+
+void tearDown(void)
+{
+}
+
+void test_records_are_read_in_order(void)
+{
+	snap_frame_t tx, rx;
+	snap_aggregator_t aggregator;
+
+	snap_init(&tx, txBuffer, sizeof(txBuffer));
+	snap_init(&rx, rxBuffer, sizeof(rxBuffer));
+	TEST_ASSERT_EQUAL_INT16(sizeof(queue), snap_initAggregator(&aggregator, queue, sizeof(queue) + 100U, 0x1234));	// Limited to the largest payload
+	TEST_ASSERT_FALSE(snap_isAggregateDue(&aggregator, 0));
+
+	for(uint16_t n = 0; n < 1000; n++)
+	{
+		uint32_t now = 0xFFFFFFF0UL + n;
+		uint16_t count = 0;
+		uint16_t offset = 0;
+
+		snap_setAggregationLimits(&aggregator, (uint16_t)(100U + nextRandom() % 500U), 5);
+
+		while(!snap_isAggregateDue(&aggregator, now))
+		{
+			const uint16_t size = (uint16_t)((nextRandom() % 4 == 0) ? nextRandom() % 300U : nextRandom() % 8U);	// Some with a 2-byte length
+			const uint8_t type = (uint8_t)nextRandom();
+
+			if(offset + size > sizeof(values))
+			{
+				break;
+			}
+
+			for(uint16_t i = 0; i < size; i++)
+			{
+				values[offset + i] = (uint8_t)nextRandom();
+			}
+
+			const uint16_t previousSize = aggregator.size;
+			const int16_t result = snap_addRecord(&aggregator, type, &values[offset], size, now);
+
+			if(result < 0)
+			{
+				TEST_ASSERT_EQUAL_INT16(SNAP_ERROR_SHORT_BUFFER, result);
+				TEST_ASSERT_EQUAL_UINT16(previousSize, aggregator.size);
+				break;
+			}
+
+			TEST_ASSERT_EQUAL_INT16(previousSize + SNAP_SIZE_RECORD_HEADER(size) + size, result);
+			queued[count].offset = offset;
+			queued[count].size = size;
+			queued[count].type = type;
+			offset = (uint16_t)(offset + size);
+			count++;
+			now++;
+		}
+
+		if(count != 0)
+		{
+			checkAggregate(&tx, &rx, &aggregator, count);
+		}
+	}
+}
+
+void test_queue_of_empty_records(void)
+{
+	snap_frame_t tx, rx;
+	snap_aggregator_t aggregator;
+
+	snap_init(&tx, txBuffer, sizeof(txBuffer));
+	snap_init(&rx, rxBuffer, sizeof(rxBuffer));
+	snap_initAggregator(&aggregator, queue, sizeof(queue), 0x00AB);
+	snap_setAggregationLimits(&aggregator, sizeof(queue), 1000);
+
+	for(uint16_t k = 0; k < MAX_RECORDS; k++)	// More than 255 records in a single frame
+	{
+		queued[k].offset = 0;
+		queued[k].size = 0;
+		queued[k].type = (uint8_t)k;
+		TEST_ASSERT_EQUAL_INT16(2U * (k + 1U), snap_addRecord(&aggregator, (uint8_t)k, NULL, 0, 0));
+	}
+
+	TEST_ASSERT_EQUAL_INT16(SNAP_ERROR_SHORT_BUFFER, snap_addRecord(&aggregator, 0, NULL, 0, 0));
+	TEST_ASSERT_TRUE(snap_isAggregateDue(&aggregator, 0));
+	checkAggregate(&tx, &rx, &aggregator, MAX_RECORDS);
+}
+
+void test_deadline_with_time_wrap(void)
+{
+	snap_aggregator_t aggregator;
+	const uint8_t value = 'x';
+
+	snap_initAggregator(&aggregator, queue, sizeof(queue), 0x00AB);
+	snap_setAggregationLimits(&aggregator, sizeof(queue), 10);
+	snap_addRecord(&aggregator, 1, &value, 1, 0xFFFFFFFAUL);
+
+	TEST_ASSERT_FALSE(snap_isAggregateDue(&aggregator, 0xFFFFFFFFUL));
+	TEST_ASSERT_FALSE(snap_isAggregateDue(&aggregator, 3));
+	TEST_ASSERT_TRUE(snap_isAggregateDue(&aggregator, 4));
+
+	snap_setAggregationLimits(&aggregator, 5, 1000);
+	TEST_ASSERT_FALSE(snap_isAggregateDue(&aggregator, 0xFFFFFFFAUL));
+	snap_addRecord(&aggregator, 1, NULL, 0, 0xFFFFFFFAUL);
+	TEST_ASSERT_TRUE(snap_isAggregateDue(&aggregator, 0xFFFFFFFAUL));	// Flush size reached
+}
+
+void test_invalid_records(void)
+{
+	static const uint8_t truncatedValue[] = {0x01, 0x05, 'a', 'b'};
+	static const uint8_t truncatedLength[] = {0x01, SNAP_LENGTH_EXTENDED};
+	static const uint8_t valid[] = {0x01, 0x00, 0x02, 0x01, 'z'};
+	snap_recordReader_t reader;
+	snap_record_t record;
+	snap_frame_t frame;
+	snap_fields_t fields;
+
+	reader.data = truncatedValue;
+	reader.size = sizeof(truncatedValue);
+	reader.index = 0;
+	TEST_ASSERT_FALSE(snap_readRecord(&reader, &record));
+
+	reader.data = truncatedLength;
+	reader.size = sizeof(truncatedLength);
+	reader.index = 0;
+	TEST_ASSERT_FALSE(snap_readRecord(&reader, &record));
+
+	reader.data = valid;
+	reader.size = sizeof(valid);
+	reader.index = 0;
+	TEST_ASSERT_TRUE(snap_readRecord(&reader, &record));
+	TEST_ASSERT_EQUAL_UINT8(0x01, record.type);
+	TEST_ASSERT_EQUAL_UINT16(0, record.size);
+	TEST_ASSERT_TRUE(snap_readRecord(&reader, &record));
+	TEST_ASSERT_EQUAL_UINT8(0x02, record.type);
+	TEST_ASSERT_EQUAL_UINT16(1, record.size);
+	TEST_ASSERT_EQUAL_UINT8('z', record.value[0]);
+	TEST_ASSERT_FALSE(snap_readRecord(&reader, &record));
+
+	memset(&fields, 0, sizeof(fields));
+	fields.header.pfb = SNAP_HDB2_PFB_2BYTE_PROTOCOL_FLAGS;
+	fields.header.ndb = SNAP_HDB1_NDB_USER_SPECIFIED;
+	fields.data = values;
+	fields.dataSize = 4;
+	snap_init(&frame, txBuffer, sizeof(txBuffer));
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(&frame, &fields));
+	TEST_ASSERT_EQUAL_INT16(SNAP_ERROR_FRAME_FORMAT, snap_initRecordReader(&reader, &frame));	// Aggregation bit cleared
+}
+
+void test_plain_frame_after_aggregate_has_no_aggregation_bit(void)
+{
+	static const uint8_t value[] = {0x01, 0x02};
+	static const uint8_t plain[] = "plain";
+	snap_aggregator_t aggregator;
+	snap_recordReader_t reader;
+	snap_frame_t tx;
+	snap_frame_t rx;
+	snap_fields_t fields;
+	uint32_t flags;
+
+	memset(&fields, 0, sizeof(fields));
+	fields.header.dab = SNAP_HDB2_DAB_1BYTE_DEST_ADDRESS;
+	fields.header.sab = SNAP_HDB2_SAB_1BYTE_SOURCE_ADDRESS;
+	fields.header.pfb = SNAP_HDB2_PFB_2BYTE_PROTOCOL_FLAGS;
+	fields.header.edm = SNAP_HDB1_EDM_16BIT_CRC;
+	fields.destAddress = 0x22;
+	fields.sourceAddress = 0x01;
+	fields.protocolFlags = 0x0001;
+
+	snap_init(&tx, txBuffer, sizeof(txBuffer));
+	snap_init(&rx, rxBuffer, sizeof(rxBuffer));
+	TEST_ASSERT_TRUE(snap_initAggregator(&aggregator, queue, sizeof(queue), 0x33) > 0);
+	TEST_ASSERT_TRUE(snap_addRecord(&aggregator, 0x01, value, sizeof(value), 0) >= 0);
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulateAggregate(&tx, &fields, &aggregator));
+	TEST_ASSERT_EQUAL_HEX32(0x0001, fields.protocolFlags);	// The fields of the user are not changed
+	TEST_ASSERT_EQUAL_HEX32(0x22, fields.destAddress);
+
+	fields.data = (uint8_t *)plain;
+	fields.dataSize = sizeof(plain);
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(&tx, &fields));
+	deliverFrame(&tx, &rx);
+	snap_getProtocolFlags(&rx, &flags);
+	TEST_ASSERT_EQUAL_HEX32(0x0001, flags);
+	TEST_ASSERT_EQUAL_INT16(SNAP_ERROR_FRAME_FORMAT, snap_initRecordReader(&reader, &rx));
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_records_are_read_in_order);
+	RUN_TEST(test_queue_of_empty_records);
+	RUN_TEST(test_deadline_with_time_wrap);
+	RUN_TEST(test_invalid_records);
+	RUN_TEST(test_plain_frame_after_aggregate_has_no_aggregation_bit);
+	return UNITY_END();
+}
@@ -0,0 +1,290 @@
+/**
+ * @file   test_main.c
+ * @brief  Host tests of the selective-repeat ARQ layer: every message must be delivered exactly once over a lossy link,
+ *         and only the frames reported missing must be sent again before their timeout.
+ */
+
+#include <string.h>
+#include <unity.h>
+#include "snap.h"
+#include "snap_arq.h"
+#include "snap_test.h"
+
+#define SLOT_SIZE		(64U)
+#define MESSAGE_COUNT	(3000U)
+#define LINK_DELAY		(8U)
+#define LINK_CAPACITY	(256U)
+
+/**
+ * @brief Frame travelling on the simulated link.
+ */
+typedef struct
+{
+	uint32_t arrivalTime;
+	uint16_t size;
+	uint8_t  bytes[SLOT_SIZE];
+} linkFrame_t;
+
+/**
+ * @brief One direction of the simulated link: a queue of frames delivered after a fixed delay.
+ */
+typedef struct
+{
+	linkFrame_t frame[LINK_CAPACITY];
+	uint32_t    head;
+	uint32_t    tail;
+} link_t;
+
+static uint8_t senderBuffer[SNAP_ARQ_WINDOW * SLOT_SIZE];
+static uint8_t rxBuffer[SLOT_SIZE];
+static uint8_t ackBuffer[SLOT_SIZE];
+static bool delivered[MESSAGE_COUNT];
+static link_t forward, backward;
+
+static void pushFrame(link_t *link, const snap_frame_t *frame, const uint32_t now)
+{
+	linkFrame_t *entry = &link->frame[link->tail % LINK_CAPACITY];
+
+	TEST_ASSERT_TRUE(link->tail - link->head < LINK_CAPACITY);
+	entry->arrivalTime = now + LINK_DELAY;
+	entry->size = frame->size;
+	memcpy(entry->bytes, frame->buffer, frame->size);
+	link->tail++;
+}
+
+/**
+ * @brief Decode the next frame of the link that has arrived.
+ * @return true if a frame was decoded, false if there are none.
+ */
+static bool popFrame(link_t *link, snap_frame_t *frame, const uint32_t now)
+{
+	if((link->head == link->tail) || (link->frame[link->head % LINK_CAPACITY].arrivalTime > now))
+	{
+		return false;
+	}
+
+	const linkFrame_t *entry = &link->frame[link->head % LINK_CAPACITY];
+
+	snap_reset(frame);
+
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, decodeBytes(frame, entry->bytes, entry->size));
+	link->head++;
+
+	return true;
+}
+
+static snap_frame_t *sendMessage(snap_arqSender_t *sender, const uint16_t id, const uint32_t now)
+{
+	uint8_t data[20];
+	snap_fields_t fields;
+
+	memset(data, 0xA5, sizeof(data));
+	data[0] = (uint8_t)(id >> 8);
+	data[1] = (uint8_t)id;
+
+	memset(&fields, 0, sizeof(fields));
+	fields.header.edm = SNAP_HDB1_EDM_16BIT_CRC;
+	fields.data = data;
+	fields.dataSize = sizeof(data);
+	fields.paddingAfter = true;
+
+	return snap_arqSend(sender, &fields, now);
+}
+
+static void sendAck(const snap_arqReceiver_t *receiver, snap_frame_t *frame)
+{
+	snap_fields_t fields;
+
+	memset(&fields, 0, sizeof(fields));
+	fields.header.edm = SNAP_HDB1_EDM_16BIT_CRC;
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_arqEncapsulateAck(receiver, frame, &fields));
+}
+
+void setUp(void)
+{
+	seed = 21;
+	memset(&forward, 0, sizeof(forward));
+	memset(&backward, 0, sizeof(backward));
+}
+
+void tearDown(void)
+{
+}
+
+void test_messages_are_delivered_once_with_losses(void)
+{
+	for(uint8_t lossPercent = 0; lossPercent <= 20; lossPercent = (uint8_t)(lossPercent + 10U))
+	{
+		snap_arqSender_t sender;
+		snap_arqReceiver_t receiver;
+		snap_frame_t rx, ack;
+		uint16_t sent = 0, received = 0;
+		uint32_t now = 0;
+
+		TEST_ASSERT_EQUAL_INT16(SLOT_SIZE, snap_initArqSender(&sender, senderBuffer, SLOT_SIZE, 40, 50));
+		snap_initArqReceiver(&receiver);
+		snap_init(&rx, rxBuffer, sizeof(rxBuffer));
+		snap_init(&ack, ackBuffer, sizeof(ackBuffer));
+		memset(delivered, 0, sizeof(delivered));
+		memset(&forward, 0, sizeof(forward));
+		memset(&backward, 0, sizeof(backward));
+
+		while((received < MESSAGE_COUNT) && (now < 1000000UL))
+		{
+			while(popFrame(&forward, &rx, now))
+			{
+				if(snap_arqReceive(&receiver, &rx))
+				{
+					const uint16_t id = (uint16_t)((rxBuffer[rx.layout.dataIndex] << 8) | rxBuffer[rx.layout.dataIndex + 1U]);
+
+					TEST_ASSERT_FALSE(delivered[id]);
+					delivered[id] = true;
+					received++;
+				}
+
+				sendAck(&receiver, &ack);
+
+				if(nextRandom() % 100U >= lossPercent)
+				{
+					pushFrame(&backward, &ack, now);
+				}
+			}
+
+			while(popFrame(&backward, &rx, now))
+			{
+				snap_arqProcessAck(&sender, &rx);
+			}
+
+			snap_frame_t *frame = snap_arqGetRetransmission(&sender, now);
+
+			if((frame == NULL) && (sent < MESSAGE_COUNT))
+			{
+				frame = sendMessage(&sender, sent, now);
+				sent = (uint16_t)(sent + ((frame != NULL) ? 1U : 0U));
+			}
+
+			if((frame != NULL) && (nextRandom() % 100U >= lossPercent))
+			{
+				pushFrame(&forward, frame, now);
+			}
+
+			now++;
+		}
+
+		TEST_ASSERT_EQUAL_UINT16(MESSAGE_COUNT, received);
+		TEST_ASSERT_EQUAL_UINT16(0, sender.failedCount);
+	}
+}
+
+void test_window_limit(void)
+{
+	snap_arqSender_t sender;
+
+	snap_initArqSender(&sender, senderBuffer, SLOT_SIZE, 40, 3);
+
+	for(uint16_t i = 0; i < SNAP_ARQ_WINDOW; i++)
+	{
+		TEST_ASSERT_NOT_NULL(sendMessage(&sender, i, 0));
+	}
+
+	TEST_ASSERT_EQUAL_UINT8(SNAP_ARQ_WINDOW, snap_arqGetPendingCount(&sender));
+	TEST_ASSERT_NULL(sendMessage(&sender, SNAP_ARQ_WINDOW, 0));
+	TEST_ASSERT_NULL(snap_arqGetRetransmission(&sender, 39));
+
+	for(uint32_t now = 40; now <= 160; now += 40)	// Sent again 3 times, then given up
+	{
+		for(uint16_t i = 0; i < SNAP_ARQ_WINDOW; i++)
+		{
+			const snap_frame_t *frame = snap_arqGetRetransmission(&sender, now);
+			uint8_t seq;
+
+			if(now == 160)
+			{
+				TEST_ASSERT_NULL(frame);
+				break;
+			}
+
+			TEST_ASSERT_NOT_NULL(frame);
+			TEST_ASSERT_TRUE(snap_getSeq(frame, &seq));
+			TEST_ASSERT_EQUAL_UINT8(i, seq);
+		}
+
+		TEST_ASSERT_NULL(snap_arqGetRetransmission(&sender, now));
+	}
+
+	TEST_ASSERT_EQUAL_UINT16(SNAP_ARQ_WINDOW, sender.failedCount);
+	TEST_ASSERT_EQUAL_UINT8(0, snap_arqGetPendingCount(&sender));
+	TEST_ASSERT_NOT_NULL(sendMessage(&sender, 0, 160));
+}
+
+void test_selective_ack(void)
+{
+	snap_arqSender_t sender;
+	snap_arqReceiver_t receiver;
+	snap_frame_t rx, ack;
+	uint8_t seq;
+
+	if(SNAP_ARQ_WINDOW < 2)
+	{
+		TEST_IGNORE_MESSAGE("Selective ACK needs a window of 2 frames or more");
+	}
+
+	snap_initArqSender(&sender, senderBuffer, SLOT_SIZE, 40, 3);
+	snap_initArqReceiver(&receiver);
+	snap_init(&rx, rxBuffer, sizeof(rxBuffer));
+	snap_init(&ack, ackBuffer, sizeof(ackBuffer));
+
+	for(uint16_t i = 0; i < SNAP_ARQ_WINDOW; i++)
+	{
+		const snap_frame_t *frame = sendMessage(&sender, i, 0);
+
+		if(i != 0)	// The first frame is lost
+		{
+			pushFrame(&forward, frame, 0);
+		}
+	}
+
+	while(popFrame(&forward, &rx, LINK_DELAY))
+	{
+		TEST_ASSERT_TRUE(snap_arqReceive(&receiver, &rx));
+		TEST_ASSERT_FALSE(snap_arqReceive(&receiver, &rx));	// Duplicate
+	}
+
+	sendAck(&receiver, &ack);
+	TEST_ASSERT_TRUE(snap_getSeq(&ack, &seq));
+	TEST_ASSERT_EQUAL_UINT8(0, seq);	// Cumulative ACK
+
+	pushFrame(&backward, &ack, LINK_DELAY);
+	TEST_ASSERT_TRUE(popFrame(&backward, &rx, 2U * LINK_DELAY));
+	TEST_ASSERT_EQUAL_UINT8(SNAP_ARQ_WINDOW - 1U, snap_arqProcessAck(&sender, &rx));
+	TEST_ASSERT_EQUAL_UINT8(SNAP_ARQ_WINDOW, snap_arqGetPendingCount(&sender));	// The window cannot move past the first frame
+
+	const snap_frame_t *frame = snap_arqGetRetransmission(&sender, 2U * LINK_DELAY);	// Sent again before its timeout
+	TEST_ASSERT_NOT_NULL(frame);
+	TEST_ASSERT_TRUE(snap_getSeq(frame, &seq));
+	TEST_ASSERT_EQUAL_UINT8(0, seq);
+	TEST_ASSERT_NULL(snap_arqGetRetransmission(&sender, 2U * LINK_DELAY));
+
+	pushFrame(&forward, frame, 2U * LINK_DELAY);
+	TEST_ASSERT_TRUE(popFrame(&forward, &rx, 3U * LINK_DELAY));
+	TEST_ASSERT_TRUE(snap_arqReceive(&receiver, &rx));
+
+	sendAck(&receiver, &ack);
+	TEST_ASSERT_TRUE(snap_getSeq(&ack, &seq));
+	TEST_ASSERT_EQUAL_UINT8(SNAP_ARQ_WINDOW, seq);
+
+	pushFrame(&backward, &ack, 3U * LINK_DELAY);
+	TEST_ASSERT_TRUE(popFrame(&backward, &rx, 4U * LINK_DELAY));
+	TEST_ASSERT_EQUAL_UINT8(1, snap_arqProcessAck(&sender, &rx));
+	TEST_ASSERT_EQUAL_UINT8(0, snap_arqGetPendingCount(&sender));
+	TEST_ASSERT_EQUAL_UINT8(0, snap_arqProcessAck(&sender, &rx));	// Stale ACK
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_messages_are_delivered_once_with_losses);
+	RUN_TEST(test_window_limit);
+	RUN_TEST(test_selective_ack);
+	return UNITY_END();
+}
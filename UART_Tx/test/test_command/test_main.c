@@ -0,0 +1,333 @@
+/**
+ * @file   test_main.c
+ * @brief  Host tests of the command dispatcher: each request must run the handler of its opcode and be answered with
+ *         an ACK response carrying the result, or a NACK response if the command is unknown or fails.
+ */
+
+#include <string.h>
+#include <unity.h>
+#include "snap.h"
+#include "snap_arq.h"
+#include "snap_command.h"
+#include "snap_test.h"
+
+#define BIG_RESULT_SIZE	(200U)
+
+static uint8_t requestBuffer[SNAP_MAX_SIZE_BUFFER];
+static uint8_t responseBuffer[SNAP_MAX_SIZE_BUFFER];
+static uint8_t rxBuffer[SNAP_MAX_SIZE_BUFFER];
+static uint16_t callCount;
+static uint16_t lastMaxResultSize;
+static const uint8_t *lastResult;
+
+static int16_t echoCommand(const uint8_t *args, const uint16_t argSize, uint8_t *result, const uint16_t maxResultSize, void *context)
+{
+	callCount++;
+	TEST_ASSERT_EQUAL_PTR(&callCount, context);
+
+	if(argSize > maxResultSize)
+	{
+		return -1;
+	}
+
+	memcpy(result, args, argSize);
+
+	return (int16_t)argSize;
+}
+
+static int16_t failingCommand(const uint8_t *args, const uint16_t argSize, uint8_t *result, const uint16_t maxResultSize, void *context)
+{
+	(void)args;
+	(void)argSize;
+	(void)result;
+	(void)maxResultSize;
+	(void)context;
+	callCount++;
+
+	return -3;
+}
+
+static int16_t bigCommand(const uint8_t *args, const uint16_t argSize, uint8_t *result, const uint16_t maxResultSize, void *context)
+{
+	(void)args;
+	(void)argSize;
+	(void)context;
+	callCount++;
+
+	for(uint16_t i = 0; (i < BIG_RESULT_SIZE) && (i < maxResultSize); i++)
+	{
+		result[i] = (uint8_t)i;
+	}
+
+	return BIG_RESULT_SIZE;	// It does not check the maximum size: the dispatcher must
+}
+
+static int16_t sizeCommand(const uint8_t *args, const uint16_t argSize, uint8_t *result, const uint16_t maxResultSize, void *context)
+{
+	(void)args;
+	(void)argSize;
+	(void)context;
+	callCount++;
+	lastMaxResultSize = maxResultSize;
+	lastResult = result;
+
+	return 0;
+}
+
+static const snap_commandHandler_t handlers[] SNAP_CMD_FLASH = {echoCommand, NULL, failingCommand, bigCommand};
+static const snap_commandHandler_t sizeHandlers[] SNAP_CMD_FLASH = {sizeCommand};
+
+/**
+ * @brief Encapsulate a request from node 0x09 to node 0x02 with the arguments 0, 1, 2...
+ */
+static void encapsulateRequest(snap_frame_t *frame, const uint8_t opcode, const uint16_t argSize, const uint8_t ack, const uint8_t seq)
+{
+	snap_fields_t fields;
+
+	memset(&fields, 0, sizeof(fields));
+	fields.header.dab = SNAP_HDB2_DAB_1BYTE_DEST_ADDRESS;
+	fields.header.sab = SNAP_HDB2_SAB_1BYTE_SOURCE_ADDRESS;
+	fields.header.edm = SNAP_HDB1_EDM_16BIT_CRC;
+	fields.header.ack = ack;
+	fields.destAddress = 0x02;
+	fields.sourceAddress = 0x09;
+	snap_setSeq(&fields, seq);
+
+	snap_init(frame, requestBuffer, sizeof(requestBuffer));
+	uint8_t *args = snap_reserveCommand(frame, &fields, opcode, argSize);
+	TEST_ASSERT_NOT_NULL(args);
+
+	for(uint16_t i = 0; i < argSize; i++)
+	{
+		args[i] = (uint8_t)(i * 3U + argSize);
+	}
+
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(frame, &fields));
+	TEST_ASSERT_TRUE(snap_isCommand(frame));
+}
+
+/**
+ * @brief Dispatch a request and decode its response.
+ * @return Status returned by snap_dispatchCommand().
+ */
+static int8_t dispatch(const snap_dispatcher_t *dispatcher, const snap_frame_t *request, snap_frame_t *response, snap_frame_t *received)
+{
+	snap_fields_t fields;
+
+	memset(&fields, 0, sizeof(fields));
+	fields.header.dab = SNAP_HDB2_DAB_1BYTE_DEST_ADDRESS;
+	fields.header.sab = SNAP_HDB2_SAB_1BYTE_SOURCE_ADDRESS;
+	fields.header.edm = SNAP_HDB1_EDM_8BIT_CRC;
+	fields.sourceAddress = 0x02;
+
+	const int8_t status = snap_dispatchCommand(dispatcher, request, response, &fields);
+
+	if(status == SNAP_STATUS_VALID)
+	{
+		snap_init(received, rxBuffer, sizeof(rxBuffer));
+
+		TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, decodeBytes(received, response->buffer, response->size));
+		TEST_ASSERT_EQUAL_UINT8(SNAP_HDB1_CMD_MODE_ENABLED, SNAP_HDB1_CMD(rxBuffer));
+		TEST_ASSERT_FALSE(snap_isCommand(received));	// Responses are not dispatched again
+	}
+
+	return status;
+}
+
+void setUp(void)
+{
+	callCount = 0;
+}
+
+void tearDown(void)
+{
+}
+
+void test_result_is_returned_in_ack(void)
+{
+	snap_dispatcher_t dispatcher;
+	snap_frame_t request, response, received;
+
+	snap_initDispatcher(&dispatcher, handlers, sizeof(handlers) / sizeof(handlers[0]), &callCount);
+	snap_init(&response, responseBuffer, sizeof(responseBuffer));
+
+	for(uint16_t argSize = 0; argSize < 300; argSize = (uint16_t)(argSize + 7U))
+	{
+		const uint8_t *data;
+		uint32_t dest;
+		uint8_t seq;
+
+		encapsulateRequest(&request, 0, argSize, SNAP_HDB2_ACK_REQUESTED, (uint8_t)argSize);
+		TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, dispatch(&dispatcher, &request, &response, &received));
+
+		TEST_ASSERT_EQUAL_UINT8(SNAP_HDB2_ACK_RESPONSE_ACK, SNAP_HDB2_ACK(rxBuffer));
+		TEST_ASSERT_EQUAL_INT16(SNAP_CMD_SIZE_OPCODE + argSize, snap_getFieldPtr(&received, &data, SNAP_FIELD_DATA));
+		TEST_ASSERT_EQUAL_HEX8(SNAP_CMD_RESPONSE | 0x00, data[0]);
+
+		for(uint16_t i = 0; i < argSize; i++)
+		{
+			TEST_ASSERT_EQUAL_HEX8((uint8_t)(i * 3U + argSize), data[SNAP_CMD_SIZE_OPCODE + i]);
+		}
+
+		snap_getDestAddress(&received, &dest);
+		TEST_ASSERT_EQUAL_UINT32(0x09, dest);	// Answered to the source of the request
+		TEST_ASSERT_TRUE(snap_getSeq(&received, &seq));
+		TEST_ASSERT_EQUAL_UINT8((uint8_t)argSize, seq);	// Same sequence number as the request
+	}
+
+	TEST_ASSERT_EQUAL_UINT16((300U + 6U) / 7U, callCount);
+}
+
+void test_unknown_or_failed_command_is_nacked(void)
+{
+	static const uint8_t opcodes[] = {1, 2, 4, SNAP_CMD_MAX_OPCODE};
+	static const uint16_t calls[] = {0, 1, 0, 0};
+	snap_dispatcher_t dispatcher;
+	snap_frame_t request, response, received;
+
+	snap_initDispatcher(&dispatcher, handlers, sizeof(handlers) / sizeof(handlers[0]), &callCount);
+	snap_init(&response, responseBuffer, sizeof(responseBuffer));
+
+	for(uint8_t k = 0; k < sizeof(opcodes); k++)
+	{
+		const uint8_t *data;
+
+		callCount = 0;
+		encapsulateRequest(&request, opcodes[k], 4, SNAP_HDB2_ACK_REQUESTED, 0);
+		TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, dispatch(&dispatcher, &request, &response, &received));
+		TEST_ASSERT_EQUAL_UINT8(SNAP_HDB2_ACK_RESPONSE_NACK, SNAP_HDB2_ACK(rxBuffer));
+		TEST_ASSERT_EQUAL_INT16(SNAP_CMD_SIZE_OPCODE, snap_getFieldPtr(&received, &data, SNAP_FIELD_DATA));	// Opcode without result
+		TEST_ASSERT_EQUAL_HEX8(SNAP_CMD_RESPONSE | opcodes[k], data[0]);
+		TEST_ASSERT_EQUAL_UINT16(calls[k], callCount);
+	}
+}
+
+void test_result_larger_than_buffer(void)
+{
+	uint8_t smallBuffer[40];
+	uint8_t tinyBuffer[3];
+	snap_dispatcher_t dispatcher;
+	snap_frame_t request, response, received;
+
+	snap_initDispatcher(&dispatcher, handlers, sizeof(handlers) / sizeof(handlers[0]), &callCount);
+	encapsulateRequest(&request, 3, 0, SNAP_HDB2_ACK_REQUESTED, 0);
+
+	snap_init(&response, responseBuffer, sizeof(responseBuffer));
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, dispatch(&dispatcher, &request, &response, &received));
+	TEST_ASSERT_EQUAL_UINT8(SNAP_HDB2_ACK_RESPONSE_ACK, SNAP_HDB2_ACK(rxBuffer));
+	TEST_ASSERT_EQUAL_UINT16(SNAP_CMD_SIZE_OPCODE + BIG_RESULT_SIZE, snap_getDataSize(&received));
+
+	snap_init(&response, smallBuffer, sizeof(smallBuffer));
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, dispatch(&dispatcher, &request, &response, &received));
+	TEST_ASSERT_EQUAL_UINT8(SNAP_HDB2_ACK_RESPONSE_NACK, SNAP_HDB2_ACK(rxBuffer));
+
+	snap_init(&response, tinyBuffer, sizeof(tinyBuffer));
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_ERROR_OVERFLOW, dispatch(&dispatcher, &request, &response, &received));
+	TEST_ASSERT_EQUAL_UINT16(0, response.size);
+	TEST_ASSERT_EQUAL_UINT16(2, callCount);	// Not called without a response buffer
+}
+
+void test_requests_without_response(void)
+{
+	snap_dispatcher_t dispatcher;
+	snap_frame_t request, response, received;
+	snap_fields_t fields;
+
+	snap_initDispatcher(&dispatcher, handlers, sizeof(handlers) / sizeof(handlers[0]), &callCount);
+	snap_init(&response, responseBuffer, sizeof(responseBuffer));
+
+	encapsulateRequest(&request, 0, 2, SNAP_HDB2_ACK_NOT_REQUESTED, 0);
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_IDLE, dispatch(&dispatcher, &request, &response, &received));
+	TEST_ASSERT_EQUAL_UINT16(1, callCount);
+	TEST_ASSERT_EQUAL_UINT16(0, response.size);
+
+	snap_initDispatcher(&dispatcher, sizeHandlers, sizeof(sizeHandlers) / sizeof(sizeHandlers[0]), &callCount);
+	lastResult = responseBuffer;
+	lastMaxResultSize = 0xFFFF;
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_IDLE, dispatch(&dispatcher, &request, &response, &received));
+	TEST_ASSERT_EQUAL_UINT16(2, callCount);
+	TEST_ASSERT_NULL(lastResult);	// Nowhere to write a result
+	TEST_ASSERT_EQUAL_UINT16(0, lastMaxResultSize);
+
+	memset(&fields, 0, sizeof(fields));
+	fields.header.ack = SNAP_HDB2_ACK_REQUESTED;
+	TEST_ASSERT_NULL(snap_reserveCommand(&request, &fields, SNAP_CMD_RESPONSE, 0));	// Not a request opcode
+	TEST_ASSERT_NULL(snap_reserveCommand(&request, &fields, 0, SNAP_MAX_SIZE_DATA));
+
+	fields.data = requestBuffer;
+	fields.dataSize = 0;
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(&request, &fields));	// No CMD bit
+	TEST_ASSERT_FALSE(snap_isCommand(&request));
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_IDLE, dispatch(&dispatcher, &request, &response, &received));
+	TEST_ASSERT_EQUAL_UINT16(2, callCount);
+}
+
+void test_response_space_is_the_largest_payload(void)
+{
+	static const uint8_t edms[] = {SNAP_HDB1_EDM_NO_ERROR_DETECTION, SNAP_HDB1_EDM_3_RETRANSMISSION, SNAP_HDB1_EDM_8BIT_CRC, SNAP_HDB1_EDM_32BIT_CRC, SNAP_HDB1_EDM_FEC};
+	static const uint8_t depths[] = {SNAP_DEPTH_1, SNAP_DEPTH_2, SNAP_DEPTH_8};
+	snap_dispatcher_t dispatcher;
+	snap_frame_t request, response;
+	snap_fields_t fields;
+
+	snap_initDispatcher(&dispatcher, sizeHandlers, sizeof(sizeHandlers) / sizeof(sizeHandlers[0]), &callCount);
+	encapsulateRequest(&request, 0, 0, SNAP_HDB2_ACK_REQUESTED, 0);
+
+	for(uint8_t e = 0; e < sizeof(edms); e++)
+	{
+		for(uint8_t d = 0; d < sizeof(depths); d++)
+		{
+			for(uint16_t maxSize = SNAP_MIN_SIZE_FRAME; maxSize <= SNAP_MAX_SIZE_BUFFER; maxSize = (uint16_t)(maxSize + 1U + maxSize / 64U))
+			{
+				memset(&fields, 0, sizeof(fields));
+				fields.header.dab = SNAP_HDB2_DAB_1BYTE_DEST_ADDRESS;
+				fields.header.sab = SNAP_HDB2_SAB_2BYTE_SOURCE_ADDRESS;
+				fields.header.pfb = SNAP_HDB2_PFB_2BYTE_PROTOCOL_FLAGS;
+				fields.header.edm = edms[e];
+				fields.protocolFlags = (uint32_t)depths[d] << SNAP_FLAGS_DEPTH_POS;
+
+				snap_init(&response, responseBuffer, maxSize);
+				snap_setInterleaving(&response, true);
+				lastMaxResultSize = 0xFFFF;
+
+				const int8_t status = snap_dispatchCommand(&dispatcher, &request, &response, &fields);
+				snap_fields_t largest = fields;	// Same format, searched byte by byte
+				uint16_t size = 0;
+
+				largest.header.ndb = SNAP_HDB1_NDB_USER_SPECIFIED;
+
+				for(uint16_t k = SNAP_MAX_SIZE_DATA + 1U; k-- > 0;)
+				{
+					largest.dataSize = k;
+
+					if(snap_reservePayload(&response, &largest) != NULL)
+					{
+						size = k;
+						break;
+					}
+				}
+
+				if(size < SNAP_CMD_SIZE_OPCODE)
+				{
+					TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_ERROR_OVERFLOW, status);
+				}
+				else
+				{
+					TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, status);
+					TEST_ASSERT_EQUAL_UINT16(size - SNAP_CMD_SIZE_OPCODE, lastMaxResultSize);
+				}
+			}
+		}
+	}
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_result_is_returned_in_ack);
+	RUN_TEST(test_unknown_or_failed_command_is_nacked);
+	RUN_TEST(test_result_larger_than_buffer);
+	RUN_TEST(test_requests_without_response);
+	RUN_TEST(test_response_space_is_the_largest_payload);
+	return UNITY_END();
+}
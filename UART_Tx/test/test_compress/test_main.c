@@ -0,0 +1,250 @@
+/**
+ * @file   test_main.c
+ * @brief  Host tests of the header compression: compressed frames must be restored to the plain frames they replace,
+ *         and a lost context update must be detected and recovered from.
+ */
+
+#include <string.h>
+#include <unity.h>
+#include "snap.h"
+#include "snap_compress.h"
+#include "snap_test.h"
+
+#define FLOW_COUNT	(4U)
+
+static uint8_t data[SNAP_MAX_SIZE_DATA];
+static uint8_t txBuffer[SNAP_MAX_SIZE_BUFFER];
+static uint8_t rxBuffer[SNAP_MAX_SIZE_BUFFER];
+static uint8_t plainBuffer[SNAP_MAX_SIZE_BUFFER];
+
+/**
+ * @brief Fields of a flow with 3-byte addresses, the given EDM and random data with a data length field.
+ */
+static void setFlowFields(snap_fields_t *fields, const uint8_t flow, const uint8_t edm)
+{
+	memset(fields, 0, sizeof(*fields));
+	fields->header.dab = SNAP_HDB2_DAB_3BYTE_DEST_ADDRESS;
+	fields->header.sab = SNAP_HDB2_SAB_3BYTE_SOURCE_ADDRESS;
+	fields->header.pfb = flow % 4U;
+	fields->header.edm = edm;
+	fields->header.ndb = SNAP_HDB1_NDB_USER_SPECIFIED;
+	fields->destAddress = 0x100000UL + flow;
+	fields->sourceAddress = 0xABCDEF;
+	fields->dataSize = (uint16_t)(nextRandom() % 40U);
+	fields->data = data;
+
+	fillRandom(data, fields->dataSize);
+}
+
+/**
+ * @brief Check that the restored frame has the same fields as the plain frame.
+ */
+static void assertPlainFrame(snap_frame_t *rx, const snap_fields_t *fields)
+{
+	snap_frame_t plain;
+	snap_fields_t expected = *fields;
+	snap_fields_t restored, decapsulated;
+
+	snap_init(&plain, plainBuffer, sizeof(plainBuffer));
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(&plain, &expected));
+
+	memset(&restored, 0, sizeof(restored));
+	memset(&decapsulated, 0, sizeof(decapsulated));
+	snap_decapsulate(rx, &restored);
+	snap_decapsulate(&plain, &decapsulated);
+
+	TEST_ASSERT_EQUAL_UINT8(decapsulated.header.dab, restored.header.dab);
+	TEST_ASSERT_EQUAL_UINT8(decapsulated.header.sab, restored.header.sab);
+	TEST_ASSERT_EQUAL_UINT8(decapsulated.header.pfb, restored.header.pfb);
+	TEST_ASSERT_EQUAL_UINT8(decapsulated.header.ack, restored.header.ack);
+	TEST_ASSERT_EQUAL_UINT8(decapsulated.header.edm, restored.header.edm);
+	TEST_ASSERT_EQUAL_HEX32(decapsulated.destAddress, restored.destAddress);
+	TEST_ASSERT_EQUAL_HEX32(decapsulated.sourceAddress, restored.sourceAddress);
+	TEST_ASSERT_EQUAL_HEX32(decapsulated.protocolFlags, restored.protocolFlags);
+	TEST_ASSERT_EQUAL_UINT16(decapsulated.dataSize, restored.dataSize);
+
+	if(restored.dataSize != 0)
+	{
+		TEST_ASSERT_EQUAL_MEMORY(decapsulated.data, restored.data, restored.dataSize);
+	}
+
+	if(SNAP_HDB1_EDM(rx->buffer) == SNAP_HDB1_EDM_16BIT_CRC)
+	{
+		uint32_t hash, calculated;
+		snap_getHash(rx, &hash);
+		snap_calculateHash(rx, &calculated);
+		TEST_ASSERT_EQUAL_HEX32(calculated, hash);
+	}
+}
+
+void setUp(void)
+{
+	seed = 20;
+}
+
+void tearDown(void)
+{
+}
+
+void test_flows_are_restored_with_losses(void)
+{
+	static const uint8_t edms[FLOW_COUNT] = {SNAP_HDB1_EDM_16BIT_CRC, SNAP_HDB1_EDM_8BIT_CRC, SNAP_HDB1_EDM_3_RETRANSMISSION, SNAP_HDB1_EDM_FEC};
+	snap_frame_t tx, rx, plain;
+	snap_contexts_t txContexts, rxContexts;
+	uint32_t flags[FLOW_COUNT] = {0};
+	uint32_t plainBytes = 0, compressedBytes = 0;
+
+	snap_init(&tx, txBuffer, sizeof(txBuffer));
+	snap_init(&rx, rxBuffer, sizeof(rxBuffer));
+	snap_init(&plain, plainBuffer, sizeof(plainBuffer));
+	snap_initContexts(&txContexts, 8);
+	snap_initContexts(&rxContexts, 0);
+
+	for(uint16_t n = 0; n < 10000; n++)
+	{
+		const uint8_t flow = (uint8_t)(nextRandom() % FLOW_COUNT);
+		snap_fields_t fields;
+
+		setFlowFields(&fields, flow, edms[flow]);
+		fields.header.ack = nextRandom() % 2;
+
+		if(nextRandom() % 4 == 0)
+		{
+			flags[flow] = nextRandom() & 0xFFFCFF;	// Without interleaving
+		}
+
+		fields.protocolFlags = flags[flow];
+
+		snap_fields_t plainFields = fields;
+		TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(&plain, &plainFields));
+		TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulateCompressed(&tx, &fields, &txContexts, flow));
+		plainBytes += plain.size;
+		compressedBytes += tx.size;
+
+		if(nextRandom() % 20 == 0)	// Lost
+		{
+			continue;
+		}
+
+		deliverFrame(&tx, &rx);
+		TEST_ASSERT_TRUE(snap_isCompressed(&rx));
+
+		const int8_t status = snap_decompress(&rx, &rxContexts);
+
+		if(status == SNAP_STATUS_ERROR_HASH)	// A context update was lost: the transmitter sends the full header again
+		{
+			snap_resetContext(&txContexts, flow);
+			continue;
+		}
+
+		TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, status);
+		TEST_ASSERT_FALSE(snap_isCompressed(&rx));
+		assertPlainFrame(&rx, &fields);
+	}
+
+	TEST_ASSERT_LESS_THAN_UINT32(plainBytes, compressedBytes);
+}
+
+void test_lost_context_update_is_detected(void)
+{
+	snap_frame_t tx, rx;
+	snap_fields_t fields;
+	snap_contexts_t txContexts, rxContexts;
+
+	snap_init(&tx, txBuffer, sizeof(txBuffer));
+	snap_init(&rx, rxBuffer, sizeof(rxBuffer));
+	snap_initContexts(&txContexts, 0);
+	snap_initContexts(&rxContexts, 0);
+	setFlowFields(&fields, 2, SNAP_HDB1_EDM_16BIT_CRC);
+
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulateCompressed(&tx, &fields, &txContexts, 1));
+	TEST_ASSERT_BITS_HIGH(SNAP_COMP_FULL, txBuffer[tx.layout.flagsIndex]);
+	deliverFrame(&tx, &rx);
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_decompress(&rx, &rxContexts));
+
+	fields.protocolFlags = 0x1234;
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulateCompressed(&tx, &fields, &txContexts, 1));	// Lost
+	TEST_ASSERT_BITS_HIGH(SNAP_COMP_FLAGS, txBuffer[tx.layout.flagsIndex]);
+
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulateCompressed(&tx, &fields, &txContexts, 1));
+	TEST_ASSERT_BITS_LOW(SNAP_COMP_FULL | SNAP_COMP_FLAGS, txBuffer[tx.layout.flagsIndex]);
+	deliverFrame(&tx, &rx);
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_ERROR_HASH, snap_decompress(&rx, &rxContexts));
+
+	snap_resetContext(&txContexts, 1);
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulateCompressed(&tx, &fields, &txContexts, 1));
+	deliverFrame(&tx, &rx);
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_decompress(&rx, &rxContexts));
+	assertPlainFrame(&rx, &fields);
+}
+
+void test_refresh_period(void)
+{
+	snap_frame_t tx;
+	snap_fields_t fields;
+	snap_contexts_t txContexts;
+
+	snap_init(&tx, txBuffer, sizeof(txBuffer));
+	snap_initContexts(&txContexts, 3);
+	setFlowFields(&fields, 0, SNAP_HDB1_EDM_8BIT_CHECKSUM);
+
+	for(uint8_t n = 0; n < 12; n++)
+	{
+		TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulateCompressed(&tx, &fields, &txContexts, 0));
+		TEST_ASSERT_EQUAL_UINT8((n % 4U == 0) ? SNAP_COMP_FULL : 0, txBuffer[tx.layout.flagsIndex] & SNAP_COMP_FULL);
+	}
+
+	fields.sourceAddress = 0x123456;	// Another flow with the same id
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulateCompressed(&tx, &fields, &txContexts, 0));
+	TEST_ASSERT_BITS_HIGH(SNAP_COMP_FULL, txBuffer[tx.layout.flagsIndex]);
+
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_ERROR_OVERFLOW, snap_encapsulateCompressed(&tx, &fields, &txContexts, SNAP_MAX_CONTEXTS));
+	TEST_ASSERT_EQUAL_UINT16(0, tx.size);
+}
+
+void test_unknown_flows_and_plain_frames(void)
+{
+	snap_frame_t tx, rx;
+	snap_fields_t fields;
+	snap_contexts_t txContexts, rxContexts;
+
+	snap_init(&tx, txBuffer, sizeof(txBuffer));
+	snap_init(&rx, rxBuffer, sizeof(rxBuffer));
+	snap_initContexts(&txContexts, 0);
+	snap_initContexts(&rxContexts, 0);
+	snap_setAddressFilter(&rx, 0x100001, 0);
+	setFlowFields(&fields, 0, SNAP_HDB1_EDM_16BIT_CRC);
+
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulateCompressed(&tx, &fields, &txContexts, 0));
+	deliverFrame(&tx, &rx);
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_IDLE, snap_decompress(&rx, &rxContexts));	// Full header addressed to another node
+	TEST_ASSERT_EQUAL_UINT16(0, rx.size);
+
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulateCompressed(&tx, &fields, &txContexts, 0));
+	deliverFrame(&tx, &rx);
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_IDLE, snap_decompress(&rx, &rxContexts));	// Unknown flow
+	TEST_ASSERT_EQUAL_UINT16(0, rx.size);
+
+	memset(&fields, 0, sizeof(fields));
+	fields.header.pfb = SNAP_HDB2_PFB_2BYTE_PROTOCOL_FLAGS;
+	fields.protocolFlags = 0x8000;	// Marker bit of a compressed frame, but with a destination address
+	fields.header.dab = SNAP_HDB2_DAB_1BYTE_DEST_ADDRESS;
+	fields.data = data;
+	fields.dataSize = 3;
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(&tx, &fields));
+	deliverFrame(&tx, &rx);
+	TEST_ASSERT_FALSE(snap_isCompressed(&rx));
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_decompress(&rx, &rxContexts));
+	TEST_ASSERT_EQUAL_UINT16(tx.size, rx.size);
+	TEST_ASSERT_EQUAL_MEMORY(txBuffer, rxBuffer, tx.size);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_flows_are_restored_with_losses);
+	RUN_TEST(test_lost_context_update_is_detected);
+	RUN_TEST(test_refresh_period);
+	RUN_TEST(test_unknown_flows_and_plain_frames);
+	return UNITY_END();
+}
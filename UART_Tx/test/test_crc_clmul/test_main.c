@@ -0,0 +1,174 @@
+/**
+ * @file   test_main.c
+ * @brief  Host tests of the carry-less multiplication (PCLMULQDQ) CRCs: blocks of 64 bytes or more must give exactly
+ *         the same CRC-16 and CRC-32 as the bitwise definitions, for any length and alignment.
+ */
+
+#include <string.h>
+#include <unity.h>
+#include "snap.h"
+#include "snap_test.h"
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	#include <cpuid.h>
+#endif
+
+#define MAX_SIZE	(8192U)
+
+static uint8_t bytes[MAX_SIZE + 16U];
+
+/**
+ * @brief Check if the library uses the carry-less multiplications (same conditions as snap.c).
+ */
+static bool isClmulUsed(void)
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && !defined(SNAP_DISABLE_CLMUL)
+	unsigned int eax, ebx, ecx, edx;
+
+	return __get_cpuid(1, &eax, &ebx, &ecx, &edx) && ((ecx & bit_PCLMUL) != 0) && ((ecx & bit_SSSE3) != 0);
+#else
+	return false;
+#endif
+}
+
+/**
+ * @brief Bitwise CRC-16/XMODEM.
+ */
+static uint16_t referenceCrc16(const uint8_t *data, const uint16_t size)
+{
+	uint16_t crc = 0;
+
+	for(uint16_t i = 0; i < size; i++)
+	{
+		crc ^= (uint16_t)(data[i] << 8);
+
+		for(uint8_t j = 0; j < 8; j++)
+		{
+			crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+		}
+	}
+
+	return crc;
+}
+
+/**
+ * @brief Bitwise CRC-32/ISO-HDLC.
+ */
+static uint32_t referenceCrc32(const uint8_t *data, const uint16_t size)
+{
+	uint32_t crc = 0xFFFFFFFF;
+
+	for(uint16_t i = 0; i < size; i++)
+	{
+		crc ^= data[i];
+
+		for(uint8_t j = 0; j < 8; j++)
+		{
+			crc = (crc & 1) ? ((crc >> 1) ^ 0xEDB88320) : (crc >> 1);
+		}
+	}
+
+	return ~crc;
+}
+
+void setUp(void)
+{
+	seed = 15;
+
+	fillRandom(bytes, sizeof(bytes));
+}
+
+void tearDown(void)
+{
+}
+
+void test_every_folding_size_matches_the_bitwise_crc(void)
+{
+	if(!isClmulUsed())
+	{
+		TEST_IGNORE_MESSAGE("Carry-less multiplications are not used by this build or CPU");
+	}
+
+	for(uint16_t size = 0; size <= 600; size++)	// Below and above the minimum size, every tail length of the 16 and 64-byte folds
+	{
+		for(uint8_t offset = 0; offset < 16; offset++)
+		{
+			TEST_ASSERT_EQUAL_HEX16(referenceCrc16(&bytes[offset], size), snap_calculateCrc16(&bytes[offset], size));
+			TEST_ASSERT_EQUAL_HEX32(referenceCrc32(&bytes[offset], size), snap_calculateCrc32(&bytes[offset], size));
+		}
+	}
+}
+
+void test_random_lengths_and_offsets_match_the_bitwise_crc(void)
+{
+	if(!isClmulUsed())
+	{
+		TEST_IGNORE_MESSAGE("Carry-less multiplications are not used by this build or CPU");
+	}
+
+	for(uint16_t n = 0; n < 2000; n++)
+	{
+		const uint16_t size = (uint16_t)(nextRandom() % (MAX_SIZE + 1U));
+		const uint8_t offset = (uint8_t)(nextRandom() % 16U);
+
+		bytes[offset + nextRandom() % (size + 1U)] ^= (uint8_t)nextRandom();	// New data on each pass
+
+		TEST_ASSERT_EQUAL_HEX16(referenceCrc16(&bytes[offset], size), snap_calculateCrc16(&bytes[offset], size));
+		TEST_ASSERT_EQUAL_HEX32(referenceCrc32(&bytes[offset], size), snap_calculateCrc32(&bytes[offset], size));
+	}
+}
+
+void test_uniform_data_matches_the_bitwise_crc(void)
+{
+	static const uint8_t values[] = {0x00, 0xFF, 0x01, 0x80};
+
+	if(!isClmulUsed())
+	{
+		TEST_IGNORE_MESSAGE("Carry-less multiplications are not used by this build or CPU");
+	}
+
+	for(uint8_t v = 0; v < sizeof(values); v++)
+	{
+		memset(bytes, values[v], sizeof(bytes));
+
+		for(uint16_t size = 64; size <= MAX_SIZE; size = (uint16_t)(size + 1U + size / 4U))
+		{
+			TEST_ASSERT_EQUAL_HEX16(referenceCrc16(bytes, size), snap_calculateCrc16(bytes, size));
+			TEST_ASSERT_EQUAL_HEX32(referenceCrc32(bytes, size), snap_calculateCrc32(bytes, size));
+		}
+	}
+}
+
+void test_large_frames_match_the_running_hash(void)
+{
+	static const uint8_t edms[] = {SNAP_HDB1_EDM_16BIT_CRC, SNAP_HDB1_EDM_32BIT_CRC};
+	static uint8_t txBuffer[SNAP_MAX_SIZE_BUFFER];
+	static uint8_t rxBuffer[SNAP_MAX_SIZE_BUFFER];
+	snap_frame_t tx, rx;
+	snap_fields_t fields;
+
+	for(uint16_t n = 0; n < 400; n++)
+	{
+		memset(&fields, 0, sizeof(fields));
+		fields.header.edm = edms[n % sizeof(edms)];
+		fields.header.ndb = SNAP_HDB1_NDB_USER_SPECIFIED;
+		fields.dataSize = (uint16_t)(64U + nextRandom() % (SNAP_MAX_SIZE_DATA - 63U));
+		fields.data = &bytes[nextRandom() % 16U];
+
+		snap_init(&tx, txBuffer, sizeof(txBuffer));
+		TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(&tx, &fields));
+
+		snap_init(&rx, rxBuffer, sizeof(rxBuffer));
+
+		TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, decodeBytes(&rx, txBuffer, tx.size));	// Byte by byte (tables) in builds without weak symbols
+	}
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_every_folding_size_matches_the_bitwise_crc);
+	RUN_TEST(test_random_lengths_and_offsets_match_the_bitwise_crc);
+	RUN_TEST(test_uniform_data_matches_the_bitwise_crc);
+	RUN_TEST(test_large_frames_match_the_running_hash);
+	return UNITY_END();
+}
@@ -0,0 +1,175 @@
+/**
+ * @file   test_main.c
+ * @brief  Host tests of the CRC lookup tables: every table size (SNAP_CRCx_TABLE_SIZE, see the native_crc_* environments)
+ *         must give the same results as the bitwise definition of each CRC, for any size and alignment of the data.
+ */
+
+#include <string.h>
+#include <unity.h>
+#include "snap.h"
+#include "snap_test.h"
+
+#define MAX_SIZE	(SNAP_MAX_SIZE_FRAME + 16U)
+
+static uint8_t bytes[MAX_SIZE + 8U];
+
+/**
+ * @brief Bitwise CRC-8/MAXIM-DOW.
+ */
+static uint8_t referenceCrc8(const uint8_t *data, const uint16_t size)
+{
+	uint8_t crc = 0;
+
+	for(uint16_t i = 0; i < size; i++)
+	{
+		crc ^= data[i];
+
+		for(uint8_t j = 0; j < 8; j++)
+		{
+			crc = (crc & 1) ? (uint8_t)((crc >> 1) ^ 0x8C) : (uint8_t)(crc >> 1);
+		}
+	}
+
+	return crc;
+}
+
+/**
+ * @brief Bitwise CRC-16/XMODEM.
+ */
+static uint16_t referenceCrc16(const uint8_t *data, const uint16_t size)
+{
+	uint16_t crc = 0;
+
+	for(uint16_t i = 0; i < size; i++)
+	{
+		crc ^= (uint16_t)(data[i] << 8);
+
+		for(uint8_t j = 0; j < 8; j++)
+		{
+			crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+		}
+	}
+
+	return crc;
+}
+
+/**
+ * @brief Bitwise CRC-32/ISO-HDLC.
+ */
+static uint32_t referenceCrc32(const uint8_t *data, const uint16_t size)
+{
+	uint32_t crc = 0xFFFFFFFF;
+
+	for(uint16_t i = 0; i < size; i++)
+	{
+		crc ^= data[i];
+
+		for(uint8_t j = 0; j < 8; j++)
+		{
+			crc = (crc & 1) ? ((crc >> 1) ^ 0xEDB88320) : (crc >> 1);
+		}
+	}
+
+	return ~crc;
+}
+
+void setUp(void)
+{
+	seed = 10;
+}
+
+void tearDown(void)
+{
+}
+
+void test_check_values(void)
+{
+	static const uint8_t check[] = "123456789";
+
+	TEST_ASSERT_EQUAL_HEX8(0xA1, snap_calculateCrc8(check, 9));
+	TEST_ASSERT_EQUAL_HEX16(0x31C3, snap_calculateCrc16(check, 9));
+	TEST_ASSERT_EQUAL_HEX32(0xCBF43926, snap_calculateCrc32(check, 9));
+}
+
+void test_every_size_and_alignment_matches_the_bitwise_crc(void)
+{
+	fillRandom(bytes, sizeof(bytes));
+
+	for(uint16_t size = 0; size <= MAX_SIZE; size++)
+	{
+		for(uint8_t offset = 0; offset < 8; offset++)	// The slicing tables read 4 or 8 bytes at a time
+		{
+			const uint8_t *data = &bytes[offset];
+
+			TEST_ASSERT_EQUAL_HEX8(referenceCrc8(data, size), snap_calculateCrc8(data, size));
+			TEST_ASSERT_EQUAL_HEX16(referenceCrc16(data, size), snap_calculateCrc16(data, size));
+			TEST_ASSERT_EQUAL_HEX32(referenceCrc32(data, size), snap_calculateCrc32(data, size));
+		}
+	}
+}
+
+void test_uniform_data_matches_the_bitwise_crc(void)
+{
+	static const uint8_t values[] = {0x00, 0xFF, 0x80, 0x01};
+
+	for(uint8_t v = 0; v < sizeof(values); v++)
+	{
+		memset(bytes, values[v], sizeof(bytes));
+
+		for(uint16_t size = 0; size <= MAX_SIZE; size = (uint16_t)(size + 1U + size / 8U))
+		{
+			TEST_ASSERT_EQUAL_HEX8(referenceCrc8(bytes, size), snap_calculateCrc8(bytes, size));
+			TEST_ASSERT_EQUAL_HEX16(referenceCrc16(bytes, size), snap_calculateCrc16(bytes, size));
+			TEST_ASSERT_EQUAL_HEX32(referenceCrc32(bytes, size), snap_calculateCrc32(bytes, size));
+		}
+	}
+}
+
+void test_frame_hash_matches_the_bitwise_crc(void)
+{
+	static const uint8_t edms[] = {SNAP_HDB1_EDM_8BIT_CRC, SNAP_HDB1_EDM_16BIT_CRC, SNAP_HDB1_EDM_32BIT_CRC};
+	static uint8_t data[SNAP_MAX_SIZE_DATA];
+	static uint8_t txBuffer[SNAP_MAX_SIZE_BUFFER];
+	static uint8_t rxBuffer[SNAP_MAX_SIZE_BUFFER];
+	snap_frame_t tx, rx;
+	snap_fields_t fields;
+
+	for(uint16_t n = 0; n < 600; n++)
+	{
+		const uint8_t edm = edms[n % sizeof(edms)];
+		uint32_t hash = 0;
+
+		memset(&fields, 0, sizeof(fields));
+		fields.header.edm = edm;
+		fields.header.ndb = SNAP_HDB1_NDB_USER_SPECIFIED;
+		fields.dataSize = (uint16_t)(nextRandom() % (SNAP_MAX_SIZE_DATA + 1U));
+		fields.data = data;
+
+		fillRandom(data, fields.dataSize);
+
+		snap_init(&tx, txBuffer, sizeof(txBuffer));
+		TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(&tx, &fields));
+		snap_getHash(&tx, &hash);
+
+		const uint16_t hashedSize = (uint16_t)(tx.layout.hashIndex - SNAP_INDEX_HDB2);
+		const uint8_t *hashed = &txBuffer[SNAP_INDEX_HDB2];
+		const uint32_t expected = (edm == SNAP_HDB1_EDM_8BIT_CRC) ? referenceCrc8(hashed, hashedSize) :
+		                          (edm == SNAP_HDB1_EDM_16BIT_CRC) ? referenceCrc16(hashed, hashedSize) : referenceCrc32(hashed, hashedSize);
+
+		TEST_ASSERT_EQUAL_HEX32(expected, hash);
+
+		snap_init(&rx, rxBuffer, sizeof(rxBuffer));
+
+		TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, decodeBytes(&rx, txBuffer, tx.size));	// Running hash of the decoder
+	}
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_check_values);
+	RUN_TEST(test_every_size_and_alignment_matches_the_bitwise_crc);
+	RUN_TEST(test_uniform_data_matches_the_bitwise_crc);
+	RUN_TEST(test_frame_hash_matches_the_bitwise_crc);
+	return UNITY_END();
+}
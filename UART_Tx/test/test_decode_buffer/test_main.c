@@ -0,0 +1,201 @@
+/**
+ * @file   test_main.c
+ * @brief  Host tests of snap_decodeBuffer(): decoding a stream in slices of any size must give the same frames
+ *         as decoding it byte by byte with snap_decode().
+ */
+
+#include <unity.h>
+#include "snap.h"
+#include "snap_test.h"
+
+#define STREAM_SIZE	(12000U)
+#define MAX_FRAMES	(200U)
+
+static uint8_t stream[STREAM_SIZE + SNAP_MAX_SIZE_BUFFER];
+static uint8_t txBuffer[SNAP_MAX_SIZE_BUFFER];
+static uint8_t rxBuffer[SNAP_MAX_SIZE_BUFFER];
+
+/**
+ * @brief Result of a decoded frame (status, size and CRC-32 of its bytes).
+ */
+typedef struct result_t
+{
+	int8_t   status;
+	uint16_t size;
+	uint32_t crc;
+} result_t;
+
+static result_t expected[MAX_FRAMES];
+
+/**
+ * @brief Append a frame with random fields (any EDM and NDB) to the stream.
+ * @param[out] bytes     Pointer to the end of the stream.
+ * @param[in]  errorRate One in errorRate frames gets a bit error (zero for none).
+ * @return Number of bytes appended.
+ */
+static uint16_t appendRandomFrame(uint8_t *bytes, const uint8_t errorRate)
+{
+	static uint8_t data[SNAP_MAX_SIZE_DATA];
+	snap_frame_t frame;
+	snap_fields_t fields;
+
+	const uint8_t edm = (uint8_t)(nextRandom() % 8);
+	const uint16_t maxDataSize = (nextRandom() % 2) ? SNAP_MAX_SIZE_DATA : 19U;
+
+	setRandomFields(&fields, edm, maxDataSize);
+	fillRandom(data, fields.dataSize);
+	fields.data = data;
+
+	snap_init(&frame, bytes, SNAP_MAX_SIZE_BUFFER);
+	snap_encapsulate(&frame, &fields);
+
+	if(errorRate && (nextRandom() % errorRate == 0))
+	{
+		const uint16_t index = (uint16_t)(nextRandom() % frame.size);
+		bytes[index] ^= (uint8_t)(1U << (nextRandom() % 8));
+	}
+
+	return frame.size;
+}
+
+/**
+ * @brief Fill the stream with frames and noise (with plenty of false sync bytes).
+ * @return Stream size.
+ */
+static uint16_t buildStream(void)
+{
+	uint16_t size = 0;
+
+	while(size < STREAM_SIZE)
+	{
+		for(uint8_t i = (uint8_t)(nextRandom() % 4); i != 0; i--)
+		{
+			stream[size++] = (nextRandom() % 4 == 0) ? SNAP_SYNC : (uint8_t)nextRandom();
+		}
+
+		size = (uint16_t)(size + appendRandomFrame(&stream[size], 4));
+	}
+
+	return size;
+}
+
+/**
+ * @brief Decode the stream byte by byte, resetting the frame after each complete one.
+ * @return Number of frames.
+ */
+static uint16_t decodeReference(const uint16_t size, const uint16_t maxSize)
+{
+	snap_frame_t frame;
+	uint16_t count = 0;
+
+	snap_init(&frame, rxBuffer, maxSize);
+
+	for(uint16_t i = 0; (i < size) && (count < MAX_FRAMES); i++)
+	{
+		const int8_t status = snap_decode(&frame, stream[i]);
+
+		if((status != SNAP_STATUS_IDLE) && (status != SNAP_STATUS_INCOMPLETE))
+		{
+			expected[count].status = status;
+			expected[count].size = frame.size;
+			expected[count].crc = snap_calculateCrc32(rxBuffer, frame.size);
+			count++;
+			snap_reset(&frame);
+		}
+	}
+
+	return count;
+}
+
+void setUp(void)
+{
+	seed = 0xC0FFEE;
+}
+
+void tearDown(void)
+{
+}
+
+void test_slices_of_any_size_match_the_byte_decoder(void)
+{
+	for(uint8_t n = 0; n < 20; n++)
+	{
+		const uint16_t size = buildStream();
+		const uint16_t maxSize = (nextRandom() % 2) ? SNAP_MAX_SIZE_BUFFER : (uint16_t)(3 + nextRandom() % 600);
+		const uint16_t expectedCount = decodeReference(size, maxSize);
+		snap_frame_t frame;
+		uint16_t position = 0;
+		uint16_t count = 0;
+
+		snap_init(&frame, rxBuffer, maxSize);
+
+		while((position < size) && (count < expectedCount))
+		{
+			uint16_t sliceSize = (uint16_t)(1 + nextRandom() % 700);
+			uint16_t consumed;
+
+			if(sliceSize > size - position)
+			{
+				sliceSize = (uint16_t)(size - position);
+			}
+
+			const int8_t status = snap_decodeBuffer(&frame, &stream[position], sliceSize, &consumed);
+
+			TEST_ASSERT_LESS_OR_EQUAL(sliceSize, consumed);
+			position = (uint16_t)(position + consumed);
+
+			if((status == SNAP_STATUS_IDLE) || (status == SNAP_STATUS_INCOMPLETE))
+			{
+				TEST_ASSERT_EQUAL_UINT16(sliceSize, consumed);	// Only a complete frame stops the slice
+				continue;
+			}
+
+			TEST_ASSERT_EQUAL_INT8(expected[count].status, status);
+			TEST_ASSERT_EQUAL_UINT16(expected[count].size, frame.size);
+			TEST_ASSERT_EQUAL_HEX32(expected[count].crc, snap_calculateCrc32(rxBuffer, frame.size));
+			count++;
+			snap_reset(&frame);
+		}
+
+		TEST_ASSERT_EQUAL_UINT16(expectedCount, count);
+	}
+}
+
+void test_slice_stops_at_the_end_of_a_frame(void)
+{
+	const uint16_t firstSize = appendRandomFrame(stream, 0);
+	const uint16_t secondSize = appendRandomFrame(&stream[firstSize], 0);
+	snap_frame_t frame;
+	uint16_t consumed = 0;
+
+	snap_init(&frame, rxBuffer, sizeof(rxBuffer));
+
+	const int8_t status = snap_decodeBuffer(&frame, stream, (uint16_t)(firstSize + secondSize), &consumed);
+
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, status);
+	TEST_ASSERT_EQUAL_UINT16(firstSize, consumed);
+}
+
+void test_consumed_count_is_optional(void)
+{
+	const uint16_t size = appendRandomFrame(stream, 0);
+	snap_frame_t reference, frame;
+	int8_t status = SNAP_STATUS_IDLE;
+
+	snap_init(&reference, txBuffer, sizeof(txBuffer));
+
+	status = decodeBytes(&reference, stream, size);
+
+	snap_init(&frame, rxBuffer, sizeof(rxBuffer));
+	TEST_ASSERT_EQUAL_INT8(status, snap_decodeBuffer(&frame, stream, size, NULL));
+	TEST_ASSERT_EQUAL_UINT16(reference.size, frame.size);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_slices_of_any_size_match_the_byte_decoder);
+	RUN_TEST(test_slice_stops_at_the_end_of_a_frame);
+	RUN_TEST(test_consumed_count_is_optional);
+	return UNITY_END();
+}
@@ -0,0 +1,303 @@
+/**
+ * @file   test_main.c
+ * @brief  Host tests of snap_decodeStream(): frames that start inside a failed frame must be recovered from the
+ *         stored bytes, without accepting unverifiable frames and without losing the bytes received meanwhile.
+ */
+
+#include <string.h>
+#include <unity.h>
+#include "snap.h"
+#include "snap_test.h"
+
+#define MAX_FRAMES	(600U)
+
+static uint8_t stream[MAX_FRAMES * 320U];
+static uint8_t sent[MAX_FRAMES][320];
+static uint16_t sentSize[MAX_FRAMES];
+static uint8_t rxBuffer[SNAP_MAX_SIZE_FRAME];
+
+/**
+ * @brief Encapsulate a frame with the given EDM and data into a buffer.
+ * @return Frame size.
+ */
+static uint16_t encapsulate(uint8_t *buffer, const uint16_t maxSize, const uint8_t edm, const uint8_t *data, const uint16_t dataSize)
+{
+	snap_frame_t frame;
+	snap_fields_t fields;
+
+	memset(&fields, 0, sizeof(fields));
+	fields.header.dab = SNAP_HDB2_DAB_1BYTE_DEST_ADDRESS;
+	fields.header.sab = SNAP_HDB2_SAB_1BYTE_SOURCE_ADDRESS;
+	fields.header.edm = edm;
+	fields.destAddress = 0x12;
+	fields.sourceAddress = 0x34;
+	fields.data = (uint8_t *)data;
+	fields.dataSize = dataSize;
+	fields.paddingAfter = true;
+
+	snap_init(&frame, buffer, maxSize);
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(&frame, &fields));
+	return frame.size;
+}
+
+/**
+ * @brief Decode a stream with snap_decodeStream() and count the valid frames equal to the given one.
+ * @return Number of valid frames (any content).
+ */
+static uint16_t countValidFrames(const uint8_t *bytes, const uint16_t size, const uint8_t *expected, const uint16_t expectedSize, uint16_t *matched)
+{
+	snap_frame_t frame;
+	uint16_t count = 0;
+
+	*matched = 0;
+	snap_init(&frame, rxBuffer, sizeof(rxBuffer));
+
+	for(uint16_t i = 0; i < size; i++)
+	{
+		if(snap_decodeStream(&frame, bytes[i]) == SNAP_STATUS_VALID)
+		{
+			count++;
+
+			if((frame.size == expectedSize) && (memcmp(rxBuffer, expected, expectedSize) == 0))
+			{
+				(*matched)++;
+			}
+
+			snap_reset(&frame);
+		}
+	}
+
+	return count;
+}
+
+void setUp(void)
+{
+	seed = 77;
+}
+
+void tearDown(void)
+{
+}
+
+void test_frame_after_a_false_sync_is_recovered(void)
+{
+	static const uint8_t data[] = "recovered";
+	static const uint8_t falseSync[] = {SNAP_SYNC, 0x00, 0x4B};	// No addresses, CRC-16, 64 data bytes
+	uint8_t frameBytes[64];
+	uint16_t size = 0;
+	uint16_t matched;
+
+	memcpy(&stream[size], falseSync, sizeof(falseSync));
+	size = (uint16_t)(size + sizeof(falseSync));
+
+	const uint16_t frameSize = encapsulate(frameBytes, sizeof(frameBytes), SNAP_HDB1_EDM_16BIT_CRC, data, sizeof(data));
+	memcpy(&stream[size], frameBytes, frameSize);
+	size = (uint16_t)(size + frameSize);
+	memset(&stream[size], 0, 80);	// Completes the false frame
+	size = (uint16_t)(size + 80);
+
+	TEST_ASSERT_EQUAL_UINT16(1, countValidFrames(stream, size, frameBytes, frameSize, &matched));
+	TEST_ASSERT_EQUAL_UINT16(1, matched);
+}
+
+void test_resynced_frame_without_hash_is_rejected(void)
+{
+	static const uint8_t inner[] = {SNAP_SYNC, 0x00, 0x01, 0xAA};	// No addresses, no error detection, 1 data byte
+	uint8_t outer[64];
+	uint16_t matched;
+
+	const uint16_t outerSize = encapsulate(outer, sizeof(outer), SNAP_HDB1_EDM_16BIT_CRC, inner, sizeof(inner));
+	outer[outerSize - 1] ^= 0x01;	// The outer frame fails, and its payload looks like a frame
+
+	TEST_ASSERT_EQUAL_UINT16(0, countValidFrames(outer, outerSize, inner, sizeof(inner), &matched));
+}
+
+void test_resynced_triple_copy_frame_does_not_lock_the_decoder(void)
+{
+	static const uint8_t inner[] = {SNAP_SYNC, 0x00, 0x10, SNAP_SYNC, 0x00, 0x10};	// 2 copies of a 3-byte EDM 1 frame
+	static const uint8_t data[] = "after the triple copy";
+	uint8_t frameBytes[64];
+	uint16_t size;
+	uint16_t matched;
+
+	size = encapsulate(stream, SNAP_MAX_SIZE_FRAME, SNAP_HDB1_EDM_16BIT_CRC, inner, sizeof(inner));
+	stream[size - 1] ^= 0x01;
+
+	const uint16_t frameSize = encapsulate(frameBytes, sizeof(frameBytes), SNAP_HDB1_EDM_16BIT_CRC, data, sizeof(data));
+	memcpy(&stream[size], frameBytes, frameSize);
+	size = (uint16_t)(size + frameSize);
+
+	TEST_ASSERT_EQUAL_UINT16(1, countValidFrames(stream, size, frameBytes, frameSize, &matched));
+	TEST_ASSERT_EQUAL_UINT16(1, matched);
+}
+
+void test_bytes_received_before_the_reset_are_kept(void)
+{
+	static const uint8_t first[] = "first";
+	static const uint8_t second[] = "second";
+	uint8_t secondBytes[64];
+	snap_frame_t frame;
+	uint16_t size;
+	int8_t status = SNAP_STATUS_IDLE;
+
+	size = encapsulate(stream, SNAP_MAX_SIZE_FRAME, SNAP_HDB1_EDM_32BIT_CRC, first, sizeof(first));
+	const uint16_t secondSize = encapsulate(secondBytes, sizeof(secondBytes), SNAP_HDB1_EDM_32BIT_CRC, second, sizeof(second));
+	memcpy(&stream[size], secondBytes, secondSize);
+	size = (uint16_t)(size + secondSize);
+	stream[size++] = 0x00;
+
+	snap_init(&frame, rxBuffer, sizeof(rxBuffer));
+
+	for(uint16_t i = 0; i < size; i++)	// The first frame is not reset before the second one arrives
+	{
+		status = snap_decodeStream(&frame, stream[i]);
+	}
+
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, status);
+	TEST_ASSERT_EQUAL_UINT16(size - secondSize - 1, frame.size);
+
+	snap_reset(&frame);
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_decodeStream(&frame, 0x00));
+	TEST_ASSERT_EQUAL_UINT16(secondSize, frame.size);
+	TEST_ASSERT_EQUAL_MEMORY(secondBytes, rxBuffer, secondSize);
+}
+
+void test_bytes_beyond_the_buffer_behind_a_valid_frame_are_flagged(void)
+{
+	static const uint8_t data[] = "held";
+	uint8_t buffer[64];
+	snap_frame_t frame;
+	const uint16_t size = encapsulate(stream, SNAP_MAX_SIZE_FRAME, SNAP_HDB1_EDM_32BIT_CRC, data, sizeof(data));
+	int8_t status = SNAP_STATUS_IDLE;
+
+	snap_init(&frame, buffer, sizeof(buffer));
+
+	for(uint16_t i = 0; i < size; i++)
+	{
+		status = snap_decodeStream(&frame, stream[i]);
+	}
+
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, status);
+
+	for(uint16_t i = size; i < sizeof(buffer); i++)	// Fill the buffer behind the held frame
+	{
+		TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_decodeStream(&frame, 0x00));
+	}
+
+	TEST_ASSERT_FALSE(frame.pendingOverflow);
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_decodeStream(&frame, 0x00));
+	TEST_ASSERT_TRUE(frame.pendingOverflow);
+	TEST_ASSERT_EQUAL_UINT16(sizeof(buffer) - size, frame.pendingSize);
+	TEST_ASSERT_EQUAL_UINT16(size, frame.size);
+
+	snap_reset(&frame);	// The stored bytes are decoded, the next valid frame clears the flag
+
+	for(uint16_t i = 0; i < size; i++)
+	{
+		status = snap_decodeStream(&frame, stream[i]);
+	}
+
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, status);
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_decodeStream(&frame, 0x00));
+	TEST_ASSERT_FALSE(frame.pendingOverflow);
+}
+
+void test_noisy_stream_loses_no_more_frames_than_the_byte_decoder(void)
+{
+	uint32_t size = 0;
+	uint16_t intact = 0;
+
+	for(uint16_t n = 0; n < MAX_FRAMES; n++)
+	{
+		uint8_t data[256];
+		const uint16_t maxDataSize = (nextRandom() % 4) ? 40 : 257;
+		const uint16_t dataSize = (uint16_t)(nextRandom() % maxDataSize);
+
+		for(uint8_t i = (uint8_t)(nextRandom() % 6); i != 0; i--)
+		{
+			stream[size++] = (uint8_t)(nextRandom() % SNAP_SYNC);	// Noise without sync bytes
+		}
+
+		for(uint16_t i = 0; i < dataSize; i++)
+		{
+			data[i] = (nextRandom() % 8 == 0) ? SNAP_SYNC : (uint8_t)nextRandom();	// Plenty of false sync bytes
+		}
+
+		const uint16_t frameSize = encapsulate(sent[n], sizeof(sent[n]), SNAP_HDB1_EDM_32BIT_CRC, data, dataSize);
+		memcpy(&stream[size], sent[n], frameSize);
+		sentSize[n] = frameSize;
+
+		if(nextRandom() % 10 == 0)
+		{
+			stream[size + 1U + nextRandom() % (frameSize - 1U)] ^= 0x10;
+			sentSize[n] = 0;	// Never matches
+		}
+		else
+		{
+			intact++;
+		}
+
+		size += frameSize;
+	}
+
+	snap_frame_t plain, resync;
+	uint8_t plainBuffer[SNAP_MAX_SIZE_FRAME];
+	uint16_t plainCount = 0, streamCount = 0, nextPlain = 0, nextStream = 0;
+
+	snap_init(&plain, plainBuffer, sizeof(plainBuffer));
+	snap_init(&resync, rxBuffer, sizeof(rxBuffer));
+
+	for(uint32_t i = 0; i < size; i++)
+	{
+		const int8_t status = snap_decode(&plain, stream[i]);
+
+		if(status == SNAP_STATUS_VALID)
+		{
+			while((nextPlain < MAX_FRAMES) && ((sentSize[nextPlain] != plain.size) || memcmp(sent[nextPlain], plainBuffer, plain.size)))
+			{
+				nextPlain++;
+			}
+
+			plainCount += (nextPlain < MAX_FRAMES) ? 1 : 0;
+			nextPlain++;
+		}
+
+		if((status != SNAP_STATUS_IDLE) && (status != SNAP_STATUS_INCOMPLETE))
+		{
+			snap_reset(&plain);
+		}
+
+		if(snap_decodeStream(&resync, stream[i]) == SNAP_STATUS_VALID)
+		{
+			uint16_t j = nextStream;
+
+			while((j < MAX_FRAMES) && ((sentSize[j] != resync.size) || memcmp(sent[j], rxBuffer, resync.size)))
+			{
+				j++;
+			}
+
+			if(j < MAX_FRAMES)
+			{
+				streamCount++;
+				nextStream = (uint16_t)(j + 1);
+			}
+
+			snap_reset(&resync);
+		}
+	}
+
+	TEST_ASSERT_GREATER_OR_EQUAL(plainCount, streamCount);
+	TEST_ASSERT_GREATER_OR_EQUAL(intact - intact / 100, streamCount);	// At most 1% of the intact frames are lost
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_frame_after_a_false_sync_is_recovered);
+	RUN_TEST(test_resynced_frame_without_hash_is_rejected);
+	RUN_TEST(test_resynced_triple_copy_frame_does_not_lock_the_decoder);
+	RUN_TEST(test_bytes_received_before_the_reset_are_kept);
+	RUN_TEST(test_bytes_beyond_the_buffer_behind_a_valid_frame_are_flagged);
+	RUN_TEST(test_noisy_stream_loses_no_more_frames_than_the_byte_decoder);
+	return UNITY_END();
+}
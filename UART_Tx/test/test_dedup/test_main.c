@@ -0,0 +1,258 @@
+/**
+ * @file   test_main.c
+ * @brief  Host tests of the duplicate suppression cache: frames sent again must be dropped and answered with the cached
+ *         response, within a window of sequence numbers per source and with the least recently used source evicted first.
+ */
+
+#include <string.h>
+#include <unity.h>
+#include "snap.h"
+#include "snap_arq.h"
+#include "snap_dedup.h"
+#include "snap_test.h"
+
+#define SLOT_SIZE	(32U)
+
+static uint8_t rxBuffer[SNAP_MAX_SIZE_BUFFER];
+static uint8_t txBuffer[SNAP_MAX_SIZE_BUFFER];
+static uint8_t senderBuffer[SNAP_ARQ_WINDOW * SLOT_SIZE];
+static snap_dedup_t dedup;
+static snap_frame_t rx, tx;
+static snap_fields_t responseFields;
+
+/**
+ * @brief Encapsulate a frame from a source, as received by this node.
+ * @param[in] seq Sequence number (only if pfb is not zero).
+ */
+static void receiveFrame(const uint32_t source, const uint8_t seq, const uint8_t ack, const uint8_t pfb)
+{
+	uint8_t data[3] = {1, 2, 3};
+	snap_fields_t fields;
+
+	memset(&fields, 0, sizeof(fields));
+	fields.header.dab = SNAP_HDB2_DAB_1BYTE_DEST_ADDRESS;
+	fields.header.sab = SNAP_HDB2_SAB_2BYTE_SOURCE_ADDRESS;
+	fields.header.pfb = pfb;
+	fields.header.ack = ack;
+	fields.header.edm = SNAP_HDB1_EDM_16BIT_CRC;
+	fields.destAddress = 0x01;
+	fields.sourceAddress = source;
+	fields.data = data;
+	fields.dataSize = sizeof(data);
+
+	if(pfb != SNAP_HDB2_PFB_NO_PROTOCOL_FLAGS)
+	{
+		snap_setSeq(&fields, seq);
+	}
+
+	snap_init(&rx, rxBuffer, sizeof(rxBuffer));
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(&rx, &fields));
+}
+
+static bool isDuplicate(const uint32_t source, const uint8_t seq)
+{
+	receiveFrame(source, seq, SNAP_HDB2_ACK_REQUESTED, SNAP_HDB2_PFB_1BYTE_PROTOCOL_FLAGS);
+
+	return snap_isDuplicate(&dedup, &rx);
+}
+
+void setUp(void)
+{
+	snap_initDedup(&dedup);
+	snap_init(&tx, txBuffer, sizeof(txBuffer));
+	memset(&responseFields, 0, sizeof(responseFields));
+	responseFields.header.dab = SNAP_HDB2_DAB_2BYTE_DEST_ADDRESS;
+	responseFields.header.sab = SNAP_HDB2_SAB_1BYTE_SOURCE_ADDRESS;
+	responseFields.header.edm = SNAP_HDB1_EDM_8BIT_CRC;
+	responseFields.sourceAddress = 0x01;
+}
+
+void tearDown(void)
+{
+}
+
+void test_cached_response(void)
+{
+	uint8_t response[SNAP_MAX_SIZE_BUFFER];
+	uint32_t dest;
+	uint8_t seq;
+
+	TEST_ASSERT_FALSE(isDuplicate(100, 5));
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_IDLE, snap_encapsulateCachedAck(&dedup, &tx, &responseFields, &rx));	// Not answered yet
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulateDedupAck(&dedup, &tx, &responseFields, &rx, SNAP_HDB2_ACK_RESPONSE_NACK));
+
+	const uint16_t responseSize = tx.size;
+	memcpy(response, txBuffer, responseSize);
+	memset(txBuffer, 0, sizeof(txBuffer));
+
+	TEST_ASSERT_TRUE(isDuplicate(100, 5));
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulateCachedAck(&dedup, &tx, &responseFields, &rx));
+	TEST_ASSERT_EQUAL_UINT16(responseSize, tx.size);
+	TEST_ASSERT_EQUAL_MEMORY(response, txBuffer, responseSize);
+	TEST_ASSERT_EQUAL_UINT8(SNAP_HDB2_ACK_RESPONSE_NACK, SNAP_HDB2_ACK(txBuffer));
+	snap_getDestAddress(&tx, &dest);
+	TEST_ASSERT_EQUAL_UINT32(100, dest);
+	TEST_ASSERT_TRUE(snap_getSeq(&tx, &seq));
+	TEST_ASSERT_EQUAL_UINT8(5, seq);
+
+	TEST_ASSERT_FALSE(isDuplicate(100, 6));
+	receiveFrame(100, 6, SNAP_HDB2_ACK_RESPONSE_ACK, SNAP_HDB2_PFB_1BYTE_PROTOCOL_FLAGS);
+	TEST_ASSERT_FALSE(snap_isDuplicate(&dedup, &rx));	// Responses carry the sequence number of the frame they answer
+	receiveFrame(100, 6, SNAP_HDB2_ACK_REQUESTED, SNAP_HDB2_PFB_NO_PROTOCOL_FLAGS);
+	TEST_ASSERT_FALSE(snap_isDuplicate(&dedup, &rx));	// No sequence number
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_ERROR_OVERFLOW, snap_encapsulateDedupAck(&dedup, &tx, &responseFields, &rx, SNAP_HDB2_ACK_RESPONSE_ACK));
+	TEST_ASSERT_EQUAL_UINT16(0, tx.size);
+
+	TEST_ASSERT_EQUAL_UINT16(1, dedup.duplicateCount);
+}
+
+void test_least_recently_used_source_is_evicted(void)
+{
+	TEST_ASSERT_FALSE(isDuplicate(100, 1));
+
+	for(uint32_t source = 1; source <= SNAP_DEDUP_SIZE; source++)
+	{
+		TEST_ASSERT_FALSE(isDuplicate(200 + source, 1));
+	}
+
+	TEST_ASSERT_EQUAL_UINT8(SNAP_DEDUP_SIZE, dedup.count);
+	TEST_ASSERT_FALSE(isDuplicate(100, 1));	// Evicted by the last source, then evicts source 201
+
+	if(SNAP_DEDUP_SIZE > 1)
+	{
+		TEST_ASSERT_TRUE(isDuplicate(202, 1));
+	}
+
+	TEST_ASSERT_FALSE(isDuplicate(201, 1));
+	TEST_ASSERT_TRUE(isDuplicate(201, 1));
+}
+
+void test_window_of_sequence_numbers(void)
+{
+	const uint8_t first = 254;	// The window wraps around
+	const uint8_t last = (uint8_t)(first + SNAP_ARQ_WINDOW - 1U);
+
+	TEST_ASSERT_FALSE(isDuplicate(9, last));	// Frames received out of order
+
+	for(uint8_t i = 0; i + 1U < SNAP_ARQ_WINDOW; i++)
+	{
+		TEST_ASSERT_FALSE(isDuplicate(9, (uint8_t)(first + i)));
+	}
+
+	for(uint8_t i = 0; i < SNAP_ARQ_WINDOW; i++)
+	{
+		TEST_ASSERT_TRUE(isDuplicate(9, (uint8_t)(first + i)));
+	}
+
+	TEST_ASSERT_FALSE(isDuplicate(9, (uint8_t)(last + 1U)));	// Slides the first frame out of the window
+	TEST_ASSERT_FALSE(isDuplicate(9, first));	// Older than the window: the source restarted
+	TEST_ASSERT_TRUE(isDuplicate(9, first));
+	TEST_ASSERT_FALSE(isDuplicate(9, (uint8_t)(last + 1U)));	// The restart dropped the previous window
+
+	TEST_ASSERT_FALSE(isDuplicate(9, 100));
+	TEST_ASSERT_TRUE(isDuplicate(9, 100));
+}
+
+void test_responses_of_the_window(void)
+{
+	if(SNAP_ARQ_WINDOW < 2)
+	{
+		TEST_IGNORE_MESSAGE("Needs a window of 2 frames or more");
+	}
+
+	TEST_ASSERT_FALSE(isDuplicate(9, 255));
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulateDedupAck(&dedup, &tx, &responseFields, &rx, SNAP_HDB2_ACK_RESPONSE_ACK));
+	TEST_ASSERT_FALSE(isDuplicate(9, 0));
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulateDedupAck(&dedup, &tx, &responseFields, &rx, SNAP_HDB2_ACK_RESPONSE_NACK));
+
+	TEST_ASSERT_TRUE(isDuplicate(9, 255));	// Each frame keeps its own response
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulateCachedAck(&dedup, &tx, &responseFields, &rx));
+	TEST_ASSERT_EQUAL_UINT8(SNAP_HDB2_ACK_RESPONSE_ACK, SNAP_HDB2_ACK(txBuffer));
+
+	TEST_ASSERT_TRUE(isDuplicate(9, 0));
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulateCachedAck(&dedup, &tx, &responseFields, &rx));
+	TEST_ASSERT_EQUAL_UINT8(SNAP_HDB2_ACK_RESPONSE_NACK, SNAP_HDB2_ACK(txBuffer));
+
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulateDedupAck(&dedup, &tx, &responseFields, &rx, SNAP_HDB2_ACK_RESPONSE_ACK));	// Accepted later
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulateCachedAck(&dedup, &tx, &responseFields, &rx));
+	TEST_ASSERT_EQUAL_UINT8(SNAP_HDB2_ACK_RESPONSE_ACK, SNAP_HDB2_ACK(txBuffer));
+}
+
+/**
+ * @brief Deliver a frame of the ARQ sender through the cache, and return the response to the sender.
+ * @return Number of frames released by the response.
+ */
+static uint8_t deliverArqFrame(snap_arqSender_t *sender, const snap_frame_t *frame)
+{
+	snap_frame_t ack;
+	uint8_t ackBuffer[SNAP_MAX_SIZE_BUFFER];
+
+	snap_init(&rx, rxBuffer, sizeof(rxBuffer));
+	deliverFrame(frame, &rx);
+
+	if(snap_isDuplicate(&dedup, &rx))
+	{
+		TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulateCachedAck(&dedup, &tx, &responseFields, &rx));
+	}
+	else
+	{
+		TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulateDedupAck(&dedup, &tx, &responseFields, &rx, SNAP_HDB2_ACK_RESPONSE_ACK));
+	}
+
+	snap_init(&ack, ackBuffer, sizeof(ackBuffer));
+	deliverFrame(&tx, &ack);
+
+	return snap_arqProcessAck(sender, &ack);
+}
+
+void test_responses_of_the_arq_layer(void)
+{
+	if(SNAP_ARQ_WINDOW < 4)
+	{
+		TEST_IGNORE_MESSAGE("Needs a window of 4 frames or more");
+	}
+
+	snap_arqSender_t sender;
+	snap_frame_t *frame[4];
+	uint8_t data = 0;
+	snap_fields_t fields;
+
+	memset(&fields, 0, sizeof(fields));
+	fields.header.dab = SNAP_HDB2_DAB_1BYTE_DEST_ADDRESS;
+	fields.header.sab = SNAP_HDB2_SAB_1BYTE_SOURCE_ADDRESS;
+	fields.header.edm = SNAP_HDB1_EDM_16BIT_CRC;
+	fields.destAddress = 0x01;
+	fields.sourceAddress = 0x42;
+	fields.data = &data;
+	fields.dataSize = 1;
+
+	TEST_ASSERT_EQUAL_INT16(SLOT_SIZE, snap_initArqSender(&sender, senderBuffer, SLOT_SIZE, 100, 3));
+
+	for(uint8_t i = 0; i < 4; i++)
+	{
+		frame[i] = snap_arqSend(&sender, &fields, 0);
+		TEST_ASSERT_NOT_NULL(frame[i]);
+	}
+
+	TEST_ASSERT_EQUAL_UINT8(1, deliverArqFrame(&sender, frame[0]));	// Frame 1 is lost
+	TEST_ASSERT_EQUAL_UINT8(1, deliverArqFrame(&sender, frame[2]));	// Releases frame 2 only
+	TEST_ASSERT_EQUAL_UINT8(1, deliverArqFrame(&sender, frame[3]));
+	TEST_ASSERT_EQUAL_UINT8(3, snap_arqGetPendingCount(&sender));	// The window still starts at frame 1
+
+	TEST_ASSERT_EQUAL_PTR(frame[1], snap_arqGetRetransmission(&sender, 1));	// Reported missing
+	TEST_ASSERT_EQUAL_UINT8(0, deliverArqFrame(&sender, frame[0]));	// Duplicate: the cached ACK releases nothing more
+	TEST_ASSERT_EQUAL_UINT8(1, deliverArqFrame(&sender, frame[1]));
+	TEST_ASSERT_EQUAL_UINT8(0, snap_arqGetPendingCount(&sender));
+	TEST_ASSERT_EQUAL_UINT16(1, dedup.duplicateCount);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_cached_response);
+	RUN_TEST(test_least_recently_used_source_is_evicted);
+	RUN_TEST(test_window_of_sequence_numbers);
+	RUN_TEST(test_responses_of_the_window);
+	RUN_TEST(test_responses_of_the_arq_layer);
+	return UNITY_END();
+}
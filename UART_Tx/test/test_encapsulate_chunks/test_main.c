@@ -0,0 +1,123 @@
+/**
+ * @file   test_main.c
+ * @brief  Host tests of the scatter-gather encapsulation: a payload gathered from several chunks by
+ *         snap_encapsulateChunks() must give the same frame as the concatenated payload given to snap_encapsulate().
+ */
+
+#include <unity.h>
+#include "snap.h"
+#include "snap_test.h"
+
+#define MAX_CHUNKS	(12U)
+
+static uint8_t data[SNAP_MAX_SIZE_DATA + 64U];
+static uint8_t copiedBuffer[SNAP_MAX_SIZE_BUFFER];
+static uint8_t chunksBuffer[SNAP_MAX_SIZE_BUFFER];
+
+void setUp(void)
+{
+	seed = 6;
+
+	fillRandom(data, sizeof(data));
+}
+
+void tearDown(void)
+{
+}
+
+void test_chunks_give_the_same_frame_as_one_payload(void)
+{
+	snap_frame_t copied, gathered;
+	snap_fields_t fields, chunkFields;
+	snap_chunk_t chunks[MAX_CHUNKS];
+
+	for(uint16_t n = 0; n < 20000; n++)
+	{
+		const uint8_t chunkCount = (uint8_t)(nextRandom() % (MAX_CHUNKS + 1U));
+		const uint16_t maxSize = (nextRandom() % 4) ? (uint16_t)SNAP_MAX_SIZE_BUFFER : (uint16_t)(SNAP_MIN_SIZE_FRAME + nextRandom() % 600U);
+		uint16_t dataSize = 0;
+
+		for(uint8_t i = 0; i < chunkCount; i++)	// Consecutive pieces of the data array, some of them empty
+		{
+			const uint16_t maxChunkSize = (nextRandom() % 8) ? 20 : 200;
+
+			chunks[i].data = &data[dataSize];
+			chunks[i].size = (uint16_t)(nextRandom() % maxChunkSize);
+			chunks[i].inFlash = nextRandom() % 2;
+			dataSize = (uint16_t)(dataSize + chunks[i].size);
+
+			if(dataSize > sizeof(data))
+			{
+				chunks[i].size = (uint16_t)(chunks[i].size - (dataSize - sizeof(data)));
+				dataSize = sizeof(data);
+			}
+		}
+
+		setRandomFields(&fields, (uint8_t)(nextRandom() % 7), 0);
+		chunkFields = fields;
+		fields.data = data;
+		fields.dataSize = dataSize;
+
+		snap_init(&copied, copiedBuffer, maxSize);
+		snap_init(&gathered, chunksBuffer, maxSize);
+
+		const int8_t status = snap_encapsulate(&copied, &fields);
+
+		TEST_ASSERT_EQUAL_INT8(status, snap_encapsulateChunks(&gathered, &chunkFields, chunks, chunkCount));
+		TEST_ASSERT_EQUAL_UINT16(dataSize, chunkFields.dataSize);
+
+		if(status != SNAP_STATUS_VALID)
+		{
+			TEST_ASSERT_EQUAL_UINT16(0, gathered.size);
+			continue;
+		}
+
+		TEST_ASSERT_EQUAL_UINT16(copied.size, gathered.size);
+		TEST_ASSERT_EQUAL_MEMORY(copiedBuffer, chunksBuffer, copied.size);
+		const uint16_t paddingSize = (uint16_t)(gathered.layout.dataSize - dataSize);
+		TEST_ASSERT_TRUE(chunkFields.data == &chunksBuffer[gathered.layout.dataIndex + (fields.paddingAfter ? 0U : paddingSize)]);
+	}
+}
+
+void test_no_chunks_gives_an_empty_payload(void)
+{
+	snap_frame_t frame;
+	snap_fields_t fields;
+
+	setRandomFields(&fields, SNAP_HDB1_EDM_16BIT_CRC, 0);
+	fields.header.ndb = SNAP_HDB1_NDB_USER_SPECIFIED;
+
+	snap_init(&frame, chunksBuffer, sizeof(chunksBuffer));
+
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulateChunks(&frame, &fields, NULL, 0));
+	TEST_ASSERT_EQUAL_UINT16(0, fields.dataSize);
+	TEST_ASSERT_EQUAL_UINT16(0, snap_getDataSize(&frame));
+}
+
+void test_chunks_above_maximum_size_are_rejected(void)
+{
+	static uint8_t large[40000];
+	snap_frame_t frame;
+	snap_fields_t fields;
+	snap_chunk_t chunks[2];
+
+	chunks[0].data = large;
+	chunks[0].size = sizeof(large);
+	chunks[0].inFlash = false;
+	chunks[1] = chunks[0];	// The total does not fit in 16 bits
+
+	setRandomFields(&fields, (uint8_t)(nextRandom() % 7), 0);
+	snap_init(&frame, chunksBuffer, sizeof(chunksBuffer));
+
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_ERROR_OVERFLOW, snap_encapsulateChunks(&frame, &fields, chunks, 2));
+	TEST_ASSERT_EQUAL_UINT16(0, frame.size);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_chunks_give_the_same_frame_as_one_payload);
+	RUN_TEST(test_no_chunks_gives_an_empty_payload);
+	RUN_TEST(test_chunks_above_maximum_size_are_rejected);
+	return UNITY_END();
+}
@@ -0,0 +1,169 @@
+/**
+ * @file   test_main.c
+ * @brief  Host tests of the exact-length payloads (NDB 15): frames must be exactly as long as their data,
+ *         and the data must be decoded without guessing where the padding starts.
+ */
+
+#include <string.h>
+#include <unity.h>
+#include "snap.h"
+#include "snap_test.h"
+
+static uint8_t data[SNAP_MAX_SIZE_DATA];
+static uint8_t txBuffer[SNAP_MAX_SIZE_BUFFER];
+static uint8_t rxBuffer[SNAP_MAX_SIZE_BUFFER];
+
+/**
+ * @brief Set the fields of a frame with exact-length data.
+ */
+static void setFields(snap_fields_t *fields, const uint8_t edm, const uint16_t dataSize)
+{
+	memset(fields, 0, sizeof(*fields));
+	fields->header.dab = SNAP_HDB2_DAB_2BYTE_DEST_ADDRESS;
+	fields->header.sab = SNAP_HDB2_SAB_1BYTE_SOURCE_ADDRESS;
+	fields->header.pfb = SNAP_HDB2_PFB_1BYTE_PROTOCOL_FLAGS;
+	fields->header.edm = edm;
+	fields->header.ndb = SNAP_HDB1_NDB_USER_SPECIFIED;
+	fields->destAddress = 0x1234;
+	fields->sourceAddress = 0x56;
+	fields->protocolFlags = 0x78;
+	fields->data = data;
+	fields->dataSize = dataSize;
+}
+
+void setUp(void)
+{
+	seed = 15;
+}
+
+void tearDown(void)
+{
+}
+
+void test_frame_has_no_padding(void)
+{
+	snap_frame_t frame;
+	snap_fields_t fields;
+
+	for(uint16_t dataSize = 0; dataSize <= SNAP_MAX_SIZE_DATA; dataSize++)
+	{
+		const uint16_t lengthSize = (dataSize < SNAP_LENGTH_EXTENDED) ? 1U : 2U;
+
+		setFields(&fields, SNAP_HDB1_EDM_32BIT_CRC, dataSize);
+		snap_init(&frame, txBuffer, sizeof(txBuffer));
+
+		TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(&frame, &fields));
+		TEST_ASSERT_EQUAL_UINT16(1U + 2U + 2U + 1U + 1U + lengthSize + dataSize + 4U, frame.size);
+		TEST_ASSERT_EQUAL_UINT16(dataSize, SNAP_SIZE_DATA(txBuffer));
+		TEST_ASSERT_EQUAL_UINT16(7U + lengthSize, SNAP_INDEX_DATA(txBuffer));
+	}
+}
+
+void test_data_with_zero_bytes_is_decoded_intact(void)
+{
+	snap_frame_t tx, rx;
+	snap_fields_t fields, decoded;
+	static const uint8_t edms[] = {SNAP_HDB1_EDM_NO_ERROR_DETECTION, SNAP_HDB1_EDM_3_RETRANSMISSION, SNAP_HDB1_EDM_8BIT_CHECKSUM,
+	                               SNAP_HDB1_EDM_8BIT_CRC, SNAP_HDB1_EDM_16BIT_CRC, SNAP_HDB1_EDM_32BIT_CRC, SNAP_HDB1_EDM_FEC};
+
+	for(uint16_t n = 0; n < 1000; n++)
+	{
+		const uint16_t dataSize = (uint16_t)(nextRandom() % (SNAP_MAX_SIZE_DATA + 1U));
+
+		for(uint16_t i = 0; i < dataSize; i++)
+		{
+			data[i] = (nextRandom() % 2) ? 0x00 : (uint8_t)nextRandom();	// Padding bytes are zero too
+		}
+
+		setFields(&fields, edms[n % sizeof(edms)], dataSize);
+		snap_init(&tx, txBuffer, sizeof(txBuffer));
+		TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(&tx, &fields));
+
+		snap_init(&rx, rxBuffer, sizeof(rxBuffer));
+
+		TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, decodeBytes(&rx, txBuffer, tx.size));
+		TEST_ASSERT_EQUAL_UINT16(tx.size, rx.size);
+		TEST_ASSERT_EQUAL_INT16(dataSize, snap_decapsulate(&rx, &decoded));
+		TEST_ASSERT_EQUAL_UINT32(0x1234, decoded.destAddress);
+
+		if(dataSize)
+		{
+			TEST_ASSERT_EQUAL_MEMORY(data, decoded.data, dataSize);
+		}
+	}
+}
+
+void test_length_field_above_maximum_is_rejected(void)
+{
+	static const uint8_t header[] = {SNAP_SYNC, 0x00, 0x4F, 0x82, 0x01};	// No addresses, CRC-16, exact length of 513 bytes
+	snap_frame_t frame;
+
+	snap_init(&frame, rxBuffer, sizeof(rxBuffer));
+
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_ERROR_OVERFLOW, decodeBytes(&frame, header, sizeof(header)));
+}
+
+void test_data_larger_than_maximum_is_not_encapsulated(void)
+{
+	snap_frame_t frame;
+	snap_fields_t fields;
+
+	setFields(&fields, SNAP_HDB1_EDM_16BIT_CRC, SNAP_MAX_SIZE_DATA + 1U);
+	snap_init(&frame, txBuffer, sizeof(txBuffer));
+
+	TEST_ASSERT_TRUE(snap_encapsulate(&frame, &fields) != SNAP_STATUS_VALID);
+}
+
+void test_largest_frames_fit_in_maximum_size(void)
+{
+	snap_frame_t tx, rx;
+	snap_fields_t fields;
+	uint16_t maxHashedSize = 0;
+
+	for(uint8_t edm = SNAP_HDB1_EDM_NO_ERROR_DETECTION; edm <= SNAP_HDB1_EDM_USER_SPECIFIED; edm++)
+	{
+		setFields(&fields, edm, SNAP_MAX_SIZE_DATA);
+		fields.header.dab = SNAP_HDB2_DAB_3BYTE_DEST_ADDRESS;
+		fields.header.sab = SNAP_HDB2_SAB_3BYTE_SOURCE_ADDRESS;
+		fields.header.pfb = SNAP_HDB2_PFB_3BYTE_PROTOCOL_FLAGS;
+
+		snap_init(&tx, txBuffer, sizeof(txBuffer));
+		TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(&tx, &fields));
+
+		const uint16_t frameSize = (uint16_t)(tx.layout.hashIndex + tx.layout.hashSize);	// One copy of EDM 1
+
+		if(edm == SNAP_HDB1_EDM_FEC)
+		{
+			TEST_ASSERT_LESS_OR_EQUAL_UINT16(SNAP_MAX_SIZE_FEC_FRAME, frameSize);	// Interleaved frames may have more codewords
+		}
+		else if(frameSize > maxHashedSize)
+		{
+			maxHashedSize = frameSize;
+		}
+
+		TEST_ASSERT_LESS_OR_EQUAL_UINT16(SNAP_MAX_SIZE_FRAME, frameSize);
+		TEST_ASSERT_LESS_OR_EQUAL_UINT16(SNAP_MAX_SIZE_BUFFER, tx.size);
+
+		snap_init(&rx, rxBuffer, SNAP_MAX_SIZE_FRAME * ((edm == SNAP_HDB1_EDM_3_RETRANSMISSION) ? 3U : 1U));
+
+		for(uint16_t i = 0; i < tx.size; i++)
+		{
+			snap_decode(&rx, txBuffer[i]);
+		}
+
+		TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, rx.status);
+	}
+
+	TEST_ASSERT_EQUAL_UINT16(SNAP_MAX_SIZE_HASHED_FRAME, maxHashedSize);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_frame_has_no_padding);
+	RUN_TEST(test_data_with_zero_bytes_is_decoded_intact);
+	RUN_TEST(test_length_field_above_maximum_is_rejected);
+	RUN_TEST(test_data_larger_than_maximum_is_not_encapsulated);
+	RUN_TEST(test_largest_frames_fit_in_maximum_size);
+	return UNITY_END();
+}
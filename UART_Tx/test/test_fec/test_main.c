@@ -0,0 +1,259 @@
+/**
+ * @file   test_main.c
+ * @brief  Host tests of the Reed-Solomon FEC (EDM 6): up to half the parity bytes of each codeword must be corrected,
+ *         and frames with more errors must not be reported as valid.
+ */
+
+#include <string.h>
+#include <unity.h>
+#include "snap.h"
+#include "snap_test.h"
+
+#define MAX_ERRORS	(SNAP_SIZE_FEC_PARITY / 2U)
+
+static uint8_t data[SNAP_MAX_SIZE_DATA];
+static uint8_t txBuffer[SNAP_MAX_SIZE_BUFFER];
+static uint8_t rxBuffer[SNAP_MAX_SIZE_BUFFER];
+static uint8_t sent[SNAP_MAX_SIZE_BUFFER];
+
+/**
+ * @brief Add errors (random non-zero values) to distinct bytes of an array.
+ * @param[in,out] bytes Pointer to the array.
+ * @param[in]     size  Number of bytes in the array.
+ * @param[in]     count Number of errors (not greater than size).
+ */
+static void addErrors(uint8_t *bytes, const uint16_t size, const uint16_t count)
+{
+	static bool hit[SNAP_MAX_SIZE_BUFFER];
+
+	memset(hit, 0, size);
+
+	for(uint16_t n = 0; n < count; n++)
+	{
+		uint16_t index;
+
+		do
+		{
+			index = (uint16_t)(nextRandom() % size);
+		} while(hit[index]);
+
+		hit[index] = true;
+		bytes[index] ^= (uint8_t)(1U + nextRandom() % 255U);
+	}
+}
+
+/**
+ * @brief Encapsulate a FEC frame with random data.
+ * @param[out] frame    Pointer to the frame structure (buffer txBuffer, also copied to the sent array).
+ * @param[in]  dataSize Number of data bytes (exact length).
+ */
+static void encapsulateFecFrame(snap_frame_t *frame, const uint16_t dataSize)
+{
+	snap_fields_t fields;
+
+	memset(&fields, 0, sizeof(fields));
+	fields.header.dab = SNAP_HDB2_DAB_1BYTE_DEST_ADDRESS;
+	fields.header.sab = SNAP_HDB2_SAB_1BYTE_SOURCE_ADDRESS;
+	fields.header.edm = SNAP_HDB1_EDM_FEC;
+	fields.header.ndb = SNAP_HDB1_NDB_USER_SPECIFIED;
+	fields.destAddress = 0x05;
+	fields.sourceAddress = 0x06;
+	fields.dataSize = dataSize;
+	fields.data = data;
+
+	fillRandom(data, dataSize);
+
+	snap_init(frame, txBuffer, sizeof(txBuffer));
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(frame, &fields));
+	memcpy(sent, txBuffer, frame->size);
+}
+
+/**
+ * @brief Decode the bytes of the txBuffer array.
+ * @return Status of the last decoded byte.
+ */
+static int8_t decodeFrame(snap_frame_t *frame, const uint16_t size)
+{
+	snap_init(frame, rxBuffer, sizeof(rxBuffer));
+
+	return decodeBytes(frame, txBuffer, size);
+}
+
+void setUp(void)
+{
+	seed = 6;
+}
+
+void tearDown(void)
+{
+}
+
+/**
+ * @brief Multiply two elements of GF(256) (primitive polynomial 0x11D), bit by bit.
+ */
+static uint8_t gfMul(uint8_t a, uint8_t b)
+{
+	uint8_t product = 0;
+
+	for(; b != 0; b >>= 1)
+	{
+		if(b & 1U)
+		{
+			product ^= a;
+		}
+
+		a = (uint8_t)((a << 1) ^ ((a & 0x80U) ? 0x1DU : 0U));
+	}
+
+	return product;
+}
+
+void test_codewords_have_every_generator_root(void)
+{
+	uint8_t parity[SNAP_SIZE_FEC_PARITY];
+
+	for(uint8_t n = 0; n < 3; n++)	// The generator is the same on every call
+	{
+		const uint16_t size = (uint16_t)(1U + nextRandom() % SNAP_SIZE_FEC_MESSAGE);
+		uint8_t root = 1;
+
+		for(uint16_t i = 0; i < size; i++)
+		{
+			data[i] = (uint8_t)nextRandom();
+		}
+
+		snap_calculateFecParity(data, size, parity);
+
+		for(uint8_t r = 0; r < SNAP_SIZE_FEC_PARITY; r++, root = gfMul(root, 2))
+		{
+			uint8_t value = 0;
+
+			for(uint16_t i = 0; i < size; i++)
+			{
+				value = gfMul(value, root) ^ data[i];
+			}
+
+			for(uint8_t i = 0; i < SNAP_SIZE_FEC_PARITY; i++)
+			{
+				value = gfMul(value, root) ^ parity[i];
+			}
+
+			TEST_ASSERT_EQUAL_HEX8(0, value);	// Codeword evaluated at alpha^r
+		}
+	}
+}
+
+void test_codeword_errors_are_corrected(void)
+{
+	uint8_t message[SNAP_SIZE_FEC_MESSAGE + SNAP_SIZE_FEC_PARITY];
+	uint8_t codeword[sizeof(message)];
+
+	for(uint16_t n = 0; n < 2000; n++)
+	{
+		const uint16_t size = (uint16_t)(1U + nextRandom() % SNAP_SIZE_FEC_MESSAGE);
+		const uint16_t errors = (uint16_t)(nextRandom() % (MAX_ERRORS + 1U));
+
+		fillRandom(message, size);
+
+		snap_calculateFecParity(message, size, &message[size]);
+		memcpy(codeword, message, size + SNAP_SIZE_FEC_PARITY);
+		addErrors(codeword, (uint16_t)(size + SNAP_SIZE_FEC_PARITY), errors);
+
+		TEST_ASSERT_EQUAL_INT16(errors, snap_correctFecErrors(codeword, size, &codeword[size]));
+		TEST_ASSERT_EQUAL_MEMORY(message, codeword, size + SNAP_SIZE_FEC_PARITY);
+	}
+}
+
+void test_uncorrectable_codeword_is_unchanged(void)
+{
+	uint8_t message[SNAP_SIZE_FEC_MESSAGE + SNAP_SIZE_FEC_PARITY];
+	uint8_t codeword[sizeof(message)];
+	uint16_t detected = 0;
+
+	for(uint16_t n = 0; n < 2000; n++)
+	{
+		const uint16_t size = (uint16_t)(MAX_ERRORS + 1U + nextRandom() % (SNAP_SIZE_FEC_MESSAGE - MAX_ERRORS));
+
+		fillRandom(message, size);
+
+		snap_calculateFecParity(message, size, &message[size]);
+		memcpy(codeword, message, size + SNAP_SIZE_FEC_PARITY);
+		addErrors(codeword, size, (uint16_t)(MAX_ERRORS + 1U));
+
+		uint8_t received[sizeof(message)];
+		memcpy(received, codeword, size + SNAP_SIZE_FEC_PARITY);
+
+		if(snap_correctFecErrors(codeword, size, &codeword[size]) == SNAP_ERROR_UNCORRECTABLE)
+		{
+			TEST_ASSERT_EQUAL_MEMORY(received, codeword, size + SNAP_SIZE_FEC_PARITY);
+			detected++;
+		}
+	}
+
+#if SNAP_SIZE_FEC_PARITY >= 8
+	TEST_ASSERT_GREATER_THAN(1900, detected);	// Others are miscorrected into another codeword (often with few parity bytes)
+#else
+	TEST_ASSERT_GREATER_THAN(0, detected);
+#endif
+}
+
+void test_frame_errors_are_corrected_in_every_codeword(void)
+{
+	snap_frame_t tx, rx;
+
+	for(uint16_t n = 0; n < 500; n++)
+	{
+		encapsulateFecFrame(&tx, (uint16_t)(nextRandom() % (SNAP_MAX_SIZE_DATA + 1U)));
+
+		const uint16_t count = (uint16_t)((tx.layout.hashSize - SNAP_SIZE_FEC_CHECK) / SNAP_SIZE_FEC_PARITY);
+		const uint16_t splitSize = (uint16_t)(tx.layout.hashIndex + SNAP_SIZE_FEC_CHECK - SNAP_INDEX_HDB2);
+		uint16_t index = SNAP_INDEX_HDB2;
+
+		TEST_ASSERT_EQUAL_UINT16((splitSize + SNAP_SIZE_FEC_MESSAGE - 1U) / SNAP_SIZE_FEC_MESSAGE, count);
+
+		for(uint16_t i = 0; i < count; i++)	// Errors in the data, CRC and parity of each codeword (the header gives the length)
+		{
+			const uint16_t messageSize = (uint16_t)(splitSize / count + ((i < splitSize % count) ? 1U : 0U));
+			const uint16_t start = (index < tx.layout.dataIndex) ? tx.layout.dataIndex : index;
+
+			const uint16_t spanSize = (uint16_t)(index + messageSize - start);
+			const uint16_t errors = (uint16_t)(nextRandom() % (MAX_ERRORS / 2U + 1U));
+
+			addErrors(&txBuffer[start], spanSize, (errors < spanSize) ? errors : spanSize);
+			index = (uint16_t)(index + messageSize);
+			addErrors(&txBuffer[tx.layout.hashIndex + SNAP_SIZE_FEC_CHECK + i * SNAP_SIZE_FEC_PARITY], SNAP_SIZE_FEC_PARITY, (uint16_t)(nextRandom() % (MAX_ERRORS / 2U + 1U)));
+		}
+
+		TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, decodeFrame(&rx, tx.size));
+		TEST_ASSERT_EQUAL_MEMORY(sent, rxBuffer, tx.layout.hashIndex);
+	}
+}
+
+void test_frame_with_too_many_errors_is_rejected(void)
+{
+	snap_frame_t tx, rx;
+
+	for(uint16_t n = 0; n < 3000; n++)
+	{
+		encapsulateFecFrame(&tx, (uint16_t)(MAX_ERRORS + 1U + nextRandom() % 200U));
+
+		const uint16_t bodySize = (uint16_t)(tx.size - tx.layout.dataIndex);
+		addErrors(&txBuffer[tx.layout.dataIndex], bodySize, (uint16_t)(MAX_ERRORS + 1U + nextRandom() % 4U));
+
+		if(decodeFrame(&rx, tx.size) == SNAP_STATUS_VALID)
+		{
+			TEST_ASSERT_EQUAL_MEMORY(sent, rxBuffer, tx.layout.hashIndex);	// Miscorrections are caught by the CRC-16
+		}
+	}
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_codewords_have_every_generator_root);
+	RUN_TEST(test_codeword_errors_are_corrected);
+	RUN_TEST(test_uncorrectable_codeword_is_unchanged);
+	RUN_TEST(test_frame_errors_are_corrected_in_every_codeword);
+	RUN_TEST(test_frame_with_too_many_errors_is_rejected);
+	return UNITY_END();
+}
@@ -0,0 +1,177 @@
+/**
+ * @file   test_main.c
+ * @brief  Host tests of the zero-copy field access: snap_getFieldPtr() and snap_decapsulate() must point into the
+ *         frame buffer and give the same values as the copies made by snap_getField().
+ */
+
+#include <unity.h>
+#include "snap.h"
+#include "snap_test.h"
+
+static uint8_t data[SNAP_MAX_SIZE_DATA];
+static uint8_t txBuffer[SNAP_MAX_SIZE_BUFFER];
+static uint8_t rxBuffer[SNAP_MAX_SIZE_BUFFER];
+static uint8_t copy[SNAP_MAX_SIZE_DATA];
+
+/**
+ * @brief Encapsulate a frame with random fields (any EDM but FEC) and decode it into rxBuffer.
+ */
+static void decodeRandomFrame(snap_frame_t *rx, snap_fields_t *fields)
+{
+	snap_frame_t tx;
+
+	setRandomFields(fields, (uint8_t)(nextRandom() % 6), SNAP_MAX_SIZE_DATA);
+	fields->header.ndb = SNAP_HDB1_NDB_USER_SPECIFIED;
+	fields->destAddress &= 0xFFFFFFU >> (8U * (3U - fields->header.dab));
+	fields->sourceAddress &= 0xFFFFFFU >> (8U * (3U - fields->header.sab));
+	fields->protocolFlags &= 0xFFFFFFU >> (8U * (3U - fields->header.pfb));
+	fields->data = data;
+
+	fillRandom(data, fields->dataSize);
+
+	snap_init(&tx, txBuffer, sizeof(txBuffer));
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(&tx, fields));
+
+	snap_init(rx, rxBuffer, sizeof(rxBuffer));
+
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, decodeBytes(rx, txBuffer, tx.size));
+}
+
+/**
+ * @brief Compare every bit field of 2 headers.
+ */
+static void assertHeader(const snap_header_t *expected, const snap_header_t *actual)
+{
+	TEST_ASSERT_EQUAL_UINT8(expected->dab, actual->dab);
+	TEST_ASSERT_EQUAL_UINT8(expected->sab, actual->sab);
+	TEST_ASSERT_EQUAL_UINT8(expected->pfb, actual->pfb);
+	TEST_ASSERT_EQUAL_UINT8(expected->ack, actual->ack);
+	TEST_ASSERT_EQUAL_UINT8(expected->cmd, actual->cmd);
+	TEST_ASSERT_EQUAL_UINT8(expected->edm, actual->edm);
+	TEST_ASSERT_EQUAL_UINT8(expected->ndb, actual->ndb);
+}
+
+void setUp(void)
+{
+	seed = 4;
+}
+
+void tearDown(void)
+{
+}
+
+void test_decapsulate_points_into_the_buffer(void)
+{
+	snap_frame_t rx;
+	snap_fields_t sent, decoded;
+
+	for(uint16_t n = 0; n < 3000; n++)
+	{
+		decodeRandomFrame(&rx, &sent);
+
+		TEST_ASSERT_EQUAL_INT16(sent.dataSize, snap_decapsulate(&rx, &decoded));
+		TEST_ASSERT_EQUAL_UINT32(sent.destAddress, decoded.destAddress);
+		TEST_ASSERT_EQUAL_UINT32(sent.sourceAddress, decoded.sourceAddress);
+		TEST_ASSERT_EQUAL_UINT32(sent.protocolFlags, decoded.protocolFlags);
+		assertHeader(&sent.header, &decoded.header);
+		TEST_ASSERT_EQUAL_UINT16(sent.dataSize, decoded.dataSize);
+
+		if(sent.dataSize)
+		{
+			TEST_ASSERT_TRUE(decoded.data == &rxBuffer[rx.layout.dataIndex]);
+			TEST_ASSERT_EQUAL_MEMORY(data, decoded.data, sent.dataSize);
+		}
+		else
+		{
+			TEST_ASSERT_NULL(decoded.data);
+		}
+	}
+}
+
+void test_field_pointers_match_the_copies(void)
+{
+	snap_frame_t rx;
+	snap_fields_t sent;
+
+	for(uint16_t n = 0; n < 3000; n++)
+	{
+		decodeRandomFrame(&rx, &sent);
+
+		for(uint8_t type = SNAP_FIELD_HEADER; type <= SNAP_FIELD_HASH; type++)
+		{
+			const uint8_t *field = NULL;
+			const int16_t size = snap_getFieldPtr(&rx, &field, type);
+
+			if(size > 0)
+			{
+				TEST_ASSERT_TRUE((field >= rxBuffer) && (field + size <= rxBuffer + rx.size));
+
+				if(type == SNAP_FIELD_HEADER)
+				{
+					snap_header_t header;
+
+					TEST_ASSERT_EQUAL_INT16(size, snap_getField(&rx, &header, type));
+					assertHeader(&sent.header, &header);
+					TEST_ASSERT_TRUE(field == &rxBuffer[SNAP_INDEX_HDB2]);
+				}
+				else if(type == SNAP_FIELD_DATA)
+				{
+					TEST_ASSERT_EQUAL_INT16(size, snap_getField(&rx, copy, type));
+					TEST_ASSERT_EQUAL_MEMORY(copy, field, size);
+				}
+				else
+				{
+					uint32_t value;
+					uint32_t expected = 0;
+
+					for(int16_t i = 0; i < size; i++)	// MSB first
+					{
+						expected = (expected << 8) | field[i];
+					}
+
+					TEST_ASSERT_EQUAL_INT16(size, snap_getField(&rx, &value, type));
+					TEST_ASSERT_EQUAL_UINT32(expected, value);
+				}
+			}
+			else
+			{
+				TEST_ASSERT_NULL(field);
+				TEST_ASSERT_EQUAL_INT16(snap_getField(&rx, copy, type), size);
+			}
+		}
+	}
+}
+
+void test_missing_and_incomplete_fields(void)
+{
+	static const uint8_t header[] = {SNAP_SYNC, 0x00, 0x4F, 0x05};	// No addresses, CRC-16, 5 data bytes
+	snap_frame_t frame;
+	snap_fields_t fields;
+	const uint8_t *field = NULL;
+
+	snap_init(&frame, rxBuffer, sizeof(rxBuffer));
+	TEST_ASSERT_EQUAL_INT16(SNAP_ERROR_UNKNOWN_FORMAT, snap_getFieldPtr(&frame, &field, SNAP_FIELD_DATA));
+	TEST_ASSERT_EQUAL_INT16(SNAP_ERROR_UNKNOWN_FORMAT, snap_decapsulate(&frame, &fields));
+
+	for(uint8_t i = 0; i < sizeof(header); i++)
+	{
+		snap_decode(&frame, header[i]);
+	}
+
+	snap_decode(&frame, 0xAA);	// 1 of 5 data bytes
+
+	TEST_ASSERT_EQUAL_INT16(SNAP_ERROR_FRAME_FORMAT, snap_getFieldPtr(&frame, &field, SNAP_FIELD_DEST_ADDRESS));
+	TEST_ASSERT_EQUAL_INT16(SNAP_ERROR_SHORT_FRAME, snap_getFieldPtr(&frame, &field, SNAP_FIELD_DATA));
+	TEST_ASSERT_EQUAL_INT16(SNAP_ERROR_SHORT_FRAME, snap_decapsulate(&frame, &fields));
+	TEST_ASSERT_EQUAL_INT16(SNAP_ERROR_FIELD_TYPE, snap_getFieldPtr(&frame, &field, SNAP_FIELD_HASH + 1));
+	TEST_ASSERT_NULL(field);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_decapsulate_points_into_the_buffer);
+	RUN_TEST(test_field_pointers_match_the_copies);
+	RUN_TEST(test_missing_and_incomplete_fields);
+	return UNITY_END();
+}
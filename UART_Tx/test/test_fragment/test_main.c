@@ -0,0 +1,303 @@
+/**
+ * @file   test_main.c
+ * @brief  Host tests of the fragmentation layer: messages must be reassembled from fragments received in any order,
+ *         with losses and duplicates, by requesting only the missing fragments again.
+ */
+
+#include <string.h>
+#include <unity.h>
+#include "snap.h"
+#include "snap_fragment.h"
+#include "snap_test.h"
+
+#define MAX_SIZE_MESSAGE	(20000U)
+
+static uint8_t message[MAX_SIZE_MESSAGE];
+static uint8_t reassembled[MAX_SIZE_MESSAGE + SNAP_SIZE_FRAG_CHECK];
+static uint8_t txBuffer[SNAP_MAX_SIZE_BUFFER];
+static uint8_t rxBuffer[SNAP_MAX_SIZE_BUFFER];
+
+/**
+ * @brief Encapsulate a fragment of the message, decode it and add it to the reassembly.
+ * @return Value returned by snap_addFragment().
+ */
+static int16_t sendFragment(snap_frame_t *tx, snap_frame_t *rx, snap_fields_t *fields, snap_reassembly_t *reassembly,
+                            const uint16_t messageSize, const uint16_t fragmentSize, const uint8_t index)
+{
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulateFragment(tx, fields, message, messageSize, fragmentSize, index));
+	deliverFrame(tx, rx);
+
+	return snap_addFragment(reassembly, rx);
+}
+
+void setUp(void)
+{
+	seed = 18;
+}
+
+void tearDown(void)
+{
+}
+
+void test_fragment_count(void)
+{
+	TEST_ASSERT_EQUAL_UINT8(0, snap_getFragmentCount(0, 10));
+	TEST_ASSERT_EQUAL_UINT8(0, snap_getFragmentCount(10, 0));
+	TEST_ASSERT_EQUAL_UINT8(0, snap_getFragmentCount(10, SNAP_MAX_SIZE_DATA + 1U));
+	TEST_ASSERT_EQUAL_UINT8(1, snap_getFragmentCount(1, SNAP_MAX_SIZE_DATA));
+	TEST_ASSERT_EQUAL_UINT8(2, snap_getFragmentCount(9, 10));	// The CRC does not fit in the first fragment
+	TEST_ASSERT_EQUAL_UINT8(SNAP_MAX_FRAGMENTS, snap_getFragmentCount(SNAP_MAX_FRAGMENTS * 10U - SNAP_SIZE_FRAG_CHECK, 10));
+	TEST_ASSERT_EQUAL_UINT8(0, snap_getFragmentCount(SNAP_MAX_FRAGMENTS * 10U - SNAP_SIZE_FRAG_CHECK + 1U, 10));	// Too many fragments
+	TEST_ASSERT_EQUAL_UINT8(SNAP_MAX_FRAGMENTS, snap_getFragmentCount(SNAP_MAX_SIZE_MESSAGE, SNAP_MAX_SIZE_DATA));
+}
+
+void test_message_is_reassembled_with_losses(void)
+{
+	snap_frame_t tx, rx;
+	snap_reassembly_t reassembly;
+
+	snap_init(&tx, txBuffer, sizeof(txBuffer));
+	snap_init(&rx, rxBuffer, sizeof(rxBuffer));
+	TEST_ASSERT_EQUAL_INT16(sizeof(reassembled), snap_initReassembly(&reassembly, reassembled, sizeof(reassembled)));
+
+	for(uint16_t n = 0; n < 500; n++)
+	{
+		const uint16_t fragmentSize = (uint16_t)(1U + nextRandom() % SNAP_MAX_SIZE_DATA);
+		const uint32_t maxSize = (fragmentSize * SNAP_MAX_FRAGMENTS - SNAP_SIZE_FRAG_CHECK < MAX_SIZE_MESSAGE) ? fragmentSize * SNAP_MAX_FRAGMENTS - SNAP_SIZE_FRAG_CHECK : MAX_SIZE_MESSAGE;
+		const uint16_t messageSize = (uint16_t)(1U + nextRandom() % maxSize);
+		const uint8_t count = snap_getFragmentCount(messageSize, fragmentSize);
+		uint8_t order[SNAP_MAX_FRAGMENTS];
+		snap_fields_t fields;
+		int16_t missing = -1;
+
+		TEST_ASSERT_EQUAL_UINT8((messageSize + SNAP_SIZE_FRAG_CHECK + fragmentSize - 1U) / fragmentSize, count);
+
+		fillRandom(message, messageSize);
+
+		for(uint8_t i = 0; i < count; i++)
+		{
+			order[i] = i;
+		}
+
+		for(uint8_t i = (uint8_t)(count - 1U); i > 0; i--)
+		{
+			const uint8_t j = (uint8_t)(nextRandom() % (i + 1U));
+			const uint8_t swap = order[i];
+			order[i] = order[j];
+			order[j] = swap;
+		}
+
+		memset(&fields, 0, sizeof(fields));
+		fields.header.dab = SNAP_HDB2_DAB_1BYTE_DEST_ADDRESS;
+		fields.header.sab = SNAP_HDB2_SAB_1BYTE_SOURCE_ADDRESS;
+		fields.header.edm = SNAP_HDB1_EDM_16BIT_CRC;
+		fields.destAddress = 0x02;
+		fields.sourceAddress = 1U + n % 5U;
+		fields.protocolFlags = 0x300;	// Other users of the flags keep their bits
+
+		for(uint8_t k = 0; k < count; k++)	// 30 % of the fragments are lost, some are duplicated
+		{
+			if(nextRandom() % 10 < 3)
+			{
+				continue;
+			}
+
+			missing = sendFragment(&tx, &rx, &fields, &reassembly, messageSize, fragmentSize, order[k]);
+			TEST_ASSERT_TRUE(missing >= 0);
+
+			uint32_t flags;
+			snap_getProtocolFlags(&rx, &flags);
+			TEST_ASSERT_EQUAL_HEX32(0x300, flags & 0xFFF);
+
+			if((missing > 0) && (nextRandom() % 5 == 0))
+			{
+				TEST_ASSERT_EQUAL_INT16(missing, snap_addFragment(&reassembly, &rx));
+			}
+		}
+
+		for(uint8_t round = 0; (missing != 0) && (round < 50); round++)
+		{
+			snap_fields_t request, received;
+			uint8_t bitmap[SNAP_SIZE_FRAG_BITMAP];
+
+			memset(&request, 0, sizeof(request));
+			request.header.dab = SNAP_HDB2_DAB_1BYTE_DEST_ADDRESS;
+			request.header.sab = SNAP_HDB2_SAB_1BYTE_SOURCE_ADDRESS;
+			request.header.edm = SNAP_HDB1_EDM_16BIT_CRC;
+			request.sourceAddress = 0x02;
+
+			TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulateResendRequest(&tx, &request, &reassembly));
+			deliverFrame(&tx, &rx);
+			TEST_ASSERT_EQUAL_INT16(SNAP_ERROR_FRAME_FORMAT, snap_addFragment(&reassembly, &rx));	// Not a fragment
+
+			memset(&received, 0, sizeof(received));
+			snap_decapsulate(&rx, &received);
+			TEST_ASSERT_EQUAL_UINT8(SNAP_HDB2_ACK_RESPONSE_NACK, received.header.ack);
+			TEST_ASSERT_TRUE(received.dataSize <= sizeof(bitmap));
+
+			if(reassembly.started)
+			{
+				TEST_ASSERT_EQUAL_UINT32(fields.sourceAddress, received.destAddress);
+			}
+
+			if(received.dataSize != 0)
+			{
+				memcpy(bitmap, received.data, received.dataSize);
+			}
+
+			for(uint8_t i = 0; i < count; i++)
+			{
+				if(!snap_isFragmentRequested(bitmap, received.dataSize, i))
+				{
+					continue;
+				}
+
+				if(reassembly.started)
+				{
+					TEST_ASSERT_BITS_LOW(1U << (i % 8U), reassembly.received[i / 8U]);	// Only the missing fragments are requested
+				}
+
+				if(nextRandom() % 10 >= 2)	// 20 % of the resent fragments are lost again
+				{
+					missing = sendFragment(&tx, &rx, &fields, &reassembly, messageSize, fragmentSize, i);
+					TEST_ASSERT_TRUE(missing >= 0);
+				}
+			}
+		}
+
+		TEST_ASSERT_EQUAL_INT16(0, missing);
+		TEST_ASSERT_EQUAL_UINT16(messageSize, reassembly.size);
+		TEST_ASSERT_EQUAL_MEMORY(message, reassembled, messageSize);
+
+		snap_resetReassembly(&reassembly);
+	}
+}
+
+void test_short_buffer(void)
+{
+	uint8_t buffer[100];
+	snap_frame_t tx, rx;
+	snap_fields_t fields;
+	snap_reassembly_t reassembly;
+
+	fillRandom(message, 200);
+
+	snap_init(&tx, txBuffer, sizeof(txBuffer));
+	snap_init(&rx, rxBuffer, sizeof(rxBuffer));
+	snap_initReassembly(&reassembly, buffer, sizeof(buffer));
+	memset(&fields, 0, sizeof(fields));
+
+	TEST_ASSERT_EQUAL_INT16(3, sendFragment(&tx, &rx, &fields, &reassembly, 200, 60, 3));	// Last fragment (20 bytes and the CRC) is kept until the size is known
+	TEST_ASSERT_EQUAL_INT16(SNAP_ERROR_SHORT_BUFFER, sendFragment(&tx, &rx, &fields, &reassembly, 200, 60, 0));
+
+	TEST_ASSERT_EQUAL_INT16(2, sendFragment(&tx, &rx, &fields, &reassembly, 88, 30, 2));	// Another message (the last index differs)
+	TEST_ASSERT_EQUAL_INT16(1, sendFragment(&tx, &rx, &fields, &reassembly, 88, 30, 1));
+	TEST_ASSERT_EQUAL_INT16(0, sendFragment(&tx, &rx, &fields, &reassembly, 88, 30, 0));
+	TEST_ASSERT_EQUAL_UINT16(88, reassembly.size);
+	TEST_ASSERT_EQUAL_MEMORY(message, buffer, 88);
+}
+
+void test_message_given_up(void)
+{
+	uint8_t first[88];
+	snap_frame_t tx, rx;
+	snap_fields_t fields;
+	snap_reassembly_t reassembly;
+	snap_fields_t request;
+	uint8_t bitmap[SNAP_SIZE_FRAG_BITMAP];
+	uint32_t flags;
+
+	snap_init(&tx, txBuffer, sizeof(txBuffer));
+	snap_init(&rx, rxBuffer, sizeof(rxBuffer));
+	snap_initReassembly(&reassembly, reassembled, sizeof(reassembled));
+	memset(&fields, 0, sizeof(fields));
+	fields.header.sab = SNAP_HDB2_SAB_1BYTE_SOURCE_ADDRESS;
+	fields.sourceAddress = 0x07;
+
+	fillRandom(message, 88);
+	memcpy(first, message, sizeof(first));
+	snap_setFragmentId(&fields, 0);
+	TEST_ASSERT_EQUAL_INT16(2, sendFragment(&tx, &rx, &fields, &reassembly, 88, 30, 0));	// Fragments 1 and 2 are lost, the sender gives up
+
+	fillRandom(message, 88);	// Next message, with the same number of fragments
+	snap_setFragmentId(&fields, 1);
+	TEST_ASSERT_EQUAL_INT16(2, sendFragment(&tx, &rx, &fields, &reassembly, 88, 30, 1));	// Starts a new message
+	TEST_ASSERT_EQUAL_INT16(1, sendFragment(&tx, &rx, &fields, &reassembly, 88, 30, 2));
+
+	snap_getMissingFragments(&reassembly, bitmap);
+	TEST_ASSERT_EQUAL_HEX8(0x01, bitmap[0]);
+	memset(&request, 0, sizeof(request));
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulateResendRequest(&tx, &request, &reassembly));
+	snap_getProtocolFlags(&tx, &flags);
+	TEST_ASSERT_EQUAL_UINT8(1, SNAP_FLAGS_FRAG_ID(flags));	// The request names the message
+
+	TEST_ASSERT_EQUAL_INT16(0, sendFragment(&tx, &rx, &fields, &reassembly, 88, 30, 0));
+	TEST_ASSERT_EQUAL_UINT16(88, reassembly.size);
+	TEST_ASSERT_EQUAL_MEMORY(message, reassembled, 88);
+	TEST_ASSERT_FALSE(memcmp(first, reassembled, 30) == 0);
+}
+
+void test_spliced_message_is_rejected(void)
+{
+	snap_frame_t tx, rx;
+	snap_fields_t fields;
+	snap_reassembly_t reassembly;
+
+	snap_init(&tx, txBuffer, sizeof(txBuffer));
+	snap_init(&rx, rxBuffer, sizeof(rxBuffer));
+	snap_initReassembly(&reassembly, reassembled, sizeof(reassembled));
+	memset(&fields, 0, sizeof(fields));
+	fields.header.sab = SNAP_HDB2_SAB_1BYTE_SOURCE_ADDRESS;
+	fields.sourceAddress = 0x07;
+
+	fillRandom(message, 88);
+	snap_setFragmentId(&fields, 0);
+	TEST_ASSERT_EQUAL_INT16(2, sendFragment(&tx, &rx, &fields, &reassembly, 88, 30, 0));	// Message N is given up, message N+1 is lost
+
+	fillRandom(message, 88);	// Message N+2 has the same id, source and number of fragments
+	snap_setFragmentId(&fields, 2);
+	TEST_ASSERT_EQUAL_INT16(1, sendFragment(&tx, &rx, &fields, &reassembly, 88, 30, 1));
+	TEST_ASSERT_EQUAL_INT16(SNAP_ERROR_MESSAGE_CHECK, sendFragment(&tx, &rx, &fields, &reassembly, 88, 30, 2));
+	TEST_ASSERT_EQUAL_UINT16(0, reassembly.size);
+	TEST_ASSERT_FALSE(reassembly.started);
+
+	TEST_ASSERT_EQUAL_INT16(2, sendFragment(&tx, &rx, &fields, &reassembly, 88, 30, 0));	// Resent fragments complete it
+	TEST_ASSERT_EQUAL_INT16(1, sendFragment(&tx, &rx, &fields, &reassembly, 88, 30, 1));
+	TEST_ASSERT_EQUAL_INT16(0, sendFragment(&tx, &rx, &fields, &reassembly, 88, 30, 2));
+	TEST_ASSERT_EQUAL_UINT16(88, reassembly.size);
+	TEST_ASSERT_EQUAL_MEMORY(message, reassembled, 88);
+}
+
+void test_invalid_fragments(void)
+{
+	snap_frame_t tx, rx;
+	snap_fields_t fields;
+	snap_reassembly_t reassembly;
+
+	snap_init(&tx, txBuffer, sizeof(txBuffer));
+	snap_init(&rx, rxBuffer, sizeof(rxBuffer));
+	snap_initReassembly(&reassembly, reassembled, sizeof(reassembled));
+
+	memset(&fields, 0, sizeof(fields));
+	fields.header.pfb = SNAP_HDB2_PFB_1BYTE_PROTOCOL_FLAGS;
+	fields.data = message;
+	fields.dataSize = 2;
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(&tx, &fields));
+	deliverFrame(&tx, &rx);
+	TEST_ASSERT_EQUAL_INT16(SNAP_ERROR_FRAME_FORMAT, snap_addFragment(&reassembly, &rx));	// Plain frame
+
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_ERROR_OVERFLOW, snap_encapsulateFragment(&tx, &fields, message, 90, 30, 4));	// Index out of range (4 fragments with the CRC)
+	TEST_ASSERT_EQUAL_UINT16(0, tx.size);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_fragment_count);
+	RUN_TEST(test_message_is_reassembled_with_losses);
+	RUN_TEST(test_short_buffer);
+	RUN_TEST(test_message_given_up);
+	RUN_TEST(test_spliced_message_is_rejected);
+	RUN_TEST(test_invalid_fragments);
+	return UNITY_END();
+}
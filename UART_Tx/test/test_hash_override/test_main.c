@@ -0,0 +1,86 @@
+/**
+ * @file   test_main.c
+ * @brief  Host tests of a hash function overridden at link time: the decoder must validate the frames
+ *         with the same function as snap_encapsulate(), not with the running hash of the library.
+ */
+
+#include <string.h>
+#include <unity.h>
+#include "snap.h"
+#include "snap_test.h"
+
+static uint8_t txBuffer[64];
+static uint8_t rxBuffer[64];
+
+/**
+ * @brief Strong definition of the weak CRC-16 of the library (it is not a real CRC, just a different function).
+ */
+uint16_t snap_calculateCrc16(const uint8_t *data, const uint16_t size)
+{
+	uint16_t hash = 0x1234;
+
+	for(uint16_t i = 0; i < size; i++)
+	{
+		hash = (uint16_t)(((hash << 3) | (hash >> 13)) ^ data[i]);
+	}
+
+	return hash;
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_overridden_crc16_is_used_by_the_encoder(void)
+{
+	static uint8_t data[] = {1, 2, 3, 4, 5};
+	snap_frame_t tx;
+	snap_fields_t fields;
+	uint32_t hash;
+
+	memset(&fields, 0, sizeof(fields));
+	fields.header.edm = SNAP_HDB1_EDM_16BIT_CRC;
+	fields.data = data;
+	fields.dataSize = sizeof(data);
+
+	snap_init(&tx, txBuffer, sizeof(txBuffer));
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(&tx, &fields));
+	TEST_ASSERT_EQUAL_INT16(2, snap_getHash(&tx, &hash));
+	TEST_ASSERT_EQUAL_HEX16(snap_calculateCrc16(&txBuffer[SNAP_INDEX_HDB2], (uint16_t)(snap_getHashIndex(&tx) - SNAP_INDEX_HDB2)), hash);
+}
+
+void test_overridden_crc16_is_used_by_the_decoder(void)
+{
+	static uint8_t data[] = {1, 2, 3, 4, 5};
+	snap_frame_t tx, rx;
+	snap_fields_t fields;
+
+	memset(&fields, 0, sizeof(fields));
+	fields.header.edm = SNAP_HDB1_EDM_16BIT_CRC;
+	fields.data = data;
+	fields.dataSize = sizeof(data);
+
+	snap_init(&tx, txBuffer, sizeof(txBuffer));
+	snap_encapsulate(&tx, &fields);
+	snap_init(&rx, rxBuffer, sizeof(rxBuffer));
+
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, decodeBytes(&rx, txBuffer, tx.size));
+	TEST_ASSERT_FALSE(rx.incrementalHash);	// The override does not give the check value of CRC-16/XMODEM
+
+	txBuffer[snap_getDataIndex(&tx)] ^= 0x01;
+	snap_reset(&rx);
+
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_ERROR_HASH, decodeBytes(&rx, txBuffer, tx.size));
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_overridden_crc16_is_used_by_the_encoder);
+	RUN_TEST(test_overridden_crc16_is_used_by_the_decoder);
+	return UNITY_END();
+}
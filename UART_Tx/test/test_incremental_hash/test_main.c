@@ -0,0 +1,152 @@
+/**
+ * @file   test_main.c
+ * @brief  Host tests of the running hash of snap_decode(): every frame with a hash value must be validated
+ *         exactly like snap_calculateHash() would, for every error detection method and frame format.
+ */
+
+#include <unity.h>
+#include "snap.h"
+#include "snap_test.h"
+
+static uint8_t txBuffer[SNAP_MAX_SIZE_BUFFER];
+static uint8_t rxBuffer[SNAP_MAX_SIZE_BUFFER];
+static uint8_t data[SNAP_MAX_SIZE_DATA];
+
+/**
+ * @brief Encapsulate a frame with random fields and the given error detection method.
+ */
+static void encapsulateRandomFrame(snap_frame_t *frame, const uint8_t edm)
+{
+	snap_fields_t fields;
+
+	setRandomFields(&fields, edm, SNAP_MAX_SIZE_DATA);
+	fillRandom(data, fields.dataSize);
+	fields.data = data;
+
+	snap_init(frame, txBuffer, sizeof(txBuffer));
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(frame, &fields));
+}
+
+void setUp(void)
+{
+	seed = 0x12345678;
+}
+
+void tearDown(void)
+{
+}
+
+void test_valid_frames_are_accepted_with_every_hash(void)
+{
+	static const uint8_t edm[] = {SNAP_HDB1_EDM_8BIT_CHECKSUM, SNAP_HDB1_EDM_8BIT_CRC, SNAP_HDB1_EDM_16BIT_CRC, SNAP_HDB1_EDM_32BIT_CRC};
+
+	for(uint8_t e = 0; e < sizeof(edm); e++)
+	{
+		for(uint16_t n = 0; n < 200; n++)
+		{
+			snap_frame_t tx, rx;
+			uint32_t expected, actual;
+
+			encapsulateRandomFrame(&tx, edm[e]);
+			snap_init(&rx, rxBuffer, sizeof(rxBuffer));
+
+			TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, decodeBytes(&rx, txBuffer, tx.size));
+			TEST_ASSERT_EQUAL_UINT16(tx.size, rx.size);
+			TEST_ASSERT_EQUAL_MEMORY(txBuffer, rxBuffer, tx.size);
+
+			TEST_ASSERT_GREATER_THAN(0, snap_calculateHash(&rx, &expected));
+			TEST_ASSERT_GREATER_THAN(0, snap_getHash(&rx, &actual));
+			TEST_ASSERT_EQUAL_HEX32(expected, actual);
+		}
+	}
+}
+
+void test_single_bit_errors_are_rejected(void)
+{
+	static const uint8_t edm[] = {SNAP_HDB1_EDM_8BIT_CHECKSUM, SNAP_HDB1_EDM_8BIT_CRC, SNAP_HDB1_EDM_16BIT_CRC, SNAP_HDB1_EDM_32BIT_CRC};
+
+	for(uint8_t e = 0; e < sizeof(edm); e++)
+	{
+		for(uint16_t n = 0; n < 200; n++)
+		{
+			snap_frame_t tx, rx;
+
+			encapsulateRandomFrame(&tx, edm[e]);
+
+			const uint16_t dataEnd = (uint16_t)(snap_getHashIndex(&tx) + snap_getHashSize(&tx));
+			const uint16_t index = (uint16_t)(snap_getDataIndex(&tx) + nextRandom() % (dataEnd - snap_getDataIndex(&tx)));
+
+			txBuffer[index] ^= (uint8_t)(1U << (nextRandom() % 8));
+
+			snap_init(&rx, rxBuffer, sizeof(rxBuffer));
+			TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_ERROR_HASH, decodeBytes(&rx, txBuffer, tx.size));
+		}
+	}
+}
+
+void test_hash_restarts_after_reset(void)
+{
+	for(uint16_t n = 0; n < 100; n++)
+	{
+		snap_frame_t tx, rx;
+
+		encapsulateRandomFrame(&tx, (uint8_t)(SNAP_HDB1_EDM_8BIT_CHECKSUM + n % 4));
+		snap_init(&rx, rxBuffer, sizeof(rxBuffer));
+
+		decodeBytes(&rx, txBuffer, (uint16_t)(tx.size - 1));	// Incomplete frame
+		snap_reset(&rx);
+
+		TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, decodeBytes(&rx, txBuffer, tx.size));
+	}
+}
+
+void test_buffer_decoder_matches_byte_decoder(void)
+{
+	for(uint16_t n = 0; n < 200; n++)
+	{
+		snap_frame_t tx, rx;
+		uint16_t consumed;
+
+		encapsulateRandomFrame(&tx, (uint8_t)(SNAP_HDB1_EDM_8BIT_CHECKSUM + n % 4));
+
+		if(n % 2)
+		{
+			txBuffer[tx.size - 1] ^= 0x01;
+		}
+
+		snap_init(&rx, rxBuffer, sizeof(rxBuffer));
+		const int8_t status = snap_decodeBuffer(&rx, txBuffer, tx.size, &consumed);
+
+		TEST_ASSERT_EQUAL_UINT16(tx.size, consumed);
+		TEST_ASSERT_EQUAL_INT8((n % 2) ? SNAP_STATUS_ERROR_HASH : SNAP_STATUS_VALID, status);
+	}
+}
+
+void test_running_crc_is_kept_without_override(void)
+{
+	for(uint16_t n = 0; n < 300; n++)
+	{
+		const uint8_t edm = (uint8_t)(SNAP_HDB1_EDM_8BIT_CRC + n % 3);
+		snap_frame_t tx, rx;
+		uint32_t expected;
+
+		encapsulateRandomFrame(&tx, edm);
+		snap_init(&rx, rxBuffer, sizeof(rxBuffer));
+
+		TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, decodeBytes(&rx, txBuffer, tx.size));
+		TEST_ASSERT_TRUE(rx.incrementalHash);
+		TEST_ASSERT_GREATER_THAN(0, snap_calculateHash(&rx, &expected));
+		TEST_ASSERT_EQUAL_HEX32(expected, (edm == SNAP_HDB1_EDM_32BIT_CRC) ? ~rx.hash : rx.hash);	// The built-in CRCs are accumulated byte by byte
+	}
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_valid_frames_are_accepted_with_every_hash);
+	RUN_TEST(test_single_bit_errors_are_rejected);
+	RUN_TEST(test_hash_restarts_after_reset);
+	RUN_TEST(test_running_crc_is_kept_without_override);
+	RUN_TEST(test_buffer_decoder_matches_byte_decoder);
+	return UNITY_END();
+}
@@ -0,0 +1,235 @@
+/**
+ * @file   test_main.c
+ * @brief  Host tests of the byte interleaver: interleaved frames must decode to the same bytes as plain frames,
+ *         and a burst spread over the FEC codewords must be corrected.
+ */
+
+#include <string.h>
+#include <unity.h>
+#include "snap.h"
+#include "snap_test.h"
+
+static uint8_t data[SNAP_MAX_SIZE_DATA];
+static uint8_t txBuffer[SNAP_MAX_SIZE_BUFFER];
+static uint8_t rxBuffer[SNAP_MAX_SIZE_BUFFER];
+static uint8_t plainBuffer[SNAP_MAX_SIZE_BUFFER];
+static uint8_t streamBuffer[2 * SNAP_MAX_SIZE_BUFFER];
+
+/**
+ * @brief Set random fields (any EDM) and random data, mostly short but up to the maximum size.
+ */
+static void setRandomFrame(snap_fields_t *fields)
+{
+	const uint8_t edm = (uint8_t)(nextRandom() % 7);
+	const uint16_t maxDataSize = (nextRandom() % 4) ? 119U : SNAP_MAX_SIZE_DATA;
+
+	setRandomFields(fields, edm, maxDataSize);
+	fillRandom(data, fields->dataSize);
+	fields->data = data;
+}
+
+/**
+ * @brief Decode a frame with interleaving enabled, using one of the decoding functions.
+ * @return Frame status.
+ */
+static int8_t decodeInterleaved(snap_frame_t *frame, const uint8_t *bytes, const uint16_t size, const uint8_t mode)
+{
+	int8_t status = SNAP_STATUS_IDLE;
+	uint16_t consumed;
+
+	snap_init(frame, rxBuffer, sizeof(rxBuffer));
+	snap_setInterleaving(frame, true);
+
+	if(mode == 1)
+	{
+		return snap_decodeBuffer(frame, bytes, size, &consumed);
+	}
+
+	for(uint16_t i = 0; i < size; i++)
+	{
+		status = (mode == 0) ? snap_decode(frame, bytes[i]) : snap_decodeStream(frame, bytes[i]);
+	}
+
+	return status;
+}
+
+void setUp(void)
+{
+	seed = 16;
+}
+
+void tearDown(void)
+{
+}
+
+void test_depth_one_frame_is_not_changed(void)
+{
+	snap_frame_t interleaved, plain;
+	snap_fields_t fields;
+
+	for(uint16_t n = 0; n < 1000; n++)
+	{
+		setRandomFrame(&fields);
+		fields.protocolFlags &= ~((uint32_t)SNAP_FLAGS_DEPTH_MASK << SNAP_FLAGS_DEPTH_POS);
+
+		snap_init(&interleaved, txBuffer, sizeof(txBuffer));
+		snap_setInterleaving(&interleaved, true);
+		snap_init(&plain, plainBuffer, sizeof(plainBuffer));
+
+		TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(&interleaved, &fields));
+		TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(&plain, &fields));
+		TEST_ASSERT_EQUAL_UINT16(plain.size, interleaved.size);
+		TEST_ASSERT_EQUAL_MEMORY(plainBuffer, txBuffer, plain.size);
+	}
+}
+
+void test_interleaved_frame_round_trip(void)
+{
+	snap_frame_t tx, rx, plain;
+	snap_fields_t fields;
+
+	for(uint16_t n = 0; n < 3000; n++)
+	{
+		setRandomFrame(&fields);
+
+		snap_init(&tx, txBuffer, sizeof(txBuffer));
+		snap_setInterleaving(&tx, true);
+		snap_init(&plain, plainBuffer, sizeof(plainBuffer));
+
+		TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(&tx, &fields));
+		TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(&plain, &fields));
+		TEST_ASSERT_EQUAL_MEMORY(plainBuffer, txBuffer, plain.layout.dataIndex);	// Only the data and hash are interleaved
+
+		TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, decodeInterleaved(&rx, txBuffer, tx.size, (uint8_t)(n % 3)));
+		TEST_ASSERT_EQUAL_UINT16(tx.size, rx.size);
+		TEST_ASSERT_EQUAL_UINT16(plain.layout.hashIndex, rx.layout.hashIndex);
+		TEST_ASSERT_EQUAL_MEMORY(plainBuffer, rxBuffer, plain.layout.hashIndex);
+	}
+}
+
+void test_burst_is_corrected_by_the_codewords(void)
+{
+	snap_frame_t tx, rx, plain;
+	snap_fields_t fields;
+
+	for(uint16_t n = 0; n < 3000; n++)
+	{
+		setRandomFrame(&fields);
+		fields.header.pfb = SNAP_HDB2_PFB_2BYTE_PROTOCOL_FLAGS;
+		fields.header.edm = SNAP_HDB1_EDM_FEC;
+		fields.protocolFlags = (uint32_t)(1U + nextRandom() % 3U) << SNAP_FLAGS_DEPTH_POS;
+
+		snap_init(&tx, txBuffer, sizeof(txBuffer));
+		snap_setInterleaving(&tx, true);
+		snap_init(&plain, plainBuffer, sizeof(plainBuffer));
+
+		TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(&tx, &fields));
+		TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(&plain, &fields));
+
+		const uint16_t codewordCount = (uint16_t)((tx.layout.hashSize - SNAP_SIZE_FEC_CHECK) / SNAP_SIZE_FEC_PARITY);
+		const uint16_t interleavedSize = (uint16_t)(tx.size - tx.layout.dataIndex);
+		uint16_t burst = (uint16_t)(1U + nextRandom() % (codewordCount * SNAP_SIZE_FEC_PARITY / 2U));
+
+		burst = (burst < interleavedSize) ? burst : interleavedSize;
+
+		const uint16_t start = (uint16_t)(tx.layout.dataIndex + nextRandom() % (interleavedSize - burst + 1U));
+
+		for(uint16_t i = start; i < start + burst; i++)
+		{
+			txBuffer[i] ^= (uint8_t)(1U + nextRandom() % 255U);
+		}
+
+		TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, decodeInterleaved(&rx, txBuffer, tx.size, (uint8_t)(n % 3)));
+		TEST_ASSERT_EQUAL_MEMORY(plainBuffer, rxBuffer, plain.layout.hashIndex);
+	}
+}
+
+void test_filtered_interleaved_frame_is_skipped_whole(void)
+{
+	snap_frame_t tx, rx, plain;
+	snap_fields_t fields;
+
+	for(uint16_t n = 0; n < 1000; n++)
+	{
+		setRandomFrame(&fields);	// Frame to another node, with the sync byte all over its interleaved bytes
+		fields.header.dab = SNAP_HDB2_DAB_1BYTE_DEST_ADDRESS;
+		fields.header.pfb = SNAP_HDB2_PFB_2BYTE_PROTOCOL_FLAGS + nextRandom() % 2U;
+		fields.header.edm = SNAP_HDB1_EDM_FEC;
+		fields.header.ndb = 0;
+		fields.destAddress = 0x33;
+		fields.protocolFlags = (uint32_t)(1U + nextRandom() % 3U) << SNAP_FLAGS_DEPTH_POS;
+
+		snap_init(&tx, txBuffer, sizeof(txBuffer));
+		snap_setInterleaving(&tx, true);
+		TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(&tx, &fields));
+		memcpy(streamBuffer, txBuffer, tx.layout.dataIndex);
+		memset(&streamBuffer[tx.layout.dataIndex], SNAP_SYNC, (size_t)(tx.size - tx.layout.dataIndex));
+
+		setRandomFrame(&fields);	// Frame to this node
+		fields.header.dab = SNAP_HDB2_DAB_1BYTE_DEST_ADDRESS;
+		fields.destAddress = 0x05;
+		fields.protocolFlags &= ~((uint32_t)SNAP_FLAGS_DEPTH_MASK << SNAP_FLAGS_DEPTH_POS);
+
+		snap_init(&plain, plainBuffer, sizeof(plainBuffer));
+		TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(&plain, &fields));
+		memcpy(&streamBuffer[tx.size], plainBuffer, plain.size);
+
+		const uint8_t mode = (uint8_t)(n % 3);
+		const uint16_t size = (uint16_t)(tx.size + plain.size);
+		uint16_t validCount = 0;
+
+		snap_init(&rx, rxBuffer, sizeof(rxBuffer));
+		snap_setInterleaving(&rx, true);
+		snap_setAddressFilter(&rx, 0x05, 0);
+
+		for(uint16_t i = 0; i < size; i++)
+		{
+			const int8_t status = (mode == 1) ? snap_decodeBuffer(&rx, &streamBuffer[i], 1, NULL) :
+			                      (mode == 0) ? snap_decode(&rx, streamBuffer[i]) : snap_decodeStream(&rx, streamBuffer[i]);
+
+			if(status == SNAP_STATUS_VALID)
+			{
+				validCount++;
+				TEST_ASSERT_EQUAL_UINT16(size - 1U, i);
+			}
+		}
+
+		TEST_ASSERT_EQUAL_UINT16(1, validCount);
+		TEST_ASSERT_EQUAL_MEMORY(plainBuffer, rxBuffer, plain.layout.hashIndex);
+	}
+}
+
+void test_largest_interleaved_frame_fits_in_maximum_size(void)
+{
+	snap_frame_t tx, rx;
+	snap_fields_t fields;
+
+	setRandomFrame(&fields);
+	fields.header.dab = SNAP_HDB2_DAB_3BYTE_DEST_ADDRESS;
+	fields.header.sab = SNAP_HDB2_SAB_3BYTE_SOURCE_ADDRESS;
+	fields.header.pfb = SNAP_HDB2_PFB_3BYTE_PROTOCOL_FLAGS;
+	fields.header.edm = SNAP_HDB1_EDM_FEC;
+	fields.header.ndb = SNAP_HDB1_NDB_512BYTE_DATA;
+	fields.protocolFlags = (uint32_t)SNAP_DEPTH_8 << SNAP_FLAGS_DEPTH_POS;
+	fields.dataSize = SNAP_MAX_SIZE_DATA;
+
+	snap_init(&tx, txBuffer, sizeof(txBuffer));
+	snap_setInterleaving(&tx, true);
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(&tx, &fields));
+	TEST_ASSERT_EQUAL_UINT16(SNAP_SIZE_FEC_CHECK + SNAP_MAX_DEPTH * SNAP_SIZE_FEC_PARITY, tx.layout.hashSize);
+	TEST_ASSERT_LESS_OR_EQUAL_UINT16(SNAP_MAX_SIZE_FEC_FRAME, tx.size);
+	TEST_ASSERT_LESS_OR_EQUAL_UINT16(SNAP_MAX_SIZE_FRAME, tx.size);
+
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, decodeInterleaved(&rx, txBuffer, tx.size, 0));
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_depth_one_frame_is_not_changed);
+	RUN_TEST(test_interleaved_frame_round_trip);
+	RUN_TEST(test_burst_is_corrected_by_the_codewords);
+	RUN_TEST(test_filtered_interleaved_frame_is_skipped_whole);
+	RUN_TEST(test_largest_interleaved_frame_fits_in_maximum_size);
+	return UNITY_END();
+}
@@ -0,0 +1,119 @@
+/**
+ * @file   test_main.c
+ * @brief  Host tests of the cached frame layout: the offsets and sizes stored in the frame structure must match
+ *         the ones derived from the header bytes, after encapsulation, while decoding and after a manual update.
+ */
+
+#include <unity.h>
+#include "snap.h"
+#include "snap_test.h"
+
+static uint8_t data[SNAP_MAX_SIZE_DATA];
+static uint8_t txBuffer[SNAP_MAX_SIZE_BUFFER];
+static uint8_t rxBuffer[SNAP_MAX_SIZE_BUFFER];
+
+/**
+ * @brief Encapsulate a frame with random fields (any EDM but FEC, whose hash size is not given by the header).
+ */
+static void encapsulateRandomFrame(snap_frame_t *frame)
+{
+	snap_fields_t fields;
+
+	setRandomFields(&fields, (uint8_t)(nextRandom() % 6), SNAP_MAX_SIZE_DATA);
+	fields.data = data;
+
+	snap_init(frame, txBuffer, sizeof(txBuffer));
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(frame, &fields));
+}
+
+/**
+ * @brief Check the cached layout against the header bytes of the frame.
+ */
+static void assertLayout(const snap_frame_t *frame)
+{
+	const uint8_t *bytes = frame->buffer;
+	const uint16_t copies = (SNAP_HDB1_EDM(bytes) == SNAP_HDB1_EDM_3_RETRANSMISSION) ? 3U : 1U;
+
+	TEST_ASSERT_EQUAL_UINT16(SNAP_INDEX_SAB(bytes), snap_getSourceAddrIndex(frame));
+	TEST_ASSERT_EQUAL_UINT16(SNAP_INDEX_PFB(bytes), snap_getProtFlagsIndex(frame));
+	TEST_ASSERT_EQUAL_UINT16(SNAP_INDEX_DATA(bytes), snap_getDataIndex(frame));
+	TEST_ASSERT_EQUAL_UINT16(SNAP_SIZE_DATA(bytes), snap_getDataSize(frame));
+	TEST_ASSERT_EQUAL_UINT16(SNAP_INDEX_HASH(bytes), snap_getHashIndex(frame));
+	TEST_ASSERT_EQUAL_UINT16(SNAP_SIZE_HASH(bytes), frame->layout.hashSize);
+	TEST_ASSERT_EQUAL_UINT16(copies * (SNAP_INDEX_HASH(bytes) + SNAP_SIZE_HASH(bytes)), frame->layout.fullSize);
+}
+
+void setUp(void)
+{
+	seed = 3;
+}
+
+void tearDown(void)
+{
+}
+
+void test_layout_after_encapsulation(void)
+{
+	snap_frame_t frame;
+
+	for(uint16_t n = 0; n < 5000; n++)
+	{
+		encapsulateRandomFrame(&frame);
+		assertLayout(&frame);
+		TEST_ASSERT_EQUAL_UINT16(frame.layout.fullSize, frame.size);
+	}
+}
+
+void test_layout_while_decoding(void)
+{
+	snap_frame_t tx, rx;
+
+	for(uint16_t n = 0; n < 2000; n++)
+	{
+		encapsulateRandomFrame(&tx);
+		snap_init(&rx, rxBuffer, sizeof(rxBuffer));
+
+		const uint16_t headerSize = (uint16_t)(SNAP_IS_EXACT_LENGTH(txBuffer) ? tx.layout.dataIndex : SNAP_MIN_SIZE_FRAME);
+
+		for(uint16_t i = 0; i < tx.size; i++)
+		{
+			const int8_t status = snap_decode(&rx, txBuffer[i]);
+
+			if(i + 1U >= headerSize)	// Known as soon as the header (and data length field) is complete
+			{
+				assertLayout(&rx);
+				TEST_ASSERT_EQUAL_UINT16(tx.layout.fullSize, rx.layout.fullSize);
+			}
+
+			TEST_ASSERT_EQUAL_INT8((i + 1U == tx.size) ? SNAP_STATUS_VALID : SNAP_STATUS_INCOMPLETE, status);
+		}
+	}
+}
+
+void test_layout_after_manual_update(void)
+{
+	snap_frame_t frame;
+
+	encapsulateRandomFrame(&frame);
+
+	for(uint16_t n = 0; n < 1000; n++)
+	{
+		const uint8_t hdb1 = (uint8_t)(nextRandom() & ~0x70U);
+
+		txBuffer[SNAP_INDEX_HDB2] = (uint8_t)nextRandom();
+		txBuffer[SNAP_INDEX_HDB1] = (uint8_t)(hdb1 | ((nextRandom() % 6U) << 4));	// EDM 0 to 5
+		txBuffer[SNAP_INDEX_LENGTH(txBuffer)] = (uint8_t)(nextRandom() & 0x7F);
+
+		snap_updateLayout(&frame);
+		assertLayout(&frame);
+	}
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_layout_after_encapsulation);
+	RUN_TEST(test_layout_while_decoding);
+	RUN_TEST(test_layout_after_manual_update);
+	return UNITY_END();
+}
@@ -0,0 +1,323 @@
+/**
+ * @file   test_main.c
+ * @brief  Host tests of the link manager: the error detection method must follow the error rate of the link with hysteresis,
+ *         and follow the changes made by the peer. The NDB size class must be close to the one with the highest goodput.
+ */
+
+#include <string.h>
+#include <unity.h>
+#include "snap.h"
+#include "snap_link.h"
+#include "snap_test.h"
+
+static uint8_t txBuffer[SNAP_MAX_SIZE_BUFFER];
+
+/**
+ * @brief Data size of the NDB size class with the highest goodput, for frames with a 1-byte address, a 1-byte source and a CRC-16.
+ * @param[in] byteErrorPpm Probability of error of each byte, in parts per million.
+ */
+static uint16_t getBestDataSize(const uint32_t byteErrorPpm)
+{
+	double bestGoodput = 0.0;
+	uint16_t bestSize = 0;
+
+	for(uint8_t ndb = SNAP_HDB1_NDB_1BYTE_DATA; ndb <= SNAP_HDB1_NDB_512BYTE_DATA; ndb++)
+	{
+		const uint16_t dataSize = snap_getDataSizeFromNdb(ndb);
+		const uint16_t frameSize = (uint16_t)(SNAP_INDEX_DAB + 2U + dataSize + 2U);
+		double success = 1.0;
+
+		for(uint16_t i = 0; i < frameSize; i++)
+		{
+			success *= 1.0 - byteErrorPpm / 1e6;
+		}
+
+		if(success * dataSize / frameSize > bestGoodput)
+		{
+			bestGoodput = success * dataSize / frameSize;
+			bestSize = dataSize;
+		}
+	}
+
+	return bestSize;
+}
+
+/**
+ * @brief Report frames that fail with the given probability.
+ * @return Number of changes of the error detection method.
+ */
+static uint16_t reportFrames(snap_link_t *link, const uint16_t count, const uint8_t failPercent)
+{
+	uint16_t changes = 0;
+
+	for(uint16_t i = 0; i < count; i++)
+	{
+		const uint8_t edm = link->edm;
+		const bool failed = (nextRandom() % 100U) < failPercent;
+		const uint8_t failure = (uint8_t)(SNAP_LINK_EVENT_NACK + nextRandom() % 3U);
+
+		snap_reportLinkEvent(link, failed ? failure : SNAP_LINK_EVENT_ACK);
+		changes = (uint16_t)(changes + ((link->edm != edm) ? 1U : 0U));
+	}
+
+	return changes;
+}
+
+void setUp(void)
+{
+	seed = 22;
+}
+
+void tearDown(void)
+{
+}
+
+void test_init_and_find(void)
+{
+	snap_link_t links[3];
+
+	snap_initLink(&links[0], 5, SNAP_HDB1_EDM_8BIT_CHECKSUM, SNAP_HDB1_EDM_FEC);
+	snap_initLink(&links[1], 6, SNAP_HDB1_EDM_NO_ERROR_DETECTION, SNAP_HDB1_EDM_USER_SPECIFIED);	// Limited to the ladder
+	snap_initLink(&links[2], 7, SNAP_HDB1_EDM_32BIT_CRC, SNAP_HDB1_EDM_8BIT_CRC);
+
+	TEST_ASSERT_EQUAL_UINT8(SNAP_HDB1_EDM_8BIT_CHECKSUM, links[0].edm);
+	TEST_ASSERT_EQUAL_UINT8(SNAP_HDB1_EDM_8BIT_CHECKSUM, links[1].minEdm);
+	TEST_ASSERT_EQUAL_UINT8(SNAP_HDB1_EDM_FEC, links[1].maxEdm);
+	TEST_ASSERT_EQUAL_UINT8(SNAP_HDB1_EDM_32BIT_CRC, links[2].minEdm);
+	TEST_ASSERT_EQUAL_UINT8(SNAP_HDB1_EDM_32BIT_CRC, links[2].maxEdm);
+	TEST_ASSERT_EQUAL_UINT8(SNAP_HDB1_EDM_32BIT_CRC, links[2].edm);
+
+	TEST_ASSERT_EQUAL_PTR(&links[1], snap_findLink(links, 3, 6));
+	TEST_ASSERT_NULL(snap_findLink(links, 3, 8));
+}
+
+void test_method_follows_error_rate(void)
+{
+	snap_link_t link;
+
+	snap_initLink(&link, 5, SNAP_HDB1_EDM_8BIT_CHECKSUM, SNAP_HDB1_EDM_FEC);
+
+	TEST_ASSERT_EQUAL_UINT16(0, reportFrames(&link, 3000, 0));
+	TEST_ASSERT_EQUAL_UINT8(SNAP_HDB1_EDM_8BIT_CHECKSUM, link.edm);
+
+	reportFrames(&link, 3000, 40);
+	TEST_ASSERT_EQUAL_UINT8(SNAP_HDB1_EDM_FEC, link.edm);
+	TEST_ASSERT_EQUAL_UINT16(0, reportFrames(&link, 3000, 40));	// Already the strongest method
+
+	reportFrames(&link, 3000, 0);
+	TEST_ASSERT_EQUAL_UINT8(SNAP_HDB1_EDM_8BIT_CHECKSUM, link.edm);
+
+	for(uint16_t i = 0; i < 3000; i++)	// Between the thresholds, failures keep the method from going down (no oscillation)
+	{
+		const uint8_t edm = link.edm;
+
+		reportFrames(&link, 1, (SNAP_LINK_UP_PERCENT + SNAP_LINK_DOWN_PERCENT) / 2U);
+		TEST_ASSERT_TRUE(link.edm >= edm);
+	}
+}
+
+void test_hysteresis(void)
+{
+	snap_link_t link;
+
+	snap_initLink(&link, 5, SNAP_HDB1_EDM_8BIT_CHECKSUM, SNAP_HDB1_EDM_FEC);
+
+	for(uint16_t i = 0; i < SNAP_LINK_UP_HOLD - 1U; i++)
+	{
+		snap_reportLinkEvent(&link, SNAP_LINK_EVENT_RETRY);
+		TEST_ASSERT_EQUAL_UINT8(SNAP_HDB1_EDM_8BIT_CHECKSUM, link.edm);
+	}
+
+	snap_reportLinkEvent(&link, SNAP_LINK_EVENT_RETRY);
+	TEST_ASSERT_EQUAL_UINT8(SNAP_HDB1_EDM_8BIT_CRC, link.edm);
+
+	for(uint16_t i = 0; i < SNAP_LINK_UP_HOLD - 1U; i++)	// One step per hold period
+	{
+		snap_reportLinkEvent(&link, SNAP_LINK_EVENT_RETRY);
+		TEST_ASSERT_EQUAL_UINT8(SNAP_HDB1_EDM_8BIT_CRC, link.edm);
+	}
+
+	snap_reportLinkEvent(&link, SNAP_LINK_EVENT_NACK);
+	TEST_ASSERT_EQUAL_UINT8(SNAP_HDB1_EDM_16BIT_CRC, link.edm);
+
+	uint16_t clean = 0, sinceChange = 0;
+	uint8_t edm = link.edm;
+
+	while(link.edm >= edm)	// The error rate decays slowly, so the method may still climb before it goes down
+	{
+		if(link.edm != edm)
+		{
+			edm = link.edm;
+			sinceChange = 0;
+		}
+
+		snap_reportLinkEvent(&link, SNAP_LINK_EVENT_ACK);
+		sinceChange++;
+		clean++;
+	}
+
+	TEST_ASSERT_EQUAL_UINT8(edm - 1U, link.edm);
+	TEST_ASSERT_TRUE(sinceChange >= SNAP_LINK_DOWN_HOLD);
+	TEST_ASSERT_EQUAL_UINT16(clean, link.ackCount);
+	TEST_ASSERT_EQUAL_UINT16(2U * SNAP_LINK_UP_HOLD - 1U, link.retryCount);
+	TEST_ASSERT_EQUAL_UINT16(1, link.nackCount);
+}
+
+void test_method_follows_peer(void)
+{
+	snap_link_t link;
+	snap_frame_t frame;
+	snap_fields_t fields;
+
+	snap_initLink(&link, 6, SNAP_HDB1_EDM_8BIT_CHECKSUM, SNAP_HDB1_EDM_32BIT_CRC);
+	snap_init(&frame, txBuffer, sizeof(txBuffer));
+	memset(&fields, 0, sizeof(fields));
+
+	fields.header.edm = SNAP_HDB1_EDM_32BIT_CRC;
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(&frame, &fields));
+	snap_reportLinkFrame(&link, &frame);
+	TEST_ASSERT_EQUAL_UINT8(SNAP_HDB1_EDM_32BIT_CRC, link.edm);
+	TEST_ASSERT_EQUAL_UINT16(1, link.ackCount);
+
+	fields.header.edm = SNAP_HDB1_EDM_FEC;	// Not supported by this link
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(&frame, &fields));
+	snap_reportLinkFrame(&link, &frame);
+	TEST_ASSERT_EQUAL_UINT8(SNAP_HDB1_EDM_32BIT_CRC, link.edm);
+
+	frame.status = SNAP_STATUS_ERROR_HASH;
+	snap_reportLinkFrame(&link, &frame);
+	TEST_ASSERT_EQUAL_UINT16(1, link.hashErrorCount);
+
+	snap_applyLink(&link, &fields);
+	TEST_ASSERT_EQUAL_UINT8(SNAP_HDB1_EDM_32BIT_CRC, fields.header.edm);
+}
+
+void test_peer_follows_hysteresis(void)
+{
+	snap_link_t link;
+	snap_frame_t frame;
+	snap_fields_t fields;
+
+	snap_initLink(&link, 6, SNAP_HDB1_EDM_8BIT_CHECKSUM, SNAP_HDB1_EDM_FEC);
+	snap_init(&frame, txBuffer, sizeof(txBuffer));
+	memset(&fields, 0, sizeof(fields));
+
+	for(uint16_t i = 0; i < 20; i++)
+	{
+		snap_reportLinkEvent(&link, SNAP_LINK_EVENT_NACK);
+	}
+
+	const uint8_t edm = link.edm;
+	TEST_ASSERT_TRUE(edm > SNAP_HDB1_EDM_8BIT_CHECKSUM);
+
+	fields.header.edm = SNAP_HDB1_EDM_8BIT_CHECKSUM;	// Sent by the peer before it saw the move up
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(&frame, &fields));
+	snap_reportLinkFrame(&link, &frame);
+	TEST_ASSERT_EQUAL_UINT8(edm, link.edm);
+
+	uint16_t count = 1;
+
+	while(link.edm != SNAP_HDB1_EDM_8BIT_CHECKSUM)	// The peer keeps the lighter method on a clean link
+	{
+		snap_reportLinkFrame(&link, &frame);
+		count++;
+	}
+
+	TEST_ASSERT_TRUE(count > SNAP_LINK_DOWN_HOLD);
+}
+
+void test_data_size_follows_byte_error_rate(void)
+{
+	static const uint32_t byteErrorPpm[] = {0, 10, 100, 500, 2000, 10000, 50000};
+	snap_fields_t fields;
+
+	memset(&fields, 0, sizeof(fields));
+	fields.header.dab = SNAP_HDB2_DAB_1BYTE_DEST_ADDRESS;
+	fields.header.sab = SNAP_HDB2_SAB_1BYTE_SOURCE_ADDRESS;
+
+	for(uint8_t k = 0; k < sizeof(byteErrorPpm) / sizeof(byteErrorPpm[0]); k++)
+	{
+		snap_link_t link;
+		snap_linkStats_t stats;
+
+		snap_initLink(&link, 1, SNAP_HDB1_EDM_16BIT_CRC, SNAP_HDB1_EDM_16BIT_CRC);
+		uint16_t dataSize = snap_selectLinkDataSize(&link, &fields, SNAP_MAX_SIZE_DATA);
+		TEST_ASSERT_EQUAL_UINT16(SNAP_MAX_SIZE_DATA, dataSize);	// No errors seen yet
+
+		for(uint16_t n = 0; n < 3000; n++)
+		{
+			const uint16_t frameSize = (uint16_t)(SNAP_INDEX_DAB + 2U + dataSize + 2U);
+			bool failed = false;
+
+			for(uint16_t i = 0; i < frameSize; i++)
+			{
+				failed = failed || ((nextRandom() % 1000000UL) < byteErrorPpm[k]);
+			}
+
+			snap_reportLinkTransfer(&link, failed ? SNAP_LINK_EVENT_RETRY : SNAP_LINK_EVENT_ACK, frameSize);
+			dataSize = snap_selectLinkDataSize(&link, &fields, SNAP_MAX_SIZE_DATA);
+		}
+
+		const uint16_t bestSize = getBestDataSize(byteErrorPpm[k]);
+
+		snap_getLinkStats(&link, &stats);
+		TEST_ASSERT_EQUAL_UINT16(dataSize, stats.dataSize);
+		TEST_ASSERT_EQUAL_UINT8(snap_getNdbFromDataSize(dataSize), stats.ndb);
+		TEST_ASSERT_TRUE((stats.dataSize >= bestSize / 4U) && (stats.dataSize <= bestSize * 4U));	// Within 2 size classes
+		TEST_ASSERT_EQUAL_UINT16(stats.ackCount + stats.retryCount, 3000);
+
+		const uint32_t expectedRate = byteErrorPpm[k] * SNAP_LINK_RATE_ONE / 1000000UL;
+
+		TEST_ASSERT_TRUE(stats.byteErrorRate <= 4U * expectedRate + 16U);
+		TEST_ASSERT_TRUE((byteErrorPpm[k] < 500U) || (stats.byteErrorRate >= expectedRate / 4U));
+	}
+}
+
+void test_data_size_limits(void)
+{
+	snap_link_t link;
+	snap_fields_t fields;
+
+	snap_initLink(&link, 1, SNAP_HDB1_EDM_8BIT_CHECKSUM, SNAP_HDB1_EDM_FEC);
+	memset(&fields, 0, sizeof(fields));
+
+	TEST_ASSERT_EQUAL_UINT16(64, snap_selectLinkDataSize(&link, &fields, 100));
+	TEST_ASSERT_EQUAL_UINT16(0, snap_getLinkFragmentSize(&link, &fields, 0));
+	TEST_ASSERT_EQUAL_UINT16(0, snap_getLinkFragmentSize(&link, &fields, SNAP_MAX_SIZE_MESSAGE + 1U));
+	TEST_ASSERT_EQUAL_UINT16(SNAP_MAX_SIZE_DATA, snap_getLinkFragmentSize(&link, &fields, 30000));	// Clean link
+
+	for(uint16_t n = 0; n < 200; n++)
+	{
+		snap_reportLinkTransfer(&link, SNAP_LINK_EVENT_RETRY, 100);
+	}
+
+	const uint16_t fragmentSize = snap_getLinkFragmentSize(&link, &fields, 1000);
+
+	TEST_ASSERT_TRUE(fragmentSize >= (1000U + SNAP_MAX_FRAGMENTS - 1U) / SNAP_MAX_FRAGMENTS);	// Bad link, but no more than 64 fragments
+	TEST_ASSERT_TRUE(snap_getFragmentCount(1000, fragmentSize) != 0);
+
+	snap_linkStats_t stats;
+	snap_getLinkStats(&link, &stats);
+	const uint16_t fullSize = (uint16_t)(stats.dataSize * SNAP_MAX_FRAGMENTS);	// 64 fragments of the class leave no room for the CRC
+	TEST_ASSERT_TRUE(snap_getFragmentCount(fullSize, snap_getLinkFragmentSize(&link, &fields, fullSize)) != 0);
+
+	const snap_link_t previous = link;
+	snap_reportLinkTransfer(&link, SNAP_LINK_EVENT_HASH_ERROR + 1U, 100);	// Invalid event
+	TEST_ASSERT_EQUAL_UINT16(previous.errorRate, link.errorRate);
+	TEST_ASSERT_EQUAL_UINT16(previous.byteCount, link.byteCount);
+	TEST_ASSERT_EQUAL_UINT16(previous.failWeight, link.failWeight);
+	TEST_ASSERT_EQUAL_UINT8(previous.holdCount, link.holdCount);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_init_and_find);
+	RUN_TEST(test_method_follows_error_rate);
+	RUN_TEST(test_hysteresis);
+	RUN_TEST(test_method_follows_peer);
+	RUN_TEST(test_peer_follows_hysteresis);
+	RUN_TEST(test_data_size_follows_byte_error_rate);
+	RUN_TEST(test_data_size_limits);
+	return UNITY_END();
+}
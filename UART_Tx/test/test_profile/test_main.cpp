@@ -0,0 +1,248 @@
+/**
+ * @file   test_main.cpp
+ * @brief  Host tests of the C++ frame profiles (snap_profile.hpp): their frames must be identical to the ones built by
+ *         snap_encapsulate(), and their decoders must accept the same frames as snap_decode().
+ */
+
+#include <string.h>
+#include <unity.h>
+#include "snap.h"
+#include "snap_profile.hpp"
+#include "snap_test.h"
+
+static uint8_t data[SNAP_MAX_SIZE_DATA];
+static uint8_t txBuffer[SNAP_MAX_SIZE_BUFFER];
+static uint8_t rxBuffer[SNAP_MAX_SIZE_BUFFER];
+
+static uint32_t randomField(const uint8_t size)
+{
+	return (size == 0) ? 0 : (nextRandom() & (0xFFFFFFFFUL >> ((4U - size) * 8U)));
+}
+
+/**
+ * @brief Random data size that snap_encapsulate() encodes with the NDB of the profile (padding bytes included).
+ */
+template<typename P> static uint16_t randomDataSize(void)
+{
+	const uint16_t previous = (P::dataSize <= 8) ? P::dataSize : (uint16_t)(P::dataSize / 2U + 1U);
+
+	return (uint16_t)(previous + nextRandom() % (P::dataSize - previous + 1U));
+}
+
+/**
+ * @brief Encapsulate a random frame of a profile with snap_encapsulate() and with the profile, and compare them.
+ * @param[out] frame Pointer to the frame structure (buffer txBuffer).
+ * @param[out] bytes Pointer to the array that will store the frame built by the profile.
+ * @param[out] fields Pointer to the fields of the frame.
+ */
+template<typename P> static void encapsulateBoth(snap_frame_t *frame, uint8_t *bytes, snap_fields_t *fields)
+{
+	memset(fields, 0, sizeof(*fields));
+	fields->header.dab = (P::sourceIndex - SNAP_INDEX_DAB);
+	fields->header.sab = (P::flagsIndex - P::sourceIndex);
+	fields->header.pfb = (P::dataIndex - P::flagsIndex);
+	fields->header.ack = nextRandom() % 4;
+	fields->header.cmd = (P::hdb1 >> SNAP_HDB1_CMD_POS) & SNAP_HDB1_CMD_MASK;
+	fields->header.edm = (P::hdb1 >> SNAP_HDB1_EDM_POS) & SNAP_HDB1_EDM_MASK;
+	fields->destAddress = randomField(fields->header.dab);
+	fields->sourceAddress = randomField(fields->header.sab);
+	fields->protocolFlags = randomField(fields->header.pfb);
+	fields->dataSize = randomDataSize<P>();
+	fields->data = data;
+	fields->paddingAfter = true;
+
+	fillRandom(data, fields->dataSize);
+
+	snap_init(frame, txBuffer, sizeof(txBuffer));
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(frame, fields));
+	TEST_ASSERT_EQUAL_HEX8(P::hdb1, txBuffer[SNAP_INDEX_HDB1]);
+
+	P::encode(bytes, (typename P::DestAddress)fields->destAddress, (typename P::SourceAddress)fields->sourceAddress,
+	          (typename P::ProtocolFlags)fields->protocolFlags, data, fields->dataSize, fields->header.ack);
+}
+
+/**
+ * @brief Check a profile against snap.c: same frames, and every frame decoded with the same fields.
+ */
+template<typename P> static void checkProfile(void)
+{
+	static uint8_t bytes[P::frameSize];
+	snap_frame_t tx, rx;
+	snap_fields_t fields;
+	typename P::Decoder decoder;
+
+	for(uint16_t n = 0; n < 300; n++)
+	{
+		encapsulateBoth<P>(&tx, bytes, &fields);
+
+		TEST_ASSERT_EQUAL_UINT16(tx.size, P::frameSize);
+		TEST_ASSERT_EQUAL_HEX8_ARRAY(txBuffer, bytes, P::frameSize);
+
+		int8_t status = SNAP_STATUS_IDLE;
+		snap_init(&rx, rxBuffer, sizeof(rxBuffer));
+		decoder.reset();
+
+		for(uint16_t i = 0; i < P::frameSize; i++)
+		{
+			status = snap_decode(&rx, bytes[i]);
+			TEST_ASSERT_EQUAL_INT8(status, decoder.decode(bytes[i]));
+		}
+
+		TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, status);
+		TEST_ASSERT_EQUAL_UINT32(fields.destAddress, decoder.getDestAddress());
+		TEST_ASSERT_EQUAL_UINT32(fields.sourceAddress, decoder.getSourceAddress());
+		TEST_ASSERT_EQUAL_UINT32(fields.protocolFlags, decoder.getProtocolFlags());
+		TEST_ASSERT_EQUAL_UINT8(fields.header.ack, decoder.getAck());
+		if(fields.dataSize != 0)
+		{
+			TEST_ASSERT_EQUAL_HEX8_ARRAY(data, decoder.getData(), fields.dataSize);
+		}
+
+		TEST_ASSERT_EQUAL_HEX8_ARRAY(rxBuffer, decoder.getBuffer(), P::frameSize);
+	}
+}
+
+typedef snap::Profile<SNAP_HDB2_DAB_1BYTE_DEST_ADDRESS, SNAP_HDB2_SAB_1BYTE_SOURCE_ADDRESS, SNAP_HDB2_PFB_1BYTE_PROTOCOL_FLAGS,
+                      SNAP_HDB1_EDM_16BIT_CRC, SNAP_HDB1_NDB_8BYTE_DATA> Crc16Profile;
+typedef snap::Profile<SNAP_HDB2_DAB_3BYTE_DEST_ADDRESS, SNAP_HDB2_SAB_NO_SOURCE_ADDRESS, SNAP_HDB2_PFB_2BYTE_PROTOCOL_FLAGS,
+                      SNAP_HDB1_EDM_32BIT_CRC, SNAP_HDB1_NDB_64BYTE_DATA, SNAP_HDB1_CMD_MODE_ENABLED> Crc32Profile;
+typedef snap::Profile<SNAP_HDB2_DAB_NO_DEST_ADDRESS, SNAP_HDB2_SAB_2BYTE_SOURCE_ADDRESS, SNAP_HDB2_PFB_NO_PROTOCOL_FLAGS,
+                      SNAP_HDB1_EDM_8BIT_CRC, SNAP_HDB1_NDB_3BYTE_DATA> Crc8Profile;
+typedef snap::Profile<SNAP_HDB2_DAB_2BYTE_DEST_ADDRESS, SNAP_HDB2_SAB_3BYTE_SOURCE_ADDRESS, SNAP_HDB2_PFB_3BYTE_PROTOCOL_FLAGS,
+                      SNAP_HDB1_EDM_8BIT_CHECKSUM, SNAP_HDB1_NDB_NO_DATA> ChecksumProfile;
+typedef snap::Profile<SNAP_HDB2_DAB_1BYTE_DEST_ADDRESS, SNAP_HDB2_SAB_1BYTE_SOURCE_ADDRESS, SNAP_HDB2_PFB_NO_PROTOCOL_FLAGS,
+                      SNAP_HDB1_EDM_NO_ERROR_DETECTION, SNAP_HDB1_NDB_16BYTE_DATA> PlainProfile;
+typedef snap::Profile<SNAP_HDB2_DAB_1BYTE_DEST_ADDRESS, SNAP_HDB2_SAB_1BYTE_SOURCE_ADDRESS, SNAP_HDB2_PFB_NO_PROTOCOL_FLAGS,
+                      SNAP_HDB1_EDM_3_RETRANSMISSION, SNAP_HDB1_NDB_6BYTE_DATA> TripleProfile;
+typedef snap::Profile<SNAP_HDB2_DAB_1BYTE_DEST_ADDRESS, SNAP_HDB2_SAB_1BYTE_SOURCE_ADDRESS, SNAP_HDB2_PFB_1BYTE_PROTOCOL_FLAGS,
+                      SNAP_HDB1_EDM_FEC, SNAP_HDB1_NDB_512BYTE_DATA> FecProfile;
+
+void setUp(void)
+{
+	seed = 9;
+}
+
+void tearDown(void)
+{
+}
+
+void test_frames_match_snap_c(void)
+{
+	TEST_ASSERT_EQUAL_UINT16(1 + 2 + 3 + 8 + 2, Crc16Profile::frameSize);
+	TEST_ASSERT_EQUAL_UINT16(3 * (1 + 2 + 2 + 6), TripleProfile::frameSize);
+
+	checkProfile<Crc16Profile>();
+	checkProfile<Crc32Profile>();
+	checkProfile<Crc8Profile>();
+	checkProfile<ChecksumProfile>();
+	checkProfile<PlainProfile>();
+	checkProfile<TripleProfile>();
+	checkProfile<FecProfile>();
+}
+
+void test_corrupted_frame_is_rejected(void)
+{
+	uint8_t bytes[Crc16Profile::frameSize];
+	snap_frame_t tx;
+	snap_fields_t fields;
+	Crc16Profile::Decoder decoder;
+
+	for(uint16_t n = 0; n < 1000; n++)
+	{
+		encapsulateBoth<Crc16Profile>(&tx, bytes, &fields);
+
+		const uint16_t index = (uint16_t)(Crc16Profile::dataIndex + nextRandom() % (Crc16Profile::frameSize - Crc16Profile::dataIndex));
+		const uint8_t error = (uint8_t)(1U << (nextRandom() % 8U));
+		bytes[index] ^= error;
+
+		int8_t status = SNAP_STATUS_IDLE;
+		decoder.reset();
+
+		for(uint16_t i = 0; i < Crc16Profile::frameSize; i++)
+		{
+			status = decoder.decode(bytes[i]);
+		}
+
+		TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_ERROR_HASH, status);
+	}
+}
+
+void test_errors_are_corrected(void)
+{
+	uint8_t bytes[FecProfile::frameSize];
+	snap_frame_t tx;
+	snap_fields_t fields;
+	FecProfile::Decoder fecDecoder;
+	TripleProfile::Decoder tripleDecoder;
+
+	for(uint16_t n = 0; n < 100; n++)
+	{
+		encapsulateBoth<FecProfile>(&tx, bytes, &fields);
+		bytes[FecProfile::dataIndex + nextRandom() % FecProfile::dataSize] ^= (uint8_t)(1U + nextRandom() % 255U);	// One error in the first codewords
+
+		int8_t status = SNAP_STATUS_IDLE;
+		fecDecoder.reset();
+
+		for(uint16_t i = 0; i < FecProfile::frameSize; i++)
+		{
+			status = fecDecoder.decode(bytes[i]);
+		}
+
+		TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, status);
+		TEST_ASSERT_EQUAL_HEX8_ARRAY(txBuffer, fecDecoder.getBuffer(), FecProfile::hashIndex);
+
+		encapsulateBoth<TripleProfile>(&tx, bytes, &fields);
+
+		const uint16_t copy = (uint16_t)(nextRandom() % TripleProfile::copies);
+		bytes[copy * TripleProfile::copySize + TripleProfile::dataIndex + nextRandom() % TripleProfile::dataSize] ^= (uint8_t)(1U + nextRandom() % 255U);
+		tripleDecoder.reset();
+
+		for(uint16_t i = 0; i < TripleProfile::frameSize; i++)
+		{
+			status = tripleDecoder.decode(bytes[i]);
+		}
+
+		TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, status);
+		TEST_ASSERT_EQUAL_HEX8_ARRAY(txBuffer, tripleDecoder.getBuffer(), TripleProfile::frameSize);
+	}
+}
+
+void test_frame_of_another_profile_is_discarded(void)
+{
+	uint8_t bytes[Crc16Profile::frameSize];
+	snap_frame_t tx;
+	snap_fields_t fields;
+	Crc8Profile::Decoder decoder;
+
+	encapsulateBoth<Crc16Profile>(&tx, bytes, &fields);
+
+	for(uint16_t i = 0; i < Crc16Profile::frameSize; i++)
+	{
+		decoder.decode(bytes[i]);
+		TEST_ASSERT_TRUE(decoder.getSize() <= SNAP_MIN_SIZE_FRAME);
+	}
+
+	uint8_t expected[Crc8Profile::frameSize];
+	encapsulateBoth<Crc8Profile>(&tx, expected, &fields);
+	decoder.reset();
+
+	int8_t status = SNAP_STATUS_IDLE;
+
+	for(uint16_t i = 0; i < Crc8Profile::frameSize; i++)
+	{
+		status = decoder.decode(expected[i]);
+	}
+
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, status);
+	TEST_ASSERT_EQUAL_UINT32(fields.sourceAddress, decoder.getSourceAddress());
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_frames_match_snap_c);
+	RUN_TEST(test_corrupted_frame_is_rejected);
+	RUN_TEST(test_errors_are_corrected);
+	RUN_TEST(test_frame_of_another_profile_is_discarded);
+	return UNITY_END();
+}
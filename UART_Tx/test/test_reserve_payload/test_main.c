@@ -0,0 +1,115 @@
+/**
+ * @file   test_main.c
+ * @brief  Host tests of the in-place encapsulation: a payload written at the address given by snap_reservePayload()
+ *         must give the same frame as a payload copied by snap_encapsulate().
+ */
+
+#include <string.h>
+#include <unity.h>
+#include "snap.h"
+#include "snap_test.h"
+
+static uint8_t data[SNAP_MAX_SIZE_DATA];
+static uint8_t copiedBuffer[SNAP_MAX_SIZE_BUFFER];
+static uint8_t inPlaceBuffer[SNAP_MAX_SIZE_BUFFER];
+
+void setUp(void)
+{
+	seed = 5;
+}
+
+void tearDown(void)
+{
+}
+
+void test_in_place_payload_gives_the_same_frame(void)
+{
+	snap_frame_t copied, inPlace;
+	snap_fields_t fields, inPlaceFields;
+
+	for(uint16_t n = 0; n < 20000; n++)
+	{
+		const uint16_t maxSize = (nextRandom() % 4) ? (uint16_t)SNAP_MAX_SIZE_BUFFER : (uint16_t)(SNAP_MIN_SIZE_FRAME + nextRandom() % 600U);
+
+		setRandomFields(&fields, (uint8_t)(nextRandom() % 7), SNAP_MAX_SIZE_DATA);
+		fields.data = data;
+
+		fillRandom(data, fields.dataSize);
+
+		inPlaceFields = fields;
+		inPlaceFields.data = NULL;
+
+		snap_init(&copied, copiedBuffer, maxSize);
+		snap_init(&inPlace, inPlaceBuffer, maxSize);
+
+		const int8_t status = snap_encapsulate(&copied, &fields);
+		uint8_t *payload = snap_reservePayload(&inPlace, &inPlaceFields);
+
+		TEST_ASSERT_EQUAL(status == SNAP_STATUS_VALID, payload != NULL);	// Same size check
+
+		if(payload == NULL)
+		{
+			continue;
+		}
+
+		TEST_ASSERT_TRUE(inPlaceFields.data == payload);
+		TEST_ASSERT_TRUE((payload >= inPlaceBuffer) && (payload + fields.dataSize <= inPlaceBuffer + maxSize));
+		memcpy(payload, data, fields.dataSize);
+
+		TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(&inPlace, &inPlaceFields));
+		TEST_ASSERT_EQUAL_UINT16(copied.size, inPlace.size);
+		TEST_ASSERT_EQUAL_MEMORY(copiedBuffer, inPlaceBuffer, copied.size);
+	}
+}
+
+void test_reserved_space_is_the_data_field(void)
+{
+	snap_frame_t frame;
+	snap_fields_t fields;
+
+	memset(&fields, 0, sizeof(fields));
+	fields.header.dab = SNAP_HDB2_DAB_3BYTE_DEST_ADDRESS;
+	fields.header.sab = SNAP_HDB2_SAB_2BYTE_SOURCE_ADDRESS;
+	fields.header.edm = SNAP_HDB1_EDM_32BIT_CRC;
+	fields.dataSize = 20;	// 32 bytes with padding
+	fields.paddingAfter = false;
+
+	snap_init(&frame, inPlaceBuffer, sizeof(inPlaceBuffer));
+	uint8_t *payload = snap_reservePayload(&frame, &fields);
+
+	TEST_ASSERT_TRUE(payload == &inPlaceBuffer[1U + 2U + 3U + 2U + 12U]);	// Sync, header, addresses, padding
+	TEST_ASSERT_EQUAL_UINT16(0, frame.size);
+	memset(payload, 0xA5, fields.dataSize);
+
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(&frame, &fields));
+	TEST_ASSERT_EQUAL_UINT16(32, snap_getDataSize(&frame));
+	TEST_ASSERT_EQUAL_HEX8(SNAP_PADDING, inPlaceBuffer[snap_getDataIndex(&frame)]);
+	TEST_ASSERT_EQUAL_HEX8(0xA5, inPlaceBuffer[snap_getDataIndex(&frame) + 12U]);
+	TEST_ASSERT_EQUAL_UINT16(20, snap_removePaddingBytes(payload - 12, 32, false));
+}
+
+void test_frame_too_large_for_the_buffer_is_not_reserved(void)
+{
+	snap_frame_t frame;
+	snap_fields_t fields;
+
+	memset(&fields, 0, sizeof(fields));
+	fields.header.edm = SNAP_HDB1_EDM_16BIT_CRC;
+	fields.header.ndb = SNAP_HDB1_NDB_USER_SPECIFIED;
+	fields.dataSize = 100;
+	fields.data = data;
+
+	snap_init(&frame, inPlaceBuffer, 1U + 2U + 1U + 100U + 2U - 1U);	// 1 byte short
+
+	TEST_ASSERT_NULL(snap_reservePayload(&frame, &fields));
+	TEST_ASSERT_TRUE(fields.data == data);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_in_place_payload_gives_the_same_frame);
+	RUN_TEST(test_reserved_space_is_the_data_field);
+	RUN_TEST(test_frame_too_large_for_the_buffer_is_not_reserved);
+	return UNITY_END();
+}
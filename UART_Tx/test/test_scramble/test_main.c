@@ -0,0 +1,182 @@
+/**
+ * @file   test_main.c
+ * @brief  Host tests of the PN9 scrambler: every byte but the sync byte must be whitened, long runs must be broken,
+ *         and scrambled frames must decode to the same bytes as plain frames.
+ */
+
+#include <string.h>
+#include <unity.h>
+#include "snap.h"
+#include "snap_test.h"
+
+static uint8_t data[SNAP_MAX_SIZE_DATA];
+static uint8_t txBuffer[SNAP_MAX_SIZE_BUFFER];
+static uint8_t rxBuffer[SNAP_MAX_SIZE_BUFFER];
+static uint8_t plainBuffer[SNAP_MAX_SIZE_BUFFER];
+
+/**
+ * @brief Encapsulate the same fields with scrambling (and optional interleaving) in txBuffer, and without both in plainBuffer.
+ */
+static void encapsulateBoth(snap_frame_t *scrambled, snap_frame_t *plain, snap_fields_t *fields, const bool interleaving)
+{
+	snap_init(scrambled, txBuffer, sizeof(txBuffer));
+	snap_setScrambling(scrambled, true);
+	snap_setInterleaving(scrambled, interleaving);
+	snap_init(plain, plainBuffer, sizeof(plainBuffer));
+
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(scrambled, fields));
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(plain, fields));
+}
+
+/**
+ * @brief Get the longest run of equal bytes in an array.
+ */
+static uint16_t getLongestRun(const uint8_t *bytes, const uint16_t size)
+{
+	uint16_t longest = 1;
+	uint16_t run = 1;
+
+	for(uint16_t i = 1; i < size; i++)
+	{
+		run = (bytes[i] == bytes[i - 1]) ? (uint16_t)(run + 1U) : 1U;
+		longest = (run > longest) ? run : longest;
+	}
+
+	return longest;
+}
+
+void setUp(void)
+{
+	seed = 17;
+}
+
+void tearDown(void)
+{
+}
+
+void test_bytes_are_xored_with_pn9(void)
+{
+	static const uint8_t pn9[] = {0xFF, 0xE1, 0x1D, 0x9A, 0xED, 0x85, 0x33, 0x24, 0xEA, 0x7A, 0xD2, 0x39, 0x70, 0x97, 0x57, 0x0A};
+	snap_frame_t scrambled, plain;
+	snap_fields_t fields;
+
+	memset(&fields, 0, sizeof(fields));
+	memset(data, 0, sizeof(pn9));
+	fields.header.ndb = SNAP_HDB1_NDB_USER_SPECIFIED;
+	fields.data = data;
+	fields.dataSize = sizeof(pn9);
+
+	encapsulateBoth(&scrambled, &plain, &fields, false);
+
+	TEST_ASSERT_EQUAL_UINT16(plain.size, scrambled.size);
+	TEST_ASSERT_EQUAL_HEX8(SNAP_SYNC, txBuffer[SNAP_INDEX_SYNC]);
+
+	for(uint16_t i = 0; i < sizeof(pn9); i++)
+	{
+		TEST_ASSERT_EQUAL_HEX8(pn9[i], txBuffer[SNAP_INDEX_HDB2 + i] ^ plainBuffer[SNAP_INDEX_HDB2 + i]);
+	}
+}
+
+void test_long_runs_are_broken(void)
+{
+	snap_frame_t scrambled, plain;
+	snap_fields_t fields;
+
+	memset(&fields, 0, sizeof(fields));
+	fields.header.edm = SNAP_HDB1_EDM_16BIT_CRC;
+	fields.data = data;
+	fields.paddingAfter = true;
+
+	for(uint16_t dataSize = 0; dataSize <= SNAP_MAX_SIZE_DATA; dataSize++)
+	{
+		memset(data, (dataSize % 2) ? 0xFF : 0x00, dataSize);
+		fields.dataSize = dataSize;
+
+		encapsulateBoth(&scrambled, &plain, &fields, false);
+
+		TEST_ASSERT_LESS_OR_EQUAL(2, getLongestRun(&txBuffer[SNAP_INDEX_HDB2], (uint16_t)(scrambled.size - SNAP_INDEX_HDB2)));
+	}
+}
+
+void test_sync_byte_of_every_copy_is_left_alone(void)
+{
+	snap_frame_t scrambled, plain;
+	snap_fields_t fields;
+
+	memset(&fields, 0, sizeof(fields));
+	fields.header.edm = SNAP_HDB1_EDM_3_RETRANSMISSION;
+	fields.data = data;
+	fields.dataSize = 40;
+
+	encapsulateBoth(&scrambled, &plain, &fields, false);
+
+	const uint16_t copySize = scrambled.size / 3U;
+
+	for(uint16_t i = 0; i < scrambled.size; i++)
+	{
+		if(i % copySize == 0)
+		{
+			TEST_ASSERT_EQUAL_HEX8(SNAP_SYNC, txBuffer[i]);
+		}
+		else
+		{
+			TEST_ASSERT_EQUAL_HEX8(txBuffer[i % copySize], txBuffer[i]);	// The sequence restarts at each sync byte
+		}
+	}
+}
+
+void test_scrambled_frame_round_trip(void)
+{
+	snap_frame_t scrambled, plain, rx;
+	snap_fields_t fields;
+
+	for(uint16_t n = 0; n < 3000; n++)
+	{
+		const bool interleaving = nextRandom() % 2;
+		const uint8_t mode = (uint8_t)(nextRandom() % 3);
+		const bool zeros = nextRandom() % 2;
+		int8_t status = SNAP_STATUS_IDLE;
+		uint16_t consumed;
+
+		setRandomFields(&fields, (uint8_t)(nextRandom() % 7), SNAP_MAX_SIZE_DATA);
+		fields.data = data;
+
+		for(uint16_t i = 0; i < fields.dataSize; i++)
+		{
+			data[i] = zeros ? 0x00 : (uint8_t)nextRandom();
+		}
+
+		encapsulateBoth(&scrambled, &plain, &fields, interleaving);
+
+		snap_init(&rx, rxBuffer, sizeof(rxBuffer));
+		snap_setScrambling(&rx, true);
+		snap_setInterleaving(&rx, interleaving);
+
+		if(mode == 1)
+		{
+			status = snap_decodeBuffer(&rx, txBuffer, scrambled.size, &consumed);
+		}
+		else
+		{
+			for(uint16_t i = 0; i < scrambled.size; i++)
+			{
+				status = (mode == 0) ? snap_decode(&rx, txBuffer[i]) : snap_decodeStream(&rx, txBuffer[i]);
+			}
+		}
+
+		TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, status);
+		TEST_ASSERT_EQUAL_UINT16(scrambled.size, rx.size);
+		TEST_ASSERT_EQUAL_UINT16(plain.layout.hashIndex, rx.layout.hashIndex);
+		TEST_ASSERT_EQUAL_MEMORY(plainBuffer, rxBuffer, plain.layout.hashIndex);
+	}
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_bytes_are_xored_with_pn9);
+	RUN_TEST(test_long_runs_are_broken);
+	RUN_TEST(test_sync_byte_of_every_copy_is_left_alone);
+	RUN_TEST(test_scrambled_frame_round_trip);
+	return UNITY_END();
+}
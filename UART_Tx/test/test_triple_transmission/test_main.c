@@ -0,0 +1,212 @@
+/**
+ * @file   test_main.c
+ * @brief  Host tests of the triple transmission (EDM 1): errors confined to one copy of each bit must be corrected
+ *         by the majority vote, and copies that cannot be aligned must be left as received.
+ */
+
+#include <string.h>
+#include <unity.h>
+#include "snap.h"
+#include "snap_test.h"
+
+static uint8_t data[SNAP_MAX_SIZE_DATA];
+static uint8_t txBuffer[SNAP_MAX_SIZE_BUFFER];
+static uint8_t rxBuffer[SNAP_MAX_SIZE_BUFFER];
+static uint8_t received[SNAP_MAX_SIZE_BUFFER];
+
+/**
+ * @brief Encapsulate a frame with random fields, sent 3 times.
+ * @param[out] frame  Pointer to the frame structure (buffer txBuffer).
+ * @param[out] fields Pointer to the fields of the frame (data in the data array).
+ */
+static void encapsulateRandomFrame(snap_frame_t *frame, snap_fields_t *fields)
+{
+	setRandomFields(fields, SNAP_HDB1_EDM_3_RETRANSMISSION, 199U);
+	fields->paddingAfter = true;
+	fillRandom(data, fields->dataSize);
+	fields->data = data;
+
+	snap_init(frame, txBuffer, sizeof(txBuffer));
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(frame, fields));
+}
+
+/**
+ * @brief Decode the given bytes from an empty frame.
+ * @return Status of the last decoded byte.
+ */
+static int8_t receiveBytes(snap_frame_t *frame, const uint8_t *bytes, const uint16_t size)
+{
+	snap_init(frame, rxBuffer, sizeof(rxBuffer));
+
+	return decodeBytes(frame, bytes, size);
+}
+
+void setUp(void)
+{
+	seed = 2024;
+}
+
+void tearDown(void)
+{
+}
+
+void test_frame_is_sent_three_times(void)
+{
+	snap_frame_t frame;
+	snap_fields_t fields;
+
+	for(uint16_t n = 0; n < 200; n++)
+	{
+		encapsulateRandomFrame(&frame, &fields);
+
+		const uint16_t copySize = frame.size / 3U;
+		TEST_ASSERT_EQUAL_UINT16(frame.size, copySize * 3U);
+		TEST_ASSERT_EQUAL_MEMORY(txBuffer, &txBuffer[copySize], copySize);
+		TEST_ASSERT_EQUAL_MEMORY(txBuffer, &txBuffer[2U * copySize], copySize);
+	}
+}
+
+void test_errors_in_one_copy_per_bit_are_corrected(void)
+{
+	snap_frame_t tx, rx;
+	snap_fields_t fields;
+	snap_fields_t decoded;
+
+	for(uint16_t n = 0; n < 500; n++)
+	{
+		encapsulateRandomFrame(&tx, &fields);
+
+		const uint16_t copySize = tx.size / 3U;
+		memcpy(received, txBuffer, tx.size);
+
+		for(uint16_t i = 0; i < copySize; i++)
+		{
+			uint8_t taken = 0;	// Bits already corrupted in a copy
+
+			for(uint8_t copy = 0; copy < 3; copy++)
+			{
+				const uint8_t mask = (uint8_t)(nextRandom() & nextRandom() & ~taken);
+
+				if((copy == 0) && (i < tx.layout.dataIndex))
+				{
+					continue;	// The decoder reads the header and data length from the first copy
+				}
+
+				received[copy * copySize + i] ^= mask;
+				taken |= mask;
+			}
+		}
+
+		TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, receiveBytes(&rx, received, tx.size));
+		TEST_ASSERT_EQUAL_UINT16(tx.size, rx.size);
+		TEST_ASSERT_EQUAL_MEMORY(txBuffer, rxBuffer, tx.size);
+
+		TEST_ASSERT_TRUE(snap_decapsulate(&rx, &decoded) >= (int16_t)fields.dataSize);
+
+		if(fields.dataSize)
+		{
+			TEST_ASSERT_EQUAL_MEMORY(data, decoded.data, fields.dataSize);
+		}
+	}
+}
+
+void test_same_error_in_two_copies_is_not_corrected(void)
+{
+	static const uint8_t payload[] = "two copies";
+	snap_frame_t tx, rx;
+	snap_fields_t fields;
+
+	memset(&fields, 0, sizeof(fields));
+	fields.header.edm = SNAP_HDB1_EDM_3_RETRANSMISSION;
+	fields.header.ndb = SNAP_HDB1_NDB_USER_SPECIFIED;
+	fields.data = (uint8_t *)payload;
+	fields.dataSize = sizeof(payload);
+
+	snap_init(&tx, txBuffer, sizeof(txBuffer));
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(&tx, &fields));
+
+	const uint16_t copySize = tx.size / 3U;
+	const uint16_t index = (uint16_t)(copySize - 1U);
+	memcpy(received, txBuffer, tx.size);
+	received[copySize + index] ^= 0x04;
+	received[2U * copySize + index] ^= 0x04;
+
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, receiveBytes(&rx, received, tx.size));	// No hash: the vote is trusted
+	TEST_ASSERT_EQUAL_HEX8(txBuffer[index] ^ 0x04, rxBuffer[index]);
+}
+
+void test_misaligned_copies_are_left_as_received(void)
+{
+	static const uint8_t payload[] = "misaligned";
+	snap_frame_t tx, rx;
+	snap_fields_t fields;
+
+	memset(&fields, 0, sizeof(fields));
+	fields.header.edm = SNAP_HDB1_EDM_3_RETRANSMISSION;
+	fields.header.ndb = SNAP_HDB1_NDB_USER_SPECIFIED;
+	fields.data = (uint8_t *)payload;
+	fields.dataSize = sizeof(payload);
+
+	snap_init(&tx, txBuffer, sizeof(txBuffer));
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(&tx, &fields));
+
+	const uint16_t copySize = tx.size / 3U;
+	memcpy(received, txBuffer, tx.size);
+	received[copySize + SNAP_INDEX_HDB1] ^= 0x01;	// The 2 other copies agree on another data length
+	received[2U * copySize + SNAP_INDEX_HDB1] ^= 0x01;
+	received[copySize + 5U] ^= 0xFF;
+
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_ERROR_HASH, receiveBytes(&rx, received, tx.size));
+	TEST_ASSERT_EQUAL_MEMORY(received, rxBuffer, tx.size);
+}
+
+void test_false_sync_is_skipped_by_the_stream_decoder(void)
+{
+	static const uint8_t falseSync[] = {SNAP_SYNC, 0x00, 0x1B};	// No addresses, 3 copies, exact length (see below)
+	static const uint8_t payload[] = {1, 8, 15, 22, 29, 36, 43, 50};
+	snap_frame_t tx, rx;
+	snap_fields_t fields;
+	uint16_t size = 0;
+	uint16_t found = 0;
+
+	memset(&fields, 0, sizeof(fields));
+	fields.header.edm = SNAP_HDB1_EDM_16BIT_CRC;
+	fields.data = (uint8_t *)payload;
+	fields.dataSize = sizeof(payload);
+
+	snap_init(&tx, txBuffer, sizeof(txBuffer));
+	TEST_ASSERT_EQUAL_INT8(SNAP_STATUS_VALID, snap_encapsulate(&tx, &fields));
+
+	memcpy(received, falseSync, sizeof(falseSync));
+	size = (uint16_t)(size + sizeof(falseSync));
+	memcpy(&received[size], txBuffer, tx.size);
+	size = (uint16_t)(size + tx.size);
+	memset(&received[size], 0, 250);	// Completes the false frame, whatever its length field says
+	size = (uint16_t)(size + 250U);
+
+	snap_init(&rx, rxBuffer, sizeof(rxBuffer));
+
+	for(uint16_t i = 0; i < size; i++)
+	{
+		if(snap_decodeStream(&rx, received[i]) == SNAP_STATUS_VALID)
+		{
+			TEST_ASSERT_EQUAL_UINT16(tx.size, rx.size);
+			TEST_ASSERT_EQUAL_MEMORY(txBuffer, rxBuffer, tx.size);
+			found++;
+			snap_reset(&rx);
+		}
+	}
+
+	TEST_ASSERT_EQUAL_UINT16(1, found);
+}
+
+int main(void)
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_frame_is_sent_three_times);
+	RUN_TEST(test_errors_in_one_copy_per_bit_are_corrected);
+	RUN_TEST(test_same_error_in_two_copies_is_not_corrected);
+	RUN_TEST(test_misaligned_copies_are_left_as_received);
+	RUN_TEST(test_false_sync_is_skipped_by_the_stream_decoder);
+	return UNITY_END();
+}